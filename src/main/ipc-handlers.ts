@@ -2,7 +2,7 @@ import { ipcMain, dialog, app } from 'electron'
 import * as fs from 'fs'
 import * as path from 'path'
 import { IPC } from '../shared/ipc-channels'
-import type { SampleFormat, SigMFAnnotation, FFTTileRequest, ExportConfig, CorrelateRequest } from '../shared/sample-formats'
+import type { SampleFormat, SigMFAnnotation, AnnotationQuery, AnnotationPageRequest, FFTTileRequest, ExportConfig, CorrelateRequest, OfdmSearchRequest, PSDRequest, CrossSpectrumRequest, DetectionConfig, DetectionUpdate, OverviewOptions, ChirpSearchConfig, SampleSearchConfig, PerfOptions, OpenFileOptions, StreamConfig, StreamEvent } from '../shared/sample-formats'
 
 // Native addon will be loaded when built
 let native: any = null
@@ -53,8 +53,9 @@ export function registerIpcHandlers(): void {
           extensions: [
             'cf32', 'fc32', 'cfile', 'raw', 'iq',
             'cf64', 'cs32', 'cs16', 'sc16', 'cs8', 'sc8', 'cu8',
-            'sigmf-data', 'sigmf-meta',
-            'rf32', 'rf64', 'rs16', 'rs8', 'ru8'
+            'sigmf-data', 'sigmf-meta', 'sigmf-collection',
+            'rf32', 'rf64', 'rs16', 'rs8', 'ru8',
+            'zst'
           ]
         },
         { name: 'All Files', extensions: ['*'] }
@@ -77,7 +78,7 @@ export function registerIpcHandlers(): void {
     return result.filePath.replace(/\.(sigmf-data|sigmf-meta)$/, '')
   })
 
-  ipcMain.handle(IPC.OPEN_FILE, async (_event, filePath: string, format?: SampleFormat) => {
+  ipcMain.handle(IPC.OPEN_FILE, async (_event, filePath: string, format?: SampleFormat, options?: OpenFileOptions) => {
     const addon = loadNative()
     if (!addon) {
       throw new Error('Native addon not loaded')
@@ -85,19 +86,57 @@ export function registerIpcHandlers(): void {
     if (typeof filePath !== 'string' || !filePath) {
       throw new Error('Invalid file path: ' + typeof filePath)
     }
-    return addon.openFile(String(filePath), String(format || ''))
+    // Statistics indexes are cached per file under the user data directory
+    const statsCacheDir = path.join(app.getPath('userData'), 'stats-cache')
+    fs.mkdirSync(statsCacheDir, { recursive: true })
+    return addon.openFile(String(filePath), String(format || ''), { ...options, statsCacheDir })
   })
 
-  ipcMain.handle(IPC.GET_SAMPLES, async (_event, start: number, length: number, stride: number = 1) => {
+  ipcMain.handle(IPC.REFRESH_FILE, async () => {
     const addon = loadNative()
     if (!addon) throw new Error('Native addon not loaded')
-    return addon.getSamples(start, length, stride || 1)
+    return addon.refreshFile()
+  })
+
+  ipcMain.handle(IPC.START_STREAM, async (event, config: StreamConfig) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    const sender = event.sender
+    addon.startStream(config, (data: StreamEvent) => {
+      if (!sender.isDestroyed()) sender.send(IPC.STREAM_EVENT, data)
+    })
+  })
+
+  ipcMain.handle(IPC.STOP_STREAM, async () => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.stopStream()
+  })
+
+  ipcMain.handle(IPC.STREAM_STATS, async () => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.getStreamStats()
+  })
+
+  ipcMain.handle(IPC.GET_SAMPLES, async (_event, start: number, length: number, stride: number = 1, channel: number = 0) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.getSamples(start, length, stride || 1, channel || 0)
   })
 
   ipcMain.handle(IPC.COMPUTE_FFT_TILE, async (_event, req: FFTTileRequest) => {
     const addon = loadNative()
     if (!addon) throw new Error('Native addon not loaded')
-    return addon.computeFFTTile(req.startSample, req.fftSize, req.stride)
+    return addon.computeFFTTile(req.startSample, req.fftSize, req.stride, {
+      mode: req.mode || 'stft',
+      fLow: req.fLow,
+      fHigh: req.fHigh,
+      channel: req.channel ?? 0,
+      spreadingFactor: req.spreadingFactor,
+      chirpBandwidth: req.chirpBandwidth,
+      symbolSamples: req.symbolSamples
+    })
   })
 
   ipcMain.handle(IPC.EXPORT_SIGMF, async (_event, config: ExportConfig) => {
@@ -106,6 +145,174 @@ export function registerIpcHandlers(): void {
     return addon.exportSigMF(config)
   })
 
+  ipcMain.handle(IPC.COMPUTE_PSD, async (_event, req: PSDRequest) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.computePSD(req.start, req.end, req.fftSize, req.overlap ?? 0.5, req.window || 'hann', req.mode || 'average', req.channel ?? 0)
+  })
+
+  ipcMain.handle(IPC.COMPUTE_CROSS_SPECTRUM, async (_event, req: CrossSpectrumRequest) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.computeCrossSpectrum(req.start, req.end, req.fftSize, req.overlap ?? 0.5, req.window || 'hann', req.pairs || [])
+  })
+
+  ipcMain.handle(IPC.DETECT_BURSTS, async (event, config: DetectionConfig) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    const sender = event.sender
+    return addon.detectBursts(config || {}, (update: DetectionUpdate) => {
+      if (!sender.isDestroyed()) sender.send(IPC.DETECTION_UPDATE, update)
+    })
+  })
+
+  ipcMain.handle(IPC.CANCEL_DETECTION, async () => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    addon.cancelDetection()
+  })
+
+  ipcMain.handle(IPC.RENDER_OVERVIEW, async (event, options: OverviewOptions, defaultName?: string) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    const result = await dialog.showSaveDialog({
+      defaultPath: defaultName || 'overview.png',
+      filters: [
+        { name: 'PNG Image', extensions: ['png'] },
+        { name: 'All Files', extensions: ['*'] }
+      ]
+    })
+    if (result.canceled || !result.filePath) return null
+    const sender = event.sender
+    const outcome = await addon.renderOverview({ ...options, outputPath: result.filePath }, (progress: number) => {
+      if (!sender.isDestroyed()) sender.send(IPC.OVERVIEW_PROGRESS, progress)
+    })
+    return { ...outcome, path: result.filePath }
+  })
+
+  ipcMain.handle(IPC.CANCEL_OVERVIEW, async () => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    addon.cancelOverview()
+  })
+
+  ipcMain.handle(IPC.FIND_CHIRP_SYMBOLS, async (event, config: ChirpSearchConfig) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    const sender = event.sender
+    return addon.findChirpSymbols(config || {}, (progress: number) => {
+      if (!sender.isDestroyed()) sender.send(IPC.CHIRP_PROGRESS, progress)
+    })
+  })
+
+  ipcMain.handle(IPC.CANCEL_CHIRP_SEARCH, async () => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    addon.cancelChirpSearch()
+  })
+
+  ipcMain.handle(IPC.SEARCH_SAMPLES, async (event, config: SampleSearchConfig) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    const sender = event.sender
+    return addon.searchSamples(config || {}, (progress: number) => {
+      if (!sender.isDestroyed()) sender.send(IPC.SAMPLE_SEARCH_PROGRESS, progress)
+    })
+  })
+
+  ipcMain.handle(IPC.CANCEL_SAMPLE_SEARCH, async () => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    addon.cancelSampleSearch()
+  })
+
+  ipcMain.handle(IPC.QUERY_ANNOTATIONS, async (_event, query: AnnotationQuery) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.queryAnnotations(query)
+  })
+
+  ipcMain.handle(IPC.ANNOTATION_PAGE, async (_event, req: AnnotationPageRequest) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.getAnnotationPage(req)
+  })
+
+  ipcMain.handle(IPC.ADD_ANNOTATIONS, async (_event, annotations: SigMFAnnotation[]) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.addAnnotations(annotations)
+  })
+
+  ipcMain.handle(IPC.UPDATE_ANNOTATION, async (_event, id: number, annotation: SigMFAnnotation) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.updateAnnotation(id, annotation)
+  })
+
+  ipcMain.handle(IPC.REMOVE_ANNOTATION, async (_event, id: number) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.removeAnnotation(id)
+  })
+
+  ipcMain.handle(IPC.STATS_STATUS, async () => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.getStatsStatus()
+  })
+
+  ipcMain.handle(IPC.AUTO_RANGE, async (_event, start: number, end: number, fftSize: number) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.getAutoRange(start, end, fftSize)
+  })
+
+  ipcMain.handle(IPC.FIND_SIGNAL, async (_event, from: number, direction: number, thresholdDb?: number) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.findSignal(from, direction, thresholdDb ?? 10)
+  })
+
+  ipcMain.handle(IPC.HEALTH_REPORT, async () => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.getHealthReport()
+  })
+
+  ipcMain.handle(IPC.PERF_STATS, async () => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.getPerfStats()
+  })
+
+  ipcMain.handle(IPC.RESET_PERF_STATS, async () => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    addon.resetPerfStats()
+  })
+
+  ipcMain.handle(IPC.SET_PERF_OPTIONS, async (_event, options: PerfOptions) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    addon.setPerfOptions(options)
+  })
+
+  ipcMain.handle(IPC.DUMP_PERF_TRACE, async () => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    const result = await dialog.showSaveDialog({
+      defaultPath: 'snail-trace.json',
+      filters: [
+        { name: 'Chrome Trace', extensions: ['json'] },
+        { name: 'All Files', extensions: ['*'] }
+      ]
+    })
+    if (result.canceled || !result.filePath) return null
+    const { events } = addon.dumpPerfTrace(result.filePath)
+    return { path: result.filePath, events }
+  })
+
   ipcMain.handle(IPC.READ_FILE_SAMPLES, async (_event, path: string, format: string, start: number, length: number) => {
     const addon = loadNative()
     if (!addon) throw new Error('Native addon not loaded')
@@ -118,6 +325,12 @@ export function registerIpcHandlers(): void {
     return addon.correlate(req)
   })
 
+  ipcMain.handle(IPC.SEARCH_OFDM, async (_event, req: OfdmSearchRequest) => {
+    const addon = loadNative()
+    if (!addon) throw new Error('Native addon not loaded')
+    return addon.searchOfdm(req)
+  })
+
   ipcMain.handle(IPC.SAVE_ANNOTATION, async (_event, filePath: string, annotation: SigMFAnnotation) => {
     // Determine the .sigmf-meta path
     let metaPath: string
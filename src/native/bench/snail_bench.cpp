@@ -0,0 +1,458 @@
+// snail_bench: standalone benchmarks for the native hot paths.
+//
+// Generates synthetic captures in every sample format, then times sample
+// conversion, tile computation, correlation, filtering/export and cold vs
+// warm page-cache reads. Results go out as JSON so runs can be compared
+// across releases. Build in Release; see CMakeLists.txt.
+
+#include "input_source.h"
+#include "tile_engine.h"
+#include "correlation_engine.h"
+#include "filter_engine.h"
+#include "sigmf_writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* const FORMATS[] = {
+    "cf32", "cf64", "cs32", "cs16", "cs8", "cu8",
+    "rf32", "rf64", "rs16", "rs8", "ru8"
+};
+
+// Samples converted per getSamples call in the conversion benchmark
+const size_t READ_CHUNK = 1 << 16;
+// Samples generated per write while building a synthetic capture
+const size_t GEN_CHUNK = 1 << 16;
+
+struct Options {
+    std::string outPath;              // empty = stdout
+    std::string dir;                  // synthetic captures and export output
+    size_t samples = size_t(1) << 24; // per synthetic capture
+    int reps = 5;
+    std::vector<std::string> only;    // sections to run, empty = all
+};
+
+void usage() {
+    std::fprintf(stderr,
+        "usage: snail_bench [--out FILE] [--dir DIR] [--samples N] [--reps N]\n"
+        "                   [--quick] [--only conversion,tiles,correlation,filter,cache]\n");
+}
+
+Options parseArgs(int argc, char** argv) {
+    Options opt;
+    opt.dir = (fs::temp_directory_path() / "snail-bench").string();
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--out") opt.outPath = value();
+        else if (arg == "--dir") opt.dir = value();
+        else if (arg == "--samples") opt.samples = std::stoull(value());
+        else if (arg == "--reps") opt.reps = std::max(1, std::stoi(value()));
+        else if (arg == "--quick") {
+            opt.samples = size_t(1) << 20;
+            opt.reps = 2;
+        } else if (arg == "--only") {
+            std::string list = value();
+            size_t pos = 0;
+            while (pos <= list.size()) {
+                size_t comma = list.find(',', pos);
+                if (comma == std::string::npos) comma = list.size();
+                if (comma > pos) opt.only.push_back(list.substr(pos, comma - pos));
+                pos = comma + 1;
+            }
+        } else if (arg == "--help" || arg == "-h") {
+            usage();
+            std::exit(0);
+        } else {
+            usage();
+            throw std::runtime_error("Unknown option: " + arg);
+        }
+    }
+    return opt;
+}
+
+bool wanted(const Options& opt, const std::string& section) {
+    return opt.only.empty() || std::find(opt.only.begin(), opt.only.end(), section) != opt.only.end();
+}
+
+// Median wall time of reps runs of fn, in seconds
+double medianSeconds(int reps, const std::function<void()>& fn) {
+    std::vector<double> times;
+    for (int r = 0; r < reps; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+// Keeps the optimizer from discarding benchmarked work
+volatile float g_sink;
+
+void consume(const std::complex<float>* data, size_t n) {
+    float acc = 0.0f;
+    for (size_t i = 0; i < n; i += 4096) acc += data[i].real();
+    g_sink = acc;
+}
+
+size_t sampleSize(const std::string& format) {
+    std::string type = format.substr(1);
+    size_t bytes = type == "f64" ? 8 : type == "f32" || type == "s32" ? 4 : type == "s16" ? 2 : 1;
+    return format[0] == 'c' ? bytes * 2 : bytes;
+}
+
+template <typename T>
+void put(std::vector<uint8_t>& out, T value) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+template <typename T>
+T quantize(float x, float scale, float offset, float lo, float hi) {
+    return static_cast<T>(std::min(hi, std::max(lo, std::round(x * scale + offset))));
+}
+
+void encode(const std::string& format, std::complex<float> s, std::vector<uint8_t>& out) {
+    float parts[2] = {s.real(), s.imag()};
+    int count = format[0] == 'c' ? 2 : 1;
+    std::string type = format.substr(1);
+    for (int k = 0; k < count; k++) {
+        float x = parts[k];
+        if (type == "f32") put(out, x);
+        else if (type == "f64") put(out, static_cast<double>(x));
+        else if (type == "s32") put(out, quantize<int32_t>(x, 2147483520.0f, 0.0f, -2147483520.0f, 2147483520.0f));
+        else if (type == "s16") put(out, quantize<int16_t>(x, 32767.0f, 0.0f, -32768.0f, 32767.0f));
+        else if (type == "s8") put(out, quantize<int8_t>(x, 127.0f, 0.0f, -128.0f, 127.0f));
+        else put(out, quantize<uint8_t>(x, 128.0f, 127.4f, 0.0f, 255.0f));
+    }
+}
+
+// Two tones plus noise at about -6 dBFS; the same signal in every format
+std::string makeCapture(const Options& opt, const std::string& format) {
+    fs::path path = fs::path(opt.dir) / ("synthetic." + format);
+    size_t bytes = opt.samples * sampleSize(format);
+    std::error_code ec;
+    if (fs::exists(path, ec) && fs::file_size(path, ec) == bytes) return path.string();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.good()) throw std::runtime_error("Cannot create " + path.string());
+    std::mt19937 rng(1234);
+    std::normal_distribution<float> noise(0.0f, 0.02f);
+    std::vector<uint8_t> chunk;
+    for (size_t done = 0; done < opt.samples; done += GEN_CHUNK) {
+        size_t n = std::min(GEN_CHUNK, opt.samples - done);
+        chunk.clear();
+        for (size_t i = 0; i < n; i++) {
+            double t = static_cast<double>(done + i);
+            std::complex<float> s =
+                0.3f * std::polar(1.0f, static_cast<float>(std::fmod(2 * M_PI * 0.0625 * t, 2 * M_PI))) +
+                0.1f * std::polar(1.0f, static_cast<float>(std::fmod(-2 * M_PI * 0.21 * t, 2 * M_PI))) +
+                std::complex<float>(noise(rng), noise(rng));
+            encode(format, s, chunk);
+        }
+        file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+    }
+    if (!file.good()) throw std::runtime_error("Failed to write " + path.string());
+    return path.string();
+}
+
+// Read every sample of source, converting to complex float
+void readAll(const InputSource& source) {
+    std::vector<std::complex<float>> buf(READ_CHUNK);
+    size_t total = source.totalSamples();
+    for (size_t at = 0; at < total; at += READ_CHUNK) {
+        size_t n = std::min(READ_CHUNK, total - at);
+        source.getSamples(at, n, buf.data());
+        consume(buf.data(), n);
+    }
+}
+
+// Ask the kernel to drop the file's cached pages. Only clean pages go, and
+// only where posix_fadvise exists; the result records whether it worked.
+bool evictFromPageCache(const std::string& path) {
+#if defined(POSIX_FADV_DONTNEED)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    ::fdatasync(fd);
+    bool ok = ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(fd);
+    return ok;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+json benchConversion(const Options& opt) {
+    json results = json::array();
+    for (const char* format : FORMATS) {
+        std::string path = makeCapture(opt, format);
+        BackendOptions backend;
+        backend.kind = "mmap";
+        InputSource source;
+        source.open(path, format, backend);
+        readAll(source);  // fault the pages in; this measures conversion, not I/O
+
+        double seconds = medianSeconds(opt.reps, [&] { readAll(source); });
+        double bytes = static_cast<double>(source.fileSize());
+        results.push_back({
+            {"format", format},
+            {"bytes", source.fileSize()},
+            {"seconds", seconds},
+            {"inputGBps", bytes / seconds / 1e9},
+            {"outputGBps", source.totalSamples() * sizeof(std::complex<float>) / seconds / 1e9},
+            {"msps", source.totalSamples() / seconds / 1e6}
+        });
+    }
+    return results;
+}
+
+json benchTiles(const Options& opt) {
+    json results = json::array();
+    std::string path = makeCapture(opt, "cf32");
+    InputSource source;
+    source.open(path, "cf32");
+    readAll(source);
+
+    struct Case {
+        std::string mode;
+        int fftSize;
+        int strideDiv;  // stride = fftSize / strideDiv
+    };
+    std::vector<Case> cases;
+    for (int fftSize : {256, 1024, 4096, 16384}) {
+        for (int div : {1, 4}) cases.push_back({"stft", fftSize, div});
+    }
+    for (int fftSize : {256, 1024, 4096}) cases.push_back({"reassigned", fftSize, 4});
+    for (int fftSize : {1024, 4096}) cases.push_back({"zoom", fftSize, 4});
+
+    for (auto& c : cases) {
+        int stride = std::max(1, c.fftSize / c.strideDiv);
+        TileOptions options;
+        options.mode = c.mode;
+        if (c.mode == "zoom") {
+            options.fLow = 0.05;
+            options.fHigh = 0.075;
+        }
+
+        // Consecutive tiles from the start, as when scrolling through the file
+        size_t tileSpan = static_cast<size_t>(TileEngine::TILE_LINES) * stride;
+        size_t tiles = std::max<size_t>(1, std::min<size_t>(8, source.totalSamples() / tileSpan));
+        size_t bins = TileEngine::lineBins(source, c.fftSize, options);
+        size_t lines = 0;
+        double seconds = medianSeconds(opt.reps, [&] {
+            lines = 0;
+            for (size_t t = 0; t < tiles; t++) {
+                auto tile = TileEngine::compute(source, t * tileSpan, c.fftSize, stride, options);
+                lines += tile.size() / bins;
+                g_sink = tile[0];
+            }
+        });
+        results.push_back({
+            {"mode", c.mode},
+            {"fftSize", c.fftSize},
+            {"stride", stride},
+            {"tiles", tiles},
+            {"seconds", seconds},
+            {"msPerTile", seconds * 1e3 / tiles},
+            {"linesPerSecond", lines / seconds},
+            {"msps", static_cast<double>(lines) * stride / seconds / 1e6}
+        });
+    }
+    return results;
+}
+
+json benchCorrelation(const Options& opt) {
+    json results = json::array();
+    std::string path = makeCapture(opt, "cf32");
+    InputSource source;
+    source.open(path, "cf32");
+
+    // Template of len samples searched through 4 * len, as the file-vs-file
+    // correlation does; the CP self-correlation runs over the same window
+    for (size_t len = 1 << 10; len <= (size_t(1) << 20); len <<= 2) {
+        size_t signalLen = len * 4;
+        if (signalLen > source.totalSamples()) break;
+        std::vector<std::complex<float>> signal(signalLen);
+        source.getSamples(0, signalLen, signal.data());
+
+        double crossSeconds = medianSeconds(opt.reps, [&] {
+            auto out = CorrelationEngine::crossCorrelate(signal.data(), signalLen, signal.data() + len, len);
+            g_sink = out.empty() ? 0.0f : out[0];
+        });
+        size_t tu = std::max<size_t>(64, len / 16);
+        double selfSeconds = medianSeconds(opt.reps, [&] {
+            auto out = CorrelationEngine::selfCorrelate(signal.data(), signalLen, tu, tu / 4);
+            g_sink = out.empty() ? 0.0f : out[0];
+        });
+        results.push_back({
+            {"window", len},
+            {"signal", signalLen},
+            {"crossMs", crossSeconds * 1e3},
+            {"selfMs", selfSeconds * 1e3},
+            {"selfTu", tu}
+        });
+    }
+    return results;
+}
+
+json benchFilter(const Options& opt) {
+    std::string path = makeCapture(opt, "cf32");
+    InputSource source;
+    source.open(path, "cf32");
+    size_t count = std::min<size_t>(source.totalSamples(), size_t(1) << 22);
+    std::vector<std::complex<float>> samples(count), filtered(count);
+    source.getSamples(0, count, samples.data());
+
+    const double sampleRate = 1e6;
+    double filterSeconds = medianSeconds(opt.reps, [&] {
+        FilterEngine::bandpassFilter(samples.data(), filtered.data(), count, 0.0625 * sampleRate, 0.02 * sampleRate, sampleRate);
+        consume(filtered.data(), count);
+    });
+
+    SigMFWriteConfig config;
+    config.outputPath = (fs::path(opt.dir) / "export").string();
+    config.sampleRate = sampleRate;
+    config.sampleCount = count;
+    double writeSeconds = medianSeconds(opt.reps, [&] {
+        SigMFWriter::write(config, filtered.data(), count);
+    });
+
+    double bytes = static_cast<double>(count * sizeof(std::complex<float>));
+    return {
+        {"samples", count},
+        {"filterSeconds", filterSeconds},
+        {"filterMsps", count / filterSeconds / 1e6},
+        {"writeSeconds", writeSeconds},
+        {"writeMBps", bytes / writeSeconds / 1e6},
+        {"exportMsps", count / (filterSeconds + writeSeconds) / 1e6}
+    };
+}
+
+json benchCache(const Options& opt) {
+    json results = json::array();
+    std::string path = makeCapture(opt, "cs16");
+    for (const char* kind : {"mmap", "async"}) {
+        BackendOptions backend;
+        backend.kind = kind;
+
+        // Cold runs evict before each pass, so each is a fresh open and read
+        bool evicted = true;
+        double coldSeconds = medianSeconds(opt.reps, [&] {
+            evicted = evictFromPageCache(path) && evicted;
+            InputSource source;
+            source.open(path, "cs16", backend);
+            readAll(source);
+        });
+
+        InputSource source;
+        source.open(path, "cs16", backend);
+        readAll(source);
+        double warmSeconds = medianSeconds(opt.reps, [&] { readAll(source); });
+
+        double bytes = static_cast<double>(source.fileSize());
+        results.push_back({
+            {"backend", kind},
+            {"bytes", source.fileSize()},
+            {"evicted", evicted},
+            {"coldSeconds", coldSeconds},
+            {"coldGBps", bytes / coldSeconds / 1e9},
+            {"warmSeconds", warmSeconds},
+            {"warmGBps", bytes / warmSeconds / 1e9}
+        });
+    }
+    return results;
+}
+
+std::string timestamp() {
+    std::time_t now = std::time(nullptr);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buf;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options opt = parseArgs(argc, argv);
+        fs::create_directories(opt.dir);
+
+        json report = {
+            {"tool", "snail_bench"},
+            {"schema", 1},
+            {"timestamp", timestamp()},
+            {"threads", std::thread::hardware_concurrency()},
+            {"samples", opt.samples},
+            {"reps", opt.reps}
+        };
+#if defined(__VERSION__)
+        report["compiler"] = __VERSION__;
+#endif
+
+        struct Section {
+            const char* name;
+            json (*run)(const Options&);
+        };
+        const Section sections[] = {
+            {"conversion", benchConversion},
+            {"tiles", benchTiles},
+            {"correlation", benchCorrelation},
+            {"filter", benchFilter},
+            {"cache", benchCache},
+        };
+        for (auto& section : sections) {
+            if (!wanted(opt, section.name)) continue;
+            std::fprintf(stderr, "snail_bench: %s...\n", section.name);
+            report["results"][section.name] = section.run(opt);
+        }
+
+        std::string text = report.dump(2);
+        if (opt.outPath.empty()) {
+            std::cout << text << std::endl;
+        } else {
+            std::ofstream out(opt.outPath);
+            if (!out.good()) throw std::runtime_error("Cannot write " + opt.outPath);
+            out << text << std::endl;
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "snail_bench: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,796 @@
+// snail_cli: headless batch processing on the native engine.
+//
+// Runs one command over a list of captures (files or directories) with
+// the same InputSource, tile, correlation, filter and SigMF code as the
+// app. Files are processed several at a time and each one splits its own
+// work across threads, so a batch keeps every core and disk busy. One JSON
+// line per file goes to stdout; progress goes to stderr.
+
+#include "input_source.h"
+#include "tile_engine.h"
+#include "burst_detector.h"
+#include "correlation_engine.h"
+#include "filter_engine.h"
+#include "sigmf_writer.h"
+#include "color_map.h"
+#include "png_writer.h"
+#include "overview_renderer.h"
+#include "chirp_engine.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace {
+
+// Default image width in time columns when neither --width nor --stride is set
+const int DEFAULT_WIDTH = 4096;
+// Default overview image height
+const int DEFAULT_HEIGHT = 512;
+// Refuse spectrogram images larger than this many pixels
+const size_t MAX_PIXELS = size_t(1) << 30;
+// Samples per correlation chunk, before the template overlap
+const size_t CORRELATE_CHUNK = size_t(1) << 20;
+// Samples per filter chunk in export
+const size_t EXPORT_CHUNK = size_t(1) << 22;
+
+struct Options {
+    std::string command;
+    std::vector<std::string> inputs;
+    std::string outDir = ".";
+    std::string format;      // sample format override
+    double rate = 0;         // sample rate override, Hz
+    unsigned jobs = 0;       // files at once, 0 = auto
+    bool recursive = false;
+    size_t start = 0;
+    size_t length = 0;       // 0 = to end of file
+    unsigned channels = 0;   // interleaved channels, 0 = from metadata
+    unsigned channel = 0;    // channel to render (spectrogram, overview)
+
+    // Frequencies in Hz relative to the centre, or cycles/sample when the
+    // capture has no sample rate (spectrogram --mode zoom, export)
+    double low = 0;
+    double high = 0;
+    bool hasBand = false;
+
+    // spectrogram
+    int fftSize = 1024;
+    int stride = 0;
+    int width = 0;
+    int height = 0;
+    std::string mode = "stft";
+    float minDb = 0;
+    float maxDb = 0;
+    bool hasMinDb = false;
+    bool hasMaxDb = false;
+    std::string colormap = "plasma-dark";
+    bool tiles = false;
+
+    // correlate
+    std::string templatePath;
+    std::string templateFormat;
+    size_t templateStart = 0;
+    size_t templateLength = 0;  // 0 = whole template file
+    size_t peaks = 10;
+    float minScore = 0.0f;
+
+    // detect
+    BurstConfig burst;
+
+    // chirps, spectrogram --mode dechirp
+    int spreadingFactor = 7;
+    double chirpBandwidth = 0;  // Hz, or cycles/sample without a rate; 0 = full band
+    size_t minSymbols = 4;
+};
+
+void usage() {
+    std::fprintf(stderr,
+        "usage: snail_cli <command> [options] <file|dir>...\n"
+        "\n"
+        "commands:\n"
+        "  spectrogram  render each capture to a PNG (time left to right, +freq at top)\n"
+        "  overview     render each whole capture to a --width x --height PNG, peak-held\n"
+        "  correlate    cross-correlate each capture against --template; report the top peaks\n"
+        "  detect       find bursts; writes <name>.bursts.json\n"
+        "  chirps       dechirp LoRa-style symbols; writes <name>.chirps.json\n"
+        "  export       bandpass --low..--high and write <name>.sigmf-{data,meta}\n"
+        "\n"
+        "common options:\n"
+        "  --out-dir DIR       where outputs go (default .)\n"
+        "  --format FMT        sample format override (cf32, cs16, ...)\n"
+        "  --rate HZ           sample rate for raw files\n"
+        "  --channels N        channels interleaved in the file (default: metadata, else 1)\n"
+        "  --start N           first sample (default 0)\n"
+        "  --length N          samples to process (default: to end of file)\n"
+        "  --jobs N            files processed at once (default: all cores)\n"
+        "  --recursive         descend into subdirectories\n"
+        "  --low HZ --high HZ  band relative to the centre; cycles/sample without a rate\n"
+        "\n"
+        "spectrogram:\n"
+        "  --fft N             FFT size (default 1024)\n"
+        "  --width N           time columns (default %d)\n"
+        "  --stride N          samples between columns (overrides --width)\n"
+        "  --mode M            stft, reassigned, zoom (needs --low/--high) or dechirp\n"
+        "  --min-db X          colour range (default: from the data)\n"
+        "  --max-db X\n"
+        "  --colormap NAME     plasma-dark or inspectrum\n"
+        "  --tiles             also write each %d-column tile as its own PNG\n"
+        "  --channel C         channel of a multi-channel file (default 0; overview too)\n"
+        "\n"
+        "overview:\n"
+        "  --fft N --width N --min-db X --max-db X --colormap NAME   as above\n"
+        "  --height N          rows (default %d)\n"
+        "\n"
+        "correlate:\n"
+        "  --template FILE     capture holding the template\n"
+        "  --template-format FMT\n"
+        "  --template-start N  --template-length N   template range within FILE\n"
+        "  --peaks N           peaks to report (default 10)\n"
+        "  --min-score X       ignore peaks below this normalized score\n"
+        "\n"
+        "detect:\n"
+        "  --fft N             frame length (default 256)\n"
+        "  --bands N           frequency bands (default 32)\n"
+        "  --threshold DB      power above the noise floor (default 10)\n"
+        "  --hysteresis DB     (default 4)\n"
+        "  --min-duration N    shortest burst in samples (default 0)\n"
+        "  --hold N            quiet frames tolerated inside a burst (default 1)\n"
+        "\n"
+        "chirps (--sf and --bw also set the spectrogram's dechirp mode):\n"
+        "  --sf N              spreading factor, 5 to 12 (default 7)\n"
+        "  --bw HZ             chirp bandwidth; cycles/sample without a rate (default: full band)\n"
+        "  --threshold DB      symbol peak above the mean of the symbol bins (default 10)\n"
+        "  --min-symbols N     shortest run reported as a frame (default 4)\n",
+        DEFAULT_WIDTH, TileEngine::TILE_LINES, DEFAULT_HEIGHT);
+}
+
+Options parseArgs(int argc, char** argv) {
+    Options opt;
+    if (argc < 2) {
+        usage();
+        throw std::runtime_error("Missing command");
+    }
+    opt.command = argv[1];
+    if (opt.command == "--help" || opt.command == "-h") {
+        usage();
+        std::exit(0);
+    }
+    if (opt.command != "spectrogram" && opt.command != "overview" && opt.command != "correlate" &&
+        opt.command != "detect" && opt.command != "chirps" && opt.command != "export") {
+        usage();
+        throw std::runtime_error("Unknown command: " + opt.command);
+    }
+
+    bool fftSet = false;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--out-dir") opt.outDir = value();
+        else if (arg == "--format") opt.format = value();
+        else if (arg == "--rate") opt.rate = std::stod(value());
+        else if (arg == "--channels") opt.channels = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--channel") opt.channel = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--start") opt.start = std::stoull(value());
+        else if (arg == "--length") opt.length = std::stoull(value());
+        else if (arg == "--jobs") opt.jobs = static_cast<unsigned>(std::max(1, std::stoi(value())));
+        else if (arg == "--recursive") opt.recursive = true;
+        else if (arg == "--low") { opt.low = std::stod(value()); opt.hasBand = true; }
+        else if (arg == "--high") { opt.high = std::stod(value()); opt.hasBand = true; }
+        else if (arg == "--fft") { opt.fftSize = std::stoi(value()); fftSet = true; }
+        else if (arg == "--width") opt.width = std::stoi(value());
+        else if (arg == "--height") opt.height = std::stoi(value());
+        else if (arg == "--stride") opt.stride = std::stoi(value());
+        else if (arg == "--mode") opt.mode = value();
+        else if (arg == "--min-db") { opt.minDb = std::stof(value()); opt.hasMinDb = true; }
+        else if (arg == "--max-db") { opt.maxDb = std::stof(value()); opt.hasMaxDb = true; }
+        else if (arg == "--colormap") opt.colormap = value();
+        else if (arg == "--tiles") opt.tiles = true;
+        else if (arg == "--template") opt.templatePath = value();
+        else if (arg == "--template-format") opt.templateFormat = value();
+        else if (arg == "--template-start") opt.templateStart = std::stoull(value());
+        else if (arg == "--template-length") opt.templateLength = std::stoull(value());
+        else if (arg == "--peaks") opt.peaks = std::max<size_t>(1, std::stoull(value()));
+        else if (arg == "--min-score") opt.minScore = std::stof(value());
+        else if (arg == "--bands") opt.burst.bands = std::stoi(value());
+        else if (arg == "--threshold") opt.burst.thresholdDb = std::stod(value());
+        else if (arg == "--hysteresis") opt.burst.hysteresisDb = std::stod(value());
+        else if (arg == "--min-duration") opt.burst.minDuration = std::stoull(value());
+        else if (arg == "--hold") opt.burst.holdFrames = std::stoi(value());
+        else if (arg == "--sf") opt.spreadingFactor = std::stoi(value());
+        else if (arg == "--bw") opt.chirpBandwidth = std::stod(value());
+        else if (arg == "--min-symbols") opt.minSymbols = std::stoull(value());
+        else if (arg == "--help" || arg == "-h") {
+            usage();
+            std::exit(0);
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            usage();
+            throw std::runtime_error("Unknown option: " + arg);
+        } else {
+            opt.inputs.push_back(arg);
+        }
+    }
+
+    if (opt.inputs.empty()) throw std::runtime_error("No input files");
+    if (opt.command == "detect") opt.burst.fftSize = fftSet ? opt.fftSize : 256;
+    if (opt.fftSize < 2) throw std::runtime_error("--fft must be at least 2");
+    if (opt.command == "correlate" && opt.templatePath.empty()) {
+        throw std::runtime_error("correlate needs --template");
+    }
+    if (opt.command == "export" && !opt.hasBand) {
+        throw std::runtime_error("export needs --low and --high");
+    }
+    if (opt.command == "spectrogram" && opt.mode == "zoom" && !opt.hasBand) {
+        throw std::runtime_error("--mode zoom needs --low and --high");
+    }
+    if (opt.hasBand && opt.high <= opt.low) throw std::runtime_error("--high must be above --low");
+    ColorMap check(opt.colormap);  // throws on an unknown name
+    (void)check;
+    return opt;
+}
+
+// Files picked up when scanning directories: any extension the reader
+// knows a format for. SigMF recordings are found through their
+// .sigmf-meta; compressed files end in .zst on top.
+bool isCapture(const fs::path& path) {
+    std::string name = path.filename().string();
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".zst") == 0) name.resize(name.size() - 4);
+    // A data file without its meta is still a recording
+    if (name.size() > 11 && name.compare(name.size() - 11, 11, ".sigmf-data") == 0) {
+        fs::path meta = path;
+        meta.replace_extension(".sigmf-meta");
+        return !fs::exists(meta);
+    }
+    size_t dot = name.rfind('.');
+    return dot != std::string::npos && dot > 0 && !formatForExtension(name.substr(dot + 1)).empty();
+}
+
+std::vector<std::string> collectInputs(const Options& opt) {
+    std::vector<std::string> files;
+    for (auto& input : opt.inputs) {
+        fs::path path(input);
+        if (!fs::is_directory(path)) {
+            files.push_back(input);
+            continue;
+        }
+        std::vector<std::string> found;
+        auto consider = [&](const fs::directory_entry& entry) {
+            if (entry.is_regular_file() && isCapture(entry.path())) found.push_back(entry.path().string());
+        };
+        if (opt.recursive) {
+            for (auto& entry : fs::recursive_directory_iterator(path)) consider(entry);
+        } else {
+            for (auto& entry : fs::directory_iterator(path)) consider(entry);
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+    return files;
+}
+
+// Output name for a capture: the file name without .zst or its SigMF
+// extension (raw files keep theirs, which names the format), made unique
+// across the batch
+std::vector<std::string> outputStems(const std::vector<std::string>& files) {
+    std::vector<std::string> stems;
+    std::map<std::string, int> seen;
+    for (auto& file : files) {
+        std::string name = fs::path(file).filename().string();
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".zst") == 0) name.resize(name.size() - 4);
+        size_t dot = name.rfind('.');
+        if (dot != std::string::npos && dot > 0 && name.compare(dot, 7, ".sigmf-") == 0) name.resize(dot);
+        int n = seen[name]++;
+        stems.push_back(n == 0 ? name : name + "-" + std::to_string(n));
+    }
+    return stems;
+}
+
+struct Job {
+    std::string path;
+    std::string stem;
+    unsigned workers;  // threads this file may use
+};
+
+// Open a job's capture with the layout options
+void openSource(const Options& opt, const Job& job, InputSource& source) {
+    BackendOptions options;
+    options.channels = opt.channels;
+    source.open(job.path, opt.format, options);
+}
+
+// Sample range of a job within its source
+void jobRange(const Options& opt, const InputSource& source, size_t& start, size_t& end) {
+    size_t total = source.totalSamples();
+    if (opt.start >= total) throw std::runtime_error("--start is past the end of the file");
+    start = opt.start;
+    end = opt.length ? std::min(total, start + opt.length) : total;
+}
+
+double sampleRateOf(const Options& opt, const InputSource& source) {
+    return opt.rate > 0 ? opt.rate : source.sampleRate();
+}
+
+// Band options to cycles/sample
+void normalizedBand(const Options& opt, double rate, double& fLow, double& fHigh) {
+    double scale = rate > 0 ? rate : 1.0;
+    fLow = opt.low / scale;
+    fHigh = opt.high / scale;
+    if (fLow < -0.5 || fHigh > 0.5) throw std::runtime_error("Band lies outside the captured bandwidth");
+}
+
+// Chirp options to ChirpParams, bandwidth in cycles/sample
+ChirpParams chirpParams(const Options& opt, double rate) {
+    ChirpParams params;
+    params.spreadingFactor = opt.spreadingFactor;
+    if (opt.chirpBandwidth > 0) params.bandwidth = opt.chirpBandwidth / (rate > 0 ? rate : 1.0);
+    params.length();  // throws for invalid parameters
+    return params;
+}
+
+json runSpectrogram(const Options& opt, const Job& job) {
+    InputSource source;
+    openSource(opt, job, source);
+    size_t start, end;
+    jobRange(opt, source, start, end);
+    size_t span = end - start;
+
+    int fftSize = opt.fftSize;
+    TileOptions tileOptions;
+    tileOptions.mode = opt.mode;
+    tileOptions.channel = opt.channel;
+    if (opt.mode == "zoom") normalizedBand(opt, sampleRateOf(opt, source), tileOptions.fLow, tileOptions.fHigh);
+    if (opt.mode == "dechirp") tileOptions.chirp = chirpParams(opt, sampleRateOf(opt, source));
+    // Rows per line: half the FFT for real captures, which have no
+    // negative frequencies
+    const int bins = TileEngine::lineBins(source, fftSize, tileOptions);
+
+    size_t stride = opt.stride > 0 ? static_cast<size_t>(opt.stride)
+        : std::max<size_t>(1, (span + (opt.width > 0 ? opt.width : DEFAULT_WIDTH) - 1) /
+                              (opt.width > 0 ? opt.width : DEFAULT_WIDTH));
+    if (stride > static_cast<size_t>(INT32_MAX)) throw std::runtime_error("Stride too large; raise --width");
+    size_t lines = (span + stride - 1) / stride;
+    if (lines * bins > MAX_PIXELS || lines > static_cast<size_t>(INT32_MAX)) {
+        throw std::runtime_error("Image too large (" + std::to_string(lines) + " x " +
+                                 std::to_string(bins) + "); lower --width or raise --stride");
+    }
+
+    // Tiles in parallel, each transposed into the image: column = line,
+    // row 0 = highest bin, as on screen
+    const size_t width = lines;
+    const size_t tileLines = TileEngine::TILE_LINES;
+    const size_t tiles = (lines + tileLines - 1) / tileLines;
+    std::vector<float> image(width * bins);
+    parallelForEach(tiles, job.workers, [&](size_t t, unsigned) {
+        size_t first = t * tileLines;
+        auto tile = TileEngine::compute(source, start + first * stride, fftSize, static_cast<int>(stride), tileOptions);
+        size_t count = std::min(tile.size() / bins, lines - first);
+        for (size_t l = 0; l < count; l++) {
+            const float* line = tile.data() + l * bins;
+            for (int bin = 0; bin < bins; bin++) {
+                image[(bins - 1 - bin) * width + first + l] = line[bin];
+            }
+        }
+        // Lines past the end of the file stay at the floor
+        for (size_t l = count; l < std::min(tileLines, lines - first); l++) {
+            for (int bin = 0; bin < bins; bin++) {
+                image[(bins - 1 - bin) * width + first + l] = -INFINITY;
+            }
+        }
+    });
+
+    float minDb, maxDb;
+    ColorMap::autoRange(image.data(), image.size(), minDb, maxDb);
+    if (opt.hasMinDb) minDb = opt.minDb;
+    if (opt.hasMaxDb) maxDb = opt.maxDb;
+
+    ColorMap colors(opt.colormap);
+    std::vector<uint8_t> rgba(image.size() * 4);
+    parallelFor(bins, job.workers, [&](size_t begin, size_t end, unsigned) {
+        colors.apply(image.data() + begin * width, (end - begin) * width, minDb, maxDb, rgba.data() + begin * width * 4);
+    });
+
+    fs::path out = fs::path(opt.outDir) / (job.stem + ".png");
+    PngWriter::write(out.string(), static_cast<int>(width), bins, rgba.data());
+
+    json result = {
+        {"output", out.string()},
+        {"width", width},
+        {"height", bins},
+        {"stride", stride},
+        {"minDb", minDb},
+        {"maxDb", maxDb}
+    };
+
+    if (opt.tiles) {
+        json tileFiles = json::array();
+        std::vector<std::string> names(tiles);
+        parallelForEach(tiles, job.workers, [&](size_t t, unsigned) {
+            size_t first = t * tileLines;
+            size_t count = std::min(tileLines, lines - first);
+            std::vector<uint8_t> tile(count * bins * 4);
+            for (int row = 0; row < bins; row++) {
+                std::copy_n(rgba.data() + (row * width + first) * 4, count * 4, tile.data() + row * count * 4);
+            }
+            char suffix[32];
+            std::snprintf(suffix, sizeof(suffix), ".tile%05zu.png", t);
+            names[t] = (fs::path(opt.outDir) / (job.stem + suffix)).string();
+            PngWriter::write(names[t], static_cast<int>(count), bins, tile.data());
+        });
+        for (auto& name : names) tileFiles.push_back(name);
+        result["tiles"] = tileFiles;
+    }
+    return result;
+}
+
+json runOverview(const Options& opt, const Job& job) {
+    InputSource source;
+    openSource(opt, job, source);
+
+    OverviewConfig config;
+    jobRange(opt, source, config.start, config.end);
+    config.width = opt.width > 0 ? opt.width : DEFAULT_WIDTH;
+    config.height = opt.height > 0 ? opt.height : DEFAULT_HEIGHT;
+    config.fftSize = opt.fftSize;
+    config.colormap = opt.colormap;
+    config.channel = opt.channel;
+    if (opt.hasMinDb) config.minDb = opt.minDb;
+    if (opt.hasMaxDb) config.maxDb = opt.maxDb;
+
+    fs::path out = fs::path(opt.outDir) / (job.stem + ".overview.png");
+    std::atomic<bool> cancel{false};
+    OverviewResult result = OverviewRenderer::render(source, config, out.string(), nullptr, cancel);
+
+    return {
+        {"output", out.string()},
+        {"width", config.width},
+        {"height", config.height},
+        {"ffts", result.ffts},
+        {"minDb", result.minDb},
+        {"maxDb", result.maxDb}
+    };
+}
+
+// Correlation template; real holds the same samples as floats when the
+// template file is a real format
+struct Template {
+    std::vector<std::complex<float>> samples;
+    std::vector<float> real;
+};
+
+struct Peak {
+    size_t sample;
+    float score;
+};
+
+// Strongest peaks at least separation apart, best first
+std::vector<Peak> strongestPeaks(std::vector<Peak> candidates, size_t count, size_t separation) {
+    std::sort(candidates.begin(), candidates.end(), [](const Peak& a, const Peak& b) {
+        return a.score > b.score || (a.score == b.score && a.sample < b.sample);
+    });
+    std::vector<Peak> kept;
+    for (auto& c : candidates) {
+        if (kept.size() == count) break;
+        bool clear = std::none_of(kept.begin(), kept.end(), [&](const Peak& k) {
+            size_t d = k.sample > c.sample ? k.sample - c.sample : c.sample - k.sample;
+            return d < separation;
+        });
+        if (clear) kept.push_back(c);
+    }
+    return kept;
+}
+
+json runCorrelate(const Options& opt, const Job& job, const Template& tmpl) {
+    InputSource source;
+    openSource(opt, job, source);
+    size_t start, end;
+    jobRange(opt, source, start, end);
+    size_t tmplLen = tmpl.samples.size();
+    // Real template against a real capture: r2c/c2r at half the cost
+    const bool real = !tmpl.real.empty() && !source.isComplex();
+    if (end - start < tmplLen) throw std::runtime_error("Capture is shorter than the template");
+
+    // Only lags where the whole template overlaps the signal count. Chunks
+    // of CORRELATE_CHUNK such lags each read tmplLen - 1 samples beyond.
+    size_t chunk = std::max(CORRELATE_CHUNK, tmplLen * 4);
+    size_t lagCount = end - start - tmplLen + 1;
+    size_t chunks = (lagCount + chunk - 1) / chunk;
+    std::vector<std::vector<Peak>> found(chunks);
+
+    parallelForEach(chunks, job.workers, [&](size_t c, unsigned) {
+        size_t lag0 = c * chunk;
+        size_t lags = std::min(chunk, lagCount - lag0);
+        size_t len = lags + tmplLen - 1;
+        std::vector<float> scores;
+        if (real) {
+            std::vector<float> signal(len);
+            source.getRealSamples(start + lag0, len, signal.data());
+            scores = CorrelationEngine::crossCorrelateReal(signal.data(), len, tmpl.real.data(), tmplLen);
+        } else {
+            std::vector<std::complex<float>> signal(len);
+            source.getSamples(start + lag0, len, signal.data());
+            scores = CorrelationEngine::crossCorrelate(signal.data(), len, tmpl.samples.data(), tmplLen);
+        }
+
+        // Output index tmplLen - 1 + k holds lag k
+        std::vector<Peak> candidates;
+        for (size_t k = 0; k < lags; k++) {
+            float s = scores[tmplLen - 1 + k];
+            if (s >= opt.minScore && s > 0) candidates.push_back({start + lag0 + k, s});
+        }
+        // Keep plenty per chunk so the global pass can still space them out
+        size_t keep = opt.peaks * 8;
+        if (candidates.size() > keep) {
+            std::nth_element(candidates.begin(), candidates.begin() + keep, candidates.end(),
+                             [](const Peak& a, const Peak& b) { return a.score > b.score; });
+            candidates.resize(keep);
+        }
+        found[c] = strongestPeaks(std::move(candidates), opt.peaks, tmplLen);
+    });
+
+    std::vector<Peak> all;
+    for (auto& f : found) all.insert(all.end(), f.begin(), f.end());
+    auto peaks = strongestPeaks(std::move(all), opt.peaks, tmplLen);
+
+    double rate = sampleRateOf(opt, source);
+    json list = json::array();
+    for (auto& p : peaks) {
+        json peak = {{"sample", p.sample}, {"score", p.score}};
+        if (rate > 0) peak["seconds"] = p.sample / rate;
+        list.push_back(peak);
+    }
+    return {{"templateLength", tmplLen}, {"peaks", list}};
+}
+
+json runDetect(const Options& opt, const Job& job) {
+    InputSource source;
+    openSource(opt, job, source);
+    BurstConfig config = opt.burst;
+    jobRange(opt, source, config.start, config.end);
+
+    // BurstDetector splits the range across its own workers
+    std::vector<Burst> bursts;
+    std::atomic<bool> cancel{false};
+    BurstDetector::run(source, config,
+        [&](const std::vector<Burst>& batch) { bursts.insert(bursts.end(), batch.begin(), batch.end()); },
+        [](double) {},
+        cancel);
+    std::sort(bursts.begin(), bursts.end(), [](const Burst& a, const Burst& b) {
+        return a.sampleStart < b.sampleStart;
+    });
+
+    double rate = sampleRateOf(opt, source);
+    json list = json::array();
+    for (auto& b : bursts) {
+        json burst = {
+            {"sampleStart", b.sampleStart},
+            {"sampleCount", b.sampleCount},
+            {"freqLow", b.freqLow},
+            {"freqHigh", b.freqHigh},
+            {"peakDb", b.peakDb}
+        };
+        if (rate > 0) {
+            burst["freqLowHz"] = source.centerFrequency() + b.freqLow * rate;
+            burst["freqHighHz"] = source.centerFrequency() + b.freqHigh * rate;
+        }
+        list.push_back(burst);
+    }
+
+    fs::path out = fs::path(opt.outDir) / (job.stem + ".bursts.json");
+    std::ofstream file(out);
+    if (!file.good()) throw std::runtime_error("Cannot write " + out.string());
+    file << list.dump(2) << std::endl;
+    if (!file.good()) throw std::runtime_error("Failed to write " + out.string());
+
+    return {{"output", out.string()}, {"bursts", bursts.size()}};
+}
+
+json runChirps(const Options& opt, const Job& job) {
+    InputSource source;
+    openSource(opt, job, source);
+    double rate = sampleRateOf(opt, source);
+    ChirpSearchConfig config;
+    config.chirp = chirpParams(opt, rate);
+    config.thresholdDb = opt.burst.thresholdDb;
+    config.minSymbols = opt.minSymbols;
+    config.channel = opt.channel;
+    jobRange(opt, source, config.start, config.end);
+
+    // ChirpEngine splits the range across its own workers
+    std::atomic<bool> cancel{false};
+    ChirpSearchResult result = ChirpEngine::findSymbols(source, config, nullptr, cancel);
+
+    json list = json::array();
+    for (auto& f : result.frames) {
+        json values = json::array();
+        for (size_t i = 0; i < f.symbolCount; i++) values.push_back(result.symbols[f.firstSymbol + i].value);
+        json frame = {
+            {"sampleStart", f.sampleStart},
+            {"sampleCount", f.sampleCount},
+            {"symbols", values}
+        };
+        if (rate > 0) frame["seconds"] = static_cast<double>(f.sampleStart) / rate;
+        list.push_back(frame);
+    }
+
+    fs::path out = fs::path(opt.outDir) / (job.stem + ".chirps.json");
+    std::ofstream file(out);
+    if (!file.good()) throw std::runtime_error("Cannot write " + out.string());
+    file << list.dump(2) << std::endl;
+    if (!file.good()) throw std::runtime_error("Failed to write " + out.string());
+
+    return {{"output", out.string()}, {"frames", result.frames.size()}, {"symbols", result.symbols.size()}};
+}
+
+json runExport(const Options& opt, const Job& job) {
+    InputSource source;
+    openSource(opt, job, source);
+    size_t start, end;
+    jobRange(opt, source, start, end);
+    size_t count = end - start;
+
+    double rate = sampleRateOf(opt, source);
+    double fLow, fHigh;
+    normalizedBand(opt, rate, fLow, fHigh);
+    double center = (fLow + fHigh) / 2;
+    double bandwidth = fHigh - fLow;
+
+    // The filter is an NCO mix-down and an FIR, so chunks filter
+    // independently: each starts filterLen samples early to settle the
+    // FIR and is rotated by the NCO phase its first sample would have had.
+    // Rounds of one chunk per worker are written in order.
+    size_t history = FilterEngine::filterLength(bandwidth, 1.0);
+    size_t chunks = (count + EXPORT_CHUNK - 1) / EXPORT_CHUNK;
+    unsigned workers = std::max(1u, job.workers);
+
+    fs::path base = fs::path(opt.outDir) / (job.stem + ".export");
+    std::string dataPath = base.string() + ".sigmf-data";
+    std::ofstream data(dataPath, std::ios::binary);
+    if (!data.good()) throw std::runtime_error("Cannot create " + dataPath);
+
+    std::vector<std::vector<std::complex<float>>> out(workers);
+    for (size_t round = 0; round < chunks; round += workers) {
+        size_t n = std::min<size_t>(workers, chunks - round);
+        parallelFor(n, workers, [&](size_t begin, size_t stop, unsigned) {
+            std::vector<std::complex<float>> in;
+            for (size_t w = begin; w < stop; w++) {
+                size_t c0 = (round + w) * EXPORT_CHUNK;
+                size_t len = std::min(EXPORT_CHUNK, count - c0);
+                size_t lead = std::min(history, c0);
+                size_t from = start + c0 - lead;
+                in.resize(lead + len);
+                out[w].resize(lead + len);
+                source.getSamples(from, lead + len, in.data());
+                FilterEngine::bandpassFilter(in.data(), out[w].data(), lead + len, center, bandwidth, 1.0);
+                double phase = std::fmod(-2 * M_PI * center * static_cast<double>(from - start), 2 * M_PI);
+                std::complex<float> rotate = std::polar(1.0f, static_cast<float>(phase));
+                for (size_t i = 0; i < len; i++) out[w][i] = out[w][lead + i] * rotate;
+                out[w].resize(len);
+            }
+        });
+        for (size_t w = 0; w < n; w++) {
+            data.write(reinterpret_cast<const char*>(out[w].data()), out[w].size() * sizeof(std::complex<float>));
+        }
+        if (!data.good()) throw std::runtime_error("Failed to write " + dataPath);
+    }
+    data.close();
+
+    SigMFWriteConfig config;
+    config.outputPath = base.string();
+    config.sampleRate = rate;
+    config.centerFrequency = source.centerFrequency();
+    config.captures = SigMFWriter::rebaseCaptures(source.captures(), start, end);
+    if (config.captures.size() == 1 && config.captures[0].frequency == 0) {
+        config.captures[0].frequency = source.centerFrequency();
+    }
+    config.description = "Bandpass export of " + fs::path(job.path).filename().string();
+    config.sampleStart = 0;
+    config.sampleCount = count;
+    SigMFWriter::writeMeta(config);
+
+    return {{"output", dataPath}, {"samples", count}};
+}
+
+Template loadTemplate(const Options& opt) {
+    InputSource source;
+    source.open(opt.templatePath, opt.templateFormat);
+    size_t total = source.totalSamples();
+    if (opt.templateStart >= total) throw std::runtime_error("--template-start is past the end of the template");
+    size_t len = opt.templateLength ? std::min(opt.templateLength, total - opt.templateStart)
+                                    : total - opt.templateStart;
+    Template tmpl;
+    tmpl.samples.resize(len);
+    source.getSamples(opt.templateStart, len, tmpl.samples.data());
+    if (!source.isComplex()) {
+        tmpl.real.resize(len);
+        source.getRealSamples(opt.templateStart, len, tmpl.real.data());
+    }
+    return tmpl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        Options opt = parseArgs(argc, argv);
+        std::vector<std::string> files = collectInputs(opt);
+        if (files.empty()) throw std::runtime_error("No captures found");
+        fs::create_directories(opt.outDir);
+        std::vector<std::string> stems = outputStems(files);
+
+        Template tmpl;
+        if (opt.command == "correlate") tmpl = loadTemplate(opt);
+
+        // Files at once, and the threads each file may use on top
+        unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+        unsigned jobs = opt.jobs ? opt.jobs : hw;
+        jobs = static_cast<unsigned>(std::min<size_t>(jobs, files.size()));
+        unsigned inner = std::max(1u, hw / jobs);
+
+        std::mutex outputMutex;
+        std::atomic<size_t> done{0};
+        std::atomic<size_t> failed{0};
+        auto batchStart = std::chrono::steady_clock::now();
+
+        parallelForEach(files.size(), jobs, [&](size_t i, unsigned) {
+            Job job{files[i], stems[i], inner};
+            auto t0 = std::chrono::steady_clock::now();
+            json line = {{"file", job.path}, {"command", opt.command}};
+            try {
+                json result;
+                if (opt.command == "spectrogram") result = runSpectrogram(opt, job);
+                else if (opt.command == "overview") result = runOverview(opt, job);
+                else if (opt.command == "correlate") result = runCorrelate(opt, job, tmpl);
+                else if (opt.command == "detect") result = runDetect(opt, job);
+                else if (opt.command == "chirps") result = runChirps(opt, job);
+                else result = runExport(opt, job);
+                line["ok"] = true;
+                line.update(result);
+            } catch (const std::exception& e) {
+                line["ok"] = false;
+                line["error"] = e.what();
+                failed++;
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            line["seconds"] = seconds;
+
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cout << line.dump() << std::endl;
+            std::fprintf(stderr, "snail_cli: [%zu/%zu] %s %s (%.2f s)\n", ++done, files.size(),
+                         line["ok"].get<bool>() ? "done" : "FAILED", job.path.c_str(), seconds);
+        });
+
+        double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count();
+        std::fprintf(stderr, "snail_cli: %zu files, %zu failed, %.2f s\n", files.size(), failed.load(), total);
+        return failed ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "snail_cli: %s\n", e.what());
+        return 2;
+    }
+}
@@ -4,12 +4,42 @@
 #include "spectrogram_worker.h"
 #include "filter_engine.h"
 #include "correlation_engine.h"
+#include "psd_engine.h"
+#include "cross_spectrum_engine.h"
+#include "burst_detector.h"
+#include "stats_index.h"
 #include "sigmf_writer.h"
-
-// Global input source (single file at a time)
-static InputSource g_source;
-
-// ── openFile(path, format?) -> FileInfo ──────────────────────────
+#include "stream_source.h"
+#include "perf_stats.h"
+#include "overview_renderer.h"
+#include "chirp_engine.h"
+#include "sample_search.h"
+#include "memory_budget.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Global input source (single file at a time). Workers take a reference
+// when queued, so reopening never frees a source a scan is still reading.
+static std::shared_ptr<InputSource> g_source = std::make_shared<InputSource>();
+// Statistics of the open file, built in the background after each open
+static StatsIndex g_stats;
+// Cancel flags of the long scans, set by cancel*() and by opening a file
+static std::atomic<bool> g_detectCancel{false};
+static std::atomic<bool> g_overviewCancel{false};
+static std::atomic<bool> g_chirpCancel{false};
+static std::atomic<bool> g_sampleSearchCancel{false};
+
+// ── openFile(path, format?, options?) -> FileInfo ────────────────
 
 Napi::Value OpenFile(const Napi::CallbackInfo& info) {
     auto env = info.Env();
@@ -20,8 +50,42 @@ Napi::Value OpenFile(const Napi::CallbackInfo& info) {
         format = info[1].As<Napi::String>().Utf8Value();
     }
 
+    BackendOptions options;
+    std::string statsCacheDir;
+    if (info.Length() > 2 && info[2].IsObject()) {
+        auto opts = info[2].As<Napi::Object>();
+        if (opts.Has("ioBackend") && opts.Get("ioBackend").IsString())
+            options.kind = opts.Get("ioBackend").As<Napi::String>().Utf8Value();
+        if (opts.Has("queueDepth") && opts.Get("queueDepth").IsNumber())
+            options.queueDepth = opts.Get("queueDepth").As<Napi::Number>().Uint32Value();
+        if (opts.Has("blockSize") && opts.Get("blockSize").IsNumber())
+            options.blockSize = static_cast<size_t>(opts.Get("blockSize").As<Napi::Number>().DoubleValue());
+        if (opts.Has("cacheSize") && opts.Get("cacheSize").IsNumber())
+            options.cacheBytes = static_cast<size_t>(opts.Get("cacheSize").As<Napi::Number>().DoubleValue());
+        if (opts.Has("segments") && opts.Get("segments").IsArray()) {
+            auto segments = opts.Get("segments").As<Napi::Array>();
+            for (uint32_t i = 0; i < segments.Length(); i++) {
+                options.segments.push_back(segments.Get(i).As<Napi::String>().Utf8Value());
+            }
+        }
+        if (opts.Has("channels") && opts.Get("channels").IsNumber())
+            options.channels = opts.Get("channels").As<Napi::Number>().Uint32Value();
+        if (opts.Has("statsCacheDir") && opts.Get("statsCacheDir").IsString())
+            statsCacheDir = opts.Get("statsCacheDir").As<Napi::String>().Utf8Value();
+    }
+
+    // The index reads the source, so it must stop before the source reopens
+    g_stats.stop();
+    // Scans of the previous file are stale; each holds its own reference
+    // to that file, which closes when the last of them finishes
+    g_detectCancel = true;
+    g_overviewCancel = true;
+    g_chirpCancel = true;
+    g_sampleSearchCancel = true;
+    g_source = std::make_shared<InputSource>();
     try {
-        g_source.open(path, format);
+        g_source->open(path, format, options);
+        g_stats.start(*g_source, path, statsCacheDir);
     } catch (const std::exception& e) {
         Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
         return env.Undefined();
@@ -29,23 +93,56 @@ Napi::Value OpenFile(const Napi::CallbackInfo& info) {
 
     auto result = Napi::Object::New(env);
     result.Set("path", Napi::String::New(env, path));
-    result.Set("format", Napi::String::New(env, g_source.format()));
-    result.Set("sampleRate", Napi::Number::New(env, g_source.sampleRate()));
-    result.Set("totalSamples", Napi::Number::New(env, static_cast<double>(g_source.totalSamples())));
-    result.Set("fileSize", Napi::Number::New(env, static_cast<double>(g_source.fileSize())));
-
-    if (g_source.centerFrequency() != 0) {
-        result.Set("centerFrequency", Napi::Number::New(env, g_source.centerFrequency()));
+    result.Set("format", Napi::String::New(env, g_source->format()));
+    result.Set("sampleRate", Napi::Number::New(env, g_source->sampleRate()));
+    result.Set("totalSamples", Napi::Number::New(env, static_cast<double>(g_source->totalSamples())));
+    result.Set("fileSize", Napi::Number::New(env, static_cast<double>(g_source->fileSize())));
+    result.Set("ioBackend", Napi::String::New(env, g_source->backendName()));
+    result.Set("segmentCount", Napi::Number::New(env, static_cast<double>(g_source->segmentCount())));
+    result.Set("channels", Napi::Number::New(env, static_cast<double>(g_source->channels())));
+
+    if (g_source->centerFrequency() != 0) {
+        result.Set("centerFrequency", Napi::Number::New(env, g_source->centerFrequency()));
     }
 
-    if (!g_source.sigmfMetaJson().empty()) {
-        result.Set("sigmfMetaJson", Napi::String::New(env, g_source.sigmfMetaJson()));
+    result.Set("annotationCount", Napi::Number::New(env, static_cast<double>(g_source->annotations().size())));
+
+    // Capture segments, so the renderer can label retunes and look up the
+    // tuning of any sample
+    const auto& captures = g_source->captures();
+    auto captureArray = Napi::Array::New(env, captures.size());
+    for (size_t i = 0; i < captures.size(); i++) {
+        auto c = Napi::Object::New(env);
+        c.Set("sampleStart", Napi::Number::New(env, static_cast<double>(captures[i].sampleStart)));
+        c.Set("frequency", Napi::Number::New(env, captures[i].frequency));
+        if (captures[i].hasGlobalIndex)
+            c.Set("globalIndex", Napi::Number::New(env, static_cast<double>(captures[i].globalIndex)));
+        if (!captures[i].datetime.empty())
+            c.Set("datetime", Napi::String::New(env, captures[i].datetime));
+        captureArray.Set(static_cast<uint32_t>(i), c);
     }
+    result.Set("captures", captureArray);
 
     return result;
 }
 
-// ── getSamples(start, length) -> Float32Array ────────────────────
+// ── refreshFile() -> {totalSamples, fileSize, grown} ─────────────
+// Follow mode: picks up samples appended to a still-recording file
+
+Napi::Value RefreshFile(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+
+    size_t before = g_source->totalSamples();
+    size_t after = g_source->refresh();
+
+    auto result = Napi::Object::New(env);
+    result.Set("totalSamples", Napi::Number::New(env, static_cast<double>(after)));
+    result.Set("fileSize", Napi::Number::New(env, static_cast<double>(g_source->fileSize())));
+    result.Set("grown", Napi::Boolean::New(env, after > before));
+    return result;
+}
+
+// ── getSamples(start, length, stride?, channel?) -> Float32Array ──
 
 Napi::Value GetSamples(const Napi::CallbackInfo& info) {
     auto env = info.Env();
@@ -58,9 +155,13 @@ Napi::Value GetSamples(const Napi::CallbackInfo& info) {
     }
 
     if (stride < 1) stride = 1;
+    size_t channel = 0;
+    if (info.Length() > 3 && info[3].IsNumber()) {
+        channel = info[3].As<Napi::Number>().Uint32Value();
+    }
 
     // Check bounds
-    if (start >= g_source.totalSamples()) {
+    if (start >= g_source->totalSamples()) {
         return Napi::Float32Array::New(env, 0);
     }
 
@@ -69,18 +170,19 @@ Napi::Value GetSamples(const Napi::CallbackInfo& info) {
     // (count - 1) * stride < totalSamples - start
     // count - 1 < (totalSamples - start) / stride
     // count < (totalSamples - start) / stride + 1
-    size_t maxLen = (g_source.totalSamples() - start + stride - 1) / stride;
+    size_t maxLen = (g_source->totalSamples() - start + stride - 1) / stride;
     if (length > maxLen) {
         length = maxLen;
     }
 
-    // Allocate complex samples then flatten to interleaved I/Q
-    std::vector<std::complex<float>> samples(length);
+    // Read complex samples then flatten to interleaved I/Q
+    PooledBuffer<std::complex<float>> samples;
     try {
+        samples = PooledBuffer<std::complex<float>>(length);
         if (stride > 1) {
-            g_source.getSamplesDetected(start, length, stride, samples.data());
+            g_source->getSamplesDetected(start, length, stride, samples.data(), channel);
         } else {
-            g_source.getSamplesStrided(start, length, stride, samples.data());
+            g_source->getSamplesStrided(start, length, stride, samples.data(), channel);
         }
     } catch (const std::exception& e) {
         Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
@@ -95,7 +197,7 @@ Napi::Value GetSamples(const Napi::CallbackInfo& info) {
     return result;
 }
 
-// ── computeFFTTile(startSample, fftSize, stride) -> Promise<Float32Array> ──
+// ── computeFFTTile(startSample, fftSize, stride, options?) -> Promise<Float32Array> ──
 
 Napi::Value ComputeFFTTile(const Napi::CallbackInfo& info) {
     auto env = info.Env();
@@ -103,15 +205,146 @@ Napi::Value ComputeFFTTile(const Napi::CallbackInfo& info) {
     size_t startSample = static_cast<size_t>(info[0].As<Napi::Number>().DoubleValue());
     int fftSize = info[1].As<Napi::Number>().Int32Value();
     int stride = info[2].As<Napi::Number>().Int32Value();
+    TileOptions options;
+    if (info.Length() > 3 && info[3].IsObject()) {
+        auto opts = info[3].As<Napi::Object>();
+        if (opts.Has("mode") && opts.Get("mode").IsString())
+            options.mode = opts.Get("mode").As<Napi::String>().Utf8Value();
+        if (opts.Has("fLow") && opts.Get("fLow").IsNumber())
+            options.fLow = opts.Get("fLow").As<Napi::Number>().DoubleValue();
+        if (opts.Has("fHigh") && opts.Get("fHigh").IsNumber())
+            options.fHigh = opts.Get("fHigh").As<Napi::Number>().DoubleValue();
+        if (opts.Has("channel") && opts.Get("channel").IsNumber())
+            options.channel = opts.Get("channel").As<Napi::Number>().Uint32Value();
+        if (opts.Has("spreadingFactor") && opts.Get("spreadingFactor").IsNumber())
+            options.chirp.spreadingFactor = opts.Get("spreadingFactor").As<Napi::Number>().Int32Value();
+        if (opts.Has("chirpBandwidth") && opts.Get("chirpBandwidth").IsNumber())
+            options.chirp.bandwidth = opts.Get("chirpBandwidth").As<Napi::Number>().DoubleValue();
+        if (opts.Has("symbolSamples") && opts.Get("symbolSamples").IsNumber())
+            options.chirp.symbolSamples = static_cast<size_t>(opts.Get("symbolSamples").As<Napi::Number>().DoubleValue());
+    }
 
     auto deferred = Napi::Promise::Deferred::New(env);
-    auto worker = new SpectrogramWorker(env, deferred, g_source, startSample, fftSize, stride);
+    auto worker = new SpectrogramWorker(env, deferred, g_source, startSample, fftSize, stride, options);
     worker->Queue();
 
     return deferred.Promise();
 }
 
-// ── exportSigMF(config) -> {success, error?} ────────────────────
+// ── exportSigMF(config) -> Promise<{success, error?}> ───────────
+// Streams the range to disk in chunks, each reserved from the memory
+// budget while it is read, filtered and written
+
+// Samples per chunk, halved while a chunk does not fit the budget
+static const size_t EXPORT_CHUNK = size_t(1) << 22;
+static const size_t MIN_EXPORT_CHUNK = size_t(1) << 16;
+
+class ExportWorker : public Napi::AsyncWorker {
+public:
+    ExportWorker(
+        Napi::Env env,
+        Napi::Promise::Deferred deferred,
+        const SigMFWriteConfig& writeConfig,
+        size_t startSample,
+        size_t endSample,
+        bool applyBandpass,
+        double bandpassLow,
+        double bandpassHigh
+    ) : Napi::AsyncWorker(env),
+        deferred_(deferred),
+        writeConfig_(writeConfig),
+        startSample_(startSample),
+        endSample_(endSample),
+        applyBandpass_(applyBandpass),
+        bandpassLow_(bandpassLow),
+        bandpassHigh_(bandpassHigh),
+        queuedNs_(PerfStats::nowNs()) {}
+
+    void Execute() override {
+        PerfStats::record(PerfStage::QueueWait, queuedNs_, PerfStats::nowNs());
+        try {
+            run();
+        } catch (const std::exception& e) {
+            error_ = e.what();
+        }
+    }
+
+    void OnOK() override {
+        auto env = Env();
+        auto result = Napi::Object::New(env);
+        result.Set("success", Napi::Boolean::New(env, error_.empty()));
+        if (!error_.empty()) result.Set("error", Napi::String::New(env, error_));
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    void run() {
+        size_t count = endSample_ - startSample_;
+        PerfScope perf(PerfStage::Export, count * sizeof(std::complex<float>), true);
+        const double sampleRate = writeConfig_.sampleRate;
+        const double bpCenter = (bandpassLow_ + bandpassHigh_) / 2.0;
+        const double bpBandwidth = std::abs(bandpassHigh_ - bandpassLow_);
+
+        // The filter is an NCO mix-down and an FIR, so chunks filter
+        // independently: each starts filterLen samples early to settle the
+        // FIR and is rotated by the NCO phase its first sample would have had
+        const size_t history = applyBandpass_ ? FilterEngine::filterLength(bpBandwidth, sampleRate) : 0;
+        // Input and output, plus the mix-down copy the filter makes
+        auto chunkBytes = [&](size_t len) {
+            return (history + len) * sizeof(std::complex<float>) * (applyBandpass_ ? 3 : 1);
+        };
+        size_t chunk = EXPORT_CHUNK;
+        size_t limit = MemoryBudget::requestLimit();
+        while (limit && chunk > MIN_EXPORT_CHUNK && chunkBytes(chunk) > limit) chunk /= 2;
+
+        std::string dataPath = writeConfig_.outputPath + ".sigmf-data";
+        std::ofstream data(dataPath, std::ios::binary);
+        if (!data.good()) throw std::runtime_error("Failed to create data file: " + dataPath);
+
+        for (size_t c0 = 0; c0 < count; c0 += chunk) {
+            size_t len = std::min(chunk, count - c0);
+            size_t lead = std::min(history, c0);
+            size_t from = startSample_ + c0 - lead;
+            auto budget = MemoryBudget::reserve(chunkBytes(len));
+
+            PooledBuffer<std::complex<float>> in(lead + len);
+            source_->getSamples(from, lead + len, in.data());
+            const std::complex<float>* out = in.data();
+            PooledBuffer<std::complex<float>> filtered;
+            if (applyBandpass_) {
+                filtered = PooledBuffer<std::complex<float>>(lead + len);
+                FilterEngine::bandpassFilter(in.data(), filtered.data(), lead + len,
+                                             bpCenter, bpBandwidth, sampleRate);
+                double phase = std::fmod(-2 * M_PI * bpCenter / sampleRate * static_cast<double>(from - startSample_),
+                                         2 * M_PI);
+                std::complex<float> rotate = std::polar(1.0f, static_cast<float>(phase));
+                for (size_t i = 0; i < len; i++) filtered[lead + i] *= rotate;
+                out = filtered.data() + lead;
+            }
+            data.write(reinterpret_cast<const char*>(out), len * sizeof(std::complex<float>));
+            if (!data.good()) throw std::runtime_error("Failed to write " + dataPath);
+        }
+        data.close();
+
+        SigMFWriter::writeMeta(writeConfig_);
+    }
+
+    Napi::Promise::Deferred deferred_;
+    SigMFWriteConfig writeConfig_;
+    size_t startSample_;
+    size_t endSample_;
+    bool applyBandpass_;
+    double bandpassLow_;
+    double bandpassHigh_;
+    uint64_t queuedNs_;
+    std::string error_;
+    // The file open when this was queued; outlives a reopen of g_source
+    std::shared_ptr<const InputSource> source_ = g_source;
+};
 
 Napi::Value ExportSigMF(const Napi::CallbackInfo& info) {
     auto env = info.Env();
@@ -133,56 +366,40 @@ Napi::Value ExportSigMF(const Napi::CallbackInfo& info) {
     if (config.Has("centerFrequency") && config.Get("centerFrequency").IsNumber())
         centerFreq = config.Get("centerFrequency").As<Napi::Number>().DoubleValue();
 
-    auto result = Napi::Object::New(env);
-
-    try {
-        size_t count = endSample - startSample;
-        std::vector<std::complex<float>> samples(count);
-        g_source.getSamples(startSample, count, samples.data());
-
-        std::complex<float>* outputSamples = samples.data();
-        std::vector<std::complex<float>> filtered;
-
-        if (applyBandpass) {
-            double bandpassLow = 0, bandpassHigh = 0;
-            if (config.Has("bandpassLow") && config.Get("bandpassLow").IsNumber())
-                bandpassLow = config.Get("bandpassLow").As<Napi::Number>().DoubleValue();
-            if (config.Has("bandpassHigh") && config.Get("bandpassHigh").IsNumber())
-                bandpassHigh = config.Get("bandpassHigh").As<Napi::Number>().DoubleValue();
-
-            double bpCenter = (bandpassLow + bandpassHigh) / 2.0;
-            double bpBandwidth = std::abs(bandpassHigh - bandpassLow);
-
-            filtered.resize(count);
-            FilterEngine::bandpassFilter(
-                samples.data(), filtered.data(), count,
-                bpCenter, bpBandwidth, sampleRate
-            );
-            outputSamples = filtered.data();
-        }
-
-        SigMFWriteConfig writeConfig;
-        writeConfig.outputPath = outputPath;
-        writeConfig.sampleRate = sampleRate;
-        writeConfig.centerFrequency = centerFreq;
-        writeConfig.description = description;
-        writeConfig.author = author;
-        writeConfig.sampleStart = 0;
-        writeConfig.sampleCount = count;
-
-        SigMFWriter::write(writeConfig, outputSamples, count);
-
-        result.Set("success", Napi::Boolean::New(env, true));
-    } catch (const std::exception& e) {
-        result.Set("success", Napi::Boolean::New(env, false));
-        result.Set("error", Napi::String::New(env, e.what()));
+    double bandpassLow = 0, bandpassHigh = 0;
+    if (config.Has("bandpassLow") && config.Get("bandpassLow").IsNumber())
+        bandpassLow = config.Get("bandpassLow").As<Napi::Number>().DoubleValue();
+    if (config.Has("bandpassHigh") && config.Get("bandpassHigh").IsNumber())
+        bandpassHigh = config.Get("bandpassHigh").As<Napi::Number>().DoubleValue();
+
+    SigMFWriteConfig writeConfig;
+    writeConfig.outputPath = outputPath;
+    writeConfig.sampleRate = sampleRate;
+    writeConfig.centerFrequency = centerFreq;
+
+    writeConfig.captures = SigMFWriter::rebaseCaptures(g_source->captures(), startSample, endSample);
+    // Raw files have no tuning of their own; use the one supplied
+    if (writeConfig.captures.size() == 1 && writeConfig.captures[0].frequency == 0) {
+        writeConfig.captures[0].frequency = centerFreq;
     }
+    writeConfig.description = description;
+    writeConfig.author = author;
+    writeConfig.sampleStart = 0;
+    writeConfig.sampleCount = endSample - startSample;
 
-    return result;
+    auto deferred = Napi::Promise::Deferred::New(env);
+    auto worker = new ExportWorker(env, deferred, writeConfig, startSample, endSample,
+                                   applyBandpass, bandpassLow, bandpassHigh);
+    worker->Queue();
+
+    return deferred.Promise();
 }
 
 // ── correlate(templateStart, templateLen, secondFile, format?) -> Promise<Float32Array> ──
 
+// Lags computed per chunk when a correlation streams
+static const size_t STREAM_CHUNK_LAGS = size_t(1) << 20;
+
 class CorrelationWorker : public Napi::AsyncWorker {
 public:
     CorrelationWorker(
@@ -203,12 +420,12 @@ public:
         secondPath_(secondPath),
         secondFormat_(secondFormat),
         tu_(tu),
-        cpLen_(cpLen) {}
+        cpLen_(cpLen),
+        queuedNs_(PerfStats::nowNs()) {}
 
     void Execute() override {
-        // Read search window from current (main) file
-        std::vector<std::complex<float>> signal(windowLen_);
-        g_source.getSamples(windowStart_, windowLen_, signal.data());
+        PerfStats::record(PerfStage::QueueWait, queuedNs_, PerfStats::nowNs());
+        PerfScope perf(PerfStage::Correlate, windowLen_ * source_->sampleSize(), true);
 
         if (mode_ == "file") {
             // Open second file as the pattern/template to search for
@@ -216,7 +433,38 @@ public:
             secondSource.open(secondPath_, secondFormat_);
 
             size_t patternLen = secondSource.totalSamples();
-            std::vector<std::complex<float>> pattern(patternLen);
+            const bool real = !source_->isComplex() && !secondSource.isComplex();
+            const size_t longer = std::max(windowLen_, patternLen);
+            const size_t shorter = std::min(windowLen_, patternLen);
+
+            // One transform over everything if the budget has room for it
+            // now; otherwise stream the longer side through in chunks
+            // rather than queue behind other requests for gigabytes
+            budget_ = MemoryBudget::tryReserve(CorrelationEngine::oneShotBytes(longer, shorter, real));
+            if (!budget_ && shorter > 0) {
+                MemoryBudget::noteDegraded();
+                correlateStreaming(secondSource, patternLen, real);
+                return;
+            }
+
+            if (real) {
+                // Both real: r2c/c2r transforms at half the cost
+                PooledBuffer<float> signal(windowLen_), pattern(patternLen);
+                source_->getRealSamples(windowStart_, windowLen_, signal.data());
+                secondSource.getRealSamples(0, patternLen, pattern.data());
+                if (patternLen <= windowLen_) {
+                    result_ = CorrelationEngine::crossCorrelateReal(
+                        signal.data(), windowLen_, pattern.data(), patternLen);
+                } else {
+                    result_ = CorrelationEngine::crossCorrelateReal(
+                        pattern.data(), patternLen, signal.data(), windowLen_);
+                }
+                return;
+            }
+
+            PooledBuffer<std::complex<float>> signal(windowLen_);
+            source_->getSamples(windowStart_, windowLen_, signal.data());
+            PooledBuffer<std::complex<float>> pattern(patternLen);
             secondSource.getSamples(0, patternLen, pattern.data());
 
             // Cross-correlate: the shorter sequence slides through the longer one
@@ -236,7 +484,11 @@ public:
                 );
             }
         } else if (mode_ == "self") {
-            // Self-correlation (Schmidl & Cox)
+            // Self-correlation (Schmidl & Cox): the window, its lag
+            // products and energies, and the output
+            budget_ = MemoryBudget::reserve(windowLen_ * (2 * sizeof(std::complex<float>) + 2 * sizeof(float)));
+            PooledBuffer<std::complex<float>> signal(windowLen_);
+            source_->getSamples(windowStart_, windowLen_, signal.data());
             result_ = CorrelationEngine::selfCorrelate(
                 signal.data(), windowLen_,
                 tu_, cpLen_
@@ -247,7 +499,10 @@ public:
     void OnOK() override {
         auto env = Env();
         auto buf = Napi::Float32Array::New(env, result_.size());
-        std::memcpy(buf.Data(), result_.data(), result_.size() * sizeof(float));
+        {
+            PerfScope perf(PerfStage::CopyToJS, result_.size() * sizeof(float));
+            std::memcpy(buf.Data(), result_.data(), result_.size() * sizeof(float));
+        }
         deferred_.Resolve(buf);
     }
 
@@ -256,6 +511,43 @@ public:
     }
 
 private:
+    // The shorter side stays in memory and the longer is read a chunk at
+    // a time. The whole streaming working set is reserved up front, with
+    // chunks halved until it fits the budget, so nothing waits for more
+    // budget while holding some.
+    void correlateStreaming(const InputSource& secondSource, size_t patternLen, bool real) {
+        const bool windowLonger = patternLen <= windowLen_;
+        const size_t longer = windowLonger ? windowLen_ : patternLen;
+        const size_t shorter = windowLonger ? patternLen : windowLen_;
+
+        size_t chunkLags = CorrelationEngine::chunkLagsWithin(
+            longer, shorter, real, std::max(STREAM_CHUNK_LAGS, shorter * 4), MemoryBudget::requestLimit());
+        budget_ = MemoryBudget::reserve(CorrelationEngine::chunkedBytes(longer, shorter, real, chunkLags));
+
+        const InputSource& longSource = windowLonger ? *source_ : secondSource;
+        const size_t longStart = windowLonger ? windowStart_ : 0;
+        const InputSource& shortSource = windowLonger ? secondSource : *source_;
+        const size_t shortStart = windowLonger ? 0 : windowStart_;
+
+        if (real) {
+            PooledBuffer<float> tmpl(shorter);
+            shortSource.getRealSamples(shortStart, shorter, tmpl.data());
+            result_ = CorrelationEngine::crossCorrelateRealChunked(
+                [&](size_t start, size_t count, float* dest) {
+                    longSource.getRealSamples(longStart + start, count, dest);
+                },
+                longer, tmpl.data(), shorter, chunkLags);
+        } else {
+            PooledBuffer<std::complex<float>> tmpl(shorter);
+            shortSource.getSamples(shortStart, shorter, tmpl.data());
+            result_ = CorrelationEngine::crossCorrelateChunked(
+                [&](size_t start, size_t count, std::complex<float>* dest) {
+                    longSource.getSamples(longStart + start, count, dest);
+                },
+                longer, tmpl.data(), shorter, chunkLags);
+        }
+    }
+
     Napi::Promise::Deferred deferred_;
     std::string mode_;
     size_t windowStart_;
@@ -264,7 +556,12 @@ private:
     std::string secondFormat_;
     size_t tu_;
     size_t cpLen_;
+    uint64_t queuedNs_;
+    // Held until the result is copied out
+    MemoryReservation budget_;
     std::vector<float> result_;
+    // The file open when this was queued; outlives a reopen of g_source
+    std::shared_ptr<const InputSource> source_ = g_source;
 };
 
 Napi::Value Correlate(const Napi::CallbackInfo& info) {
@@ -298,6 +595,1026 @@ Napi::Value Correlate(const Napi::CallbackInfo& info) {
     return deferred.Promise();
 }
 
+// ── searchOfdm({windowStart, windowLength, hypotheses, maxResults?}) -> Promise<candidate[]> ──
+// Blind OFDM numerology search over the window, best candidates first
+
+class OfdmSearchWorker : public Napi::AsyncWorker {
+public:
+    OfdmSearchWorker(
+        Napi::Env env,
+        Napi::Promise::Deferred deferred,
+        size_t windowStart,
+        size_t windowLen,
+        std::vector<OfdmHypothesis> grid,
+        size_t maxResults
+    ) : Napi::AsyncWorker(env),
+        deferred_(deferred),
+        windowStart_(windowStart),
+        windowLen_(windowLen),
+        grid_(std::move(grid)),
+        maxResults_(maxResults),
+        queuedNs_(PerfStats::nowNs()) {}
+
+    void Execute() override {
+        PerfStats::record(PerfStage::QueueWait, queuedNs_, PerfStats::nowNs());
+        PerfScope perf(PerfStage::Correlate, windowLen_ * source_->sampleSize(), true);
+
+        // The window and its energies, and a set of lag products per worker
+        unsigned workers = parallelWorkers(grid_.size());
+        auto budget = MemoryBudget::reserve(
+            windowLen_ * ((1 + workers) * sizeof(std::complex<float>) + sizeof(float)));
+        PooledBuffer<std::complex<float>> signal(windowLen_);
+        source_->getSamples(windowStart_, windowLen_, signal.data());
+        result_ = CorrelationEngine::searchOfdm(signal.data(), windowLen_, std::move(grid_));
+        if (maxResults_ && result_.size() > maxResults_) result_.resize(maxResults_);
+    }
+
+    void OnOK() override {
+        auto env = Env();
+        auto list = Napi::Array::New(env, result_.size());
+        for (size_t i = 0; i < result_.size(); i++) {
+            const auto& c = result_[i];
+            auto obj = Napi::Object::New(env);
+            obj.Set("tu", Napi::Number::New(env, static_cast<double>(c.tu)));
+            obj.Set("cpLen", Napi::Number::New(env, static_cast<double>(c.cpLen)));
+            obj.Set("timing", Napi::Number::New(env, static_cast<double>(windowStart_ + c.timing)));
+            obj.Set("symbols", Napi::Number::New(env, static_cast<double>(c.symbols)));
+            obj.Set("score", Napi::Number::New(env, c.score));
+            obj.Set("peak", Napi::Number::New(env, c.peak));
+            obj.Set("cfo", Napi::Number::New(env, c.cfo));
+            list.Set(static_cast<uint32_t>(i), obj);
+        }
+        deferred_.Resolve(list);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    size_t windowStart_;
+    size_t windowLen_;
+    std::vector<OfdmHypothesis> grid_;
+    size_t maxResults_;
+    uint64_t queuedNs_;
+    std::vector<OfdmCandidate> result_;
+    // The file open when this was queued; outlives a reopen of g_source
+    std::shared_ptr<const InputSource> source_ = g_source;
+};
+
+Napi::Value SearchOfdm(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto config = info[0].As<Napi::Object>();
+
+    size_t windowStart = static_cast<size_t>(config.Get("windowStart").As<Napi::Number>().DoubleValue());
+    size_t windowLength = static_cast<size_t>(config.Get("windowLength").As<Napi::Number>().DoubleValue());
+    size_t maxResults = 0;
+    if (config.Has("maxResults") && config.Get("maxResults").IsNumber())
+        maxResults = static_cast<size_t>(config.Get("maxResults").As<Napi::Number>().DoubleValue());
+
+    std::vector<OfdmHypothesis> grid;
+    if (config.Has("hypotheses") && config.Get("hypotheses").IsArray()) {
+        auto arr = config.Get("hypotheses").As<Napi::Array>();
+        for (uint32_t i = 0; i < arr.Length(); i++) {
+            auto h = arr.Get(i).As<Napi::Object>();
+            OfdmHypothesis hypothesis;
+            hypothesis.tu = static_cast<size_t>(h.Get("tu").As<Napi::Number>().DoubleValue());
+            hypothesis.cpLen = static_cast<size_t>(h.Get("cpLen").As<Napi::Number>().DoubleValue());
+            grid.push_back(hypothesis);
+        }
+    }
+
+    auto deferred = Napi::Promise::Deferred::New(env);
+    auto worker = new OfdmSearchWorker(env, deferred, windowStart, windowLength, std::move(grid), maxResults);
+    worker->Queue();
+
+    return deferred.Promise();
+}
+
+// ── computePSD(start, end, fftSize, overlap, window, mode, channel?) -> Promise<{spectrum, segments, end, centerFrequency}> ──
+
+class PSDWorker : public Napi::AsyncWorker {
+public:
+    PSDWorker(
+        Napi::Env env,
+        Napi::Promise::Deferred deferred,
+        size_t start,
+        size_t end,
+        int fftSize,
+        double overlap,
+        WindowType window,
+        PSDMode mode,
+        unsigned channel
+    ) : Napi::AsyncWorker(env),
+        deferred_(deferred),
+        start_(start),
+        end_(end),
+        fftSize_(fftSize),
+        overlap_(overlap),
+        window_(window),
+        mode_(mode),
+        channel_(channel) {}
+
+    void Execute() override {
+        result_ = PSDEngine::compute(*source_, start_, end_, fftSize_, overlap_, window_, mode_, channel_);
+    }
+
+    void OnOK() override {
+        auto env = Env();
+        auto buf = Napi::Float32Array::New(env, result_.spectrum.size());
+        std::memcpy(buf.Data(), result_.spectrum.data(), result_.spectrum.size() * sizeof(float));
+        auto obj = Napi::Object::New(env);
+        obj.Set("spectrum", buf);
+        obj.Set("segments", Napi::Number::New(env, static_cast<double>(result_.segments)));
+        obj.Set("end", Napi::Number::New(env, static_cast<double>(result_.end)));
+        obj.Set("centerFrequency", Napi::Number::New(env, result_.centerFrequency));
+        deferred_.Resolve(obj);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    size_t start_;
+    size_t end_;
+    int fftSize_;
+    double overlap_;
+    WindowType window_;
+    PSDMode mode_;
+    unsigned channel_;
+    PSDResult result_;
+    // The file open when this was queued; outlives a reopen of g_source
+    std::shared_ptr<const InputSource> source_ = g_source;
+};
+
+Napi::Value ComputePSD(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto deferred = Napi::Promise::Deferred::New(env);
+
+    size_t start = static_cast<size_t>(info[0].As<Napi::Number>().DoubleValue());
+    size_t end = static_cast<size_t>(info[1].As<Napi::Number>().DoubleValue());
+    int fftSize = info[2].As<Napi::Number>().Int32Value();
+    double overlap = info.Length() > 3 && info[3].IsNumber() ? info[3].As<Napi::Number>().DoubleValue() : 0.5;
+    std::string window = info.Length() > 4 && info[4].IsString() ? info[4].As<Napi::String>().Utf8Value() : "hann";
+    std::string mode = info.Length() > 5 && info[5].IsString() ? info[5].As<Napi::String>().Utf8Value() : "average";
+    unsigned channel = info.Length() > 6 && info[6].IsNumber() ? info[6].As<Napi::Number>().Uint32Value() : 0;
+
+    try {
+        auto worker = new PSDWorker(
+            env, deferred, start, end, fftSize, overlap,
+            windowTypeFromName(window), psdModeFromName(mode), channel
+        );
+        worker->Queue();
+    } catch (const std::exception& e) {
+        deferred.Reject(Napi::Error::New(env, e.what()).Value());
+    }
+
+    return deferred.Promise();
+}
+
+// ── computeCrossSpectrum(start, end, fftSize, overlap, window, pairs?) -> Promise<{pairs, segments, end, centerFrequency}> ──
+// pairs is [[a, b], ...]; omitted or empty = every channel pair
+
+class CrossSpectrumWorker : public Napi::AsyncWorker {
+public:
+    CrossSpectrumWorker(
+        Napi::Env env,
+        Napi::Promise::Deferred deferred,
+        size_t start,
+        size_t end,
+        int fftSize,
+        double overlap,
+        WindowType window,
+        std::vector<std::pair<unsigned, unsigned>> pairs
+    ) : Napi::AsyncWorker(env),
+        deferred_(deferred),
+        start_(start),
+        end_(end),
+        fftSize_(fftSize),
+        overlap_(overlap),
+        window_(window),
+        pairs_(std::move(pairs)) {}
+
+    void Execute() override {
+        result_ = CrossSpectrumEngine::compute(*source_, start_, end_, fftSize_, overlap_, window_, pairs_);
+    }
+
+    void OnOK() override {
+        auto env = Env();
+        auto toArray = [&](const std::vector<float>& values) {
+            auto buf = Napi::Float32Array::New(env, values.size());
+            std::memcpy(buf.Data(), values.data(), values.size() * sizeof(float));
+            return buf;
+        };
+        auto pairs = Napi::Array::New(env, result_.pairs.size());
+        for (size_t i = 0; i < result_.pairs.size(); i++) {
+            const auto& p = result_.pairs[i];
+            auto pair = Napi::Object::New(env);
+            pair.Set("a", Napi::Number::New(env, p.a));
+            pair.Set("b", Napi::Number::New(env, p.b));
+            pair.Set("magnitude", toArray(p.magnitude));
+            pair.Set("phase", toArray(p.phase));
+            pair.Set("coherence", toArray(p.coherence));
+            pairs.Set(static_cast<uint32_t>(i), pair);
+        }
+        auto obj = Napi::Object::New(env);
+        obj.Set("pairs", pairs);
+        obj.Set("segments", Napi::Number::New(env, static_cast<double>(result_.segments)));
+        obj.Set("end", Napi::Number::New(env, static_cast<double>(result_.end)));
+        obj.Set("centerFrequency", Napi::Number::New(env, result_.centerFrequency));
+        deferred_.Resolve(obj);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    size_t start_;
+    size_t end_;
+    int fftSize_;
+    double overlap_;
+    WindowType window_;
+    std::vector<std::pair<unsigned, unsigned>> pairs_;
+    CrossSpectrumResult result_;
+    // The file open when this was queued; outlives a reopen of g_source
+    std::shared_ptr<const InputSource> source_ = g_source;
+};
+
+Napi::Value ComputeCrossSpectrum(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto deferred = Napi::Promise::Deferred::New(env);
+
+    size_t start = static_cast<size_t>(info[0].As<Napi::Number>().DoubleValue());
+    size_t end = static_cast<size_t>(info[1].As<Napi::Number>().DoubleValue());
+    int fftSize = info[2].As<Napi::Number>().Int32Value();
+    double overlap = info.Length() > 3 && info[3].IsNumber() ? info[3].As<Napi::Number>().DoubleValue() : 0.5;
+    std::string window = info.Length() > 4 && info[4].IsString() ? info[4].As<Napi::String>().Utf8Value() : "hann";
+    std::vector<std::pair<unsigned, unsigned>> pairs;
+    if (info.Length() > 5 && info[5].IsArray()) {
+        auto list = info[5].As<Napi::Array>();
+        for (uint32_t i = 0; i < list.Length(); i++) {
+            auto pair = list.Get(i).As<Napi::Array>();
+            pairs.emplace_back(pair.Get(0u).As<Napi::Number>().Uint32Value(),
+                               pair.Get(1u).As<Napi::Number>().Uint32Value());
+        }
+    }
+
+    try {
+        auto worker = new CrossSpectrumWorker(
+            env, deferred, start, end, fftSize, overlap, windowTypeFromName(window), std::move(pairs)
+        );
+        worker->Queue();
+    } catch (const std::exception& e) {
+        deferred.Reject(Napi::Error::New(env, e.what()).Value());
+    }
+
+    return deferred.Promise();
+}
+
+// ── detectBursts(config, onUpdate) -> Promise<{found, cancelled}> ──
+// onUpdate({progress, bursts}) is called as chunks finish; burst
+// frequencies are normalized (cycles/sample)
+
+struct DetectionUpdate {
+    double progress = 0.0;
+    std::vector<Burst> bursts;
+};
+
+class BurstWorker : public Napi::AsyncProgressQueueWorker<DetectionUpdate> {
+public:
+    BurstWorker(
+        Napi::Env env,
+        Napi::Promise::Deferred deferred,
+        Napi::Function onUpdate,
+        const BurstConfig& config
+    ) : Napi::AsyncProgressQueueWorker<DetectionUpdate>(env),
+        deferred_(deferred),
+        onUpdate_(Napi::Persistent(onUpdate)),
+        config_(config) {}
+
+    void Execute(const ExecutionProgress& progress) override {
+        // Bursts are batched with the progress that produced them
+        DetectionUpdate pending;
+        found_ = BurstDetector::run(*source_, config_,
+            [&](const std::vector<Burst>& bursts) {
+                pending.bursts.insert(pending.bursts.end(), bursts.begin(), bursts.end());
+            },
+            [&](double fraction) {
+                pending.progress = fraction;
+                progress.Send(&pending, 1);
+                pending.bursts.clear();
+            },
+            g_detectCancel);
+    }
+
+    void OnProgress(const DetectionUpdate* updates, size_t count) override {
+        auto env = Env();
+        for (size_t u = 0; u < count; u++) {
+            auto bursts = Napi::Array::New(env, updates[u].bursts.size());
+            for (size_t i = 0; i < updates[u].bursts.size(); i++) {
+                const Burst& b = updates[u].bursts[i];
+                auto obj = Napi::Object::New(env);
+                obj.Set("sampleStart", Napi::Number::New(env, static_cast<double>(b.sampleStart)));
+                obj.Set("sampleCount", Napi::Number::New(env, static_cast<double>(b.sampleCount)));
+                obj.Set("freqLow", Napi::Number::New(env, b.freqLow));
+                obj.Set("freqHigh", Napi::Number::New(env, b.freqHigh));
+                obj.Set("peakDb", Napi::Number::New(env, b.peakDb));
+                bursts.Set(static_cast<uint32_t>(i), obj);
+            }
+            auto update = Napi::Object::New(env);
+            update.Set("progress", Napi::Number::New(env, updates[u].progress));
+            update.Set("bursts", bursts);
+            onUpdate_.Call({update});
+        }
+    }
+
+    void OnOK() override {
+        auto env = Env();
+        auto result = Napi::Object::New(env);
+        result.Set("found", Napi::Number::New(env, static_cast<double>(found_)));
+        result.Set("cancelled", Napi::Boolean::New(env, g_detectCancel.load()));
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::FunctionReference onUpdate_;
+    BurstConfig config_;
+    size_t found_ = 0;
+    // The file open when this was queued; outlives a reopen of g_source
+    std::shared_ptr<const InputSource> source_ = g_source;
+};
+
+Napi::Value DetectBursts(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto opts = info[0].As<Napi::Object>();
+    auto onUpdate = info[1].As<Napi::Function>();
+
+    BurstConfig config;
+    if (opts.Has("start") && opts.Get("start").IsNumber())
+        config.start = static_cast<size_t>(opts.Get("start").As<Napi::Number>().DoubleValue());
+    if (opts.Has("end") && opts.Get("end").IsNumber())
+        config.end = static_cast<size_t>(opts.Get("end").As<Napi::Number>().DoubleValue());
+    if (opts.Has("fftSize") && opts.Get("fftSize").IsNumber())
+        config.fftSize = opts.Get("fftSize").As<Napi::Number>().Int32Value();
+    if (opts.Has("bands") && opts.Get("bands").IsNumber())
+        config.bands = opts.Get("bands").As<Napi::Number>().Int32Value();
+    if (opts.Has("thresholdDb") && opts.Get("thresholdDb").IsNumber())
+        config.thresholdDb = opts.Get("thresholdDb").As<Napi::Number>().DoubleValue();
+    if (opts.Has("hysteresisDb") && opts.Get("hysteresisDb").IsNumber())
+        config.hysteresisDb = opts.Get("hysteresisDb").As<Napi::Number>().DoubleValue();
+    if (opts.Has("minDuration") && opts.Get("minDuration").IsNumber())
+        config.minDuration = static_cast<size_t>(opts.Get("minDuration").As<Napi::Number>().DoubleValue());
+    if (opts.Has("holdFrames") && opts.Get("holdFrames").IsNumber())
+        config.holdFrames = opts.Get("holdFrames").As<Napi::Number>().Int32Value();
+    if (opts.Has("channel") && opts.Get("channel").IsNumber())
+        config.channel = opts.Get("channel").As<Napi::Number>().Uint32Value();
+
+    g_detectCancel = false;
+    auto deferred = Napi::Promise::Deferred::New(env);
+    auto worker = new BurstWorker(env, deferred, onUpdate, config);
+    worker->Queue();
+
+    return deferred.Promise();
+}
+
+// ── cancelDetection() -> undefined ───────────────────────────────
+
+Napi::Value CancelDetection(const Napi::CallbackInfo& info) {
+    g_detectCancel = true;
+    return info.Env().Undefined();
+}
+
+// ── renderOverview(config, onProgress) -> Promise<{minDb, maxDb, ffts, cancelled}> ──
+// Renders the whole file (or config.start..end) to a PNG at outputPath;
+// onProgress(fraction) is called as column blocks finish
+
+class OverviewWorker : public Napi::AsyncProgressQueueWorker<double> {
+public:
+    OverviewWorker(
+        Napi::Env env,
+        Napi::Promise::Deferred deferred,
+        Napi::Function onProgress,
+        const OverviewConfig& config,
+        const std::string& path
+    ) : Napi::AsyncProgressQueueWorker<double>(env),
+        deferred_(deferred),
+        onProgress_(Napi::Persistent(onProgress)),
+        config_(config),
+        path_(path) {}
+
+    void Execute(const ExecutionProgress& progress) override {
+        result_ = OverviewRenderer::render(*source_, config_, path_,
+            [&](double fraction) { progress.Send(&fraction, 1); },
+            g_overviewCancel);
+    }
+
+    void OnProgress(const double* fractions, size_t count) override {
+        if (count == 0) return;
+        onProgress_.Call({Napi::Number::New(Env(), fractions[count - 1])});
+    }
+
+    void OnOK() override {
+        auto env = Env();
+        auto result = Napi::Object::New(env);
+        result.Set("minDb", Napi::Number::New(env, result_.minDb));
+        result.Set("maxDb", Napi::Number::New(env, result_.maxDb));
+        result.Set("ffts", Napi::Number::New(env, static_cast<double>(result_.ffts)));
+        result.Set("cancelled", Napi::Boolean::New(env, result_.cancelled));
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::FunctionReference onProgress_;
+    OverviewConfig config_;
+    std::string path_;
+    OverviewResult result_;
+    // The file open when this was queued; outlives a reopen of g_source
+    std::shared_ptr<const InputSource> source_ = g_source;
+};
+
+Napi::Value RenderOverview(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto opts = info[0].As<Napi::Object>();
+    auto onProgress = info[1].As<Napi::Function>();
+
+    std::string path = opts.Get("outputPath").As<Napi::String>().Utf8Value();
+    OverviewConfig config;
+    config.width = opts.Get("width").As<Napi::Number>().Int32Value();
+    config.height = opts.Get("height").As<Napi::Number>().Int32Value();
+    config.fftSize = opts.Get("fftSize").As<Napi::Number>().Int32Value();
+    if (opts.Has("colormap") && opts.Get("colormap").IsString())
+        config.colormap = opts.Get("colormap").As<Napi::String>().Utf8Value();
+    if (opts.Has("start") && opts.Get("start").IsNumber())
+        config.start = static_cast<size_t>(opts.Get("start").As<Napi::Number>().DoubleValue());
+    if (opts.Has("end") && opts.Get("end").IsNumber())
+        config.end = static_cast<size_t>(opts.Get("end").As<Napi::Number>().DoubleValue());
+    if (opts.Has("channel") && opts.Get("channel").IsNumber())
+        config.channel = opts.Get("channel").As<Napi::Number>().Uint32Value();
+    if (opts.Has("minDb") && opts.Get("minDb").IsNumber())
+        config.minDb = static_cast<float>(opts.Get("minDb").As<Napi::Number>().DoubleValue());
+    if (opts.Has("maxDb") && opts.Get("maxDb").IsNumber())
+        config.maxDb = static_cast<float>(opts.Get("maxDb").As<Napi::Number>().DoubleValue());
+
+    g_overviewCancel = false;
+    auto deferred = Napi::Promise::Deferred::New(env);
+    auto worker = new OverviewWorker(env, deferred, onProgress, config, path);
+    worker->Queue();
+
+    return deferred.Promise();
+}
+
+// ── findChirpSymbols(config, onProgress) -> Promise<{symbols, frames, windows, cancelled}> ──
+// Dechirps the file (or config.start..end) one symbol window at a time;
+// onProgress(fraction) is called as blocks finish
+
+class ChirpSearchWorker : public Napi::AsyncProgressQueueWorker<double> {
+public:
+    ChirpSearchWorker(
+        Napi::Env env,
+        Napi::Promise::Deferred deferred,
+        Napi::Function onProgress,
+        const ChirpSearchConfig& config
+    ) : Napi::AsyncProgressQueueWorker<double>(env),
+        deferred_(deferred),
+        onProgress_(Napi::Persistent(onProgress)),
+        config_(config) {}
+
+    void Execute(const ExecutionProgress& progress) override {
+        result_ = ChirpEngine::findSymbols(*source_, config_,
+            [&](double fraction) { progress.Send(&fraction, 1); },
+            g_chirpCancel);
+    }
+
+    void OnProgress(const double* fractions, size_t count) override {
+        if (count == 0) return;
+        onProgress_.Call({Napi::Number::New(Env(), fractions[count - 1])});
+    }
+
+    void OnOK() override {
+        auto env = Env();
+        auto symbols = Napi::Array::New(env, result_.symbols.size());
+        for (size_t i = 0; i < result_.symbols.size(); i++) {
+            const auto& s = result_.symbols[i];
+            auto obj = Napi::Object::New(env);
+            obj.Set("sampleStart", Napi::Number::New(env, static_cast<double>(s.sampleStart)));
+            obj.Set("value", Napi::Number::New(env, s.value));
+            obj.Set("powerDb", Napi::Number::New(env, s.powerDb));
+            symbols.Set(static_cast<uint32_t>(i), obj);
+        }
+        auto frames = Napi::Array::New(env, result_.frames.size());
+        for (size_t i = 0; i < result_.frames.size(); i++) {
+            const auto& f = result_.frames[i];
+            auto obj = Napi::Object::New(env);
+            obj.Set("sampleStart", Napi::Number::New(env, static_cast<double>(f.sampleStart)));
+            obj.Set("sampleCount", Napi::Number::New(env, static_cast<double>(f.sampleCount)));
+            obj.Set("firstSymbol", Napi::Number::New(env, static_cast<double>(f.firstSymbol)));
+            obj.Set("symbolCount", Napi::Number::New(env, static_cast<double>(f.symbolCount)));
+            frames.Set(static_cast<uint32_t>(i), obj);
+        }
+        auto result = Napi::Object::New(env);
+        result.Set("symbols", symbols);
+        result.Set("frames", frames);
+        result.Set("windows", Napi::Number::New(env, static_cast<double>(result_.windows)));
+        result.Set("cancelled", Napi::Boolean::New(env, result_.cancelled));
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::FunctionReference onProgress_;
+    ChirpSearchConfig config_;
+    ChirpSearchResult result_;
+    // The file open when this was queued; outlives a reopen of g_source
+    std::shared_ptr<const InputSource> source_ = g_source;
+};
+
+Napi::Value FindChirpSymbols(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto opts = info[0].As<Napi::Object>();
+    auto onProgress = info[1].As<Napi::Function>();
+
+    ChirpSearchConfig config;
+    if (opts.Has("spreadingFactor") && opts.Get("spreadingFactor").IsNumber())
+        config.chirp.spreadingFactor = opts.Get("spreadingFactor").As<Napi::Number>().Int32Value();
+    if (opts.Has("chirpBandwidth") && opts.Get("chirpBandwidth").IsNumber())
+        config.chirp.bandwidth = opts.Get("chirpBandwidth").As<Napi::Number>().DoubleValue();
+    if (opts.Has("symbolSamples") && opts.Get("symbolSamples").IsNumber())
+        config.chirp.symbolSamples = static_cast<size_t>(opts.Get("symbolSamples").As<Napi::Number>().DoubleValue());
+    if (opts.Has("start") && opts.Get("start").IsNumber())
+        config.start = static_cast<size_t>(opts.Get("start").As<Napi::Number>().DoubleValue());
+    if (opts.Has("end") && opts.Get("end").IsNumber())
+        config.end = static_cast<size_t>(opts.Get("end").As<Napi::Number>().DoubleValue());
+    if (opts.Has("step") && opts.Get("step").IsNumber())
+        config.step = static_cast<size_t>(opts.Get("step").As<Napi::Number>().DoubleValue());
+    if (opts.Has("thresholdDb") && opts.Get("thresholdDb").IsNumber())
+        config.thresholdDb = opts.Get("thresholdDb").As<Napi::Number>().DoubleValue();
+    if (opts.Has("minSymbols") && opts.Get("minSymbols").IsNumber())
+        config.minSymbols = static_cast<size_t>(opts.Get("minSymbols").As<Napi::Number>().DoubleValue());
+    if (opts.Has("channel") && opts.Get("channel").IsNumber())
+        config.channel = opts.Get("channel").As<Napi::Number>().Uint32Value();
+
+    g_chirpCancel = false;
+    auto deferred = Napi::Promise::Deferred::New(env);
+    auto worker = new ChirpSearchWorker(env, deferred, onProgress, config);
+    worker->Queue();
+
+    return deferred.Promise();
+}
+
+// ── cancelChirpSearch() -> undefined ─────────────────────────────
+
+Napi::Value CancelChirpSearch(const Napi::CallbackInfo& info) {
+    g_chirpCancel = true;
+    return info.Env().Undefined();
+}
+
+// ── searchSamples(config, onProgress) -> Promise<{ranges, scanned, truncated, cancelled}> ──
+// Time-domain threshold search over the stored samples: condition
+// 'power' | 'average' | 'clip', mode 'first' | 'next' | 'all'
+
+class SampleSearchWorker : public Napi::AsyncProgressQueueWorker<double> {
+public:
+    SampleSearchWorker(
+        Napi::Env env,
+        Napi::Promise::Deferred deferred,
+        Napi::Function onProgress,
+        const SampleSearchConfig& config
+    ) : Napi::AsyncProgressQueueWorker<double>(env),
+        deferred_(deferred),
+        onProgress_(Napi::Persistent(onProgress)),
+        config_(config) {}
+
+    void Execute(const ExecutionProgress& progress) override {
+        PerfScope perf(PerfStage::Search, 0, true);
+        result_ = SampleSearch::run(*source_, config_,
+            [&](double fraction) { progress.Send(&fraction, 1); },
+            g_sampleSearchCancel);
+        perf.addBytes(result_.scanned * source_->frameSize());
+    }
+
+    void OnProgress(const double* fractions, size_t count) override {
+        if (count == 0) return;
+        onProgress_.Call({Napi::Number::New(Env(), fractions[count - 1])});
+    }
+
+    void OnOK() override {
+        auto env = Env();
+        auto ranges = Napi::Array::New(env, result_.ranges.size());
+        for (size_t i = 0; i < result_.ranges.size(); i++) {
+            const auto& r = result_.ranges[i];
+            auto obj = Napi::Object::New(env);
+            obj.Set("sampleStart", Napi::Number::New(env, static_cast<double>(r.sampleStart)));
+            obj.Set("sampleCount", Napi::Number::New(env, static_cast<double>(r.sampleCount)));
+            obj.Set("peakDb", Napi::Number::New(env, r.peakDb));
+            ranges.Set(static_cast<uint32_t>(i), obj);
+        }
+        auto result = Napi::Object::New(env);
+        result.Set("ranges", ranges);
+        result.Set("scanned", Napi::Number::New(env, static_cast<double>(result_.scanned)));
+        result.Set("truncated", Napi::Boolean::New(env, result_.truncated));
+        result.Set("cancelled", Napi::Boolean::New(env, result_.cancelled));
+        deferred_.Resolve(result);
+    }
+
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred_;
+    Napi::FunctionReference onProgress_;
+    SampleSearchConfig config_;
+    SampleSearchResult result_;
+    // The file open when this was queued; outlives a reopen of g_source
+    std::shared_ptr<const InputSource> source_ = g_source;
+};
+
+Napi::Value SearchSamples(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto opts = info[0].As<Napi::Object>();
+    auto onProgress = info[1].As<Napi::Function>();
+
+    SampleSearchConfig config;
+    if (opts.Has("condition") && opts.Get("condition").IsString()) {
+        std::string condition = opts.Get("condition").As<Napi::String>().Utf8Value();
+        if (condition == "power") config.condition = SampleCondition::Power;
+        else if (condition == "average") config.condition = SampleCondition::AveragePower;
+        else if (condition == "clip") config.condition = SampleCondition::Clip;
+        else {
+            Napi::Error::New(env, "Unknown search condition: " + condition).ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+    }
+    if (opts.Has("mode") && opts.Get("mode").IsString()) {
+        std::string mode = opts.Get("mode").As<Napi::String>().Utf8Value();
+        if (mode == "first") config.mode = SampleSearchMode::First;
+        else if (mode == "next") config.mode = SampleSearchMode::Next;
+        else if (mode == "all") config.mode = SampleSearchMode::All;
+        else {
+            Napi::Error::New(env, "Unknown search mode: " + mode).ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+    }
+    if (opts.Has("thresholdDb") && opts.Get("thresholdDb").IsNumber())
+        config.thresholdDb = opts.Get("thresholdDb").As<Napi::Number>().DoubleValue();
+    if (opts.Has("below") && opts.Get("below").IsBoolean())
+        config.below = opts.Get("below").As<Napi::Boolean>().Value();
+    if (opts.Has("window") && opts.Get("window").IsNumber())
+        config.window = static_cast<size_t>(opts.Get("window").As<Napi::Number>().DoubleValue());
+    if (opts.Has("start") && opts.Get("start").IsNumber())
+        config.start = static_cast<size_t>(opts.Get("start").As<Napi::Number>().DoubleValue());
+    if (opts.Has("end") && opts.Get("end").IsNumber())
+        config.end = static_cast<size_t>(opts.Get("end").As<Napi::Number>().DoubleValue());
+    if (opts.Has("maxGap") && opts.Get("maxGap").IsNumber())
+        config.maxGap = static_cast<size_t>(opts.Get("maxGap").As<Napi::Number>().DoubleValue());
+    if (opts.Has("maxRanges") && opts.Get("maxRanges").IsNumber())
+        config.maxRanges = static_cast<size_t>(opts.Get("maxRanges").As<Napi::Number>().DoubleValue());
+    if (opts.Has("channel") && opts.Get("channel").IsNumber())
+        config.channel = opts.Get("channel").As<Napi::Number>().Uint32Value();
+
+    g_sampleSearchCancel = false;
+    auto deferred = Napi::Promise::Deferred::New(env);
+    auto worker = new SampleSearchWorker(env, deferred, onProgress, config);
+    worker->Queue();
+
+    return deferred.Promise();
+}
+
+// ── cancelSampleSearch() -> undefined ────────────────────────────
+
+Napi::Value CancelSampleSearch(const Napi::CallbackInfo& info) {
+    g_sampleSearchCancel = true;
+    return info.Env().Undefined();
+}
+
+// ── cancelOverview() -> undefined ────────────────────────────────
+
+Napi::Value CancelOverview(const Napi::CallbackInfo& info) {
+    g_overviewCancel = true;
+    return info.Env().Undefined();
+}
+
+// ── getStatsStatus() -> {state, progress, fromCache, error?} ─────
+
+Napi::Value GetStatsStatus(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+
+    static const char* names[] = {"idle", "building", "ready", "failed"};
+    auto state = g_stats.state();
+
+    auto result = Napi::Object::New(env);
+    result.Set("state", Napi::String::New(env, names[static_cast<int>(state)]));
+    result.Set("progress", Napi::Number::New(env, g_stats.progress()));
+    result.Set("fromCache", Napi::Boolean::New(env, g_stats.fromCache()));
+    if (state == StatsIndex::State::Failed) {
+        result.Set("error", Napi::String::New(env, g_stats.error()));
+    }
+    return result;
+}
+
+// ── getAutoRange(start, end, fftSize) -> {minDb, maxDb} | null ───
+
+Napi::Value GetAutoRange(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+
+    size_t start = static_cast<size_t>(info[0].As<Napi::Number>().DoubleValue());
+    size_t end = static_cast<size_t>(info[1].As<Napi::Number>().DoubleValue());
+    int fftSize = info[2].As<Napi::Number>().Int32Value();
+
+    PowerRange range;
+    if (!g_stats.autoRange(start, end, fftSize, range)) return env.Null();
+
+    auto result = Napi::Object::New(env);
+    result.Set("minDb", Napi::Number::New(env, range.minDb));
+    result.Set("maxDb", Napi::Number::New(env, range.maxDb));
+    return result;
+}
+
+// ── findSignal(from, direction, thresholdDb) -> sample | -1 ──────
+
+Napi::Value FindSignal(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+
+    size_t from = static_cast<size_t>(info[0].As<Napi::Number>().DoubleValue());
+    int direction = info[1].As<Napi::Number>().Int32Value();
+    double thresholdDb = info.Length() > 2 && info[2].IsNumber() ? info[2].As<Napi::Number>().DoubleValue() : 10.0;
+
+    return Napi::Number::New(env, static_cast<double>(g_stats.findSignal(from, direction, thresholdDb)));
+}
+
+// ── getHealthReport() -> HealthReport | null ─────────────────────
+
+Napi::Value GetHealthReport(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+
+    HealthReport report;
+    if (!g_stats.healthReport(report)) return env.Null();
+
+    auto result = Napi::Object::New(env);
+    result.Set("complex", Napi::Boolean::New(env, report.complex));
+    result.Set("meanPowerDb", Napi::Number::New(env, report.meanPowerDb));
+    result.Set("peakPowerDb", Napi::Number::New(env, report.peakPowerDb));
+    result.Set("noiseFloorDb", Napi::Number::New(env, report.noiseFloorDb));
+    result.Set("dcOffsetI", Napi::Number::New(env, report.dcOffsetI));
+    result.Set("dcOffsetQ", Napi::Number::New(env, report.dcOffsetQ));
+    result.Set("dcOffsetDb", Napi::Number::New(env, report.dcOffsetDb));
+    result.Set("iqGainDb", Napi::Number::New(env, report.iqGainDb));
+    result.Set("iqPhaseDeg", Napi::Number::New(env, report.iqPhaseDeg));
+    result.Set("clippedSamples", Napi::Number::New(env, static_cast<double>(report.clippedSamples)));
+    result.Set("clippedFraction", Napi::Number::New(env, report.clippedFraction));
+
+    auto percentiles = Napi::Object::New(env);
+    percentiles.Set("p10", Napi::Number::New(env, report.p10Db));
+    percentiles.Set("p50", Napi::Number::New(env, report.p50Db));
+    percentiles.Set("p90", Napi::Number::New(env, report.p90Db));
+    percentiles.Set("p99", Napi::Number::New(env, report.p99Db));
+    result.Set("powerPercentilesDb", percentiles);
+    return result;
+}
+
+// ── getPerfStats() -> {detailed, tracing, stages: PerfStageStats[]} ──
+// Stage times are in microseconds except totalMs
+
+Napi::Value GetPerfStats(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+
+    auto stages = PerfStats::snapshot();
+    auto list = Napi::Array::New(env, stages.size());
+    for (size_t i = 0; i < stages.size(); i++) {
+        const auto& st = stages[i];
+        auto obj = Napi::Object::New(env);
+        obj.Set("stage", Napi::String::New(env, st.stage));
+        obj.Set("count", Napi::Number::New(env, static_cast<double>(st.count)));
+        obj.Set("totalMs", Napi::Number::New(env, st.totalNs / 1e6));
+        obj.Set("meanUs", Napi::Number::New(env, st.totalNs / 1e3 / st.count));
+        obj.Set("p50Us", Napi::Number::New(env, st.p50Ns / 1e3));
+        obj.Set("p90Us", Napi::Number::New(env, st.p90Ns / 1e3));
+        obj.Set("p99Us", Napi::Number::New(env, st.p99Ns / 1e3));
+        obj.Set("maxUs", Napi::Number::New(env, st.maxNs / 1e3));
+        obj.Set("bytes", Napi::Number::New(env, static_cast<double>(st.bytes)));
+        obj.Set("minorFaults", Napi::Number::New(env, static_cast<double>(st.minorFaults)));
+        obj.Set("majorFaults", Napi::Number::New(env, static_cast<double>(st.majorFaults)));
+        list.Set(static_cast<uint32_t>(i), obj);
+    }
+
+    auto pool = BufferPool::stats();
+    auto memory = Napi::Object::New(env);
+    memory.Set("limit", Napi::Number::New(env, static_cast<double>(pool.limit)));
+    memory.Set("inUse", Napi::Number::New(env, static_cast<double>(pool.inUse)));
+    memory.Set("pooled", Napi::Number::New(env, static_cast<double>(pool.pooled)));
+    memory.Set("peakInUse", Napi::Number::New(env, static_cast<double>(pool.peakInUse)));
+    memory.Set("peakTotal", Napi::Number::New(env, static_cast<double>(pool.peakTotal)));
+    memory.Set("hits", Napi::Number::New(env, static_cast<double>(pool.hits)));
+    memory.Set("misses", Napi::Number::New(env, static_cast<double>(pool.misses)));
+    memory.Set("trims", Napi::Number::New(env, static_cast<double>(pool.trims)));
+
+    auto reserved = MemoryBudget::stats();
+    auto budget = Napi::Object::New(env);
+    budget.Set("reserved", Napi::Number::New(env, static_cast<double>(reserved.reserved)));
+    budget.Set("cached", Napi::Number::New(env, static_cast<double>(reserved.cached)));
+    budget.Set("peakReserved", Napi::Number::New(env, static_cast<double>(reserved.peakReserved)));
+    budget.Set("queued", Napi::Number::New(env, static_cast<double>(reserved.queued)));
+    budget.Set("waits", Napi::Number::New(env, static_cast<double>(reserved.waits)));
+    budget.Set("degraded", Napi::Number::New(env, static_cast<double>(reserved.degraded)));
+    budget.Set("rejected", Napi::Number::New(env, static_cast<double>(reserved.rejected)));
+    memory.Set("budget", budget);
+
+    auto result = Napi::Object::New(env);
+    result.Set("detailed", Napi::Boolean::New(env, PerfStats::detailed()));
+    result.Set("tracing", Napi::Boolean::New(env, PerfStats::tracing()));
+    result.Set("stages", list);
+    result.Set("memory", memory);
+    return result;
+}
+
+// ── resetPerfStats() ──────────────────────────────────────────────
+
+Napi::Value ResetPerfStats(const Napi::CallbackInfo& info) {
+    PerfStats::reset();
+    BufferPool::resetStats();
+    MemoryBudget::resetStats();
+    return info.Env().Undefined();
+}
+
+// ── setPerfOptions({detailed?, tracing?, memoryLimit?}) ───────────
+// detailed adds per-line read/window/FFT/log timing; tracing keeps
+// events for dumpPerfTrace; memoryLimit is the native memory budget in
+// bytes (0 = unlimited): requests queue or take leaner paths to stay
+// within it, and the buffer pool never holds more
+
+Napi::Value SetPerfOptions(const Napi::CallbackInfo& info) {
+    auto opts = info[0].As<Napi::Object>();
+    if (opts.Has("detailed") && opts.Get("detailed").IsBoolean())
+        PerfStats::setDetailed(opts.Get("detailed").As<Napi::Boolean>().Value());
+    if (opts.Has("tracing") && opts.Get("tracing").IsBoolean())
+        PerfStats::setTracing(opts.Get("tracing").As<Napi::Boolean>().Value());
+    if (opts.Has("memoryLimit") && opts.Get("memoryLimit").IsNumber())
+        MemoryBudget::setLimit(static_cast<size_t>(opts.Get("memoryLimit").As<Napi::Number>().DoubleValue()));
+    return info.Env().Undefined();
+}
+
+// ── dumpPerfTrace(path) -> {events} ───────────────────────────────
+// Chrome trace-event JSON, viewable in Perfetto
+
+Napi::Value DumpPerfTrace(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    std::string path = info[0].As<Napi::String>().Utf8Value();
+
+    size_t events;
+    try {
+        events = PerfStats::writeTrace(path);
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto result = Napi::Object::New(env);
+    result.Set("events", Napi::Number::New(env, static_cast<double>(events)));
+    return result;
+}
+
+// ── Annotation index ──────────────────────────────────────────────
+// Annotations are {id, sampleStart, sampleCount, freqLowerEdge?,
+// freqUpperEdge?, label?, comment?}; ids stay valid until the next open
+
+static SigMFAnnotation annotationFromObject(const Napi::Object& obj) {
+    SigMFAnnotation a;
+    a.sampleStart = static_cast<size_t>(obj.Get("sampleStart").As<Napi::Number>().DoubleValue());
+    a.sampleCount = static_cast<size_t>(obj.Get("sampleCount").As<Napi::Number>().DoubleValue());
+    if (obj.Get("freqLowerEdge").IsNumber() && obj.Get("freqUpperEdge").IsNumber()) {
+        a.freqLowerEdge = obj.Get("freqLowerEdge").As<Napi::Number>().DoubleValue();
+        a.freqUpperEdge = obj.Get("freqUpperEdge").As<Napi::Number>().DoubleValue();
+    }
+    if (obj.Get("label").IsString()) a.label = obj.Get("label").As<Napi::String>().Utf8Value();
+    if (obj.Get("comment").IsString()) a.comment = obj.Get("comment").As<Napi::String>().Utf8Value();
+    return a;
+}
+
+static Napi::Object annotationToObject(Napi::Env env, AnnotationId id, const SigMFAnnotation& a) {
+    auto obj = Napi::Object::New(env);
+    obj.Set("id", Napi::Number::New(env, static_cast<double>(id)));
+    obj.Set("sampleStart", Napi::Number::New(env, static_cast<double>(a.sampleStart)));
+    obj.Set("sampleCount", Napi::Number::New(env, static_cast<double>(a.sampleCount)));
+    if (!std::isnan(a.freqLowerEdge) && !std::isnan(a.freqUpperEdge)) {
+        obj.Set("freqLowerEdge", Napi::Number::New(env, a.freqLowerEdge));
+        obj.Set("freqUpperEdge", Napi::Number::New(env, a.freqUpperEdge));
+    }
+    if (!a.label.empty()) obj.Set("label", Napi::String::New(env, a.label));
+    if (!a.comment.empty()) obj.Set("comment", Napi::String::New(env, a.comment));
+    return obj;
+}
+
+// queryAnnotations({sampleStart, sampleEnd, freqLow?, freqHigh?, limit?})
+//   -> {annotations, total, truncated}
+
+Napi::Value QueryAnnotations(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto opts = info[0].As<Napi::Object>();
+
+    AnnotationQuery query;
+    query.sampleStart = static_cast<size_t>(std::max(0.0, opts.Get("sampleStart").As<Napi::Number>().DoubleValue()));
+    query.sampleEnd = static_cast<size_t>(std::max(0.0, opts.Get("sampleEnd").As<Napi::Number>().DoubleValue()));
+    if (opts.Get("freqLow").IsNumber()) query.freqLow = opts.Get("freqLow").As<Napi::Number>().DoubleValue();
+    if (opts.Get("freqHigh").IsNumber()) query.freqHigh = opts.Get("freqHigh").As<Napi::Number>().DoubleValue();
+    if (opts.Get("limit").IsNumber()) query.limit = opts.Get("limit").As<Napi::Number>().Uint32Value();
+
+    auto found = g_source->annotations().query(query);
+
+    auto list = Napi::Array::New(env, found.annotations.size());
+    for (size_t i = 0; i < found.annotations.size(); i++) {
+        list.Set(static_cast<uint32_t>(i), annotationToObject(env, found.annotations[i].first, found.annotations[i].second));
+    }
+
+    auto result = Napi::Object::New(env);
+    result.Set("annotations", list);
+    result.Set("total", Napi::Number::New(env, static_cast<double>(g_source->annotations().size())));
+    result.Set("truncated", Napi::Boolean::New(env, found.truncated));
+    return result;
+}
+
+// ── getAnnotationPage({after?: {sampleStart, id}, count}) ────────
+//   -> {annotations, total, truncated}
+// Walks the whole index in (sampleStart, id) order; pass the last entry
+// of one page as after to get the next
+
+Napi::Value GetAnnotationPage(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto opts = info[0].As<Napi::Object>();
+
+    size_t count = opts.Get("count").IsNumber() ? opts.Get("count").As<Napi::Number>().Uint32Value() : 1000;
+    AnnotationCursor cursor{0, 0};
+    bool hasCursor = false;
+    if (opts.Get("after").IsObject()) {
+        auto after = opts.Get("after").As<Napi::Object>();
+        cursor.sampleStart = static_cast<size_t>(after.Get("sampleStart").As<Napi::Number>().DoubleValue());
+        cursor.id = static_cast<AnnotationId>(after.Get("id").As<Napi::Number>().DoubleValue());
+        hasCursor = true;
+    }
+
+    auto page = g_source->annotations().page(hasCursor ? &cursor : nullptr, count);
+
+    auto list = Napi::Array::New(env, page.annotations.size());
+    for (size_t i = 0; i < page.annotations.size(); i++) {
+        list.Set(static_cast<uint32_t>(i), annotationToObject(env, page.annotations[i].first, page.annotations[i].second));
+    }
+
+    auto result = Napi::Object::New(env);
+    result.Set("annotations", list);
+    result.Set("total", Napi::Number::New(env, static_cast<double>(g_source->annotations().size())));
+    result.Set("truncated", Napi::Boolean::New(env, page.truncated));
+    return result;
+}
+
+// ── addAnnotations(annotations) -> ids ───────────────────────────
+
+Napi::Value AddAnnotations(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto list = info[0].As<Napi::Array>();
+
+    auto ids = Napi::Array::New(env, list.Length());
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        AnnotationId id = g_source->annotations().add(annotationFromObject(list.Get(i).As<Napi::Object>()));
+        ids.Set(i, Napi::Number::New(env, static_cast<double>(id)));
+    }
+    return ids;
+}
+
+// ── updateAnnotation(id, annotation) -> bool ─────────────────────
+
+Napi::Value UpdateAnnotation(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto id = static_cast<AnnotationId>(info[0].As<Napi::Number>().DoubleValue());
+    bool ok = g_source->annotations().update(id, annotationFromObject(info[1].As<Napi::Object>()));
+    return Napi::Boolean::New(env, ok);
+}
+
+// ── removeAnnotation(id) -> bool ─────────────────────────────────
+
+Napi::Value RemoveAnnotation(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto id = static_cast<AnnotationId>(info[0].As<Napi::Number>().DoubleValue());
+    return Napi::Boolean::New(env, g_source->annotations().remove(id));
+}
+
 // ── readFileSamples(path, format, start, length) -> Float32Array ──
 // Reads samples from an arbitrary file without disturbing g_source
 
@@ -339,15 +1656,198 @@ Napi::Value ReadFileSamples(const Napi::CallbackInfo& info) {
     return result;
 }
 
+// ── startStream(config, callback) -> undefined ──────────────────
+// Live input from a FIFO, UNIX socket or stdin. The callback receives
+// {type: 'lines', lines, numLines, fftSize, firstSample} batches and a
+// final {type: 'end', error?}.
+
+// Batches queued for JS but not yet delivered. Past the limit new batches
+// are dropped (and counted) so a busy renderer cannot grow memory unbounded.
+static const int MAX_PENDING_BATCHES = 64;
+
+struct StreamEvent {
+    bool end = false;
+    std::vector<float> lines;
+    int numLines = 0;
+    uint64_t firstSample = 0;
+    std::string error;
+};
+
+static std::unique_ptr<StreamSource> g_stream;
+static Napi::ThreadSafeFunction g_streamCallback;
+static std::atomic<int> g_streamPending{0};
+
+static void deliverStreamEvent(Napi::Env env, Napi::Function callback, StreamEvent* event, int fftSize) {
+    std::unique_ptr<StreamEvent> owned(event);
+    g_streamPending--;
+    if (env == nullptr || callback == nullptr) return;
+
+    auto obj = Napi::Object::New(env);
+    if (owned->end) {
+        obj.Set("type", Napi::String::New(env, "end"));
+        if (!owned->error.empty()) {
+            obj.Set("error", Napi::String::New(env, owned->error));
+        }
+    } else {
+        auto lines = Napi::Float32Array::New(env, owned->lines.size());
+        std::memcpy(lines.Data(), owned->lines.data(), owned->lines.size() * sizeof(float));
+        obj.Set("type", Napi::String::New(env, "lines"));
+        obj.Set("lines", lines);
+        obj.Set("numLines", Napi::Number::New(env, owned->numLines));
+        obj.Set("fftSize", Napi::Number::New(env, fftSize));
+        obj.Set("firstSample", Napi::Number::New(env, static_cast<double>(owned->firstSample)));
+    }
+    callback.Call({obj});
+}
+
+static Napi::Object streamStatsToObject(Napi::Env env, const StreamStats& stats) {
+    auto result = Napi::Object::New(env);
+    result.Set("running", Napi::Boolean::New(env, stats.running));
+    result.Set("bytesIn", Napi::Number::New(env, static_cast<double>(stats.bytesIn)));
+    result.Set("samplesIn", Napi::Number::New(env, static_cast<double>(stats.samplesIn)));
+    result.Set("linesOut", Napi::Number::New(env, static_cast<double>(stats.linesOut)));
+    result.Set("overruns", Napi::Number::New(env, static_cast<double>(stats.overruns)));
+    result.Set("droppedBytes", Napi::Number::New(env, static_cast<double>(stats.droppedBytes)));
+    result.Set("linesDropped", Napi::Number::New(env, static_cast<double>(stats.linesDropped)));
+    if (!stats.error.empty()) {
+        result.Set("error", Napi::String::New(env, stats.error));
+    }
+    return result;
+}
+
+static StreamStats stopCurrentStream() {
+    StreamStats stats;
+    if (g_stream) {
+        g_stream->stop();
+        stats = g_stream->stats();
+        g_stream.reset();
+        // Already-queued batches are still delivered before the function is finalized
+        g_streamCallback.Release();
+    }
+    return stats;
+}
+
+Napi::Value StartStream(const Napi::CallbackInfo& info) {
+    auto env = info.Env();
+    auto config = info[0].As<Napi::Object>();
+    auto callback = info[1].As<Napi::Function>();
+
+    StreamConfig streamConfig;
+    streamConfig.path = config.Get("path").As<Napi::String>().Utf8Value();
+    if (config.Has("format") && config.Get("format").IsString())
+        streamConfig.format = config.Get("format").As<Napi::String>().Utf8Value();
+    if (config.Has("fftSize") && config.Get("fftSize").IsNumber())
+        streamConfig.fftSize = config.Get("fftSize").As<Napi::Number>().Int32Value();
+    streamConfig.stride = streamConfig.fftSize;
+    if (config.Has("stride") && config.Get("stride").IsNumber())
+        streamConfig.stride = config.Get("stride").As<Napi::Number>().Int32Value();
+    if (config.Has("ringSize") && config.Get("ringSize").IsNumber())
+        streamConfig.ringBytes = static_cast<size_t>(config.Get("ringSize").As<Napi::Number>().DoubleValue());
+    if (config.Has("linesPerBatch") && config.Get("linesPerBatch").IsNumber())
+        streamConfig.linesPerBatch = config.Get("linesPerBatch").As<Napi::Number>().Int32Value();
+
+    stopCurrentStream();
+
+    // Unbounded queue; backpressure is handled by g_streamPending instead,
+    // so the end event can never be refused
+    g_streamCallback = Napi::ThreadSafeFunction::New(env, callback, "snailStream", 0, 1);
+    g_streamPending = 0;
+    int fftSize = streamConfig.fftSize;
+
+    auto post = [fftSize](StreamEvent* event) {
+        g_streamPending++;
+        auto status = g_streamCallback.NonBlockingCall(event,
+            [fftSize](Napi::Env env, Napi::Function fn, StreamEvent* e) {
+                deliverStreamEvent(env, fn, e, fftSize);
+            });
+        if (status != napi_ok) {
+            g_streamPending--;
+            delete event;
+            return false;
+        }
+        return true;
+    };
+
+    auto onLines = [post](std::vector<float>&& lines, int numLines, uint64_t firstSample) {
+        if (g_streamPending >= MAX_PENDING_BATCHES) return false;
+        auto event = new StreamEvent();
+        event->lines = std::move(lines);
+        event->numLines = numLines;
+        event->firstSample = firstSample;
+        return post(event);
+    };
+
+    auto onEnd = [post](const std::string& error) {
+        auto event = new StreamEvent();
+        event->end = true;
+        event->error = error;
+        post(event);
+    };
+
+    try {
+        g_stream = std::make_unique<StreamSource>(streamConfig, onLines, onEnd);
+        g_stream->start();
+    } catch (const std::exception& e) {
+        g_stream.reset();
+        g_streamCallback.Release();
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    return env.Undefined();
+}
+
+// ── stopStream() -> StreamStats ──────────────────────────────────
+
+Napi::Value StopStream(const Napi::CallbackInfo& info) {
+    return streamStatsToObject(info.Env(), stopCurrentStream());
+}
+
+// ── getStreamStats() -> StreamStats ──────────────────────────────
+
+Napi::Value GetStreamStats(const Napi::CallbackInfo& info) {
+    StreamStats stats;
+    if (g_stream) stats = g_stream->stats();
+    return streamStatsToObject(info.Env(), stats);
+}
+
 // ── Module init ──────────────────────────────────────────────────
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports.Set("openFile", Napi::Function::New(env, OpenFile));
+    exports.Set("refreshFile", Napi::Function::New(env, RefreshFile));
     exports.Set("getSamples", Napi::Function::New(env, GetSamples));
     exports.Set("computeFFTTile", Napi::Function::New(env, ComputeFFTTile));
     exports.Set("exportSigMF", Napi::Function::New(env, ExportSigMF));
     exports.Set("correlate", Napi::Function::New(env, Correlate));
+    exports.Set("searchOfdm", Napi::Function::New(env, SearchOfdm));
+    exports.Set("computePSD", Napi::Function::New(env, ComputePSD));
+    exports.Set("computeCrossSpectrum", Napi::Function::New(env, ComputeCrossSpectrum));
+    exports.Set("detectBursts", Napi::Function::New(env, DetectBursts));
+    exports.Set("cancelDetection", Napi::Function::New(env, CancelDetection));
+    exports.Set("renderOverview", Napi::Function::New(env, RenderOverview));
+    exports.Set("cancelOverview", Napi::Function::New(env, CancelOverview));
+    exports.Set("findChirpSymbols", Napi::Function::New(env, FindChirpSymbols));
+    exports.Set("cancelChirpSearch", Napi::Function::New(env, CancelChirpSearch));
+    exports.Set("getStatsStatus", Napi::Function::New(env, GetStatsStatus));
+    exports.Set("getAutoRange", Napi::Function::New(env, GetAutoRange));
+    exports.Set("findSignal", Napi::Function::New(env, FindSignal));
+    exports.Set("searchSamples", Napi::Function::New(env, SearchSamples));
+    exports.Set("cancelSampleSearch", Napi::Function::New(env, CancelSampleSearch));
+    exports.Set("getHealthReport", Napi::Function::New(env, GetHealthReport));
+    exports.Set("getPerfStats", Napi::Function::New(env, GetPerfStats));
+    exports.Set("resetPerfStats", Napi::Function::New(env, ResetPerfStats));
+    exports.Set("setPerfOptions", Napi::Function::New(env, SetPerfOptions));
+    exports.Set("dumpPerfTrace", Napi::Function::New(env, DumpPerfTrace));
+    exports.Set("queryAnnotations", Napi::Function::New(env, QueryAnnotations));
+    exports.Set("getAnnotationPage", Napi::Function::New(env, GetAnnotationPage));
+    exports.Set("addAnnotations", Napi::Function::New(env, AddAnnotations));
+    exports.Set("updateAnnotation", Napi::Function::New(env, UpdateAnnotation));
+    exports.Set("removeAnnotation", Napi::Function::New(env, RemoveAnnotation));
     exports.Set("readFileSamples", Napi::Function::New(env, ReadFileSamples));
+    exports.Set("startStream", Napi::Function::New(env, StartStream));
+    exports.Set("stopStream", Napi::Function::New(env, StopStream));
+    exports.Set("getStreamStats", Napi::Function::New(env, GetStreamStats));
     return exports;
 }
 
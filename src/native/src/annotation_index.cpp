@@ -0,0 +1,137 @@
+#include "annotation_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+int AnnotationIndex::lengthClass(size_t sampleCount) {
+    int cls = 0;
+    while (cls < NUM_CLASSES - 1 && (sampleCount >> (cls + 1)) != 0) cls++;
+    return cls;
+}
+
+AnnotationId AnnotationIndex::add(const SigMFAnnotation& annotation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AnnotationId id = nextId_++;
+    int cls = lengthClass(annotation.sampleCount);
+    entries_.emplace(id, Entry{annotation, cls});
+    classes_[cls].emplace(annotation.sampleStart, id);
+    return id;
+}
+
+bool AnnotationIndex::remove(AnnotationId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return false;
+    classes_[it->second.lengthClass].erase({it->second.annotation.sampleStart, id});
+    entries_.erase(it);
+    return true;
+}
+
+bool AnnotationIndex::update(AnnotationId id, const SigMFAnnotation& annotation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return false;
+
+    Entry& entry = it->second;
+    int cls = lengthClass(annotation.sampleCount);
+    if (cls != entry.lengthClass || annotation.sampleStart != entry.annotation.sampleStart) {
+        classes_[entry.lengthClass].erase({entry.annotation.sampleStart, id});
+        classes_[cls].emplace(annotation.sampleStart, id);
+        entry.lengthClass = cls;
+    }
+    entry.annotation = annotation;
+    return true;
+}
+
+bool AnnotationIndex::get(AnnotationId id, SigMFAnnotation& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) return false;
+    out = it->second.annotation;
+    return true;
+}
+
+void AnnotationIndex::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    for (auto& cls : classes_) cls.clear();
+    nextId_ = 1;
+}
+
+size_t AnnotationIndex::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+template <typename Begin, typename Visit>
+void AnnotationIndex::merge(Begin begin, const Key& end, Visit visit) const {
+    using Iter = std::set<Key>::const_iterator;
+    struct Cursor {
+        Iter it;
+        Iter end;
+    };
+    auto later = [](const Cursor& a, const Cursor& b) { return *a.it > *b.it; };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(later)> heap(later);
+
+    for (int c = 0; c < NUM_CLASSES; c++) {
+        const auto& cls = classes_[c];
+        if (cls.empty()) continue;
+        Iter it = cls.lower_bound(begin(c));
+        Iter stop = cls.lower_bound(end);
+        if (it != stop) heap.push({it, stop});
+    }
+
+    while (!heap.empty()) {
+        Cursor cur = heap.top();
+        heap.pop();
+        if (!visit(cur.it->second, entries_.at(cur.it->second).annotation)) return;
+        if (++cur.it != cur.end) heap.push(cur);
+    }
+}
+
+AnnotationQueryResult AnnotationIndex::query(const AnnotationQuery& q) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AnnotationQueryResult result;
+    if (q.sampleStart >= q.sampleEnd) return result;
+
+    // Class c holds counts below 2^(c+1), so an overlapping annotation
+    // starts no earlier than sampleStart - (2^(c+1) - 1)
+    auto begin = [&](int c) {
+        size_t reach = c + 1 < NUM_CLASSES ? (size_t(1) << (c + 1)) - 1 : std::numeric_limits<size_t>::max();
+        return Key(q.sampleStart > reach ? q.sampleStart - reach : 0, 0);
+    };
+
+    // Classes merge in start order, so a limit keeps the earliest matches
+    merge(begin, Key(q.sampleEnd, 0), [&](AnnotationId id, const SigMFAnnotation& a) {
+        size_t annEnd = a.sampleStart + std::max<size_t>(a.sampleCount, 1);
+        // NaN edges mean the annotation spans every frequency
+        bool inFreq = std::isnan(a.freqLowerEdge) || std::isnan(a.freqUpperEdge) ||
+                      (a.freqUpperEdge >= q.freqLow && a.freqLowerEdge <= q.freqHigh);
+        if (annEnd <= q.sampleStart || !inFreq) return true;
+        if (q.limit && result.annotations.size() == q.limit) {
+            result.truncated = true;
+            return false;
+        }
+        result.annotations.emplace_back(id, a);
+        return true;
+    });
+    return result;
+}
+
+AnnotationQueryResult AnnotationIndex::page(const AnnotationCursor* after, size_t count) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AnnotationQueryResult result;
+
+    Key from = after ? Key(after->sampleStart, after->id + 1) : Key(0, 0);
+    Key end(std::numeric_limits<size_t>::max(), std::numeric_limits<AnnotationId>::max());
+    merge([&](int) { return from; }, end, [&](AnnotationId id, const SigMFAnnotation& a) {
+        if (result.annotations.size() == count) {
+            result.truncated = true;
+            return false;
+        }
+        result.annotations.emplace_back(id, a);
+        return true;
+    });
+    return result;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "sigmf_parser.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using AnnotationId = uint64_t;
+
+// Time-frequency box to search. Frequencies use the annotations' own units.
+struct AnnotationQuery {
+    size_t sampleStart = 0;
+    size_t sampleEnd = std::numeric_limits<size_t>::max();  // exclusive
+    double freqLow = -std::numeric_limits<double>::infinity();
+    double freqHigh = std::numeric_limits<double>::infinity();
+    size_t limit = 0;  // 0 = no limit
+};
+
+struct AnnotationQueryResult {
+    std::vector<std::pair<AnnotationId, SigMFAnnotation>> annotations;  // by sampleStart
+    bool truncated = false;  // more matches beyond limit
+};
+
+// Position in (sampleStart, id) order, for walking the whole index in pages
+struct AnnotationCursor {
+    size_t sampleStart;
+    AnnotationId id;
+};
+
+// Annotations indexed for viewport queries. Each annotation lands in the
+// length class of its sample count (powers of two); within a class the
+// entries are ordered by start, so anything overlapping a time range
+// starts at most one class length before it. A query is a lower_bound
+// per class plus the matches, and add/remove/update are O(log n).
+class AnnotationIndex {
+public:
+    AnnotationId add(const SigMFAnnotation& annotation);
+    bool remove(AnnotationId id);
+    bool update(AnnotationId id, const SigMFAnnotation& annotation);
+    bool get(AnnotationId id, SigMFAnnotation& out) const;
+    void clear();
+    size_t size() const;
+
+    AnnotationQueryResult query(const AnnotationQuery& query) const;
+
+    // Up to count annotations following after in (sampleStart, id) order,
+    // from the start when after is null; truncated means more remain
+    AnnotationQueryResult page(const AnnotationCursor* after, size_t count) const;
+
+private:
+    using Key = std::pair<size_t, AnnotationId>;  // (sampleStart, id)
+
+    static const int NUM_CLASSES = 64;
+    static int lengthClass(size_t sampleCount);
+
+    // Visit entries from begin(class) up to end across all classes in key
+    // order until visit returns false. Caller holds mutex_.
+    template <typename Begin, typename Visit>
+    void merge(Begin begin, const Key& end, Visit visit) const;
+
+    struct Entry {
+        SigMFAnnotation annotation;
+        int lengthClass;
+    };
+
+    std::unordered_map<AnnotationId, Entry> entries_;
+    std::set<Key> classes_[NUM_CLASSES];
+    AnnotationId nextId_ = 1;
+    mutable std::mutex mutex_;
+};
@@ -0,0 +1,400 @@
+#include "async_read_backend.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef SNAIL_HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+using Pending = AsyncReadBackend::Pending;
+using Completion = std::function<void(const std::shared_ptr<Pending>&)>;
+
+// ── pread thread pool ─────────────────────────────────────────────
+
+namespace {
+
+class PreadEngine : public AsyncReadBackend::IoEngine {
+public:
+    PreadEngine(int fd, unsigned threads, Completion done) : fd_(fd), done_(std::move(done)) {
+        for (unsigned i = 0; i < threads; i++) {
+            workers_.emplace_back(&PreadEngine::run, this);
+        }
+    }
+
+    ~PreadEngine() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    const char* name() const override { return "pread"; }
+
+    void submit(const std::vector<std::shared_ptr<Pending>>& batch) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.insert(queue_.end(), batch.begin(), batch.end());
+        }
+        cv_.notify_all();
+    }
+
+private:
+    void run() {
+        for (;;) {
+            std::shared_ptr<Pending> p;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+                // Drain outstanding reads before exiting so no reader is left waiting
+                if (queue_.empty()) return;
+                p = std::move(queue_.front());
+                queue_.pop_front();
+            }
+
+            while (p->filled < p->length) {
+                ssize_t n = pread(fd_, p->data->data() + p->filled,
+                                  p->length - p->filled, p->offset + p->filled);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    p->error = errno;
+                    break;
+                }
+                if (n == 0) {
+                    p->error = -1;
+                    break;
+                }
+                p->filled += static_cast<size_t>(n);
+            }
+            done_(p);
+        }
+    }
+
+    int fd_;
+    Completion done_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::shared_ptr<Pending>> queue_;
+    bool stop_ = false;
+};
+
+// ── io_uring ──────────────────────────────────────────────────────
+
+#ifdef SNAIL_HAVE_LIBURING
+
+class UringEngine : public AsyncReadBackend::IoEngine {
+public:
+    UringEngine(int fd, unsigned depth, Completion done)
+        : fd_(fd), depth_(depth), done_(std::move(done)) {
+        int ret = io_uring_queue_init(depth_, &ring_, 0);
+        if (ret < 0) {
+            throw std::runtime_error(std::string("io_uring_queue_init: ") + std::strerror(-ret));
+        }
+        reaper_ = std::thread(&UringEngine::reap, this);
+    }
+
+    ~UringEngine() override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        slotFree_.wait(lock, [this] { return inflight_ == 0; });
+
+        // A NOP with null user data tells the reaper to exit; a reaper that
+        // already stopped on a ring error needs no telling
+        if (!dead_) {
+            io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+            io_uring_prep_nop(sqe);
+            io_uring_sqe_set_data(sqe, nullptr);
+            io_uring_submit(&ring_);
+        }
+        lock.unlock();
+
+        reaper_.join();
+        io_uring_queue_exit(&ring_);
+    }
+
+    const char* name() const override { return "io_uring"; }
+
+    void submit(const std::vector<std::shared_ptr<Pending>>& batch) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < batch.size(); i++) {
+            while (!dead_ && inflight_ >= depth_) {
+                io_uring_submit(&ring_);
+                slotFree_.wait(lock);
+            }
+            if (dead_) {
+                // The reaper is gone; nothing submitted now would complete
+                lock.unlock();
+                for (; i < batch.size(); i++) {
+                    batch[i]->error = EIO;
+                    done_(batch[i]);
+                }
+                return;
+            }
+            inflight_++;
+            enqueue(batch[i]);
+        }
+        // One syscall for the whole batch
+        io_uring_submit(&ring_);
+    }
+
+private:
+    // Caller holds mutex_ and has reserved a queue slot
+    void enqueue(const std::shared_ptr<Pending>& p) {
+        io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+        io_uring_prep_read(sqe, fd_, p->data->data() + p->filled,
+                           static_cast<unsigned>(p->length - p->filled),
+                           p->offset + p->filled);
+        io_uring_sqe_set_data(sqe, p.get());
+        outstanding_[p.get()] = p;
+    }
+
+    // Fails every read still in flight and stops taking new ones, so no
+    // reader and no destructor waits on completions that will never come
+    void stop(int error) {
+        std::unordered_map<Pending*, std::shared_ptr<Pending>> orphans;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            dead_ = true;
+            orphans.swap(outstanding_);
+            inflight_ = 0;
+        }
+        slotFree_.notify_all();
+        for (auto& entry : orphans) {
+            entry.second->error = error;
+            done_(entry.second);
+        }
+    }
+
+    void reap() {
+        for (;;) {
+            io_uring_cqe* cqe = nullptr;
+            int ret = io_uring_wait_cqe(&ring_, &cqe);
+            if (ret == -EINTR) continue;
+            if (ret < 0) {
+                stop(-ret);
+                return;
+            }
+
+            auto* key = static_cast<Pending*>(io_uring_cqe_get_data(cqe));
+            int res = cqe->res;
+            io_uring_cqe_seen(&ring_, cqe);
+            if (!key) {
+                // Shutdown NOP; the destructor waited for inflight_ to drain,
+                // but fail anything left rather than strand it
+                stop(ECANCELED);
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto it = outstanding_.find(key);
+            if (it == outstanding_.end()) continue;
+            std::shared_ptr<Pending> p = std::move(it->second);
+            outstanding_.erase(it);
+
+            bool retry = false;
+            if (res == -EINTR || res == -EAGAIN) {
+                retry = true;
+            } else if (res < 0) {
+                p->error = -res;
+            } else if (res == 0) {
+                p->error = -1;
+            } else {
+                p->filled += static_cast<size_t>(res);
+                retry = p->filled < p->length;
+            }
+
+            if (retry) {
+                // Short read: reuse the slot for the remainder
+                enqueue(p);
+                io_uring_submit(&ring_);
+                continue;
+            }
+            inflight_--;
+            lock.unlock();
+            slotFree_.notify_all();
+            done_(p);
+        }
+    }
+
+    int fd_;
+    unsigned depth_;
+    Completion done_;
+    io_uring ring_;
+    std::thread reaper_;
+    std::mutex mutex_;
+    std::condition_variable slotFree_;
+    unsigned inflight_ = 0;
+    // Reads the kernel holds, by the user data of their SQE
+    std::unordered_map<Pending*, std::shared_ptr<Pending>> outstanding_;
+    bool dead_ = false;
+};
+
+#endif // SNAIL_HAVE_LIBURING
+
+} // namespace
+
+// ── AsyncReadBackend ──────────────────────────────────────────────
+
+AsyncReadBackend::AsyncReadBackend(const std::string& path, const BackendOptions& options)
+    : blockSize_(std::max<size_t>(options.blockSize, 4096)),
+      path_(path),
+      cache_(options.cacheBytes) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) < 0) {
+        ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error("Failed to stat file: " + path);
+    }
+    size_.store(st.st_size);
+
+    unsigned depth = std::max(1u, options.queueDepth);
+    Completion done = [this](const std::shared_ptr<Pending>& p) { complete(p); };
+
+#ifdef SNAIL_HAVE_LIBURING
+    try {
+        engine_ = std::make_unique<UringEngine>(fd_, depth, done);
+    } catch (const std::exception&) {
+        // io_uring unavailable (old kernel, seccomp); use the thread pool
+    }
+#endif
+    if (!engine_) {
+        engine_ = std::make_unique<PreadEngine>(fd_, std::min(depth, 16u), done);
+    }
+}
+
+AsyncReadBackend::~AsyncReadBackend() {
+    engine_.reset();
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+const char* AsyncReadBackend::name() const {
+    return engine_->name();
+}
+
+std::vector<std::shared_ptr<Pending>> AsyncReadBackend::request(size_t first, size_t last) const {
+    std::vector<std::shared_ptr<Pending>> slots(last - first + 1);
+    std::vector<std::shared_ptr<Pending>> batch;
+    size_t total = size();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t b = first; b <= last; b++) {
+            auto& slot = slots[b - first];
+            if (auto block = cache_.get(b)) {
+                // Wrap cached blocks as already-completed reads
+                slot = std::make_shared<Pending>();
+                slot->done = true;
+                slot->data = std::const_pointer_cast<std::vector<uint8_t>>(block);
+                continue;
+            }
+            auto it = inflight_.find(b);
+            if (it != inflight_.end()) {
+                slot = it->second;
+                continue;
+            }
+            slot = std::make_shared<Pending>();
+            slot->index = b;
+            slot->offset = b * blockSize_;
+            slot->length = std::min(blockSize_, total - slot->offset);
+            slot->data = std::make_shared<std::vector<uint8_t>>(slot->length);
+            inflight_[b] = slot;
+            batch.push_back(slot);
+        }
+    }
+    if (!batch.empty()) {
+        engine_->submit(batch);
+    }
+    return slots;
+}
+
+void AsyncReadBackend::complete(const std::shared_ptr<Pending>& p) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        p->done = true;
+        // A short tail block is only worth caching while it still ends at EOF
+        bool stale = p->length < blockSize_ && p->offset + p->length < size();
+        if (p->error == 0 && !stale) {
+            cache_.put(p->index, p->data);
+        }
+        // Failed blocks leave the in-flight table so a later read retries them
+        auto it = inflight_.find(p->index);
+        if (it != inflight_.end() && it->second == p) {
+            inflight_.erase(it);
+        }
+    }
+    cv_.notify_all();
+}
+
+void AsyncReadBackend::read(size_t offset, size_t length, void* dest) const {
+    if (length == 0) return;
+    if (offset + length > size()) {
+        throw std::runtime_error("Read beyond end of file");
+    }
+
+    size_t first = offset / blockSize_;
+    size_t last = (offset + length - 1) / blockSize_;
+
+    // Submit every missing block before waiting on any of them
+    auto slots = request(first, last);
+
+    auto out = static_cast<uint8_t*>(dest);
+    for (size_t b = first; b <= last; b++) {
+        auto& p = slots[b - first];
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] { return p->done; });
+        }
+        if (p->error != 0) {
+            std::string reason = p->error > 0 ? std::strerror(p->error) : "unexpected end of file";
+            throw std::runtime_error("Read failed at offset " + std::to_string(p->offset) +
+                                     " of " + path_ + ": " + reason);
+        }
+
+        size_t blockStart = b * blockSize_;
+        size_t from = std::max(offset, blockStart);
+        size_t to = std::min(offset + length, blockStart + p->data->size());
+        std::memcpy(out + (from - offset), p->data->data() + (from - blockStart), to - from);
+    }
+}
+
+void AsyncReadBackend::prefetch(size_t offset, size_t length) const {
+    size_t total = size();
+    if (length == 0 || offset >= total) return;
+    length = std::min(length, total - offset);
+    request(offset / blockSize_, (offset + length - 1) / blockSize_);
+}
+
+size_t AsyncReadBackend::refresh() {
+    struct stat st;
+    size_t oldSize = size();
+    if (fstat(fd_, &st) < 0 || static_cast<size_t>(st.st_size) <= oldSize) {
+        return oldSize;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_.store(st.st_size, std::memory_order_release);
+    // The old tail block was read short; drop it (cached or still in flight)
+    // so later reads fetch it again in full
+    if (oldSize % blockSize_ != 0) {
+        cache_.erase(oldSize / blockSize_);
+        inflight_.erase(oldSize / blockSize_);
+    }
+    return st.st_size;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "data_backend.h"
+#include "block_cache.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Reads the data file in fixed-size blocks through an asynchronous I/O
+// engine (io_uring when available, otherwise a pread thread pool) into an
+// LRU block cache. I/O errors and vanished servers become exceptions on
+// the reading thread instead of SIGBUS.
+class AsyncReadBackend : public DataBackend {
+public:
+    AsyncReadBackend(const std::string& path, const BackendOptions& options);
+    ~AsyncReadBackend() override;
+
+    const char* name() const override;
+    size_t size() const override { return size_.load(std::memory_order_acquire); }
+    void read(size_t offset, size_t length, void* dest) const override;
+    void prefetch(size_t offset, size_t length) const override;
+    size_t refresh() override;
+
+    // A single block read, shared between the engine and waiting readers
+    struct Pending {
+        size_t index = 0;
+        size_t offset = 0;
+        size_t length = 0;
+        size_t filled = 0;
+        int error = 0;  // errno, or -1 for unexpected end of file
+        bool done = false;
+        std::shared_ptr<std::vector<uint8_t>> data;
+    };
+
+    // Submits block reads and reports each completion through a callback
+    class IoEngine {
+    public:
+        virtual ~IoEngine() = default;
+        virtual const char* name() const = 0;
+        virtual void submit(const std::vector<std::shared_ptr<Pending>>& batch) = 0;
+    };
+
+private:
+    // Issue reads for every uncached, not-yet-requested block in [first, last]
+    // and return the pending entries the caller must wait for
+    std::vector<std::shared_ptr<Pending>> request(size_t first, size_t last) const;
+    void complete(const std::shared_ptr<Pending>& pending) const;
+
+    int fd_ = -1;
+    std::atomic<size_t> size_{0};
+    size_t blockSize_;
+    std::string path_;
+    std::unique_ptr<IoEngine> engine_;
+
+    mutable BlockCache cache_;
+    mutable std::mutex mutex_;
+    mutable std::condition_variable cv_;
+    mutable std::unordered_map<size_t, std::shared_ptr<Pending>> inflight_;
+};
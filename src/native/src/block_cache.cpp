@@ -0,0 +1,74 @@
+#include "block_cache.h"
+
+BlockCache::BlockCache(size_t capacityBytes)
+    : reservation_(MemoryBudget::reserveCache(capacityBytes)),
+      capacity_(reservation_.bytes()) {
+    if (capacity_ < capacityBytes) MemoryBudget::noteDegraded();
+}
+
+BlockCache::Block BlockCache::get(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = map_.find(index);
+    if (it == map_.end()) {
+        misses_++;
+        return nullptr;
+    }
+    hits_++;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+}
+
+void BlockCache::put(size_t index, Block block) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = map_.find(index);
+    if (it != map_.end()) {
+        bytes_ -= it->second->second->size();
+        lru_.erase(it->second);
+        map_.erase(it);
+    }
+    bytes_ += block->size();
+    lru_.emplace_front(index, std::move(block));
+    map_[index] = lru_.begin();
+    evictIfNeeded();
+}
+
+void BlockCache::evictIfNeeded() {
+    // Always keep the newest block, even if it alone exceeds the budget
+    while (bytes_ > capacity_ && lru_.size() > 1) {
+        auto& oldest = lru_.back();
+        bytes_ -= oldest.second->size();
+        map_.erase(oldest.first);
+        lru_.pop_back();
+    }
+}
+
+void BlockCache::erase(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = map_.find(index);
+    if (it == map_.end()) return;
+    bytes_ -= it->second->second->size();
+    lru_.erase(it->second);
+    map_.erase(it);
+}
+
+void BlockCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    map_.clear();
+    bytes_ = 0;
+}
+
+size_t BlockCache::bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+size_t BlockCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t BlockCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "memory_budget.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Thread-safe LRU cache of file blocks keyed by block index.
+// Blocks are shared, so a reader keeps its block alive after eviction.
+// The capacity is reserved from MemoryBudget for the cache's lifetime, and
+// shrinks to whatever is left of the caches' share of the budget when it
+// opens.
+class BlockCache {
+public:
+    using Block = std::shared_ptr<const std::vector<uint8_t>>;
+
+    explicit BlockCache(size_t capacityBytes);
+
+    // Returns nullptr on miss
+    Block get(size_t index);
+    void put(size_t index, Block block);
+    void erase(size_t index);
+    void clear();
+
+    size_t capacity() const { return capacity_; }
+    size_t bytes() const;
+    size_t hits() const;
+    size_t misses() const;
+
+private:
+    using Entry = std::pair<size_t, Block>;
+
+    void evictIfNeeded();
+
+    MemoryReservation reservation_;
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_;  // front = most recently used
+    std::unordered_map<size_t, std::list<Entry>::iterator> map_;
+    size_t capacity_;
+    size_t bytes_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
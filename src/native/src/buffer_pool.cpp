@@ -0,0 +1,267 @@
+#include "buffer_pool.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Cache line, and enough for any SIMD width FFTW uses
+const size_t ALIGNMENT = 64;
+// Size classes 2^12 (4 KiB) to 2^26 (64 MiB); larger buffers are unpooled
+const int MIN_CLASS_BITS = 12;
+const int MAX_CLASS_BITS = 26;
+const int CLASSES = MAX_CLASS_BITS - MIN_CLASS_BITS + 1;
+// Buffers each thread keeps per size class, and in bytes overall
+const size_t THREAD_BUFFERS_PER_CLASS = 4;
+const size_t THREAD_CACHE_BYTES = size_t(32) << 20;
+// Bytes the shared pool keeps
+const size_t SHARED_POOL_BYTES = size_t(256) << 20;
+
+// Size class index, or -1 for an unpooled size
+int sizeClass(size_t bytes) {
+    int bits = MIN_CLASS_BITS;
+    while (bits <= MAX_CLASS_BITS && (size_t(1) << bits) < bytes) bits++;
+    return bits <= MAX_CLASS_BITS ? bits - MIN_CLASS_BITS : -1;
+}
+
+size_t classBytes(int cls) {
+    return size_t(1) << (cls + MIN_CLASS_BITS);
+}
+
+size_t allocationBytes(size_t bytes) {
+    int cls = sizeClass(bytes);
+    return cls >= 0 ? classBytes(cls) : bytes;
+}
+
+// malloc with the original pointer stored just below the aligned block
+void* alignedAlloc(size_t bytes) {
+    void* raw = std::malloc(bytes + ALIGNMENT + sizeof(void*));
+    if (!raw) return nullptr;
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + sizeof(void*) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void alignedFree(void* data) {
+    std::free(static_cast<void**>(data)[-1]);
+}
+
+std::atomic<size_t> g_limit{0};
+std::atomic<size_t> g_inUse{0};
+std::atomic<size_t> g_pooled{0};
+std::atomic<size_t> g_peakInUse{0};
+std::atomic<size_t> g_peakTotal{0};
+std::atomic<uint64_t> g_hits{0};
+std::atomic<uint64_t> g_misses{0};
+std::atomic<uint64_t> g_trims{0};
+
+void raisePeak(std::atomic<size_t>& peak, size_t value) {
+    size_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+void notePeaks() {
+    size_t inUse = g_inUse.load(std::memory_order_relaxed);
+    raisePeak(g_peakInUse, inUse);
+    raisePeak(g_peakTotal, inUse + g_pooled.load(std::memory_order_relaxed));
+}
+
+struct FreeLists {
+    std::array<std::vector<void*>, CLASSES> lists;
+    size_t bytes = 0;
+
+    void* pop(int cls) {
+        auto& list = lists[cls];
+        if (list.empty()) return nullptr;
+        void* data = list.back();
+        list.pop_back();
+        bytes -= classBytes(cls);
+        return data;
+    }
+
+    void push(int cls, void* data) {
+        lists[cls].push_back(data);
+        bytes += classBytes(cls);
+    }
+
+    // Free the largest buffers first until at most target bytes remain
+    void trimTo(size_t target) {
+        for (int cls = CLASSES - 1; cls >= 0 && bytes > target; cls--) {
+            auto& list = lists[cls];
+            while (!list.empty() && bytes > target) {
+                alignedFree(list.back());
+                list.pop_back();
+                bytes -= classBytes(cls);
+                g_pooled -= classBytes(cls);
+                g_trims++;
+            }
+        }
+    }
+};
+
+struct SharedPool {
+    std::mutex mutex;
+    FreeLists free;
+};
+
+// Never destroyed: thread caches drain into it as their threads exit
+SharedPool& shared() {
+    static SharedPool* pool = new SharedPool;
+    return *pool;
+}
+
+// Keep a buffer in the shared pool if there is room, else free it
+void giveToShared(int cls, void* data) {
+    auto& pool = shared();
+    {
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (pool.free.bytes + classBytes(cls) <= SHARED_POOL_BYTES) {
+            pool.free.push(cls, data);
+            g_pooled += classBytes(cls);
+            return;
+        }
+    }
+    alignedFree(data);
+}
+
+struct ThreadCache {
+    FreeLists free;
+
+    ~ThreadCache() {
+        for (int cls = 0; cls < CLASSES; cls++) {
+            while (void* data = free.pop(cls)) {
+                g_pooled -= classBytes(cls);
+                giveToShared(cls, data);
+            }
+        }
+    }
+};
+
+thread_local ThreadCache t_cache;
+
+// Count size bytes as in use, freeing pooled buffers if that goes over
+// the limit; throws if it still does
+void reserve(size_t size) {
+    size_t inUse = g_inUse.fetch_add(size) + size;
+    size_t limit = g_limit.load(std::memory_order_relaxed);
+    if (!limit || inUse + g_pooled.load() <= limit) return;
+
+    auto room = [&]() { return limit > inUse ? limit - inUse : 0; };
+    {
+        auto& pool = shared();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        size_t others = g_pooled.load() - pool.free.bytes;
+        pool.free.trimTo(room() > others ? room() - others : 0);
+    }
+    if (inUse + g_pooled.load() > limit) {
+        size_t others = g_pooled.load() - t_cache.free.bytes;
+        t_cache.free.trimTo(room() > others ? room() - others : 0);
+    }
+    if (inUse + g_pooled.load() > limit) {
+        g_inUse -= size;
+        throw std::runtime_error("Native memory limit of " + std::to_string(limit >> 20) + " MiB reached");
+    }
+}
+
+} // namespace
+
+void* BufferPool::acquire(size_t bytes) {
+    const size_t size = allocationBytes(bytes);
+    const int cls = sizeClass(bytes);
+
+    void* data = nullptr;
+    if (cls >= 0) {
+        data = t_cache.free.pop(cls);
+        if (!data) {
+            auto& pool = shared();
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            data = pool.free.pop(cls);
+        }
+    }
+    if (data) {
+        // Moves from pooled to in use; the total is unchanged
+        g_pooled -= size;
+        g_inUse += size;
+        g_hits++;
+        notePeaks();
+        return data;
+    }
+
+    reserve(size);
+    data = alignedAlloc(size);
+    if (!data) {
+        g_inUse -= size;
+        throw std::runtime_error("Out of memory allocating " + std::to_string(size) + " bytes");
+    }
+    g_misses++;
+    notePeaks();
+    return data;
+}
+
+void BufferPool::release(void* data, size_t bytes) {
+    if (!data) return;
+    const size_t size = allocationBytes(bytes);
+    const int cls = sizeClass(bytes);
+    g_inUse -= size;
+
+    if (cls < 0) {
+        alignedFree(data);
+        return;
+    }
+    if (t_cache.free.lists[cls].size() < THREAD_BUFFERS_PER_CLASS &&
+        t_cache.free.bytes + size <= THREAD_CACHE_BYTES) {
+        t_cache.free.push(cls, data);
+        g_pooled += size;
+        return;
+    }
+    giveToShared(cls, data);
+}
+
+void BufferPool::setLimit(size_t bytes) {
+    g_limit = bytes;
+    if (!bytes) return;
+    // Give back pooled memory above the new limit right away
+    size_t inUse = g_inUse.load();
+    size_t room = bytes > inUse ? bytes - inUse : 0;
+    auto& pool = shared();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    size_t others = g_pooled.load() - pool.free.bytes;
+    pool.free.trimTo(room > others ? room - others : 0);
+}
+
+BufferPoolStats BufferPool::stats() {
+    BufferPoolStats s;
+    s.limit = g_limit.load();
+    s.inUse = g_inUse.load();
+    s.pooled = g_pooled.load();
+    s.peakInUse = g_peakInUse.load();
+    s.peakTotal = g_peakTotal.load();
+    s.hits = g_hits.load();
+    s.misses = g_misses.load();
+    s.trims = g_trims.load();
+    return s;
+}
+
+void BufferPool::resetStats() {
+    size_t inUse = g_inUse.load();
+    g_peakInUse = inUse;
+    g_peakTotal = inUse + g_pooled.load();
+    g_hits = 0;
+    g_misses = 0;
+    g_trims = 0;
+}
+
+void BufferPool::trim() {
+    {
+        auto& pool = shared();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        pool.free.trimTo(0);
+    }
+    t_cache.free.trimTo(0);
+}
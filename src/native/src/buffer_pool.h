@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+struct BufferPoolStats {
+    size_t limit = 0;        // bytes, 0 = unlimited
+    size_t inUse = 0;        // bytes handed out
+    size_t pooled = 0;       // bytes held for reuse
+    size_t peakInUse = 0;
+    size_t peakTotal = 0;    // in use + pooled
+    uint64_t hits = 0;       // acquires served from a pool
+    uint64_t misses = 0;     // acquires that allocated
+    uint64_t trims = 0;      // pooled buffers freed to stay under the limit
+};
+
+// Process-wide pool of SIMD-aligned scratch buffers (FFTW alignment), so
+// per-request buffers reuse memory that is already mapped instead of
+// churning the allocator and faulting in fresh pages.
+//
+// Sizes round up to a power of two of at least 4 KiB. Each thread keeps a
+// few buffers per size class with no locking; releases beyond that, and
+// the caches of threads that exit, go to a shared pool, so the short-lived
+// workers of parallelFor still find warm memory. Buffers above 64 MiB are
+// allocated and freed directly but still count as in use.
+//
+// The limit caps in-use plus pooled bytes for the whole module. Pooled
+// buffers are freed first to make room; an acquire that would still go
+// over throws std::runtime_error.
+class BufferPool {
+public:
+    static void* acquire(size_t bytes);
+    static void release(void* data, size_t bytes);
+
+    static void setLimit(size_t bytes);
+    static BufferPoolStats stats();
+    // Peaks restart from the current usage; hit and trim counts from zero
+    static void resetStats();
+    // Frees the shared pool and this thread's cache
+    static void trim();
+};
+
+// Move-only handle on count uninitialized elements of T from BufferPool
+template <typename T>
+class PooledBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "PooledBuffer holds raw memory");
+
+public:
+    PooledBuffer() = default;
+    explicit PooledBuffer(size_t count)
+        : data_(count ? static_cast<T*>(BufferPool::acquire(count * sizeof(T))) : nullptr),
+          size_(count) {}
+    ~PooledBuffer() { reset(); }
+
+    PooledBuffer(PooledBuffer&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept {
+        if (this != &other) {
+            reset();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    void reset() {
+        if (data_) BufferPool::release(data_, size_ * sizeof(T));
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
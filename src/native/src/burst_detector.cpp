@@ -0,0 +1,298 @@
+#include "burst_detector.h"
+#include "fft_engine.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+// Frames per parallel work item
+static const size_t CHUNK_FRAMES = 8192;
+// Frames read from the source per call
+static const size_t READ_FRAMES = 64;
+// Frames before a chunk used to seed its noise floor (median per band)
+static const size_t WARMUP_FRAMES = 32;
+// Noise floor tracking: follow drops quickly, rises slowly
+static const float FLOOR_FALL = 0.1f;
+static const float FLOOR_RISE = 0.01f;
+// While a band is active the floor moves toward the minimum power the band
+// showed over the last MIN_WINDOW_FRAMES frames, at this much slower rate
+static const float FLOOR_RISE_ACTIVE = 0.001f;
+static const size_t MIN_WINDOW_FRAMES = 256;
+// A band is part of a burst's reported extent when active in at least this
+// fraction of its frames, so on/off transients do not widen every box
+static const double BAND_OCCUPANCY = 0.2;
+
+namespace {
+
+struct OpenBurst {
+    size_t startFrame;
+    size_t lastFrame;   // last frame with an active band
+    int bandLow;
+    int bandHigh;
+    float peak;         // linear power ratio to the floor
+    std::vector<uint32_t> hits;  // active frames per band
+};
+
+// Scans one chunk; frames are indices relative to config.start
+class ChunkScanner {
+public:
+    ChunkScanner(const InputSource& source, const BurstConfig& config, size_t totalFrames)
+        : source_(source), config_(config), totalFrames_(totalFrames),
+          n_(config.fftSize), bands_(config.bands), fft_(config.fftSize),
+          samples_(READ_FRAMES * n_), power_(n_),
+          floor_(bands_), active_(bands_, false), bandPower_(bands_),
+          windowMin_(bands_), recentMin_(bands_) {
+        onRatio_ = static_cast<float>(std::pow(10.0, config.thresholdDb / 10.0));
+        offRatio_ = static_cast<float>(std::pow(10.0, (config.thresholdDb - config.hysteresisDb) / 10.0));
+    }
+
+    void scan(size_t chunkFirst, size_t chunkLast, std::vector<Burst>& out,
+              const std::atomic<bool>& cancel) {
+        // Seed the floor from the warmup frames (the chunk's own first frames at the start of the range)
+        size_t warmFirst = chunkFirst >= WARMUP_FRAMES ? chunkFirst - WARMUP_FRAMES : 0;
+        size_t warmLast = std::min(totalFrames_, warmFirst + WARMUP_FRAMES);
+        seedFloor(warmFirst, warmLast);
+
+        // Detection starts at the warmup so bursts already running when the chunk
+        // begins are recognised (and left to the chunk that owns their start)
+        open_.clear();
+        std::fill(active_.begin(), active_.end(), false);
+        recentMin_ = floor_;
+        std::fill(windowMin_.begin(), windowMin_.end(), INFINITY);
+        windowFrames_ = 0;
+        size_t frame = std::min(warmFirst, chunkFirst);
+        while (frame < totalFrames_ && !cancel) {
+            // Past the chunk only bursts this chunk owns are followed to their end
+            if (frame >= chunkLast && !ownsOpenBurst(chunkFirst)) break;
+
+            size_t count = std::min(READ_FRAMES, totalFrames_ - frame);
+            source_.getSamples(config_.start + frame * n_, count * n_, samples_.data(), config_.channel);
+            for (size_t i = 0; i < count; i++, frame++) {
+                processFrame(frame, samples_.data() + i * n_, chunkFirst, chunkLast, out);
+            }
+        }
+        // Close whatever is still open at the end of the range
+        for (auto& b : open_) emit(b, chunkFirst, out);
+        open_.clear();
+    }
+
+private:
+    void computeBands(const std::complex<float>* frame) {
+        fft_.computeLinearPower(frame, power_.data());
+        for (int b = 0; b < bands_; b++) {
+            size_t lo = static_cast<size_t>(b) * n_ / bands_;
+            size_t hi = static_cast<size_t>(b + 1) * n_ / bands_;
+            float sum = 0.0f;
+            for (size_t i = lo; i < hi; i++) sum += power_[i];
+            bandPower_[b] = std::max(sum / (hi - lo), 1e-30f);
+        }
+    }
+
+    void seedFloor(size_t first, size_t last) {
+        std::vector<std::vector<float>> history(bands_);
+        for (size_t frame = first; frame < last; frame++) {
+            source_.getSamples(config_.start + frame * n_, n_, samples_.data(), config_.channel);
+            computeBands(samples_.data());
+            for (int b = 0; b < bands_; b++) history[b].push_back(bandPower_[b]);
+        }
+        for (int b = 0; b < bands_; b++) {
+            auto& h = history[b];
+            if (h.empty()) {
+                floor_[b] = 1e-30f;
+                continue;
+            }
+            std::nth_element(h.begin(), h.begin() + h.size() / 2, h.end());
+            floor_[b] = h[h.size() / 2];
+        }
+    }
+
+    bool ownsOpenBurst(size_t chunkFirst) const {
+        for (auto& b : open_) {
+            if (b.startFrame >= chunkFirst) return true;
+        }
+        return false;
+    }
+
+    void processFrame(size_t frame, const std::complex<float>* samples,
+                      size_t chunkFirst, size_t chunkLast, std::vector<Burst>& out) {
+        computeBands(samples);
+
+        for (int b = 0; b < bands_; b++) {
+            float p = bandPower_[b];
+            if (active_[b]) {
+                active_[b] = p >= floor_[b] * offRatio_;
+            } else {
+                active_[b] = p > floor_[b] * onRatio_;
+            }
+            windowMin_[b] = std::min(windowMin_[b], p);
+            // The floor learns from quiet bands; an active band only pulls
+            // it toward its recent minimum, slowly
+            if (!active_[b]) {
+                float rate = p < floor_[b] ? FLOOR_FALL : FLOOR_RISE;
+                floor_[b] += (p - floor_[b]) * rate;
+            } else {
+                float target = recentMin_[b];
+                float rate = target < floor_[b] ? FLOOR_FALL : FLOOR_RISE_ACTIVE;
+                floor_[b] += (target - floor_[b]) * rate;
+            }
+        }
+        if (++windowFrames_ == MIN_WINDOW_FRAMES) {
+            recentMin_ = windowMin_;
+            std::fill(windowMin_.begin(), windowMin_.end(), INFINITY);
+            windowFrames_ = 0;
+        }
+
+        // Each run of adjacent active bands extends every open burst it
+        // overlaps (merging them) or starts a new one
+        for (int b = 0; b < bands_; ) {
+            if (!active_[b]) { b++; continue; }
+            int lo = b;
+            float peak = 0.0f;
+            while (b < bands_ && active_[b]) {
+                peak = std::max(peak, bandPower_[b] / floor_[b]);
+                b++;
+            }
+            int hi = b - 1;
+            extend(frame, lo, hi, peak, frame < chunkLast);
+        }
+        for (auto& burst : open_) {
+            if (burst.lastFrame != frame) continue;
+            for (int band = burst.bandLow; band <= burst.bandHigh; band++) {
+                if (active_[band]) burst.hits[band]++;
+            }
+        }
+
+        // Close bursts that have been quiet for longer than the hold time
+        for (size_t i = 0; i < open_.size(); ) {
+            if (frame - open_[i].lastFrame > static_cast<size_t>(config_.holdFrames)) {
+                emit(open_[i], chunkFirst, out);
+                open_[i] = open_.back();
+                open_.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+
+    void extend(size_t frame, int lo, int hi, float peak, bool mayStart) {
+        OpenBurst* target = nullptr;
+        for (size_t i = 0; i < open_.size(); ) {
+            auto& b = open_[i];
+            if (b.bandHigh < lo || b.bandLow > hi) { i++; continue; }
+            if (!target) {
+                target = &b;
+                i++;
+                continue;
+            }
+            // Second overlapping burst: fold it into the first
+            target->startFrame = std::min(target->startFrame, b.startFrame);
+            target->bandLow = std::min(target->bandLow, b.bandLow);
+            target->bandHigh = std::max(target->bandHigh, b.bandHigh);
+            target->peak = std::max(target->peak, b.peak);
+            for (int band = 0; band < bands_; band++) target->hits[band] += b.hits[band];
+            size_t targetIndex = target - open_.data();
+            open_[i] = open_.back();
+            open_.pop_back();
+            target = &open_[targetIndex];
+        }
+        if (!target) {
+            if (!mayStart) return;
+            open_.push_back({frame, frame, lo, hi, peak, std::vector<uint32_t>(bands_, 0)});
+            return;
+        }
+        target->lastFrame = frame;
+        target->bandLow = std::min(target->bandLow, lo);
+        target->bandHigh = std::max(target->bandHigh, hi);
+        target->peak = std::max(target->peak, peak);
+    }
+
+    void emit(const OpenBurst& b, size_t chunkFirst, std::vector<Burst>& out) const {
+        // Bursts that started before the chunk belong to the previous one
+        if (b.startFrame < chunkFirst) return;
+        Burst burst;
+        burst.sampleStart = config_.start + b.startFrame * n_;
+        burst.sampleCount = (b.lastFrame - b.startFrame + 1) * n_;
+        if (burst.sampleCount < config_.minDuration) return;
+
+        // Frequency extent from the bands that carry the burst, falling back
+        // to everything touched for bursts too short to tell
+        size_t frames = b.lastFrame - b.startFrame + 1;
+        uint32_t minHits = static_cast<uint32_t>(std::max(1.0, frames * BAND_OCCUPANCY));
+        int low = b.bandLow, high = b.bandHigh;
+        while (low < high && b.hits[low] < minHits) low++;
+        while (high > low && b.hits[high] < minHits) high--;
+        if (b.hits[low] < minHits) {
+            low = b.bandLow;
+            high = b.bandHigh;
+        }
+
+        // Bands are laid out DC-centered: bin i is frequency (i - n/2) / n
+        double half = n_ / 2.0;
+        burst.freqLow = (static_cast<double>(low) * n_ / bands_ - half) / n_;
+        burst.freqHigh = (static_cast<double>(high + 1) * n_ / bands_ - half) / n_;
+        burst.peakDb = 10.0f * std::log10(b.peak);
+        out.push_back(burst);
+    }
+
+    const InputSource& source_;
+    const BurstConfig& config_;
+    size_t totalFrames_;
+    size_t n_;
+    int bands_;
+    FFTEngine fft_;
+    std::vector<std::complex<float>> samples_;
+    std::vector<float> power_;
+    std::vector<float> floor_;
+    std::vector<bool> active_;
+    std::vector<float> bandPower_;
+    std::vector<float> windowMin_;   // per band, over the window in progress
+    std::vector<float> recentMin_;   // per band, over the last full window
+    size_t windowFrames_ = 0;
+    std::vector<OpenBurst> open_;
+    float onRatio_;
+    float offRatio_;
+};
+
+} // namespace
+
+size_t BurstDetector::run(const InputSource& source, const BurstConfig& config,
+                          const BurstCallback& onBursts, const ProgressCallback& onProgress,
+                          const std::atomic<bool>& cancel) {
+    if (config.fftSize <= 0 || config.bands <= 0 || config.bands > config.fftSize) {
+        throw std::runtime_error("Invalid FFT size or band count");
+    }
+    if (config.channel >= source.channels()) {
+        throw std::runtime_error("Channel out of range: " + std::to_string(config.channel));
+    }
+    size_t end = config.end == 0 ? source.totalSamples() : std::min(config.end, source.totalSamples());
+    if (config.start >= end) {
+        throw std::runtime_error("Empty detection range");
+    }
+
+    size_t totalFrames = (end - config.start) / config.fftSize;
+    size_t chunks = (totalFrames + CHUNK_FRAMES - 1) / CHUNK_FRAMES;
+
+    std::mutex mutex;
+    size_t found = 0;
+    size_t chunksDone = 0;
+
+    parallelForEach(chunks, parallelWorkers(chunks), [&](size_t chunk, unsigned) {
+        if (cancel) return;
+        ChunkScanner scanner(source, config, totalFrames);
+        std::vector<Burst> bursts;
+        size_t first = chunk * CHUNK_FRAMES;
+        scanner.scan(first, std::min(totalFrames, first + CHUNK_FRAMES), bursts, cancel);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        chunksDone++;
+        found += bursts.size();
+        if (!bursts.empty() && onBursts) onBursts(bursts);
+        if (onProgress) onProgress(static_cast<double>(chunksDone) / chunks);
+    });
+
+    return found;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "input_source.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+struct BurstConfig {
+    size_t start = 0;
+    size_t end = 0;             // 0 = end of file
+    int fftSize = 256;          // frame length; frames do not overlap
+    int bands = 32;             // fftSize bins grouped into this many bands
+    double thresholdDb = 10.0;  // band power above the noise floor to open a burst
+    double hysteresisDb = 4.0;  // burst stays open until power drops this far below threshold
+    size_t minDuration = 0;     // samples; shorter bursts are discarded
+    int holdFrames = 1;         // quiet frames tolerated inside a burst
+    unsigned channel = 0;       // of an interleaved multi-channel file
+};
+
+struct Burst {
+    size_t sampleStart;
+    size_t sampleCount;
+    double freqLow;   // normalized frequency, cycles/sample
+    double freqHigh;
+    float peakDb;     // strongest band power above the noise floor
+};
+
+// Energy detector: per-band power against an adaptive noise floor, with
+// hysteresis, merged into time-frequency boxes. The floor learns from quiet
+// frames, and while a band stays active it still drifts slowly toward the
+// band's recent minimum, so a floor that rises under a long occupancy is
+// followed. The range is cut into
+// chunks scanned in parallel; each chunk warms its noise floor up on the
+// frames just before it and reports only bursts that start inside it.
+class BurstDetector {
+public:
+    // Called (serialized) with each batch of finished bursts, in no particular order
+    using BurstCallback = std::function<void(const std::vector<Burst>&)>;
+    // Fraction of the range scanned so far
+    using ProgressCallback = std::function<void(double)>;
+
+    // Returns the number of bursts reported. Throws std::runtime_error for
+    // bad sizes, an empty range or a channel out of range.
+    static size_t run(const InputSource& source, const BurstConfig& config,
+                      const BurstCallback& onBursts, const ProgressCallback& onProgress,
+                      const std::atomic<bool>& cancel);
+};
@@ -0,0 +1,189 @@
+#include "chirp_engine.h"
+#include "fft_engine.h"
+#include "format_traits.h"
+#include "parallel.h"
+#include "perf_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+static const double Tau = 6.283185307179586;
+// Windows per worker below which extra threads cost more than they save
+static const size_t MIN_WINDOWS_PER_THREAD = 256;
+// Work items per worker, so progress is reported as the scan runs
+static const size_t BLOCKS_PER_WORKER = 8;
+// Longest symbol accepted, in samples
+static const size_t MAX_SYMBOL_SAMPLES = size_t(1) << 24;
+
+size_t ChirpParams::length() const {
+    if (!(bandwidth > 0.0 && bandwidth <= 1.0)) {
+        throw std::runtime_error("Chirp bandwidth must be in (0, 1] cycles/sample");
+    }
+    if (symbolSamples == 0 && (spreadingFactor < 5 || spreadingFactor > 12)) {
+        throw std::runtime_error("Spreading factor must be 5 to 12");
+    }
+    double n = symbolSamples ? static_cast<double>(symbolSamples)
+                             : std::round(std::ldexp(1.0, spreadingFactor) / bandwidth);
+    if (n < 2 || n > MAX_SYMBOL_SAMPLES) throw std::runtime_error("Invalid chirp symbol length");
+    return static_cast<size_t>(n);
+}
+
+size_t ChirpParams::symbolValues() const {
+    size_t n = length();
+    if (!symbolSamples) return std::min(n, size_t(1) << spreadingFactor);
+    return std::min(n, std::max<size_t>(1, static_cast<size_t>(std::llround(bandwidth * n))));
+}
+
+std::vector<std::complex<float>> ChirpEngine::reference(const ChirpParams& params, size_t count) {
+    // Instantaneous frequency -bw/2 + bw * t / L over each symbol, so the
+    // phase returns to zero at every symbol boundary
+    const double n = static_cast<double>(params.length());
+    const double bw = params.bandwidth;
+    std::vector<std::complex<float>> ref(count);
+    for (size_t i = 0; i < count; i++) {
+        double t = std::fmod(static_cast<double>(i), n);
+        double phase = Tau * (-0.5 * bw * t + 0.5 * bw * t * t / n);
+        ref[i] = std::complex<float>(static_cast<float>(std::cos(phase)), static_cast<float>(-std::sin(phase)));
+    }
+    return ref;
+}
+
+void ChirpEngine::computeTile(const InputSource& source, size_t startSample,
+                              int fftSize, int stride, int numLines,
+                              const ChirpParams& params, float* output,
+                              unsigned channel) {
+    const size_t n = fftSize;
+    const auto ref = reference(params, n);
+    FFTEngine fft(fftSize);
+    std::vector<std::complex<float>> samples(n);
+
+    for (int line = 0; line < numLines; line++) {
+        size_t offset = startSample + static_cast<size_t>(line) * stride;
+        source.getSamplesInCapture(offset, n, samples.data(), channel);
+        for (size_t i = 0; i < n; i++) samples[i] *= ref[i];
+        fft.computePowerSpectrum(samples.data(), output + static_cast<size_t>(line) * fftSize);
+    }
+}
+
+ChirpSearchResult ChirpEngine::findSymbols(
+    const InputSource& source,
+    const ChirpSearchConfig& config,
+    const ProgressCallback& onProgress,
+    const std::atomic<bool>& cancel
+) {
+    const size_t n = config.chirp.length();
+    const size_t values = config.chirp.symbolValues();
+    if (config.channel >= source.channels()) {
+        throw std::runtime_error("Channel out of range: " + std::to_string(config.channel));
+    }
+    size_t end = config.end == 0 ? source.totalSamples() : std::min(config.end, source.totalSamples());
+    if (config.start >= end || end - config.start < n) {
+        throw std::runtime_error("Range is shorter than one chirp symbol");
+    }
+    const size_t start = config.start;
+    const size_t step = config.step ? config.step : n;
+    const size_t windows = (end - start - n) / step + 1;
+    const float threshold = static_cast<float>(std::pow(10.0, config.thresholdDb / 10.0));
+    const auto ref = reference(config.chirp, n);
+    const size_t channels = source.channels();
+
+    unsigned workers = parallelWorkers(windows, MIN_WINDOWS_PER_THREAD);
+    size_t blocks = std::min(windows, static_cast<size_t>(workers) * BLOCKS_PER_WORKER);
+    std::vector<std::vector<ChirpSymbol>> found(blocks);
+    std::vector<std::unique_ptr<FFTEngine>> engines(workers);
+    std::mutex progressMutex;
+    size_t blocksDone = 0;
+
+    // A dechirped symbol is a tone at its value; when oversampled, the
+    // part of the chirp that wrapped past the band edge lands one symbol
+    // range below, so bins fold modulo the number of values
+    auto runBlock = [&](auto traits, size_t block, unsigned w) {
+        using Traits = decltype(traits);
+        // Rectangular: an aligned symbol then falls in exactly one bin
+        if (!engines[w]) engines[w] = std::make_unique<FFTEngine>(static_cast<int>(n), WindowType::Rectangular);
+        FFTEngine& fft = *engines[w];
+        std::vector<uint8_t> staging;
+        std::vector<float> folded(values);
+        auto& out = found[block];
+
+        size_t first = windows * block / blocks;
+        size_t last = windows * (block + 1) / blocks;
+        source.prefetch(start + first * step, (last - first - 1) * step + n);
+        for (size_t win = first; win < last && !cancel; win++) {
+            size_t offset = start + win * step;
+            // A window running over a retune is cut there
+            size_t valid = source.validInCapture(offset, n);
+            const void* raw = nullptr;
+            if (valid) {
+                PerfScope perf(PerfStage::Read, valid * source.frameSize());
+                raw = Traits::channelData(source.rawSamples(offset, valid, staging), config.channel);
+            }
+            Traits::loadWindowed(raw, valid, fft.window(), fft.input(), n, channels);
+            fftwf_complex* in = fft.input();
+            for (size_t i = 0; i < valid; i++) {
+                float re = in[i][0], im = in[i][1];
+                in[i][0] = re * ref[i].real() - im * ref[i].imag();
+                in[i][1] = re * ref[i].imag() + im * ref[i].real();
+            }
+            const fftwf_complex* spectrum = fft.executeSpectrum();
+
+            std::fill(folded.begin(), folded.end(), 0.0f);
+            for (size_t k = 0, s = 0; k < n; k++) {
+                folded[s] += spectrum[k][0] * spectrum[k][0] + spectrum[k][1] * spectrum[k][1];
+                if (++s == values) s = 0;
+            }
+            size_t best = 0;
+            float sum = 0.0f;
+            for (size_t s = 0; s < values; s++) {
+                sum += folded[s];
+                if (folded[s] > folded[best]) best = s;
+            }
+            float mean = sum / values;
+            if (mean > 0.0f && folded[best] >= threshold * mean) {
+                ChirpSymbol symbol;
+                symbol.sampleStart = offset;
+                symbol.value = static_cast<uint32_t>(best);
+                symbol.powerDb = 10.0f * std::log10(folded[best] / mean);
+                out.push_back(symbol);
+            }
+        }
+    };
+
+    dispatchFormat(source.format(), [&](auto traits) {
+        parallelForEach(blocks, workers, [&](size_t block, unsigned w) {
+            if (cancel) return;
+            runBlock(traits, block, w);
+
+            std::lock_guard<std::mutex> lock(progressMutex);
+            blocksDone++;
+            if (onProgress) onProgress(static_cast<double>(blocksDone) / blocks);
+        });
+    });
+
+    ChirpSearchResult result;
+    result.windows = windows;
+    result.cancelled = cancel;
+    for (auto& block : found) {
+        result.symbols.insert(result.symbols.end(), block.begin(), block.end());
+    }
+
+    // Chain symbols in consecutive windows into frames
+    const auto& symbols = result.symbols;
+    for (size_t i = 0; i < symbols.size(); ) {
+        size_t j = i + 1;
+        while (j < symbols.size() && symbols[j].sampleStart - symbols[j - 1].sampleStart <= step) j++;
+        if (j - i >= config.minSymbols) {
+            ChirpFrame frame;
+            frame.sampleStart = symbols[i].sampleStart;
+            frame.sampleCount = symbols[j - 1].sampleStart + n - frame.sampleStart;
+            frame.firstSymbol = i;
+            frame.symbolCount = j - i;
+            result.frames.push_back(frame);
+        }
+        i = j;
+    }
+    return result;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "input_source.h"
+
+#include <atomic>
+#include <complex>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Linear up-chirp sweeping bandwidth (cycles/sample) once per symbol, as in
+// LoRa chirp spread spectrum. Multiplying by the conjugate of the base
+// chirp ("dechirping") turns every chirp with the same slope into a tone
+// whose frequency encodes its time offset, i.e. its symbol value.
+struct ChirpParams {
+    int spreadingFactor = 7;     // 2^SF symbol values
+    double bandwidth = 1.0;      // cycles/sample; 1 = critically sampled
+    size_t symbolSamples = 0;    // 0 = 2^SF / bandwidth
+
+    // Samples per symbol. Throws std::runtime_error for invalid parameters.
+    size_t length() const;
+    // Distinct symbol values: 2^SF, or bandwidth * symbolSamples when the
+    // length is given explicitly
+    size_t symbolValues() const;
+};
+
+struct ChirpSearchConfig {
+    ChirpParams chirp;
+    size_t start = 0;
+    size_t end = 0;               // 0 = end of file
+    size_t step = 0;              // samples between windows, 0 = one symbol
+    double thresholdDb = 10.0;    // symbol peak above the mean of the symbol bins
+    size_t minSymbols = 4;        // shortest run reported as a frame
+    unsigned channel = 0;
+};
+
+struct ChirpSymbol {
+    size_t sampleStart = 0;       // window start
+    uint32_t value = 0;           // 0 .. symbolValues() - 1
+    float powerDb = 0.0f;         // peak above the mean, dB
+};
+
+// Run of symbols in consecutive windows: a preamble and what follows it
+struct ChirpFrame {
+    size_t sampleStart = 0;
+    size_t sampleCount = 0;
+    size_t firstSymbol = 0;       // index into ChirpSearchResult::symbols
+    size_t symbolCount = 0;
+};
+
+struct ChirpSearchResult {
+    std::vector<ChirpSymbol> symbols;  // in file order
+    std::vector<ChirpFrame> frames;
+    size_t windows = 0;                // windows examined
+    bool cancelled = false;
+};
+
+class ChirpEngine {
+public:
+    using ProgressCallback = std::function<void(double)>;
+
+    // Conjugate base chirp for window samples [0, count), restarting every
+    // symbol, so any window start works as the dechirp reference
+    static std::vector<std::complex<float>> reference(const ChirpParams& params, size_t count);
+
+    // Tile of numLines DC-centered dB lines like the STFT, but each window
+    // is dechirped before its FFT, so chirps of the given slope show as
+    // horizontal lines. An fftSize of one symbol gives the sharpest tones.
+    static void computeTile(const InputSource& source, size_t startSample,
+                            int fftSize, int stride, int numLines,
+                            const ChirpParams& params, float* output,
+                            unsigned channel = 0);
+
+    // Dechirp one-symbol windows step samples apart across the range,
+    // split into blocks across threads, and keep each window's strongest
+    // symbol when it clears the threshold. Windows within a step of each
+    // other then chain into frames. Throws std::runtime_error for invalid
+    // parameters or a range shorter than one symbol.
+    static ChirpSearchResult findSymbols(
+        const InputSource& source,
+        const ChirpSearchConfig& config,
+        const ProgressCallback& onProgress,
+        const std::atomic<bool>& cancel
+    );
+};
@@ -0,0 +1,124 @@
+#include "color_map.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+void hsvToRgb(double h, double s, double v, double& r, double& g, double& b) {
+    int i = static_cast<int>(std::floor(h * 6));
+    double f = h * 6 - i;
+    double p = v * (1 - s);
+    double q = v * (1 - f * s);
+    double t = v * (1 - (1 - f) * s);
+
+    switch (((i % 6) + 6) % 6) {
+        case 0: r = v; g = t; b = p; break;
+        case 1: r = q; g = v; b = p; break;
+        case 2: r = p; g = v; b = t; break;
+        case 3: r = p; g = q; b = v; break;
+        case 4: r = t; g = p; b = v; break;
+        default: r = v; g = p; b = q; break;
+    }
+}
+
+// Math.round for the non-negative values used here
+uint8_t toByte(double x) {
+    return static_cast<uint8_t>(std::floor(x * 255 + 0.5));
+}
+
+}  // namespace
+
+ColorMap::ColorMap(const std::string& name) {
+    bool inspectrum = name == "inspectrum";
+    if (!inspectrum && name != "plasma-dark") {
+        throw std::runtime_error("Unknown colormap: " + name);
+    }
+
+    for (int i = 0; i < 256; i++) {
+        double t = i / 255.0;
+        double r, g, b;
+
+        if (inspectrum) {
+            // HSV rainbow: H = 240 -> 0 (blue -> red), S=1, V=t
+            hsvToRgb((1 - t) * 240 / 360, 1, t, r, g, b);
+        } else if (t < 0.25) {
+            double s = t / 0.25;
+            r = s * 0.4;
+            g = 0;
+            b = s * 0.6;
+        } else if (t < 0.5) {
+            double s = (t - 0.25) / 0.25;
+            r = 0.4 * (1 - s) + s * 0.1;
+            g = 0;
+            b = 0.6 + s * 0.4;
+        } else if (t < 0.75) {
+            double s = (t - 0.5) / 0.25;
+            r = 0.1 * (1 - s);
+            g = s * 0.8;
+            b = 1.0;
+        } else {
+            double s = (t - 0.75) / 0.25;
+            r = s;
+            g = 0.8 + s * 0.2;
+            b = 1.0;
+        }
+
+        table_[i * 4 + 0] = toByte(r);
+        table_[i * 4 + 1] = toByte(g);
+        table_[i * 4 + 2] = toByte(b);
+        table_[i * 4 + 3] = 255;
+    }
+
+    // GL_LINEAR on a 256-texel texture: u lands at texel u * 256 - 0.5,
+    // clamped to the edge texels
+    lut_.resize(LUT_SIZE * 4);
+    for (int i = 0; i < LUT_SIZE; i++) {
+        double u = i / static_cast<double>(LUT_SIZE - 1);
+        double pos = std::min(255.0, std::max(0.0, u * 256 - 0.5));
+        int lo = static_cast<int>(pos);
+        int hi = std::min(255, lo + 1);
+        double f = pos - lo;
+        for (int c = 0; c < 4; c++) {
+            double v = table_[lo * 4 + c] * (1 - f) + table_[hi * 4 + c] * f;
+            lut_[i * 4 + c] = static_cast<uint8_t>(std::floor(v + 0.5));
+        }
+    }
+}
+
+void ColorMap::apply(const float* db, size_t count, float minDb, float maxDb, uint8_t* rgba) const {
+    float range = maxDb - minDb;
+    float scale = range > 0 ? (LUT_SIZE - 1) / range : 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        float x = (db[i] - minDb) * scale;
+        // NaN and -inf land on the bottom entry
+        int idx = x > 0 ? static_cast<int>(std::min(x + 0.5f, static_cast<float>(LUT_SIZE - 1))) : 0;
+        const uint8_t* c = &lut_[idx * 4];
+        rgba[i * 4 + 0] = c[0];
+        rgba[i * 4 + 1] = c[1];
+        rgba[i * 4 + 2] = c[2];
+        rgba[i * 4 + 3] = c[3];
+    }
+}
+
+void ColorMap::autoRange(const float* db, size_t count, float& minDb, float& maxDb) {
+    size_t step = std::max<size_t>(1, count / (1 << 20));
+    std::vector<float> sample;
+    sample.reserve(count / step + 1);
+    for (size_t i = 0; i < count; i += step) {
+        if (std::isfinite(db[i])) sample.push_back(db[i]);
+    }
+    if (sample.empty()) {
+        minDb = -100.0f;
+        maxDb = 0.0f;
+        return;
+    }
+    auto at = [&](double q) {
+        auto nth = sample.begin() + static_cast<size_t>(q * (sample.size() - 1));
+        std::nth_element(sample.begin(), nth, sample.end());
+        return *nth;
+    };
+    minDb = at(0.05);
+    maxDb = std::max(at(0.999), minDb + 10.0f);
+}
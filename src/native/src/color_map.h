@@ -0,0 +1,34 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Native copy of the renderer's colormaps (renderer/webgl/ColorMap.ts), so
+// images rendered outside the app match the on-screen spectrogram
+class ColorMap {
+public:
+    // "plasma-dark" or "inspectrum"; throws std::runtime_error otherwise
+    explicit ColorMap(const std::string& name = "plasma-dark");
+
+    // The 256 RGBA entries, identical to generateColorMap()
+    const std::array<uint8_t, 256 * 4>& table() const { return table_; }
+
+    // dB values to RGBA the way the spectrogram shader does: normalized to
+    // [minDb, maxDb], clamped, then sampled with linear filtering between
+    // table entries
+    void apply(const float* db, size_t count, float minDb, float maxDb, uint8_t* rgba) const;
+
+    // Display range for an image of dB values: the 5th percentile up to
+    // the 99.9th (at least 10 dB wide), from a strided sample of at most a
+    // million values
+    static void autoRange(const float* db, size_t count, float& minDb, float& maxDb);
+
+private:
+    static const int LUT_SIZE = 4096;
+
+    std::array<uint8_t, 256 * 4> table_;
+    std::vector<uint8_t> lut_;  // LUT_SIZE filtered RGBA entries over [0, 1]
+};
@@ -0,0 +1,263 @@
+#include "compressed_backend.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef SNAIL_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// Seekable format constants (zstd contrib/seekable_format)
+static const uint32_t SKIPPABLE_MAGIC = 0x184D2A5E;
+static const uint32_t SEEKABLE_MAGIC = 0x8F92EAB1;
+static const size_t FOOTER_SIZE = 9;
+static const size_t SKIPPABLE_HEADER_SIZE = 8;
+
+static uint32_t readLE32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static void preadFully(int fd, void* dest, size_t length, size_t offset, const std::string& path) {
+    auto out = static_cast<uint8_t*>(dest);
+    while (length > 0) {
+        ssize_t n = pread(fd, out, length, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Read failed at offset " + std::to_string(offset) +
+                                     " of " + path + ": " + std::strerror(errno));
+        }
+        if (n == 0) {
+            throw std::runtime_error("Unexpected end of file: " + path);
+        }
+        out += n;
+        offset += static_cast<size_t>(n);
+        length -= static_cast<size_t>(n);
+    }
+}
+
+bool isCompressedPath(const std::string& path) {
+    return path.size() > 4 && path.compare(path.size() - 4, 4, ".zst") == 0;
+}
+
+CompressedBackend::CompressedBackend(const std::string& path, const BackendOptions& options)
+    : path_(path), cache_(options.cacheBytes) {
+#ifndef SNAIL_HAVE_ZSTD
+    throw std::runtime_error("Built without zstd support: " + path);
+#endif
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) < 0) {
+        ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error("Failed to stat file: " + path);
+    }
+    fileSize_ = st.st_size;
+
+    try {
+        readSeekTable();
+    } catch (...) {
+        ::close(fd_);
+        fd_ = -1;
+        throw;
+    }
+}
+
+CompressedBackend::~CompressedBackend() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (prefetcher_.joinable()) prefetcher_.join();
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void CompressedBackend::readSeekTable() {
+    if (fileSize_ < FOOTER_SIZE + SKIPPABLE_HEADER_SIZE) {
+        throw std::runtime_error("Not a seekable zstd file: " + path_);
+    }
+
+    uint8_t footer[FOOTER_SIZE];
+    preadFully(fd_, footer, FOOTER_SIZE, fileSize_ - FOOTER_SIZE, path_);
+    if (readLE32(footer + 5) != SEEKABLE_MAGIC) {
+        throw std::runtime_error("Not a seekable zstd file (no seek table): " + path_);
+    }
+
+    size_t numFrames = readLE32(footer);
+    bool hasChecksums = (footer[4] & 0x80) != 0;
+    size_t entrySize = hasChecksums ? 12 : 8;
+    size_t tableSize = numFrames * entrySize;
+    size_t frameSize = tableSize + FOOTER_SIZE;
+    if (frameSize + SKIPPABLE_HEADER_SIZE > fileSize_) {
+        throw std::runtime_error("Corrupt zstd seek table: " + path_);
+    }
+
+    size_t tableStart = fileSize_ - frameSize;
+    uint8_t header[SKIPPABLE_HEADER_SIZE];
+    preadFully(fd_, header, SKIPPABLE_HEADER_SIZE, tableStart - SKIPPABLE_HEADER_SIZE, path_);
+    if (readLE32(header) != SKIPPABLE_MAGIC || readLE32(header + 4) != frameSize) {
+        throw std::runtime_error("Corrupt zstd seek table: " + path_);
+    }
+
+    std::vector<uint8_t> table(tableSize);
+    preadFully(fd_, table.data(), tableSize, tableStart, path_);
+
+    size_t compressedOffset = 0;
+    size_t offset = 0;
+    frames_.reserve(numFrames);
+    offsets_.reserve(numFrames);
+    for (size_t i = 0; i < numFrames; i++) {
+        const uint8_t* entry = table.data() + i * entrySize;
+        Frame f;
+        f.compressedOffset = compressedOffset;
+        f.compressedSize = readLE32(entry);
+        f.offset = offset;
+        f.size = readLE32(entry + 4);
+        compressedOffset += f.compressedSize;
+        offset += f.size;
+        // Skip empty frames so lookup never lands on one
+        if (f.size == 0) continue;
+        frames_.push_back(f);
+        offsets_.push_back(f.offset);
+    }
+    if (compressedOffset > tableStart - SKIPPABLE_HEADER_SIZE) {
+        throw std::runtime_error("Corrupt zstd seek table: " + path_);
+    }
+    size_ = offset;
+}
+
+size_t CompressedBackend::locate(size_t offset) const {
+    auto it = std::upper_bound(offsets_.begin(), offsets_.end(), offset);
+    return static_cast<size_t>(it - offsets_.begin()) - 1;
+}
+
+BlockCache::Block CompressedBackend::decompress(size_t index) const {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return !busy_.count(index); });
+        if (auto block = cache_.get(index)) {
+            return block;
+        }
+        busy_.insert(index);
+    }
+    struct Release {
+        const CompressedBackend* self;
+        size_t index;
+        ~Release() {
+            {
+                std::lock_guard<std::mutex> lock(self->mutex_);
+                self->busy_.erase(index);
+            }
+            self->cv_.notify_all();
+        }
+    } release{this, index};
+
+    const Frame& f = frames_[index];
+    auto out = std::make_shared<std::vector<uint8_t>>(f.size);
+
+#ifdef SNAIL_HAVE_ZSTD
+    thread_local std::vector<uint8_t> compressed;
+    compressed.resize(f.compressedSize);
+    preadFully(fd_, compressed.data(), f.compressedSize, f.compressedOffset, path_);
+
+    // One decompression context per worker thread, reused across frames
+    struct DCtx {
+        ZSTD_DCtx* ctx = ZSTD_createDCtx();
+        ~DCtx() { ZSTD_freeDCtx(ctx); }
+    };
+    thread_local DCtx dctx;
+    if (!dctx.ctx) dctx.ctx = ZSTD_createDCtx();
+    if (!dctx.ctx) {
+        throw std::runtime_error("Out of memory for a zstd decompression context");
+    }
+
+    size_t ret = ZSTD_decompressDCtx(dctx.ctx, out->data(), out->size(),
+                                     compressed.data(), compressed.size());
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error("zstd frame " + std::to_string(index) + " of " + path_ +
+                                 ": " + ZSTD_getErrorName(ret));
+    }
+    if (ret != f.size) {
+        throw std::runtime_error("zstd frame " + std::to_string(index) + " of " + path_ +
+                                 " has the wrong decompressed size");
+    }
+#endif
+
+    cache_.put(index, out);
+    return out;
+}
+
+void CompressedBackend::read(size_t offset, size_t length, void* dest) const {
+    if (offset + length > size_) {
+        throw std::runtime_error("Read beyond end of file");
+    }
+
+    auto out = static_cast<uint8_t*>(dest);
+    while (length > 0) {
+        size_t i = locate(offset);
+        const Frame& f = frames_[i];
+        auto block = decompress(i);
+        size_t chunk = std::min(length, f.offset + f.size - offset);
+        std::memcpy(out, block->data() + (offset - f.offset), chunk);
+        offset += chunk;
+        out += chunk;
+        length -= chunk;
+    }
+}
+
+void CompressedBackend::prefetch(size_t offset, size_t length) const {
+    if (length == 0 || offset >= size_) return;
+    length = std::min(length, size_ - offset);
+    size_t first = locate(offset);
+    size_t last = locate(offset + length - 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_) return;
+        // Queue no more than half the cache holds, so prefetched frames
+        // do not evict each other before they are read
+        size_t queuedBytes = 0;
+        for (size_t i : queue_) queuedBytes += frames_[i].size;
+        for (size_t i = first; i <= last; i++) {
+            if (queuedBytes + frames_[i].size > cache_.capacity() / 2) break;
+            if (busy_.count(i) || !queued_.insert(i).second) continue;
+            queue_.push_back(i);
+            queuedBytes += frames_[i].size;
+        }
+        if (!prefetcher_.joinable() && !queue_.empty()) {
+            prefetcher_ = std::thread(&CompressedBackend::runPrefetch, this);
+        }
+    }
+    cv_.notify_all();
+}
+
+void CompressedBackend::runPrefetch() const {
+    for (;;) {
+        size_t index;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_) return;
+            index = queue_.front();
+            queue_.pop_front();
+            queued_.erase(index);
+        }
+        try {
+            decompress(index);
+        } catch (const std::exception&) {
+            // A reader that needs the frame gets the error itself
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "data_backend.h"
+#include "block_cache.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// Reads a seekable-zstd archive (independent zstd frames followed by a
+// seek table in a skippable frame). Only the frames covering a request are
+// decompressed, on the calling worker thread, and decompressed frames are
+// kept in an LRU cache bounded by BackendOptions::cacheBytes. prefetch()
+// hands frames to a background thread that decompresses them into the
+// same cache.
+class CompressedBackend : public DataBackend {
+public:
+    CompressedBackend(const std::string& path, const BackendOptions& options);
+    ~CompressedBackend() override;
+
+    const char* name() const override { return "zstd"; }
+    size_t size() const override { return size_; }
+    void read(size_t offset, size_t length, void* dest) const override;
+    void prefetch(size_t offset, size_t length) const override;
+
+    size_t frameCount() const { return frames_.size(); }
+
+private:
+    struct Frame {
+        size_t compressedOffset;
+        size_t compressedSize;
+        size_t offset;  // decompressed offset
+        size_t size;    // decompressed size
+    };
+
+    void readSeekTable();
+    // Index of the frame holding decompressed byte offset, O(log n)
+    size_t locate(size_t offset) const;
+    // Cached frame, or decompressed now; waits if another thread is
+    // already decompressing it
+    BlockCache::Block decompress(size_t index) const;
+    void runPrefetch() const;
+
+    int fd_ = -1;
+    size_t fileSize_ = 0;
+    size_t size_ = 0;
+    std::string path_;
+    std::vector<Frame> frames_;
+    std::vector<size_t> offsets_;  // decompressed start of each frame, for lookup
+    mutable BlockCache cache_;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable cv_;
+    mutable std::unordered_set<size_t> busy_;    // frames being decompressed
+    mutable std::deque<size_t> queue_;           // frames to prefetch
+    mutable std::unordered_set<size_t> queued_;
+    mutable bool stop_ = false;
+    mutable std::thread prefetcher_;             // started by the first prefetch()
+};
+
+// True for paths the compressed backend handles
+bool isCompressedPath(const std::string& path);
@@ -1,7 +1,13 @@
 #include "correlation_engine.h"
+#include "fft_engine.h"
+#include "parallel.h"
+#include "buffer_pool.h"
 #include <fftw3.h>
+#include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <mutex>
+#include <stdexcept>
 
 size_t CorrelationEngine::nextPow2(size_t n) {
     size_t p = 1;
@@ -9,74 +15,34 @@ size_t CorrelationEngine::nextPow2(size_t n) {
     return p;
 }
 
-std::vector<float> CorrelationEngine::crossCorrelate(
-    const std::complex<float>* signal,
-    size_t signalLen,
-    const std::complex<float>* tmpl,
-    size_t tmplLen
-) {
-    // Zero-pad to next power of 2 >= signalLen + tmplLen - 1
-    size_t fftLen = nextPow2(signalLen + tmplLen - 1);
-
-    // Allocate FFTW buffers
-    auto* sigIn  = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * fftLen);
-    auto* tmplIn = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * fftLen);
-    auto* sigFFT  = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * fftLen);
-    auto* tmplFFT = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * fftLen);
-    auto* product = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * fftLen);
-    auto* result  = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * fftLen);
-
-    // Zero-fill
-    std::memset(sigIn, 0, sizeof(fftwf_complex) * fftLen);
-    std::memset(tmplIn, 0, sizeof(fftwf_complex) * fftLen);
-
-    // Copy input data
-    for (size_t i = 0; i < signalLen; i++) {
-        sigIn[i][0] = signal[i].real();
-        sigIn[i][1] = signal[i].imag();
-    }
-    for (size_t i = 0; i < tmplLen; i++) {
-        tmplIn[i][0] = tmpl[i].real();
-        tmplIn[i][1] = tmpl[i].imag();
-    }
-
-    // Forward FFTs
-    auto planSig = fftwf_plan_dft_1d(fftLen, sigIn, sigFFT, FFTW_FORWARD, FFTW_ESTIMATE);
-    auto planTmpl = fftwf_plan_dft_1d(fftLen, tmplIn, tmplFFT, FFTW_FORWARD, FFTW_ESTIMATE);
-    fftwf_execute(planSig);
-    fftwf_execute(planTmpl);
-
-    // Multiply: FFT(signal) * conj(FFT(template))
-    for (size_t i = 0; i < fftLen; i++) {
-        float sr = sigFFT[i][0], si = sigFFT[i][1];
-        float tr = tmplFFT[i][0], ti = -tmplFFT[i][1]; // conjugate
-        product[i][0] = sr * tr - si * ti;
-        product[i][1] = sr * ti + si * tr;
-    }
+namespace {
 
-    // Inverse FFT
-    auto planInv = fftwf_plan_dft_1d(fftLen, product, result, FFTW_BACKWARD, FFTW_ESTIMATE);
-    fftwf_execute(planInv);
+float energy(const std::complex<float>& v) { return std::norm(v); }
+float energy(float v) { return v * v; }
 
+// Normalized correlation for every linear lag k from -(tmplLen - 1) to
+// signalLen - 1, given lagMagnitude(i) = |unnormalized xcorr| at circular
+// index i of the fftLen-point result
+template <typename T, typename LagMagnitude>
+std::vector<float> normalizeLags(
+    const T* signal, size_t signalLen,
+    const T* tmpl, size_t tmplLen,
+    size_t fftLen, LagMagnitude lagMagnitude
+) {
     // Compute cumulative energies for O(1) range energy lookup
     std::vector<float> sigCumEnergy(signalLen + 1, 0.0f);
     for (size_t i = 0; i < signalLen; i++) {
-        float r = signal[i].real();
-        float im = signal[i].imag();
-        sigCumEnergy[i + 1] = sigCumEnergy[i] + (r * r + im * im);
+        sigCumEnergy[i + 1] = sigCumEnergy[i] + energy(signal[i]);
     }
 
     std::vector<float> tmplCumEnergy(tmplLen + 1, 0.0f);
     for (size_t i = 0; i < tmplLen; i++) {
-        float r = tmpl[i].real();
-        float im = tmpl[i].imag();
-        tmplCumEnergy[i + 1] = tmplCumEnergy[i] + (r * r + im * im);
+        tmplCumEnergy[i + 1] = tmplCumEnergy[i] + energy(tmpl[i]);
     }
 
     // Prepare full linear output range: lag k from -(tmplLen - 1) to (signalLen - 1)
     size_t outLen = signalLen + tmplLen - 1;
     std::vector<float> output(outLen);
-    float invN = 1.0f / fftLen;
 
     // Minimum overlap: at least 50% of the shorter sequence must overlap
     // to avoid NCC edge artifacts where tiny overlap gets normalized to 1.0
@@ -100,10 +66,7 @@ std::vector<float> CorrelationEngine::crossCorrelate(
 
         // FFT index for lag k
         size_t fftIdx = (k >= 0) ? static_cast<size_t>(k) : (fftLen + k);
-
-        float re = result[fftIdx][0] * invN;
-        float im = result[fftIdx][1] * invN;
-        float mag = std::sqrt(re * re + im * im);
+        float mag = lagMagnitude(fftIdx);
 
         float eSig = sigCumEnergy[overlapEndSig] - sigCumEnergy[overlapStartSig];
 
@@ -118,67 +81,362 @@ std::vector<float> CorrelationEngine::crossCorrelate(
             output[i] = 0.0f;
         }
     }
+    return output;
+}
+
+} // namespace
+
+std::vector<float> CorrelationEngine::crossCorrelate(
+    const std::complex<float>* signal,
+    size_t signalLen,
+    const std::complex<float>* tmpl,
+    size_t tmplLen
+) {
+    // Zero-pad to next power of 2 >= signalLen + tmplLen - 1
+    size_t fftLen = nextPow2(signalLen + tmplLen - 1);
+
+    // FFTW buffers, reused across requests through the pool
+    PooledBuffer<fftwf_complex> sigIn(fftLen), tmplIn(fftLen), sigFFT(fftLen);
+    PooledBuffer<fftwf_complex> tmplFFT(fftLen), product(fftLen), result(fftLen);
+
+    // Zero-fill
+    std::memset(sigIn.data(), 0, sizeof(fftwf_complex) * fftLen);
+    std::memset(tmplIn.data(), 0, sizeof(fftwf_complex) * fftLen);
+
+    // Copy input data
+    for (size_t i = 0; i < signalLen; i++) {
+        sigIn[i][0] = signal[i].real();
+        sigIn[i][1] = signal[i].imag();
+    }
+    for (size_t i = 0; i < tmplLen; i++) {
+        tmplIn[i][0] = tmpl[i].real();
+        tmplIn[i][1] = tmpl[i].imag();
+    }
+
+    fftwf_plan planSig, planTmpl, planInv;
+    {
+        std::lock_guard<std::mutex> lock(g_fftwMutex);
+        planSig = fftwf_plan_dft_1d(fftLen, sigIn.data(), sigFFT.data(), FFTW_FORWARD, FFTW_ESTIMATE);
+        planTmpl = fftwf_plan_dft_1d(fftLen, tmplIn.data(), tmplFFT.data(), FFTW_FORWARD, FFTW_ESTIMATE);
+        planInv = fftwf_plan_dft_1d(fftLen, product.data(), result.data(), FFTW_BACKWARD, FFTW_ESTIMATE);
+    }
+
+    // Forward FFTs
+    fftwf_execute(planSig);
+    fftwf_execute(planTmpl);
+
+    // Multiply: FFT(signal) * conj(FFT(template))
+    for (size_t i = 0; i < fftLen; i++) {
+        float sr = sigFFT[i][0], si = sigFFT[i][1];
+        float tr = tmplFFT[i][0], ti = -tmplFFT[i][1]; // conjugate
+        product[i][0] = sr * tr - si * ti;
+        product[i][1] = sr * ti + si * tr;
+    }
+
+    // Inverse FFT
+    fftwf_execute(planInv);
+
+    float invN = 1.0f / fftLen;
+    std::vector<float> output = normalizeLags(signal, signalLen, tmpl, tmplLen, fftLen, [&](size_t i) {
+        float re = result[i][0] * invN;
+        float im = result[i][1] * invN;
+        return std::sqrt(re * re + im * im);
+    });
 
     // Cleanup
-    fftwf_destroy_plan(planSig);
-    fftwf_destroy_plan(planTmpl);
-    fftwf_destroy_plan(planInv);
-    fftwf_free(sigIn);
-    fftwf_free(tmplIn);
-    fftwf_free(sigFFT);
-    fftwf_free(tmplFFT);
-    fftwf_free(product);
-    fftwf_free(result);
+    {
+        std::lock_guard<std::mutex> lock(g_fftwMutex);
+        fftwf_destroy_plan(planSig);
+        fftwf_destroy_plan(planTmpl);
+        fftwf_destroy_plan(planInv);
+    }
 
     return output;
 }
 
-std::vector<float> CorrelationEngine::selfCorrelate(
-    const std::complex<float>* signal,
+std::vector<float> CorrelationEngine::crossCorrelateReal(
+    const float* signal,
     size_t signalLen,
-    size_t tu,
-    size_t cpLen
+    const float* tmpl,
+    size_t tmplLen
 ) {
-    if (signalLen < tu + cpLen) return {};
+    size_t fftLen = nextPow2(signalLen + tmplLen - 1);
+    size_t bins = fftLen / 2 + 1;
+
+    // r2c spectra hold only the non-negative frequencies; the product of two
+    // real signals' spectra is conjugate-symmetric, so c2r recovers the
+    // real correlation from that half alone
+    PooledBuffer<float> sigIn(fftLen), tmplIn(fftLen), result(fftLen);
+    PooledBuffer<fftwf_complex> sigFFT(bins), tmplFFT(bins), product(bins);
+
+    std::memcpy(sigIn.data(), signal, sizeof(float) * signalLen);
+    std::memset(sigIn.data() + signalLen, 0, sizeof(float) * (fftLen - signalLen));
+    std::memcpy(tmplIn.data(), tmpl, sizeof(float) * tmplLen);
+    std::memset(tmplIn.data() + tmplLen, 0, sizeof(float) * (fftLen - tmplLen));
+
+    fftwf_plan planSig, planTmpl, planInv;
+    {
+        std::lock_guard<std::mutex> lock(g_fftwMutex);
+        planSig = fftwf_plan_dft_r2c_1d(fftLen, sigIn.data(), sigFFT.data(), FFTW_ESTIMATE);
+        planTmpl = fftwf_plan_dft_r2c_1d(fftLen, tmplIn.data(), tmplFFT.data(), FFTW_ESTIMATE);
+        planInv = fftwf_plan_dft_c2r_1d(fftLen, product.data(), result.data(), FFTW_ESTIMATE);
+    }
 
-    size_t outLen = signalLen - tu - cpLen + 1;
+    fftwf_execute(planSig);
+    fftwf_execute(planTmpl);
+
+    for (size_t i = 0; i < bins; i++) {
+        float sr = sigFFT[i][0], si = sigFFT[i][1];
+        float tr = tmplFFT[i][0], ti = -tmplFFT[i][1]; // conjugate
+        product[i][0] = sr * tr - si * ti;
+        product[i][1] = sr * ti + si * tr;
+    }
+
+    fftwf_execute(planInv);
+
+    float invN = 1.0f / fftLen;
+    std::vector<float> output = normalizeLags(signal, signalLen, tmpl, tmplLen, fftLen, [&](size_t i) {
+        return std::fabs(result[i] * invN);
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(g_fftwMutex);
+        fftwf_destroy_plan(planSig);
+        fftwf_destroy_plan(planTmpl);
+        fftwf_destroy_plan(planInv);
+    }
+
+    return output;
+}
+
+size_t CorrelationEngine::crossCorrelateBytes(size_t signalLen, size_t tmplLen, bool real) {
+    size_t fftLen = nextPow2(signalLen + tmplLen - 1);
+    size_t outLen = signalLen + tmplLen - 1;
+    size_t buffers = real ? 3 * fftLen * sizeof(float) + 3 * (fftLen / 2 + 1) * sizeof(fftwf_complex)
+                          : 6 * fftLen * sizeof(fftwf_complex);
+    // Output plus the cumulative energies normalizeLags keeps
+    return buffers + (outLen + signalLen + tmplLen + 2) * sizeof(float);
+}
+
+size_t CorrelationEngine::oneShotBytes(size_t signalLen, size_t tmplLen, bool real) {
+    size_t sampleBytes = real ? sizeof(float) : sizeof(std::complex<float>);
+    return (signalLen + tmplLen) * sampleBytes + crossCorrelateBytes(signalLen, tmplLen, real);
+}
+
+size_t CorrelationEngine::chunkedBytes(size_t signalLen, size_t tmplLen, bool real, size_t chunkLags) {
+    size_t sampleBytes = real ? sizeof(float) : sizeof(std::complex<float>);
+    size_t segment = chunkLags + tmplLen - 1;
+    return (tmplLen + segment) * sampleBytes + (signalLen + tmplLen) * sizeof(float) +
+           crossCorrelateBytes(segment, tmplLen, real);
+}
+
+size_t CorrelationEngine::chunkLagsWithin(size_t signalLen, size_t tmplLen, bool real,
+                                          size_t maxLags, size_t limit) {
+    size_t chunkLags = maxLags;
+    while (limit && chunkLags > tmplLen && chunkedBytes(signalLen, tmplLen, real, chunkLags) > limit) {
+        chunkLags /= 2;
+    }
+    return chunkLags;
+}
+
+namespace {
+
+// Correlate [from, to) of the signal for each chunk of output indices.
+// Output index i is lag k = i - (tmplLen - 1), which overlaps signal
+// samples [k, k + tmplLen); the chunk's segment holds all of those for
+// its lags, so their products and overlap energies match the one-shot
+// result. Segments are never shorter than the template, so the minimum
+// overlap normalizeLags applies is the same too.
+template <typename T, typename Read, typename Correlate>
+std::vector<float> correlateChunked(
+    const Read& read, size_t signalLen, const T* tmpl, size_t tmplLen,
+    size_t chunkLags, Correlate correlate
+) {
+    if (tmplLen == 0 || tmplLen > signalLen) {
+        throw std::runtime_error("Chunked correlation needs a template no longer than the signal");
+    }
+    chunkLags = std::max<size_t>(1, chunkLags);
+    const size_t outLen = signalLen + tmplLen - 1;
     std::vector<float> output(outLen);
+    std::vector<T> segment;
+
+    for (size_t i0 = 0; i0 < outLen; i0 += chunkLags) {
+        size_t i1 = std::min(outLen, i0 + chunkLags);
+        size_t to = std::min(signalLen, std::max(i1, tmplLen));
+        size_t from = i0 >= tmplLen - 1 ? i0 - (tmplLen - 1) : 0;
+        from = std::min(from, to - tmplLen);
+
+        segment.resize(to - from);
+        read(from, segment.size(), segment.data());
+        std::vector<float> part = correlate(segment.data(), segment.size(), tmpl, tmplLen);
+        std::copy(part.begin() + (i0 - from), part.begin() + (i1 - from), output.begin() + i0);
+    }
+    return output;
+}
+
+} // namespace
+
+std::vector<float> CorrelationEngine::crossCorrelateChunked(
+    const std::function<void(size_t, size_t, std::complex<float>*)>& read,
+    size_t signalLen,
+    const std::complex<float>* tmpl,
+    size_t tmplLen,
+    size_t chunkLags
+) {
+    return correlateChunked(read, signalLen, tmpl, tmplLen, chunkLags, &CorrelationEngine::crossCorrelate);
+}
+
+std::vector<float> CorrelationEngine::crossCorrelateRealChunked(
+    const std::function<void(size_t, size_t, float*)>& read,
+    size_t signalLen,
+    const float* tmpl,
+    size_t tmplLen,
+    size_t chunkLags
+) {
+    return correlateChunked(read, signalLen, tmpl, tmplLen, chunkLags, &CorrelationEngine::crossCorrelateReal);
+}
+
+namespace {
 
-    std::complex<float> currentProductSum(0, 0);
-    float currentEnergyA = 0;
-    float currentEnergyB = 0;
+const double Tau = 6.283185307179586;
+// Hypotheses per worker below which extra threads cost more than they save
+const size_t MIN_HYPOTHESES_PER_THREAD = 1;
 
-    // Initialize first window
+// Lag products x[i] conj(x[i + tu]) for every i with i + tu < signalLen
+void lagProducts(const std::complex<float>* signal, size_t signalLen, size_t tu,
+                 PooledBuffer<std::complex<float>>& products) {
+    products = PooledBuffer<std::complex<float>>(signalLen - tu);
+    for (size_t i = 0; i + tu < signalLen; i++) {
+        products[i] = signal[i] * std::conj(signal[i + tu]);
+    }
+}
+
+// Slide a cpLen-sample window over the lag products and energies and call
+// fn(d, productSum, metric) for each of the outLen window starts d, where
+// metric = |productSum| / sqrt(E[d, d + cpLen) E[d + tu, d + tu + cpLen)).
+// The sums run in double so long windows do not drift.
+template <typename Fn>
+void slideCpCorrelation(const std::complex<float>* products, const float* energies,
+                        size_t tu, size_t cpLen, size_t outLen, Fn&& fn) {
+    std::complex<double> productSum(0.0, 0.0);
+    double energyA = 0.0, energyB = 0.0;
     for (size_t i = 0; i < cpLen; i++) {
-        currentProductSum += signal[i] * std::conj(signal[i + tu]);
-        currentEnergyA += std::norm(signal[i]);
-        currentEnergyB += std::norm(signal[i + tu]);
+        productSum += std::complex<double>(products[i]);
+        energyA += energies[i];
+        energyB += energies[i + tu];
+    }
+    for (size_t d = 0; ; d++) {
+        double den = std::sqrt(energyA * energyB);
+        float metric = den > 1e-12 ? static_cast<float>(std::abs(productSum) / den) : 0.0f;
+        fn(d, productSum, metric);
+        if (d + 1 >= outLen) break;
+
+        size_t oldIdx = d;
+        size_t newIdx = d + cpLen;
+        productSum += std::complex<double>(products[newIdx]) - std::complex<double>(products[oldIdx]);
+        energyA += static_cast<double>(energies[newIdx]) - energies[oldIdx];
+        energyB += static_cast<double>(energies[newIdx + tu]) - energies[oldIdx + tu];
     }
+}
 
-    auto getMag = [&](const std::complex<float>& ps, float ea, float eb) {
-        float den = std::sqrt(ea * eb);
-        if (den > 1e-12f) return std::abs(ps) / den;
-        return 0.0f;
-    };
+} // namespace
 
-    output[0] = getMag(currentProductSum, currentEnergyA, currentEnergyB);
+std::vector<float> CorrelationEngine::selfCorrelate(
+    const std::complex<float>* signal,
+    size_t signalLen,
+    size_t tu,
+    size_t cpLen
+) {
+    if (signalLen < tu + cpLen) return {};
 
-    // Slide window
-    for (size_t j = 1; j < outLen; j++) {
-        size_t oldIdx = j - 1;
-        size_t newIdx = j + cpLen - 1;
+    size_t outLen = signalLen - tu - cpLen + 1;
+    std::vector<float> output(outLen);
 
-        currentProductSum -= signal[oldIdx] * std::conj(signal[oldIdx + tu]);
-        currentProductSum += signal[newIdx] * std::conj(signal[newIdx + tu]);
+    PooledBuffer<std::complex<float>> products;
+    lagProducts(signal, signalLen, tu, products);
+    PooledBuffer<float> energies(signalLen);
+    for (size_t i = 0; i < signalLen; i++) energies[i] = std::norm(signal[i]);
 
-        currentEnergyA -= std::norm(signal[oldIdx]);
-        currentEnergyA += std::norm(signal[newIdx]);
+    slideCpCorrelation(products.data(), energies.data(), tu, cpLen, outLen,
+        [&](size_t d, const std::complex<double>&, float metric) { output[d] = metric; });
 
-        currentEnergyB -= std::norm(signal[oldIdx + tu]);
-        currentEnergyB += std::norm(signal[newIdx + tu]);
+    return output;
+}
 
-        output[j] = getMag(currentProductSum, currentEnergyA, currentEnergyB);
+std::vector<OfdmCandidate> CorrelationEngine::searchOfdm(
+    const std::complex<float>* signal,
+    size_t signalLen,
+    std::vector<OfdmHypothesis> grid
+) {
+    for (auto& h : grid) {
+        if (h.tu == 0 || h.cpLen == 0) throw std::runtime_error("Invalid OFDM hypothesis");
     }
+    // Drop what does not fit, and sort by Tu so each worker's contiguous
+    // slice rebuilds the lag products only when Tu changes
+    grid.erase(std::remove_if(grid.begin(), grid.end(), [&](const OfdmHypothesis& h) {
+        return h.tu + h.cpLen > signalLen;
+    }), grid.end());
+    std::sort(grid.begin(), grid.end(), [](const OfdmHypothesis& a, const OfdmHypothesis& b) {
+        return a.tu != b.tu ? a.tu < b.tu : a.cpLen < b.cpLen;
+    });
+    if (grid.empty()) return {};
+
+    PooledBuffer<float> energies(signalLen);
+    for (size_t i = 0; i < signalLen; i++) energies[i] = std::norm(signal[i]);
+
+    std::vector<OfdmCandidate> candidates(grid.size());
+    unsigned workers = parallelWorkers(grid.size(), MIN_HYPOTHESES_PER_THREAD);
+    parallelFor(grid.size(), workers, [&](size_t first, size_t last, unsigned) {
+        PooledBuffer<std::complex<float>> products;
+        std::vector<double> folded;
+        std::vector<std::complex<double>> foldedSums;
+        std::vector<size_t> counts;
+        size_t productsTu = 0;
+
+        for (size_t h = first; h < last; h++) {
+            const size_t tu = grid[h].tu;
+            const size_t cpLen = grid[h].cpLen;
+            if (tu != productsTu) {
+                lagProducts(signal, signalLen, tu, products);
+                productsTu = tu;
+            }
+
+            // Fold the metric and the product sums at the symbol period
+            const size_t outLen = signalLen - tu - cpLen + 1;
+            const size_t period = std::min(tu + cpLen, outLen);
+            folded.assign(period, 0.0);
+            foldedSums.assign(period, std::complex<double>(0.0, 0.0));
+            counts.assign(period, 0);
+            float peak = 0.0f;
+            size_t phase = 0;
+            slideCpCorrelation(products.data(), energies.data(), tu, cpLen, outLen,
+                [&](size_t, const std::complex<double>& productSum, float metric) {
+                    folded[phase] += metric;
+                    foldedSums[phase] += productSum;
+                    counts[phase]++;
+                    peak = std::max(peak, metric);
+                    if (++phase == period) phase = 0;
+                });
+
+            OfdmCandidate& c = candidates[h];
+            c.tu = tu;
+            c.cpLen = cpLen;
+            c.peak = peak;
+            for (size_t p = 0; p < period; p++) {
+                float score = static_cast<float>(folded[p] / counts[p]);
+                if (score > c.score) {
+                    c.score = score;
+                    c.timing = p;
+                }
+            }
+            c.symbols = counts[c.timing];
+            // x[i] conj(x[i + Tu]) turns as exp(-j 2 pi cfo Tu)
+            c.cfo = -std::arg(foldedSums[c.timing]) / (Tau * tu);
+        }
+    });
 
-    return output;
+    std::stable_sort(candidates.begin(), candidates.end(), [](const OfdmCandidate& a, const OfdmCandidate& b) {
+        return a.score > b.score;
+    });
+    return candidates;
 }
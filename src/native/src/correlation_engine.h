@@ -1,8 +1,26 @@
 #pragma once
 
 #include <complex>
+#include <functional>
 #include <vector>
 
+// One OFDM numerology to test: useful symbol length and cyclic prefix, in
+// samples
+struct OfdmHypothesis {
+    size_t tu = 0;
+    size_t cpLen = 0;
+};
+
+struct OfdmCandidate {
+    size_t tu = 0;
+    size_t cpLen = 0;
+    size_t timing = 0;    // first symbol (CP) start, samples into the signal
+    size_t symbols = 0;   // symbol periods averaged
+    float score = 0.0f;   // CP correlation averaged at the symbol rate, 0..1
+    float peak = 0.0f;    // highest single CP correlation, 0..1
+    double cfo = 0.0;     // fractional carrier offset, cycles/sample
+};
+
 class CorrelationEngine {
 public:
     // FFT-based cross-correlation: xcorr = IFFT(FFT(signal) * conj(FFT(template)))
@@ -14,6 +32,49 @@ public:
         size_t tmplLen
     );
 
+    // crossCorrelate for real signals, with r2c/c2r transforms of half the
+    // size; same output
+    static std::vector<float> crossCorrelateReal(
+        const float* signal,
+        size_t signalLen,
+        const float* tmpl,
+        size_t tmplLen
+    );
+
+    // Working memory of crossCorrelate (or crossCorrelateReal when real),
+    // output included, inputs not
+    static size_t crossCorrelateBytes(size_t signalLen, size_t tmplLen, bool real);
+    // crossCorrelateBytes plus both inputs: what a one-shot correlation holds
+    static size_t oneShotBytes(size_t signalLen, size_t tmplLen, bool real);
+    // Working memory of the chunked correlation with chunkLags per chunk:
+    // the template, one signal segment and its transforms, and the output
+    static size_t chunkedBytes(size_t signalLen, size_t tmplLen, bool real, size_t chunkLags);
+    // chunkLags for the chunked correlation: maxLags, halved while its
+    // chunkedBytes exceed limit (0 = unlimited) but not below tmplLen
+    static size_t chunkLagsWithin(size_t signalLen, size_t tmplLen, bool real,
+                                  size_t maxLags, size_t limit);
+
+    // crossCorrelate for a signal too long to transform with its FFT
+    // buffers in memory: read(start, count, dest) fetches signal samples
+    // and the output is computed chunkLags lags at a time, each from just
+    // the samples those lags overlap. Same output as crossCorrelate; needs
+    // tmplLen <= signalLen.
+    static std::vector<float> crossCorrelateChunked(
+        const std::function<void(size_t, size_t, std::complex<float>*)>& read,
+        size_t signalLen,
+        const std::complex<float>* tmpl,
+        size_t tmplLen,
+        size_t chunkLags
+    );
+
+    static std::vector<float> crossCorrelateRealChunked(
+        const std::function<void(size_t, size_t, float*)>& read,
+        size_t signalLen,
+        const float* tmpl,
+        size_t tmplLen,
+        size_t chunkLags
+    );
+
     // CP Self-correlation (Poor man's Schmidl & Cox)
     static std::vector<float> selfCorrelate(
         const std::complex<float>* signal,
@@ -22,6 +83,20 @@ public:
         size_t cpLen
     );
 
+    // Blind OFDM numerology search: the CP self-correlation of every
+    // hypothesis in one pass over the signal. Each metric is folded at its
+    // symbol period Tu + CP, so only the true numerology averages up
+    // coherently (a shorter CP with the right Tu still peaks, but smears
+    // when folded). Hypotheses are split across threads in Tu order and
+    // share the per-Tu lag products and the signal energies. Returns the
+    // hypotheses that fit in the signal, best score first. The CFO is only
+    // known modulo 1 / Tu. Throws std::runtime_error for a zero Tu or CP.
+    static std::vector<OfdmCandidate> searchOfdm(
+        const std::complex<float>* signal,
+        size_t signalLen,
+        std::vector<OfdmHypothesis> grid
+    );
+
 private:
     static size_t nextPow2(size_t n);
 };
@@ -0,0 +1,157 @@
+#include "cross_spectrum_engine.h"
+#include "format_traits.h"
+#include "parallel.h"
+#include "perf_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <string>
+
+// Segments per worker below which extra threads cost more than they save
+static const size_t MIN_SEGMENTS_PER_THREAD = 64;
+// Segments of read-ahead hinted to the backend at a time
+static const size_t PREFETCH_SEGMENTS = 64;
+
+CrossSpectrumResult CrossSpectrumEngine::compute(
+    const InputSource& source,
+    size_t start, size_t end,
+    int fftSize,
+    double overlap,
+    WindowType window,
+    std::vector<std::pair<unsigned, unsigned>> pairs
+) {
+    const size_t channels = source.channels();
+    if (channels < 2) {
+        throw std::runtime_error("Cross spectrum needs a multi-channel file");
+    }
+    if (fftSize <= 0) {
+        throw std::runtime_error("Invalid FFT size");
+    }
+    if (pairs.empty()) {
+        for (unsigned a = 0; a < channels; a++) {
+            for (unsigned b = a + 1; b < channels; b++) pairs.emplace_back(a, b);
+        }
+    }
+    for (auto& p : pairs) {
+        if (p.first >= channels || p.second >= channels) {
+            throw std::runtime_error("Channel out of range: " + std::to_string(std::max(p.first, p.second)));
+        }
+    }
+    end = std::min({end, source.totalSamples(), source.nextCaptureStart(start)});
+    if (start >= end) {
+        throw std::runtime_error("Empty cross spectrum range");
+    }
+
+    const size_t n = fftSize;
+    overlap = std::min(std::max(overlap, 0.0), 0.99);
+    const size_t step = std::max<size_t>(1, static_cast<size_t>(n * (1.0 - overlap)));
+    const size_t length = end - start;
+    const size_t segments = length <= n ? 1 : (length - n) / step + 1;
+    const size_t bins = source.isComplex() ? n : n / 2;
+
+    // Only the channels some pair names are transformed; slot[c] indexes
+    // their spectra and auto-spectrum accumulators
+    std::vector<int> slot(channels, -1);
+    std::vector<unsigned> used;
+    for (auto& p : pairs) {
+        for (unsigned c : {p.first, p.second}) {
+            if (slot[c] < 0) {
+                slot[c] = static_cast<int>(used.size());
+                used.push_back(c);
+            }
+        }
+    }
+
+    unsigned workers = parallelWorkers(segments, MIN_SEGMENTS_PER_THREAD);
+    // Per worker: auto spectra |X_c|^2 and cross spectra X_a conj(X_b)
+    std::vector<std::vector<double>> autos(workers);
+    std::vector<std::vector<std::complex<double>>> crosses(workers);
+
+    dispatchFormat(source.format(), [&](auto traits) {
+        using Traits = decltype(traits);
+        parallelFor(segments, workers, [&](size_t first, size_t last, unsigned w) {
+            typename Traits::Engine fft(fftSize, window);
+            std::vector<uint8_t> staging;
+            std::vector<std::complex<float>> spectra(used.size() * bins);
+            auto& autoAcc = autos[w];
+            auto& crossAcc = crosses[w];
+            autoAcc.assign(used.size() * bins, 0.0);
+            crossAcc.assign(pairs.size() * bins, std::complex<double>(0.0, 0.0));
+
+            for (size_t seg = first; seg < last; seg++) {
+                size_t offset = start + seg * step;
+                if ((seg - first) % PREFETCH_SEGMENTS == 0) {
+                    size_t ahead = std::min(last - seg, PREFETCH_SEGMENTS);
+                    source.prefetch(offset, (ahead - 1) * step + n);
+                }
+
+                size_t valid = std::min(n, end - offset);
+                const void* raw;
+                {
+                    PerfScope perf(PerfStage::Read, valid * source.frameSize());
+                    raw = source.rawSamples(offset, valid, staging);
+                }
+                for (size_t s = 0; s < used.size(); s++) {
+                    Traits::loadWindowed(Traits::channelData(raw, used[s]), valid, fft.window(),
+                                         fft.input(), n, channels);
+                    const fftwf_complex* out = fft.executeSpectrum();
+                    std::complex<float>* x = spectra.data() + s * bins;
+                    double* acc = autoAcc.data() + s * bins;
+                    for (size_t i = 0; i < bins; i++) {
+                        x[i] = std::complex<float>(out[i][0], out[i][1]);
+                        acc[i] += std::norm(x[i]);
+                    }
+                }
+                for (size_t p = 0; p < pairs.size(); p++) {
+                    const std::complex<float>* xa = spectra.data() + slot[pairs[p].first] * bins;
+                    const std::complex<float>* xb = spectra.data() + slot[pairs[p].second] * bins;
+                    std::complex<double>* acc = crossAcc.data() + p * bins;
+                    for (size_t i = 0; i < bins; i++) {
+                        acc[i] += std::complex<double>(xa[i] * std::conj(xb[i]));
+                    }
+                }
+            }
+        });
+    });
+
+    // Reduce the per-worker accumulators. Complex spectra come out of the
+    // FFT DC first and are DC-centered here, as the PSD does.
+    CrossSpectrumResult result;
+    result.segments = segments;
+    result.end = end;
+    result.centerFrequency = source.captureAt(start).frequency;
+    const size_t half = n / 2;
+    const double norm = 1.0 / (static_cast<double>(n) * n * segments);
+    const float logMultiplier = 10.0f / log2f(10.0f);
+    for (size_t p = 0; p < pairs.size(); p++) {
+        CrossSpectrumPair pair;
+        pair.a = pairs[p].first;
+        pair.b = pairs[p].second;
+        pair.magnitude.resize(bins);
+        pair.phase.resize(bins);
+        pair.coherence.resize(bins);
+        const size_t sa = slot[pair.a] * bins;
+        const size_t sb = slot[pair.b] * bins;
+        for (size_t i = 0; i < bins; i++) {
+            size_t k = bins == n ? (i + n - half) % n : i;
+            std::complex<double> sxy(0.0, 0.0);
+            double sxx = 0.0, syy = 0.0;
+            for (unsigned w = 0; w < workers; w++) {
+                sxy += crosses[w][p * bins + k];
+                sxx += autos[w][sa + k];
+                syy += autos[w][sb + k];
+            }
+            float magnitude = static_cast<float>(std::abs(sxy) * norm);
+            // Avoid log of zero
+            if (magnitude < 1e-20f) magnitude = 1e-20f;
+            pair.magnitude[i] = log2f(magnitude) * logMultiplier;
+            pair.phase[i] = static_cast<float>(std::arg(sxy));
+            double den = sxx * syy;
+            pair.coherence[i] = den > 0.0 ? static_cast<float>(std::norm(sxy) / den) : 0.0f;
+        }
+        result.pairs.push_back(std::move(pair));
+    }
+    return result;
+}
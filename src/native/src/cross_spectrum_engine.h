@@ -0,0 +1,43 @@
+#pragma once
+
+#include "input_source.h"
+#include "fft_engine.h"
+
+#include <utility>
+#include <vector>
+
+struct CrossSpectrumPair {
+    unsigned a = 0;
+    unsigned b = 0;
+    // Per bin, laid out like PSDResult::spectrum
+    std::vector<float> magnitude;  // |CSD| in dB, same scale as the PSD
+    std::vector<float> phase;      // arg CSD: phase of a relative to b, radians
+    std::vector<float> coherence;  // magnitude-squared coherence, 0..1
+};
+
+struct CrossSpectrumResult {
+    std::vector<CrossSpectrumPair> pairs;
+    size_t segments = 0;
+    size_t end = 0;               // end of the samples actually used
+    double centerFrequency = 0;   // tuning of the capture they came from
+};
+
+// Cross-spectral density between channels of an interleaved file, Welch
+// style like PSDEngine. Every segment is read once as whole frames and
+// each channel it needs is de-interleaved, windowed and transformed from
+// that read, so all pairs cost one pass over the file. Segments are split
+// across cores with per-worker accumulators.
+class CrossSpectrumEngine {
+public:
+    // Pairs of channel indices; empty means every pair a < b. Throws
+    // std::runtime_error for a single-channel file, a channel out of range
+    // or an empty range.
+    static CrossSpectrumResult compute(
+        const InputSource& source,
+        size_t start, size_t end,
+        int fftSize,
+        double overlap,
+        WindowType window,
+        std::vector<std::pair<unsigned, unsigned>> pairs
+    );
+};
@@ -0,0 +1,142 @@
+#include "data_backend.h"
+#include "async_read_backend.h"
+#include "compressed_backend.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/vfs.h>
+#else
+#include <sys/mount.h>
+#include <sys/param.h>
+#endif
+
+// ── MmapBackend ───────────────────────────────────────────────────
+
+MmapBackend::MmapBackend(const std::string& path) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) < 0) {
+        ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error("Failed to stat file: " + path);
+    }
+    size_t size = st.st_size;
+
+    // An empty file is still valid: a recording that has just started
+    // is mapped on the first refresh() that sees data
+    if (size == 0) return;
+
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data == MAP_FAILED) {
+        ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error("Failed to mmap file: " + path);
+    }
+    mappings_.push_back({data, size});
+    data_.store(data);
+    size_.store(size);
+}
+
+MmapBackend::~MmapBackend() {
+    for (auto& m : mappings_) {
+        munmap(m.data, m.size);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+const void* MmapBackend::span(size_t offset, size_t length) const {
+    if (offset + length > size()) return nullptr;
+    return static_cast<const uint8_t*>(data_.load(std::memory_order_acquire)) + offset;
+}
+
+void MmapBackend::read(size_t offset, size_t length, void* dest) const {
+    const void* src = span(offset, length);
+    if (!src) {
+        throw std::runtime_error("Read beyond end of file");
+    }
+    std::memcpy(dest, src, length);
+}
+
+void MmapBackend::prefetch(size_t offset, size_t length) const {
+    size_t total = size();
+    if (offset >= total || length == 0) return;
+    length = std::min(length, total - offset);
+
+    // madvise needs a page-aligned start
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t aligned = offset & ~(pageSize - 1);
+    auto base = static_cast<uint8_t*>(data_.load(std::memory_order_acquire));
+    madvise(base + aligned, length + (offset - aligned), MADV_WILLNEED);
+}
+
+size_t MmapBackend::refresh() {
+    std::lock_guard<std::mutex> lock(remapMutex_);
+
+    struct stat st;
+    if (fstat(fd_, &st) < 0 || static_cast<size_t>(st.st_size) <= size()) {
+        return size();
+    }
+
+    size_t newSize = st.st_size;
+    void* data = mmap(nullptr, newSize, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data == MAP_FAILED) {
+        return size();
+    }
+    mappings_.push_back({data, newSize});
+
+    // Publish the pointer before the size so a reader that sees the new
+    // size always dereferences the mapping that covers it
+    data_.store(data, std::memory_order_release);
+    size_.store(newSize, std::memory_order_release);
+    return newSize;
+}
+
+// ── Backend selection ─────────────────────────────────────────────
+
+bool isNetworkFilesystem(const std::string& path) {
+    struct statfs fs;
+    if (statfs(path.c_str(), &fs) != 0) return false;
+
+#ifdef __linux__
+    switch (static_cast<unsigned long>(fs.f_type)) {
+        case 0x6969UL:      // NFS
+        case 0x517BUL:      // SMB
+        case 0xFF534D42UL:  // CIFS
+        case 0xFE534D42UL:  // SMB2
+            return true;
+        default:
+            return false;
+    }
+#else
+    return std::strcmp(fs.f_fstypename, "nfs") == 0 ||
+           std::strcmp(fs.f_fstypename, "smbfs") == 0;
+#endif
+}
+
+std::unique_ptr<DataBackend> createBackend(const std::string& path, const BackendOptions& options) {
+    // Compressed archives have a single access path regardless of kind
+    if (isCompressedPath(path)) return std::make_unique<CompressedBackend>(path, options);
+    if (options.kind == "mmap") return std::make_unique<MmapBackend>(path);
+    if (options.kind == "async") return std::make_unique<AsyncReadBackend>(path, options);
+    if (options.kind != "auto") {
+        throw std::runtime_error("Unknown I/O backend: " + options.kind);
+    }
+    if (isNetworkFilesystem(path)) {
+        return std::make_unique<AsyncReadBackend>(path, options);
+    }
+    return std::make_unique<MmapBackend>(path);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// How a data file should be read. Chosen per file at open time.
+struct BackendOptions {
+    std::string kind = "auto";      // "auto", "mmap" or "async"
+    unsigned queueDepth = 32;       // max reads in flight (async only)
+    size_t blockSize = 1 << 20;     // bytes per cached block (async only)
+    size_t cacheBytes = 256 << 20;  // block cache budget (async only)
+    std::vector<std::string> segments;  // further data files appended in order
+    unsigned channels = 0;          // interleaved channels; 0 = core:num_channels, else 1
+};
+
+// Raw byte access to a data file. InputSource layers a SampleAdapter on top.
+class DataBackend {
+public:
+    virtual ~DataBackend() = default;
+
+    virtual const char* name() const = 0;
+    virtual size_t size() const = 0;
+
+    // Pointer to bytes [offset, offset + length) when they are contiguous
+    // in memory, nullptr when the caller must go through read()
+    virtual const void* span(size_t /*offset*/, size_t /*length*/) const { return nullptr; }
+
+    // Copy bytes [offset, offset + length) into dest.
+    // Throws std::runtime_error on I/O failure instead of faulting.
+    virtual void read(size_t offset, size_t length, void* dest) const = 0;
+
+    // Hint that [offset, offset + length) will be read soon. Never blocks.
+    virtual void prefetch(size_t /*offset*/, size_t /*length*/) const {}
+
+    // Pick up data appended since open (still-recording files); returns the new size.
+    // Safe to call while other threads read.
+    virtual size_t refresh() { return size(); }
+};
+
+// Whole-file mmap. Fastest on local disks, but a vanished network server
+// surfaces as SIGBUS on the faulting thread.
+class MmapBackend : public DataBackend {
+public:
+    explicit MmapBackend(const std::string& path);
+    ~MmapBackend() override;
+
+    const char* name() const override { return "mmap"; }
+    size_t size() const override { return size_.load(std::memory_order_acquire); }
+    const void* span(size_t offset, size_t length) const override;
+    void read(size_t offset, size_t length, void* dest) const override;
+    void prefetch(size_t offset, size_t length) const override;
+    size_t refresh() override;
+
+private:
+    struct Mapping {
+        void* data;
+        size_t size;
+    };
+
+    int fd_ = -1;
+    // Growth maps the file again rather than moving the old mapping, so
+    // readers holding the previous pointer stay valid until close
+    std::atomic<void*> data_{nullptr};
+    std::atomic<size_t> size_{0};
+    std::mutex remapMutex_;
+    std::vector<Mapping> mappings_;
+};
+
+// True when path lives on NFS or SMB/CIFS
+bool isNetworkFilesystem(const std::string& path);
+
+// Factory function. "auto" picks async for network mounts and mmap otherwise;
+// .zst archives always use the compressed backend.
+std::unique_ptr<DataBackend> createBackend(const std::string& path, const BackendOptions& options);
@@ -1,6 +1,10 @@
 #include "fft_engine.h"
+#include "perf_stats.h"
+#include "buffer_pool.h"
 #include <cmath>
 #include <cstring>
+#include <stdexcept>
+#include <string>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -10,51 +14,244 @@ static const double Tau = M_PI * 2.0;
 
 std::mutex g_fftwMutex;
 
-FFTEngine::FFTEngine(int fftSize) : fftSize_(fftSize) {
-    std::lock_guard<std::mutex> lock(g_fftwMutex);
-    fftwIn_ = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * fftSize_);
-    fftwOut_ = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * fftSize_);
-    plan_ = fftwf_plan_dft_1d(fftSize_, fftwIn_, fftwOut_, FFTW_FORWARD, FFTW_ESTIMATE);
-    generateWindow();
+WindowType windowTypeFromName(const std::string& name) {
+    if (name.empty() || name == "hann") return WindowType::Hann;
+    if (name == "hamming") return WindowType::Hamming;
+    if (name == "blackman") return WindowType::Blackman;
+    if (name == "blackman-harris") return WindowType::BlackmanHarris;
+    if (name == "flattop") return WindowType::FlatTop;
+    if (name == "rectangular") return WindowType::Rectangular;
+    throw std::runtime_error("Unknown window: " + name);
+}
+
+// Generalized cosine windows: sum of a[j] * cos(2*pi*j*i / (N-1))
+static std::vector<float> makeWindow(WindowType type, int n) {
+    static const double hann[] = {0.5, -0.5};
+    static const double hamming[] = {0.54, -0.46};
+    static const double blackman[] = {0.42, -0.5, 0.08};
+    static const double blackmanHarris[] = {0.35875, -0.48829, 0.14128, -0.01168};
+    static const double flatTop[] = {0.21557895, -0.41663158, 0.277263158, -0.083578947, 0.006947368};
+    static const double rectangular[] = {1.0};
+
+    const double* coeffs = hann;
+    int terms = 2;
+    switch (type) {
+        case WindowType::Hann: break;
+        case WindowType::Hamming: coeffs = hamming; terms = 2; break;
+        case WindowType::Blackman: coeffs = blackman; terms = 3; break;
+        case WindowType::BlackmanHarris: coeffs = blackmanHarris; terms = 4; break;
+        case WindowType::FlatTop: coeffs = flatTop; terms = 5; break;
+        case WindowType::Rectangular: coeffs = rectangular; terms = 1; break;
+    }
+
+    std::vector<float> window(n);
+    for (int i = 0; i < n; i++) {
+        double w = 0.0;
+        for (int j = 0; j < terms; j++) {
+            w += coeffs[j] * cos(Tau * j * i / (n - 1));
+        }
+        window[i] = static_cast<float>(w);
+    }
+    return window;
+}
+
+static std::runtime_error planFailed(int fftSize) {
+    return std::runtime_error("FFTW could not plan a transform of size " + std::to_string(fftSize));
+}
+
+// FFT buffers come from BufferPool, so engines built per tile or per
+// worker reuse memory that is already mapped. They are held as members,
+// so an acquire that hits the pool limit, or a plan that fails, releases
+// whatever was taken before it.
+FFTEngine::FFTEngine(int fftSize, WindowType window)
+    : fftSize_(fftSize), window_(makeWindow(window, fftSize)), in_(fftSize), out_(fftSize) {
+    fftwIn_ = in_.data();
+    fftwOut_ = out_.data();
+    {
+        std::lock_guard<std::mutex> lock(g_fftwMutex);
+        plan_ = fftwf_plan_dft_1d(fftSize_, fftwIn_, fftwOut_, FFTW_FORWARD, FFTW_ESTIMATE);
+    }
+    if (!plan_) throw planFailed(fftSize_);
 }
 
 FFTEngine::~FFTEngine() {
     std::lock_guard<std::mutex> lock(g_fftwMutex);
     if (plan_) fftwf_destroy_plan(plan_);
-    if (fftwIn_) fftwf_free(fftwIn_);
-    if (fftwOut_) fftwf_free(fftwOut_);
 }
 
-void FFTEngine::generateWindow() {
-    // Hann window: 0.5 * (1 - cos(2*pi*i / (N-1)))
-    window_.resize(fftSize_);
-    for (int i = 0; i < fftSize_; i++) {
-        window_[i] = 0.5f * (1.0f - cosf(static_cast<float>(Tau * i / (fftSize_ - 1))));
+RealFFTEngine::RealFFTEngine(int fftSize, WindowType window)
+    : fftSize_(fftSize), window_(makeWindow(window, fftSize)), in_(fftSize), out_(fftSize / 2 + 1) {
+    fftwIn_ = in_.data();
+    fftwOut_ = out_.data();
+    {
+        std::lock_guard<std::mutex> lock(g_fftwMutex);
+        plan_ = fftwf_plan_dft_r2c_1d(fftSize_, fftwIn_, fftwOut_, FFTW_ESTIMATE);
+    }
+    if (!plan_) throw planFailed(fftSize_);
+}
+
+RealFFTEngine::~RealFFTEngine() {
+    std::lock_guard<std::mutex> lock(g_fftwMutex);
+    if (plan_) fftwf_destroy_plan(plan_);
+}
+
+// Power-of-two sizes get their own instantiation, so the DC-centering
+// mask, the normalization and the dB offset are compile-time constants
+// and the loops have a fixed trip count. N = 0 is the runtime fallback.
+// Real finishers read the r2c half spectrum, already in DC-up order.
+namespace {
+
+constexpr int log2Exact(int n) {
+    int bits = 0;
+    while (n > 1) {
+        n >>= 1;
+        bits++;
+    }
+    return bits;
+}
+
+template <int N, bool Real>
+void finishLinear(const fftwf_complex* out, float* output, int n) {
+    const int size = N ? N : n;
+    const int half = size >> 1;
+    const int count = Real ? half : size;
+    const float norm = 1.0f / (static_cast<float>(size) * static_cast<float>(size));
+    for (int i = 0; i < count; i++) {
+        // DC-center rearrangement; the xor only holds for powers of two
+        int k = Real ? i : N ? i ^ half : (i + size - half) % size;
+        output[i] = (out[k][0] * out[k][0] + out[k][1] * out[k][1]) * norm;
+    }
+}
+
+// 10*log10(|X|^2 / N^2) as log2(|X|^2) * 10/log2(10) - 20*log10(N), with
+// the 1e-20 floor applied to the normalized power as before
+template <int N, bool Real>
+void finishDb(const fftwf_complex* out, float* output, int n) {
+    const int size = N ? N : n;
+    const int half = size >> 1;
+    const int count = Real ? half : size;
+    const float logMultiplier = 10.0f / 3.321928094887362f;  // 10 / log2(10)
+    const float sizeSq = static_cast<float>(size) * static_cast<float>(size);
+    const float offset = N ? 20.0f * 0.3010299956639812f * log2Exact(N)
+                           : 20.0f * std::log10(static_cast<float>(size));
+    const float floor = 1e-20f * sizeSq;
+    for (int i = 0; i < count; i++) {
+        int k = Real ? i : N ? i ^ half : (i + size - half) % size;
+        float p = out[k][0] * out[k][0] + out[k][1] * out[k][1];
+        output[i] = log2f(p < floor ? floor : p) * logMultiplier - offset;
+    }
+}
+
+using Finisher = void (*)(const fftwf_complex*, float*, int);
+
+template <template <int> class Pick>
+Finisher pickFinisher(int n) {
+    switch (n) {
+        case 16: return Pick<16>::fn;
+        case 32: return Pick<32>::fn;
+        case 64: return Pick<64>::fn;
+        case 128: return Pick<128>::fn;
+        case 256: return Pick<256>::fn;
+        case 512: return Pick<512>::fn;
+        case 1024: return Pick<1024>::fn;
+        case 2048: return Pick<2048>::fn;
+        case 4096: return Pick<4096>::fn;
+        case 8192: return Pick<8192>::fn;
+        case 16384: return Pick<16384>::fn;
+        case 32768: return Pick<32768>::fn;
+        case 65536: return Pick<65536>::fn;
+        default: return Pick<0>::fn;
+    }
+}
+
+template <int N> struct LinearFinisher { static constexpr Finisher fn = finishLinear<N, false>; };
+template <int N> struct DbFinisher { static constexpr Finisher fn = finishDb<N, false>; };
+template <int N> struct RealLinearFinisher { static constexpr Finisher fn = finishLinear<N, true>; };
+template <int N> struct RealDbFinisher { static constexpr Finisher fn = finishDb<N, true>; };
+
+} // namespace
+
+void FFTEngine::executeLinearPower(float* output) {
+    {
+        PerfScope perf(PerfStage::FFT);
+        fftwf_execute(plan_);
+    }
+    pickFinisher<LinearFinisher>(fftSize_)(fftwOut_, output, fftSize_);
+}
+
+void FFTEngine::executePowerSpectrum(float* output) {
+    {
+        PerfScope perf(PerfStage::FFT);
+        fftwf_execute(plan_);
     }
+    PerfScope perf(PerfStage::Log);
+    pickFinisher<DbFinisher>(fftSize_)(fftwOut_, output, fftSize_);
+}
+
+const fftwf_complex* FFTEngine::executeSpectrum() {
+    PerfScope perf(PerfStage::FFT);
+    fftwf_execute(plan_);
+    return fftwOut_;
+}
+
+void FFTEngine::computeLinearPower(const std::complex<float>* input, float* output) {
+    // Apply window and copy to FFTW input
+    {
+        PerfScope perf(PerfStage::Window);
+        for (int i = 0; i < fftSize_; i++) {
+            fftwIn_[i][0] = input[i].real() * window_[i];
+            fftwIn_[i][1] = input[i].imag() * window_[i];
+        }
+    }
+    executeLinearPower(output);
 }
 
 void FFTEngine::computePowerSpectrum(const std::complex<float>* input, float* output) {
-    // Apply Hann window and copy to FFTW input
-    for (int i = 0; i < fftSize_; i++) {
-        fftwIn_[i][0] = input[i].real() * window_[i];
-        fftwIn_[i][1] = input[i].imag() * window_[i];
+    {
+        PerfScope perf(PerfStage::Window);
+        for (int i = 0; i < fftSize_; i++) {
+            fftwIn_[i][0] = input[i].real() * window_[i];
+            fftwIn_[i][1] = input[i].imag() * window_[i];
+        }
     }
+    executePowerSpectrum(output);
+}
+
+void RealFFTEngine::executeLinearPower(float* output) {
+    {
+        PerfScope perf(PerfStage::FFT);
+        fftwf_execute(plan_);
+    }
+    pickFinisher<RealLinearFinisher>(fftSize_)(fftwOut_, output, fftSize_);
+}
 
-    // Execute FFT
+void RealFFTEngine::executePowerSpectrum(float* output) {
+    {
+        PerfScope perf(PerfStage::FFT);
+        fftwf_execute(plan_);
+    }
+    PerfScope perf(PerfStage::Log);
+    pickFinisher<RealDbFinisher>(fftSize_)(fftwOut_, output, fftSize_);
+}
+
+const fftwf_complex* RealFFTEngine::executeSpectrum() {
+    PerfScope perf(PerfStage::FFT);
     fftwf_execute(plan_);
+    return fftwOut_;
+}
 
-    // Compute log power with DC centering
-    // k = i ^ (fftSize >> 1) rearranges so DC is in the center
-    const float invFFTSize = 1.0f / fftSize_;
-    const float logMultiplier = 10.0f / log2f(10.0f);
+void RealFFTEngine::computeLinearPower(const float* input, float* output) {
+    {
+        PerfScope perf(PerfStage::Window);
+        for (int i = 0; i < fftSize_; i++) fftwIn_[i] = input[i] * window_[i];
+    }
+    executeLinearPower(output);
+}
 
-    for (int i = 0; i < fftSize_; i++) {
-        int k = i ^ (fftSize_ >> 1); // DC-center rearrangement
-        float re = fftwOut_[k][0] * invFFTSize;
-        float im = fftwOut_[k][1] * invFFTSize;
-        float power = re * re + im * im;
-        // Avoid log of zero
-        if (power < 1e-20f) power = 1e-20f;
-        output[i] = log2f(power) * logMultiplier;
+void RealFFTEngine::computePowerSpectrum(const float* input, float* output) {
+    {
+        PerfScope perf(PerfStage::Window);
+        for (int i = 0; i < fftSize_; i++) fftwIn_[i] = input[i] * window_[i];
     }
+    executePowerSpectrum(output);
 }
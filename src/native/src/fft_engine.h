@@ -1,31 +1,92 @@
 #pragma once
 
 #include <complex>
+#include <string>
 #include <vector>
 #include <mutex>
 #include <fftw3.h>
+#include "buffer_pool.h"
 
 // FFTW planner is not thread-safe even with FFTW_ESTIMATE.
 // All plan creation/destruction must be serialized through this mutex.
 extern std::mutex g_fftwMutex;
 
+enum class WindowType {
+    Hann,
+    Hamming,
+    Blackman,
+    BlackmanHarris,
+    FlatTop,
+    Rectangular
+};
+
+// "hann", "hamming", "blackman", "blackman-harris", "flattop", "rectangular"
+WindowType windowTypeFromName(const std::string& name);
+
 class FFTEngine {
 public:
-    explicit FFTEngine(int fftSize);
+    explicit FFTEngine(int fftSize, WindowType window = WindowType::Hann);
     ~FFTEngine();
 
     // Compute FFT on input samples, output log power spectrum (dB)
-    // Applies Hann window, computes FFT, DC-centers, returns log power
+    // Applies window, computes FFT, DC-centers, returns log power
     void computePowerSpectrum(const std::complex<float>* input, float* output);
 
+    // Same as computePowerSpectrum but leaves power linear, for averaging
+    void computeLinearPower(const std::complex<float>* input, float* output);
+
+    // Fused path: callers write windowed samples straight into input()
+    // (see FormatTraits::loadWindowed), then run one of these
+    fftwf_complex* input() { return fftwIn_; }
+    const float* window() const { return window_.data(); }
+    void executePowerSpectrum(float* output);
+    void executeLinearPower(float* output);
+    // Unnormalized complex spectrum in FFTW order (DC first), for callers
+    // that need phase; valid until the next execute
+    const fftwf_complex* executeSpectrum();
+
     int size() const { return fftSize_; }
+    // Values per output line
+    int bins() const { return fftSize_; }
 
 private:
-    void generateWindow();
-
     int fftSize_;
     std::vector<float> window_;
+    // Owned here so a constructor that throws part way still releases them
+    PooledBuffer<fftwf_complex> in_;
+    PooledBuffer<fftwf_complex> out_;
     fftwf_complex* fftwIn_ = nullptr;
     fftwf_complex* fftwOut_ = nullptr;
     fftwf_plan plan_ = nullptr;
 };
+
+// Real-input counterpart of FFTEngine built on an r2c plan. A real signal's
+// spectrum is conjugate-symmetric, so only bins [0, fftSize/2) are returned,
+// from DC up, with the same scaling as the matching FFTEngine bins.
+class RealFFTEngine {
+public:
+    explicit RealFFTEngine(int fftSize, WindowType window = WindowType::Hann);
+    ~RealFFTEngine();
+
+    void computePowerSpectrum(const float* input, float* output);
+    void computeLinearPower(const float* input, float* output);
+
+    float* input() { return fftwIn_; }
+    const float* window() const { return window_.data(); }
+    void executePowerSpectrum(float* output);
+    void executeLinearPower(float* output);
+    // Bins [0, fftSize/2) of the r2c output, unnormalized
+    const fftwf_complex* executeSpectrum();
+
+    int size() const { return fftSize_; }
+    int bins() const { return fftSize_ / 2; }
+
+private:
+    int fftSize_;
+    std::vector<float> window_;
+    PooledBuffer<float> in_;
+    PooledBuffer<fftwf_complex> out_;
+    float* fftwIn_ = nullptr;
+    fftwf_complex* fftwOut_ = nullptr;
+    fftwf_plan plan_ = nullptr;
+};
@@ -26,8 +26,7 @@ void FilterEngine::bandpassFilter(
 
     // Design Kaiser-windowed FIR filter
     float attenuation = 60.0f;
-    unsigned int filterLen = estimate_req_filter_len(std::min(cutoff, 0.05f), attenuation);
-    if (filterLen < 4) filterLen = 4;
+    unsigned int filterLen = filterLength(bandwidth, sampleRate);
 
     std::vector<float> taps(filterLen);
     liquid_firdes_kaiser(filterLen, cutoff, attenuation, 0.0f, taps.data());
@@ -55,3 +54,9 @@ void FilterEngine::bandpassFilter(
     }
     firfilt_crcf_destroy(filter);
 }
+
+unsigned FilterEngine::filterLength(double bandwidth, double sampleRate) {
+    float cutoff = std::min(static_cast<float>(bandwidth / sampleRate / 2.0), 0.49f);
+    unsigned int filterLen = estimate_req_filter_len(std::min(cutoff, 0.05f), 60.0f);
+    return filterLen < 4 ? 4 : filterLen;
+}
@@ -17,4 +17,8 @@ public:
         double bandwidth,
         double sampleRate
     );
+
+    // Taps in the FIR that bandpassFilter designs for bandwidth; also the
+    // number of input samples it needs before its output settles
+    static unsigned filterLength(double bandwidth, double sampleRate);
 };
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "fft_engine.h"
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Call fn with the sample step of an interleaved read: a compile-time
+// constant for the common channel counts, so the de-interleaving loops
+// are unrolled and vectorized per layout, else the runtime value
+template <typename Fn>
+inline void withStep(size_t step, Fn&& fn) {
+    switch (step) {
+    case 1: fn(std::integral_constant<size_t, 1>{}); break;
+    case 2: fn(std::integral_constant<size_t, 2>{}); break;
+    case 4: fn(std::integral_constant<size_t, 4>{}); break;
+    case 8: fn(std::integral_constant<size_t, 8>{}); break;
+    default: fn(step); break;
+    }
+}
+
+// Compile-time description of a sample format: the stored component type,
+// whether samples are I/Q pairs, and the constants that map a component
+// to [-1, 1). The conversion matches the SampleAdapters in input_source.cpp.
+template <typename Raw, bool Complex>
+struct FormatTraits {
+    using RawType = Raw;
+    static constexpr bool complex = Complex;
+    static constexpr size_t components = Complex ? 2 : 1;
+    static constexpr size_t sampleSize = sizeof(Raw) * components;
+
+    static constexpr float scale =
+        std::is_floating_point<Raw>::value ? 1.0f :
+        std::is_same<Raw, int32_t>::value ? 1.0f / 2147483648.0f :
+        std::is_same<Raw, int16_t>::value ? 1.0f / 32768.0f :
+        1.0f / 128.0f;
+    static constexpr float offset = std::is_same<Raw, uint8_t>::value ? 127.4f : 0.0f;
+
+    // Folds to a plain cast for float formats
+    static inline float convert(Raw v) {
+        return (static_cast<float>(v) - offset) * scale;
+    }
+
+    // The loaders below read count samples of one channel from raw, which
+    // points at that channel's first sample; step is the channel count of
+    // an interleaved file, so successive samples are step apart. raw may be
+    // null when count is 0.
+
+    // Convert and multiply by window in one pass, writing straight into an
+    // FFTW input buffer; entries [count, n) are zeroed
+    static void loadWindowed(const void* raw, size_t count, const float* window,
+                             fftwf_complex* out, size_t n, size_t step = 1) {
+        const Raw* src = static_cast<const Raw*>(raw);
+        withStep(step, [&](auto stride) {
+            for (size_t i = 0; i < count; i++) {
+                const Raw* s = src + i * stride * components;
+                float w = window[i];
+                out[i][0] = convert(s[0]) * w;
+                out[i][1] = Complex ? convert(s[Complex ? 1 : 0]) * w : 0.0f;
+            }
+        });
+        for (size_t i = count; i < n; i++) {
+            out[i][0] = 0.0f;
+            out[i][1] = 0.0f;
+        }
+    }
+
+    // Same for the real input of an r2c plan; real formats only
+    static void loadWindowed(const void* raw, size_t count, const float* window,
+                             float* out, size_t n, size_t step = 1) {
+        static_assert(!Complex, "complex samples need a complex FFT input");
+        const Raw* src = static_cast<const Raw*>(raw);
+        withStep(step, [&](auto stride) {
+            for (size_t i = 0; i < count; i++) out[i] = convert(src[i * stride]) * window[i];
+        });
+        for (size_t i = count; i < n; i++) out[i] = 0.0f;
+    }
+
+    // Plain conversion, as the SampleAdapters do for single-channel files
+    static void load(const void* raw, size_t count, std::complex<float>* out, size_t step = 1) {
+        const Raw* src = static_cast<const Raw*>(raw);
+        withStep(step, [&](auto stride) {
+            for (size_t i = 0; i < count; i++) {
+                const Raw* s = src + i * stride * components;
+                out[i] = std::complex<float>(convert(s[0]), Complex ? convert(s[Complex ? 1 : 0]) : 0.0f);
+            }
+        });
+    }
+
+    // In-phase component only, which for real formats is the whole sample
+    static void loadReal(const void* raw, size_t count, float* out, size_t step = 1) {
+        const Raw* src = static_cast<const Raw*>(raw);
+        withStep(step, [&](auto stride) {
+            for (size_t i = 0; i < count; i++) out[i] = convert(src[i * stride * components]);
+        });
+    }
+
+    // Address of channel's first sample in a frame-interleaved block
+    static const void* channelData(const void* raw, size_t channel) {
+        return static_cast<const uint8_t*>(raw) + channel * sampleSize;
+    }
+
+    // Transform matching the format: r2c for real samples, which needs
+    // half the work and yields only the non-redundant half spectrum
+    using Engine = typename std::conditional<Complex, FFTEngine, RealFFTEngine>::type;
+};
+
+using FormatCF32 = FormatTraits<float, true>;
+using FormatCF64 = FormatTraits<double, true>;
+using FormatCS32 = FormatTraits<int32_t, true>;
+using FormatCS16 = FormatTraits<int16_t, true>;
+using FormatCS8 = FormatTraits<int8_t, true>;
+using FormatCU8 = FormatTraits<uint8_t, true>;
+using FormatRF32 = FormatTraits<float, false>;
+using FormatRF64 = FormatTraits<double, false>;
+using FormatRS16 = FormatTraits<int16_t, false>;
+using FormatRS8 = FormatTraits<int8_t, false>;
+using FormatRU8 = FormatTraits<uint8_t, false>;
+
+// Call fn(Traits{}) with the traits of format, resolved once so the loop
+// inside fn is compiled per format. Unknown formats read as cf32, like
+// createAdapter.
+template <typename Fn>
+auto dispatchFormat(const std::string& format, Fn&& fn) {
+    if (format == "cf64") return fn(FormatCF64{});
+    if (format == "cs32") return fn(FormatCS32{});
+    if (format == "cs16") return fn(FormatCS16{});
+    if (format == "cs8")  return fn(FormatCS8{});
+    if (format == "cu8")  return fn(FormatCU8{});
+    if (format == "rf32") return fn(FormatRF32{});
+    if (format == "rf64") return fn(FormatRF64{});
+    if (format == "rs16") return fn(FormatRS16{});
+    if (format == "rs8")  return fn(FormatRS8{});
+    if (format == "ru8")  return fn(FormatRU8{});
+    return fn(FormatCF32{});
+}
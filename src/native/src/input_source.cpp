@@ -1,19 +1,34 @@
 #include "input_source.h"
+#include "format_traits.h"
+#include "segmented_backend.h"
+#include "perf_stats.h"
+#include "sigmf_parser.h"
+#include "buffer_pool.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <stdexcept>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-#include <unistd.h>
 #include <memory>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
+// Upper bound on interleaved channels, well past any receiver we read
+static constexpr size_t kMaxChannels = 64;
+// Strided reads fetch the raw span between their samples in runs of up to
+// this many bytes, rather than making one backend read per sample
+static constexpr size_t kStridedRunBytes = size_t(1) << 20;
+
+static bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() > suffix.size() &&
+           s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
 // ── Complex adapters ──────────────────────────────────────────────
 
 void ComplexF32Adapter::copyRange(const void* src, size_t start, size_t length,
@@ -149,78 +164,143 @@ InputSource::~InputSource() {
 }
 
 void InputSource::close() {
-    if (mmapData_ && fileSize_ > 0) {
-        munmap(mmapData_, fileSize_);
-        mmapData_ = nullptr;
-    }
-    if (fd_ >= 0) {
-        ::close(fd_);
-        fd_ = -1;
-    }
+    backend_.reset();
+    annotations_.clear();
+    captures_.clear();
     fileSize_ = 0;
     totalSamples_ = 0;
 }
 
-void InputSource::open(const std::string& path, const std::string& overrideFormat) {
+void InputSource::open(const std::string& path, const std::string& overrideFormat,
+                       const BackendOptions& options) {
     close();
+    channels_ = 1;
 
     // Detect format from extension or override
     detectFormat(path, overrideFormat);
     createAdapter();
 
-    // Determine the data file path
-    std::string dataPath = path;
+    // Determine the data file path(s)
+    std::vector<std::string> dataPaths;
 
-    // If .sigmf-meta was opened, find the .sigmf-data partner
-    if (path.size() > 11 && path.substr(path.size() - 11) == ".sigmf-meta") {
-        dataPath = path.substr(0, path.size() - 11) + ".sigmf-data";
+    // A compressed data file is named after its raw counterpart plus .zst
+    std::string rawPath = endsWith(path, ".zst") ? path.substr(0, path.size() - 4) : path;
+
+    // A SigMF collection lists its recordings in playback order
+    if (endsWith(path, ".sigmf-collection")) {
+        dataPaths = parseCollection(path);
+    }
+    // If .sigmf-meta was opened, find the .sigmf-data partner (raw or compressed)
+    else if (endsWith(path, ".sigmf-meta")) {
+        std::string dataPath = path.substr(0, path.size() - 11) + ".sigmf-data";
+        if (!std::ifstream(dataPath).good() && std::ifstream(dataPath + ".zst").good()) {
+            dataPath += ".zst";
+        }
+        dataPaths.push_back(dataPath);
         parseSigMF(path);
     }
     // If .sigmf-data was opened, look for .sigmf-meta partner
-    else if (path.size() > 11 && path.substr(path.size() - 11) == ".sigmf-data") {
-        std::string metaPath = path.substr(0, path.size() - 11) + ".sigmf-meta";
+    else if (endsWith(rawPath, ".sigmf-data")) {
+        dataPaths.push_back(path);
+        std::string metaPath = rawPath.substr(0, rawPath.size() - 11) + ".sigmf-meta";
         std::ifstream test(metaPath);
         if (test.good()) {
             parseSigMF(metaPath);
         }
+    } else {
+        dataPaths.push_back(path);
+    }
+    dataPaths.insert(dataPaths.end(), options.segments.begin(), options.segments.end());
+    if (options.channels > 0) channels_ = options.channels;
+    if (channels_ > kMaxChannels) {
+        throw std::runtime_error("Unsupported channel count: " + std::to_string(channels_));
     }
 
-    // Open and mmap the data file
-    fd_ = ::open(dataPath.c_str(), O_RDONLY);
-    if (fd_ < 0) {
-        throw std::runtime_error("Failed to open file: " + dataPath);
+    // Open each data file through the requested backend (mmap by default)
+    // and stitch multiple segments into one sample index space
+    if (dataPaths.size() == 1) {
+        backend_ = createBackend(dataPaths.front(), options);
+    } else {
+        std::vector<std::unique_ptr<DataBackend>> segments;
+        for (auto& p : dataPaths) {
+            segments.push_back(createBackend(p, options));
+        }
+        backend_ = std::make_unique<SegmentedBackend>(std::move(segments), frameSize());
+    }
+    segmentCount_ = dataPaths.size();
+    fileSize_ = backend_->size();
+    totalSamples_ = fileSize_ / frameSize();
+
+    // Files without capture metadata are one segment at the global tuning
+    if (captures_.empty()) {
+        SigMFCapture capture;
+        capture.frequency = centerFrequency_;
+        captures_.push_back(capture);
     }
+}
+
+size_t InputSource::refresh() {
+    if (!backend_ || !adapter_) return 0;
+    size_t size = backend_->refresh();
+    fileSize_ = size;
+    totalSamples_ = size / frameSize();
+    return totalSamples_;
+}
 
-    struct stat st;
-    if (fstat(fd_, &st) < 0) {
-        ::close(fd_);
-        fd_ = -1;
-        throw std::runtime_error("Failed to stat file: " + dataPath);
+const void* InputSource::rawSamples(size_t start, size_t length, std::vector<uint8_t>& staging) const {
+    size_t frame = frameSize();
+    if (const void* base = backend_->span(start * frame, length * frame)) {
+        return base;
     }
+    // Non-mapped backends read raw bytes into the caller's staging buffer
+    staging.resize(length * frame);
+    backend_->read(start * frame, length * frame, staging.data());
+    return staging.data();
+}
 
-    fileSize_ = st.st_size;
-    totalSamples_ = fileSize_ / adapter_->sampleSize();
+void InputSource::copySamples(size_t start, size_t length, std::complex<float>* dest,
+                              size_t channel) const {
+    thread_local std::vector<uint8_t> staging;
+    const void* raw = rawSamples(start, length, staging);
+    if (channels_ == 1) {
+        adapter_->copyRange(raw, 0, length, dest);
+        return;
+    }
+    dispatchFormat(format_, [&](auto traits) {
+        using Traits = decltype(traits);
+        Traits::load(Traits::channelData(raw, channel), length, dest, channels_);
+    });
+}
 
-    mmapData_ = mmap(nullptr, fileSize_, PROT_READ, MAP_PRIVATE, fd_, 0);
-    if (mmapData_ == MAP_FAILED) {
-        mmapData_ = nullptr;
-        ::close(fd_);
-        fd_ = -1;
-        throw std::runtime_error("Failed to mmap file: " + dataPath);
+void InputSource::checkChannel(size_t channel) const {
+    if (channel >= channels_) {
+        throw std::runtime_error("Channel out of range: " + std::to_string(channel));
     }
 }
 
-void InputSource::getSamples(size_t start, size_t length, std::complex<float>* dest) const {
-    if (!mmapData_ || !adapter_) {
+void InputSource::prefetch(size_t start, size_t length) const {
+    size_t total = totalSamples_;
+    if (!backend_ || !adapter_ || start >= total) return;
+    length = std::min(length, total - start);
+    size_t frame = frameSize();
+    backend_->prefetch(start * frame, length * frame);
+}
+
+void InputSource::getSamples(size_t start, size_t length, std::complex<float>* dest,
+                             size_t channel) const {
+    if (!backend_ || !adapter_) {
         throw std::runtime_error("No file open");
     }
+    checkChannel(channel);
+    size_t total = totalSamples_;
     size_t end = start + length;
     size_t actualLength = length;
-    if (end > totalSamples_) {
-        actualLength = (start < totalSamples_) ? totalSamples_ - start : 0;
+    if (end > total) {
+        actualLength = (start < total) ? total - start : 0;
     }
     if (actualLength > 0) {
-        adapter_->copyRange(mmapData_, start, actualLength, dest);
+        PerfScope perf(PerfStage::Read, actualLength * frameSize());
+        copySamples(start, actualLength, dest, channel);
     }
     // Zero-fill any remaining samples beyond the file
     for (size_t i = actualLength; i < length; i++) {
@@ -228,25 +308,100 @@ void InputSource::getSamples(size_t start, size_t length, std::complex<float>* d
     }
 }
 
-void InputSource::getSamplesStrided(size_t start, size_t length, size_t stride, std::complex<float>* dest) const {
-    if (!mmapData_ || !adapter_) {
+void InputSource::getRealSamples(size_t start, size_t length, float* dest, size_t channel) const {
+    if (!backend_ || !adapter_) {
+        throw std::runtime_error("No file open");
+    }
+    checkChannel(channel);
+    size_t total = totalSamples_;
+    size_t actualLength = start < total ? std::min(length, total - start) : 0;
+    if (actualLength > 0) {
+        PerfScope perf(PerfStage::Read, actualLength * frameSize());
+        thread_local std::vector<uint8_t> staging;
+        const void* raw = rawSamples(start, actualLength, staging);
+        dispatchFormat(format_, [&](auto traits) {
+            using Traits = decltype(traits);
+            Traits::loadReal(Traits::channelData(raw, channel), actualLength, dest, channels_);
+        });
+    }
+    std::fill(dest + actualLength, dest + length, 0.0f);
+}
+
+void InputSource::getSamplesInCapture(size_t start, size_t length, std::complex<float>* dest,
+                                      size_t channel) const {
+    size_t boundary = nextCaptureStart(start);
+    size_t valid = boundary - start < length ? boundary - start : length;
+    getSamples(start, valid, dest, channel);
+    std::fill(dest + valid, dest + length, std::complex<float>(0.0f, 0.0f));
+}
+
+size_t InputSource::validInCapture(size_t start, size_t length) const {
+    size_t total = totalSamples_;
+    if (start >= total) return 0;
+    size_t limit = std::min(total, nextCaptureStart(start));
+    return std::min(length, limit - start);
+}
+
+const SigMFCapture& InputSource::captureAt(size_t sample) const {
+    static const SigMFCapture none;
+    if (captures_.empty()) return none;
+    // The first segment starts at 0, so upper_bound never returns begin()
+    auto it = std::upper_bound(captures_.begin(), captures_.end(), sample,
+        [](size_t s, const SigMFCapture& c) { return s < c.sampleStart; });
+    return *(it - 1);
+}
+
+size_t InputSource::nextCaptureStart(size_t sample) const {
+    auto it = std::upper_bound(captures_.begin(), captures_.end(), sample,
+        [](size_t s, const SigMFCapture& c) { return s < c.sampleStart; });
+    return it == captures_.end() ? SIZE_MAX : it->sampleStart;
+}
+
+void InputSource::getSamplesStrided(size_t start, size_t length, size_t stride, std::complex<float>* dest,
+                                    size_t channel) const {
+    if (!backend_ || !adapter_) {
         throw std::runtime_error("No file open");
     }
 
     // Optimization for stride=1
     if (stride == 1) {
-        getSamples(start, length, dest);
+        getSamples(start, length, dest, channel);
         return;
     }
-
-    for (size_t i = 0; i < length; i++) {
-        size_t srcIdx = start + i * stride;
-        if (srcIdx < totalSamples_) {
-            adapter_->copyRange(mmapData_, srcIdx, 1, &dest[i]);
-        } else {
-            dest[i] = std::complex<float>(0.0f, 0.0f);
+    checkChannel(channel);
+
+    size_t total = totalSamples_;
+    size_t valid = start < total ? std::min(length, (total - start - 1) / stride + 1) : 0;
+    const size_t frame = frameSize();
+
+    if (stride * frame <= kStridedRunBytes) {
+        // Read each run contiguously and convert every stride-th sample of it
+        const size_t perRun = kStridedRunBytes / (stride * frame);
+        thread_local std::vector<uint8_t> staging;
+        for (size_t i = 0; i < valid; i += perRun) {
+            size_t count = std::min(perRun, valid - i);
+            size_t first = start + i * stride;
+            size_t span = (count - 1) * stride + 1;
+            if (i + count < valid) {
+                size_t next = first + count * stride;
+                backend_->prefetch(next * frame, std::min(span, total - next) * frame);
+            }
+            const void* raw = rawSamples(first, span, staging);
+            dispatchFormat(format_, [&](auto traits) {
+                using Traits = decltype(traits);
+                Traits::load(Traits::channelData(raw, channel), count, dest + i, stride * channels_);
+            });
+        }
+    } else {
+        // Samples further apart than a run: one read each, with the next
+        // one requested ahead
+        for (size_t i = 0; i < valid; i++) {
+            size_t srcIdx = start + i * stride;
+            if (i + 1 < valid) backend_->prefetch((srcIdx + stride) * frame, frame);
+            copySamples(srcIdx, 1, &dest[i], channel);
         }
     }
+    std::fill(dest + valid, dest + length, std::complex<float>(0.0f, 0.0f));
 }
 
 void InputSource::detectFormat(const std::string& path, const std::string& overrideFormat) {
@@ -255,17 +410,25 @@ void InputSource::detectFormat(const std::string& path, const std::string& overr
         return;
     }
 
+    // Compressed files carry the raw extension underneath: capture.cs16.zst
+    std::string rawPath = endsWith(path, ".zst") ? path.substr(0, path.size() - 4) : path;
+
     // Extract extension
-    auto dotPos = path.rfind('.');
+    auto dotPos = rawPath.rfind('.');
     if (dotPos == std::string::npos) {
         format_ = "cf32";
         return;
     }
 
-    std::string ext = path.substr(dotPos + 1);
+    std::string ext = rawPath.substr(dotPos + 1);
     // Convert to lowercase
     std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
 
+    std::string format = formatForExtension(ext);
+    format_ = format.empty() ? "cf32" : format;
+}
+
+std::string formatForExtension(const std::string& ext) {
     // Extension to format mapping (ported from inspectrum)
     static const std::unordered_map<std::string, std::string> extMap = {
         {"cfile", "cf32"}, {"cf32", "cf32"}, {"fc32", "cf32"}, {"raw", "cf32"}, {"iq", "cf32"},
@@ -274,13 +437,14 @@ void InputSource::detectFormat(const std::string& path, const std::string& overr
         {"cs16", "cs16"}, {"sc16", "cs16"}, {"c16", "cs16"},
         {"cs8", "cs8"}, {"sc8", "cs8"}, {"c8", "cs8"},
         {"cu8", "cu8"}, {"uc8", "cu8"},
-        {"sigmf-data", "cf32"}, {"sigmf-meta", "cf32"},
-        {"f32", "rf32"}, {"f64", "rf64"},
-        {"s16", "rs16"}, {"s8", "rs8"}, {"u8", "ru8"}
+        {"sigmf-data", "cf32"}, {"sigmf-meta", "cf32"}, {"sigmf-collection", "cf32"},
+        {"rf32", "rf32"}, {"f32", "rf32"}, {"rf64", "rf64"}, {"f64", "rf64"},
+        {"rs16", "rs16"}, {"s16", "rs16"}, {"rs8", "rs8"}, {"s8", "rs8"},
+        {"ru8", "ru8"}, {"u8", "ru8"}
     };
 
     auto it = extMap.find(ext);
-    format_ = (it != extMap.end()) ? it->second : "cf32";
+    return it != extMap.end() ? it->second : std::string();
 }
 
 void InputSource::createAdapter() {
@@ -288,83 +452,128 @@ void InputSource::createAdapter() {
 }
 
 void InputSource::parseSigMF(const std::string& metaPath) {
-    std::ifstream file(metaPath);
+    std::ifstream file(metaPath, std::ios::binary);
     if (!file.good()) return;
 
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    sigmfMetaJson_ = content;
-
+    SigMFMetadata meta;
     try {
-        auto meta = json::parse(content);
-
-        // Parse datatype from global
-        if (meta.contains("global") && meta["global"].contains("core:datatype")) {
-            std::string dt = meta["global"]["core:datatype"];
-            // Map SigMF datatypes to our format codes
-            static const std::unordered_map<std::string, std::string> dtMap = {
-                {"cf32_le", "cf32"}, {"cf32_be", "cf32"},
-                {"cf64_le", "cf64"}, {"cf64_be", "cf64"},
-                {"ci32_le", "cs32"}, {"ci32_be", "cs32"},
-                {"ci16_le", "cs16"}, {"ci16_be", "cs16"},
-                {"ci8", "cs8"},
-                {"cu8", "cu8"},
-                {"rf32_le", "rf32"}, {"rf32_be", "rf32"},
-                {"rf64_le", "rf64"}, {"rf64_be", "rf64"},
-                {"ri16_le", "rs16"}, {"ri16_be", "rs16"},
-                {"ri8", "rs8"},
-                {"ru8", "ru8"}
-            };
-            auto it = dtMap.find(dt);
-            if (it != dtMap.end()) {
-                format_ = it->second;
-                createAdapter();
-            }
-        }
+        // Annotations stream straight into the index; the metadata is never held whole
+        meta = SigMFParser::parseStream(file, [this](SigMFAnnotation&& a) { annotations_.add(a); });
+    } catch (const std::exception&) {
+        // Invalid JSON, continue with defaults
+        annotations_.clear();
+        return;
+    }
 
-        // Parse sample rate
-        if (meta.contains("global") && meta["global"].contains("core:sample_rate")) {
-            sampleRate_ = meta["global"]["core:sample_rate"].get<double>();
+    // Map SigMF datatypes to our format codes
+    static const std::unordered_map<std::string, std::string> dtMap = {
+        {"cf32_le", "cf32"}, {"cf32_be", "cf32"},
+        {"cf64_le", "cf64"}, {"cf64_be", "cf64"},
+        {"ci32_le", "cs32"}, {"ci32_be", "cs32"},
+        {"ci16_le", "cs16"}, {"ci16_be", "cs16"},
+        {"ci8", "cs8"},
+        {"cu8", "cu8"},
+        {"rf32_le", "rf32"}, {"rf32_be", "rf32"},
+        {"rf64_le", "rf64"}, {"rf64_be", "rf64"},
+        {"ri16_le", "rs16"}, {"ri16_be", "rs16"},
+        {"ri8", "rs8"},
+        {"ru8", "ru8"}
+    };
+    auto it = dtMap.find(meta.datatype);
+    if (it != dtMap.end()) {
+        format_ = it->second;
+        createAdapter();
+    }
+
+    if (meta.sampleRate > 0) sampleRate_ = meta.sampleRate;
+    if (meta.numChannels > 0) channels_ = meta.numChannels;
+    if (meta.centerFrequency != 0) centerFrequency_ = meta.centerFrequency;
+
+    // Segment table: sorted by start, the first covering sample 0, and a
+    // repeated start keeping the later entry. Missing frequencies carry
+    // forward from the previous segment.
+    captures_ = std::move(meta.captures);
+    std::stable_sort(captures_.begin(), captures_.end(),
+        [](const SigMFCapture& a, const SigMFCapture& b) { return a.sampleStart < b.sampleStart; });
+    std::vector<SigMFCapture> table;
+    double frequency = centerFrequency_;
+    for (auto& capture : captures_) {
+        if (std::isnan(capture.frequency)) capture.frequency = frequency;
+        frequency = capture.frequency;
+        if (!table.empty() && table.back().sampleStart == capture.sampleStart) {
+            table.back() = std::move(capture);
+        } else {
+            table.push_back(std::move(capture));
         }
+    }
+    if (!table.empty()) table.front().sampleStart = 0;
+    captures_ = std::move(table);
+}
 
-        // Parse center frequency from captures
-        if (meta.contains("captures") && meta["captures"].is_array() && !meta["captures"].empty()) {
-            auto& cap = meta["captures"][0];
-            if (cap.contains("core:frequency")) {
-                centerFrequency_ = cap["core:frequency"].get<double>();
-            }
+std::vector<std::string> InputSource::parseCollection(const std::string& collectionPath) {
+    std::ifstream file(collectionPath);
+    if (!file.good()) {
+        throw std::runtime_error("Failed to open file: " + collectionPath);
+    }
+
+    json doc;
+    try {
+        doc = json::parse(file);
+    } catch (const json::exception& e) {
+        throw std::runtime_error("Invalid SigMF collection: " + std::string(e.what()));
+    }
+
+    // Stream names are recording base names relative to the collection file
+    auto slash = collectionPath.rfind('/');
+    std::string dir = (slash == std::string::npos) ? "" : collectionPath.substr(0, slash + 1);
+
+    std::vector<std::string> dataPaths;
+    auto& streams = doc["collection"]["core:streams"];
+    if (streams.is_array()) {
+        for (auto& stream : streams) {
+            if (!stream.contains("name")) continue;
+            dataPaths.push_back(dir + stream["name"].get<std::string>() + ".sigmf-data");
         }
-    } catch (const json::exception&) {
-        // Invalid JSON, continue with defaults
     }
+    if (dataPaths.empty()) {
+        throw std::runtime_error("SigMF collection lists no streams: " + collectionPath);
+    }
+
+    // The first recording's metadata describes the whole capture
+    std::string firstMeta = dataPaths.front().substr(0, dataPaths.front().size() - 11) + ".sigmf-meta";
+    parseSigMF(firstMeta);
+    return dataPaths;
 }
 
-void InputSource::getSamplesDetected(size_t start, size_t length, size_t stride, std::complex<float>* dest) const {
-    if (!mmapData_ || !adapter_) {
+void InputSource::getSamplesDetected(size_t start, size_t length, size_t stride, std::complex<float>* dest,
+                                     size_t channel) const {
+    if (!backend_ || !adapter_) {
         throw std::runtime_error("No file open");
     }
 
     if (stride == 1) {
-        getSamples(start, length, dest);
+        getSamples(start, length, dest, channel);
         return;
     }
+    checkChannel(channel);
 
-    std::vector<std::complex<float>> buffer(stride);
+    PooledBuffer<std::complex<float>> buffer(stride);
+    size_t total = totalSamples_;
 
     for (size_t i = 0; i < length; i++) {
         size_t blockStart = start + i * stride;
         
-        if (blockStart >= totalSamples_) {
+        if (blockStart >= total) {
             dest[i] = std::complex<float>(0.0f, 0.0f);
             continue;
         }
 
         size_t blockLen = stride;
-        if (blockStart + blockLen > totalSamples_) {
-            blockLen = totalSamples_ - blockStart;
+        if (blockStart + blockLen > total) {
+            blockLen = total - blockStart;
         }
 
-        adapter_->copyRange(mmapData_, blockStart, blockLen, buffer.data());
+        copySamples(blockStart, blockLen, buffer.data(), channel);
 
         float maxMag = -1.0f;
         std::complex<float> maxSample(0.0f, 0.0f);
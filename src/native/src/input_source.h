@@ -1,9 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <complex>
 #include <memory>
 #include <string>
+#include <vector>
 #include <cstddef>
+#include <cstdint>
+
+#include "data_backend.h"
+#include "annotation_index.h"
 
 // Sample adapter base class - ported from inspectrum/src/inputsource.cpp
 class SampleAdapter {
@@ -12,6 +18,9 @@ public:
     virtual size_t sampleSize() const = 0;
     virtual void copyRange(const void* src, size_t start, size_t length,
                            std::complex<float>* dest) const = 0;
+    // Normalized magnitude at which a component sits on the ADC rail;
+    // 0 for float formats, which have no full scale
+    virtual float clipLevel() const { return 0.0f; }
 };
 
 // Complex adapters
@@ -34,6 +43,7 @@ public:
     size_t sampleSize() const override { return 8; }
     void copyRange(const void* src, size_t start, size_t length,
                    std::complex<float>* dest) const override;
+    float clipLevel() const override { return 2147483647.0f / 2147483648.0f; }
 };
 
 class ComplexS16Adapter : public SampleAdapter {
@@ -41,6 +51,7 @@ public:
     size_t sampleSize() const override { return 4; }
     void copyRange(const void* src, size_t start, size_t length,
                    std::complex<float>* dest) const override;
+    float clipLevel() const override { return 32767.0f / 32768.0f; }
 };
 
 class ComplexS8Adapter : public SampleAdapter {
@@ -48,6 +59,7 @@ public:
     size_t sampleSize() const override { return 2; }
     void copyRange(const void* src, size_t start, size_t length,
                    std::complex<float>* dest) const override;
+    float clipLevel() const override { return 127.0f / 128.0f; }
 };
 
 class ComplexU8Adapter : public SampleAdapter {
@@ -55,6 +67,7 @@ public:
     size_t sampleSize() const override { return 2; }
     void copyRange(const void* src, size_t start, size_t length,
                    std::complex<float>* dest) const override;
+    float clipLevel() const override { return 127.4f / 128.0f; }
 };
 
 // Real adapters
@@ -77,6 +90,7 @@ public:
     size_t sampleSize() const override { return 2; }
     void copyRange(const void* src, size_t start, size_t length,
                    std::complex<float>* dest) const override;
+    float clipLevel() const override { return 32767.0f / 32768.0f; }
 };
 
 class RealS8Adapter : public SampleAdapter {
@@ -84,6 +98,7 @@ public:
     size_t sampleSize() const override { return 1; }
     void copyRange(const void* src, size_t start, size_t length,
                    std::complex<float>* dest) const override;
+    float clipLevel() const override { return 127.0f / 128.0f; }
 };
 
 class RealU8Adapter : public SampleAdapter {
@@ -91,43 +106,107 @@ public:
     size_t sampleSize() const override { return 1; }
     void copyRange(const void* src, size_t start, size_t length,
                    std::complex<float>* dest) const override;
+    float clipLevel() const override { return 127.4f / 128.0f; }
 };
 
-// Input source: manages mmap'd file and sample adapter
+// Input source: manages the data backend and sample adapter
 class InputSource {
 public:
     InputSource();
     ~InputSource();
 
-    void open(const std::string& path, const std::string& format = "");
+    void open(const std::string& path, const std::string& format = "",
+              const BackendOptions& options = BackendOptions());
     void close();
 
+    // Re-check the data file(s) for appended samples (follow mode for
+    // still-recording captures); returns the new totalSamples
+    size_t refresh();
+
     size_t totalSamples() const { return totalSamples_; }
     size_t fileSize() const { return fileSize_; }
+    size_t segmentCount() const { return segmentCount_; }
     const std::string& format() const { return format_; }
+    const char* backendName() const { return backend_ ? backend_->name() : ""; }
     double sampleRate() const { return sampleRate_; }
     double centerFrequency() const { return centerFrequency_; }
-    const std::string& sigmfMetaJson() const { return sigmfMetaJson_; }
-
-    void getSamples(size_t start, size_t length, std::complex<float>* dest) const;
-    void getSamplesStrided(size_t start, size_t length, size_t stride, std::complex<float>* dest) const;
-    void getSamplesDetected(size_t start, size_t length, size_t stride, std::complex<float>* dest) const;
+    // Capture segments in sample order: one per SigMF capture (a retune or
+    // time discontinuity), or a single segment at sample 0 otherwise.
+    // Every segment has a frequency, inherited from the one before if the
+    // metadata omits it.
+    const std::vector<SigMFCapture>& captures() const { return captures_; }
+    // Segment holding sample, by binary search
+    const SigMFCapture& captureAt(size_t sample) const;
+    // Start of the segment after the one holding sample, or SIZE_MAX
+    size_t nextCaptureStart(size_t sample) const;
+    // Annotations from the SigMF metadata plus any added since open
+    AnnotationIndex& annotations() { return annotations_; }
+    const AnnotationIndex& annotations() const { return annotations_; }
+    float clipLevel() const { return adapter_ ? adapter_->clipLevel() : 0.0f; }
+    // Bytes per sample of one channel
+    size_t sampleSize() const { return adapter_ ? adapter_->sampleSize() : 0; }
+    bool isComplex() const { return format_.empty() || format_[0] == 'c'; }
+    // Channels interleaved sample by sample. Sample indices count frames
+    // of one sample per channel, so every channel spans totalSamples.
+    size_t channels() const { return channels_; }
+    size_t frameSize() const { return sampleSize() * channels_; }
+
+    // Readers take the channel to de-interleave (0 for single-channel
+    // files) and throw std::runtime_error when it is out of range
+    void getSamples(size_t start, size_t length, std::complex<float>* dest,
+                    size_t channel = 0) const;
+    void getSamplesStrided(size_t start, size_t length, size_t stride, std::complex<float>* dest,
+                           size_t channel = 0) const;
+    void getSamplesDetected(size_t start, size_t length, size_t stride, std::complex<float>* dest,
+                            size_t channel = 0) const;
+    // getSamples for real-valued processing: the in-phase component of each
+    // sample, which for real formats is the whole sample
+    void getRealSamples(size_t start, size_t length, float* dest, size_t channel = 0) const;
+    // getSamples, but samples from the next capture boundary on are zeroed
+    // so an FFT frame never mixes two tunings
+    void getSamplesInCapture(size_t start, size_t length, std::complex<float>* dest,
+                             size_t channel = 0) const;
+
+    // How many of the samples [start, start + length) lie inside the file
+    // and before the next capture boundary; the rest read as zeros
+    size_t validInCapture(size_t start, size_t length) const;
+
+    // Raw stored frames [start, start + length), which must lie inside the
+    // file: a pointer into the mapping when the backend has one, otherwise
+    // staging filled from the backend. For the fused per-format loaders in
+    // format_traits.h, which step over the other channels' samples.
+    const void* rawSamples(size_t start, size_t length, std::vector<uint8_t>& staging) const;
+
+    // Hint that samples [start, start + length) will be read soon
+    void prefetch(size_t start, size_t length) const;
 
 private:
     void detectFormat(const std::string& path, const std::string& overrideFormat);
     void createAdapter();
     void parseSigMF(const std::string& metaPath);
+    std::vector<std::string> parseCollection(const std::string& collectionPath);
+
+    // Convert samples that are known to lie inside the file
+    void copySamples(size_t start, size_t length, std::complex<float>* dest, size_t channel = 0) const;
+    void checkChannel(size_t channel) const;
 
     std::unique_ptr<SampleAdapter> adapter_;
-    void* mmapData_ = nullptr;
-    size_t fileSize_ = 0;
-    size_t totalSamples_ = 0;
-    int fd_ = -1;
+    std::unique_ptr<DataBackend> backend_;
+    // Atomic because refresh() can grow them while workers read
+    std::atomic<size_t> fileSize_{0};
+    std::atomic<size_t> totalSamples_{0};
+    size_t segmentCount_ = 0;
+    size_t channels_ = 1;
     std::string format_;
     double sampleRate_ = 1000000.0;
     double centerFrequency_ = 0.0;
-    std::string sigmfMetaJson_;
+    std::vector<SigMFCapture> captures_;
+    AnnotationIndex annotations_;
 };
 
 // Factory function
 std::unique_ptr<SampleAdapter> createAdapter(const std::string& format);
+
+// Sample format a capture extension implies (lowercase, without the dot),
+// or "" for an extension that is not a capture's
+std::string formatForExtension(const std::string& ext);
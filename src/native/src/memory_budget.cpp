@@ -0,0 +1,188 @@
+#include "memory_budget.h"
+#include "buffer_pool.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// Caches together hold at most limit / CACHE_SHARE
+const size_t CACHE_SHARE = 2;
+
+struct BudgetState {
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t limit = 0;
+    size_t reserved = 0;
+    size_t cached = 0;  // of reserved, held by caches
+    size_t peakReserved = 0;
+    // Tickets hand out room in arrival order
+    uint64_t nextTicket = 0;
+    uint64_t serving = 0;
+    uint64_t waits = 0;
+    uint64_t degraded = 0;
+    uint64_t rejected = 0;
+
+    bool fits(size_t bytes) const { return !limit || reserved + bytes <= limit; }
+    // Whether bytes fit once every request, but no cache, has released
+    bool canFit(size_t bytes) const { return !limit || (cached <= limit && bytes <= limit - cached); }
+    bool queueEmpty() const { return nextTicket == serving; }
+
+    void take(size_t bytes) {
+        reserved += bytes;
+        peakReserved = std::max(peakReserved, reserved);
+    }
+};
+
+// Never destroyed: caches of static objects release into it at exit
+BudgetState& state() {
+    static BudgetState* s = new BudgetState;
+    return *s;
+}
+
+std::string mib(size_t bytes) {
+    return std::to_string((bytes + (size_t(1) << 20) - 1) >> 20) + " MiB";
+}
+
+std::runtime_error overBudget(size_t bytes, const BudgetState& s) {
+    std::string message = "Request needs " + mib(bytes) + ", more than the native memory budget of " + mib(s.limit);
+    if (s.cached) message += " leaves beside " + mib(s.cached) + " of open file caches";
+    return std::runtime_error(message);
+}
+
+} // namespace
+
+void MemoryReservation::reset() {
+    if (bytes_) MemoryBudget::release(bytes_, cache_);
+    bytes_ = 0;
+}
+
+void MemoryBudget::release(size_t bytes, bool cache) {
+    auto& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.reserved -= bytes;
+        if (cache) s.cached -= bytes;
+    }
+    s.changed.notify_all();
+}
+
+void MemoryBudget::setLimit(size_t bytes) {
+    auto& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.limit = bytes;
+    }
+    // Waiters may now fit, or now never will
+    s.changed.notify_all();
+    BufferPool::setLimit(bytes);
+}
+
+size_t MemoryBudget::limit() {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.limit;
+}
+
+size_t MemoryBudget::requestLimit() {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (!s.limit) return 0;
+    return s.limit > s.cached ? s.limit - s.cached : 1;
+}
+
+MemoryReservation MemoryBudget::reserve(size_t bytes) {
+    if (!bytes) return MemoryReservation();
+    auto& s = state();
+    std::unique_lock<std::mutex> lock(s.mutex);
+    if (!s.canFit(bytes)) {
+        s.rejected++;
+        throw overBudget(bytes, s);
+    }
+    if (s.queueEmpty() && s.fits(bytes)) {
+        s.take(bytes);
+        return MemoryReservation(bytes);
+    }
+
+    const uint64_t ticket = s.nextTicket++;
+    s.waits++;
+    s.changed.wait(lock, [&]() {
+        return s.serving == ticket && (s.fits(bytes) || !s.canFit(bytes));
+    });
+    // Let the next in line check for room whatever happens here
+    s.serving++;
+    s.changed.notify_all();
+    if (!s.fits(bytes)) {
+        // The limit was lowered below this request while it waited
+        s.rejected++;
+        throw overBudget(bytes, s);
+    }
+    s.take(bytes);
+    return MemoryReservation(bytes);
+}
+
+MemoryReservation MemoryBudget::tryReserve(size_t bytes) {
+    if (!bytes) return MemoryReservation();
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (!s.queueEmpty() || !s.fits(bytes)) return MemoryReservation();
+    s.take(bytes);
+    return MemoryReservation(bytes);
+}
+
+MemoryReservation MemoryBudget::reserveUpTo(size_t bytes) {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    // Queued requests keep their place
+    if (!s.queueEmpty()) return MemoryReservation();
+    if (s.limit) bytes = std::min(bytes, s.limit > s.reserved ? s.limit - s.reserved : 0);
+    s.take(bytes);
+    return MemoryReservation(bytes);
+}
+
+MemoryReservation MemoryBudget::reserveCache(size_t bytes) {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (!s.queueEmpty()) return MemoryReservation();
+    if (s.limit) {
+        size_t share = s.limit / CACHE_SHARE;
+        bytes = std::min(bytes, share > s.cached ? share - s.cached : 0);
+        bytes = std::min(bytes, s.limit > s.reserved ? s.limit - s.reserved : 0);
+    }
+    s.take(bytes);
+    s.cached += bytes;
+    return MemoryReservation(bytes, true);
+}
+
+void MemoryBudget::noteDegraded() {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.degraded++;
+}
+
+MemoryBudgetStats MemoryBudget::stats() {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    MemoryBudgetStats out;
+    out.limit = s.limit;
+    out.reserved = s.reserved;
+    out.cached = s.cached;
+    out.peakReserved = s.peakReserved;
+    out.queued = static_cast<size_t>(s.nextTicket - s.serving);
+    out.waits = s.waits;
+    out.degraded = s.degraded;
+    out.rejected = s.rejected;
+    return out;
+}
+
+void MemoryBudget::resetStats() {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.peakReserved = s.reserved;
+    s.waits = 0;
+    s.degraded = 0;
+    s.rejected = 0;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+struct MemoryBudgetStats {
+    size_t limit = 0;         // bytes, 0 = unlimited
+    size_t reserved = 0;      // bytes held by running requests and caches
+    size_t cached = 0;        // of reserved, held by caches of open files
+    size_t peakReserved = 0;
+    size_t queued = 0;        // requests waiting for room right now
+    uint64_t waits = 0;       // reservations that had to queue
+    uint64_t degraded = 0;    // requests that took a leaner path instead
+    uint64_t rejected = 0;    // reservations larger than the budget less the caches
+};
+
+// Bytes held against MemoryBudget until reset or destroyed
+class MemoryReservation {
+public:
+    MemoryReservation() = default;
+    ~MemoryReservation() { reset(); }
+
+    MemoryReservation(MemoryReservation&& other) noexcept
+        : bytes_(std::exchange(other.bytes_, 0)), cache_(other.cache_) {}
+    MemoryReservation& operator=(MemoryReservation&& other) noexcept {
+        if (this != &other) {
+            reset();
+            bytes_ = std::exchange(other.bytes_, 0);
+            cache_ = other.cache_;
+        }
+        return *this;
+    }
+    MemoryReservation(const MemoryReservation&) = delete;
+    MemoryReservation& operator=(const MemoryReservation&) = delete;
+
+    void reset();
+    size_t bytes() const { return bytes_; }
+    explicit operator bool() const { return bytes_ != 0; }
+
+private:
+    friend class MemoryBudget;
+    explicit MemoryReservation(size_t bytes, bool cache = false) : bytes_(bytes), cache_(cache) {}
+
+    size_t bytes_ = 0;
+    bool cache_ = false;
+};
+
+// Module-wide admission control for native memory. Before allocating its
+// working set, a request reserves an estimate of it here, so tile bursts,
+// correlations, exports and caches share one budget instead of each
+// sizing itself against the whole machine. BufferPool enforces the same
+// limit on the buffers actually handed out; the budget decides which
+// requests start.
+//
+// Requests that do not fit wait in arrival order, so a large one is not
+// starved by a stream of small tiles. Waiting blocks the calling thread:
+// only reserve() from worker threads, never the JS thread, which may be
+// the one that has to release the memory being waited for.
+//
+// Caches hold their reservations for as long as their file is open, so
+// they get at most half the limit between them, and a request that could
+// never fit beside what they hold is rejected instead of queued forever.
+class MemoryBudget {
+public:
+    // 0 = unlimited; also sets the BufferPool limit
+    static void setLimit(size_t bytes);
+    static size_t limit();
+    // Largest request reserve() accepts: the limit less what caches hold,
+    // never below 1 so that 0 still means unlimited
+    static size_t requestLimit();
+
+    // Waits until bytes fit under the limit. Throws std::runtime_error if
+    // bytes exceed the limit less what caches hold.
+    static MemoryReservation reserve(size_t bytes);
+    // bytes if they fit now and no one is queued, else an empty reservation
+    static MemoryReservation tryReserve(size_t bytes);
+    // As much of bytes as fits now without waiting, possibly none
+    static MemoryReservation reserveUpTo(size_t bytes);
+    // reserveUpTo for a cache that lives as long as its file, within the
+    // caches' share of the limit
+    static MemoryReservation reserveCache(size_t bytes);
+
+    // Counts a request that fell back to a leaner path rather than wait
+    static void noteDegraded();
+
+    static MemoryBudgetStats stats();
+    // Peak restarts from the current reservations; counts from zero
+    static void resetStats();
+
+private:
+    friend class MemoryReservation;
+    static void release(size_t bytes, bool cache);
+};
@@ -0,0 +1,155 @@
+#include "overview_renderer.h"
+#include "color_map.h"
+#include "fft_engine.h"
+#include "format_traits.h"
+#include "perf_stats.h"
+#include "parallel.h"
+#include "png_writer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+// Frames read from the source per call
+static const size_t READ_FRAMES = 64;
+// Work items per worker, so uneven columns still balance
+static const size_t BLOCKS_PER_WORKER = 8;
+// Largest image accepted, in pixels
+static const size_t MAX_PIXELS = size_t(1) << 28;
+
+std::vector<float> OverviewRenderer::computeImage(
+    const InputSource& source,
+    const OverviewConfig& config,
+    const ProgressCallback& onProgress,
+    const std::atomic<bool>& cancel,
+    size_t* ffts
+) {
+    const int n = config.fftSize;
+    if (n < 2 || config.width <= 0 || config.height <= 0) {
+        throw std::runtime_error("Invalid overview size");
+    }
+    const size_t width = config.width;
+    const size_t height = config.height;
+    if (width * height > MAX_PIXELS) throw std::runtime_error("Overview image too large");
+    if (config.channel >= source.channels()) {
+        throw std::runtime_error("Channel out of range: " + std::to_string(config.channel));
+    }
+    const size_t channels = source.channels();
+    const size_t frameSize = source.frameSize();
+
+    size_t end = config.end == 0 ? source.totalSamples() : std::min(config.end, source.totalSamples());
+    if (config.start >= end || end - config.start < static_cast<size_t>(n)) {
+        throw std::runtime_error("Overview range is shorter than one FFT");
+    }
+    const size_t start = config.start;
+    const size_t span = end - start;
+
+    // Row k from the bottom takes the peak of bins [k*bins/height, (k+1)*bins/height),
+    // or the nearest bin when the image is taller than the FFT. Real formats
+    // go through an r2c transform and span DC up to Nyquist.
+    const int bins = source.isComplex() ? n : n / 2;
+    std::vector<int> rowBin(height + 1);
+    for (size_t k = 0; k <= height; k++) rowBin[k] = static_cast<int>(k * bins / height);
+
+    std::vector<float> image(width * height);
+    unsigned workers = parallelWorkers(width);
+    size_t blocks = std::min(width, static_cast<size_t>(workers) * BLOCKS_PER_WORKER);
+    std::atomic<size_t> transforms{0};
+    std::mutex progressMutex;
+    size_t blocksDone = 0;
+
+    // Frames convert and window straight from the stored samples
+    auto runBlock = [&](auto traits, auto& engines, size_t block, unsigned w) {
+        using Traits = decltype(traits);
+        using Engine = typename Traits::Engine;
+        if (!engines[w]) engines[w] = std::make_unique<Engine>(n);
+        Engine& fft = *engines[w];
+        std::vector<uint8_t> staging;
+        std::vector<float> power(bins), peak(bins);
+        size_t count = 0;
+
+        size_t colFirst = width * block / blocks;
+        size_t colLast = width * (block + 1) / blocks;
+        for (size_t x = colFirst; x < colLast && !cancel; x++) {
+            size_t cs = start + static_cast<size_t>(static_cast<double>(span) * x / width);
+            size_t ce = start + static_cast<size_t>(static_cast<double>(span) * (x + 1) / width);
+            // Columns narrower than a frame take one frame at their start
+            size_t frames = (ce - cs) / n;
+            if (frames == 0) {
+                frames = 1;
+                cs = std::min(cs, end - n);
+            }
+
+            std::fill(peak.begin(), peak.end(), 0.0f);
+            for (size_t f = 0; f < frames; f += READ_FRAMES) {
+                size_t batch = std::min(READ_FRAMES, frames - f);
+                const uint8_t* raw;
+                {
+                    PerfScope perf(PerfStage::Read, batch * n * frameSize);
+                    raw = static_cast<const uint8_t*>(Traits::channelData(
+                        source.rawSamples(cs + f * n, batch * n, staging), config.channel));
+                }
+                for (size_t b = 0; b < batch; b++) {
+                    Traits::loadWindowed(raw + b * n * frameSize, n, fft.window(), fft.input(), n, channels);
+                    fft.executeLinearPower(power.data());
+                    for (int i = 0; i < bins; i++) peak[i] = std::max(peak[i], power[i]);
+                }
+            }
+            count += frames;
+
+            for (size_t k = 0; k < height; k++) {
+                int b0 = rowBin[k];
+                int b1 = std::max(rowBin[k + 1], b0 + 1);
+                float p = *std::max_element(peak.begin() + b0, peak.begin() + std::min(b1, bins));
+                image[(height - 1 - k) * width + x] = 10.0f * std::log10(std::max(p, 1e-20f));
+            }
+        }
+        transforms += count;
+    };
+
+    dispatchFormat(source.format(), [&](auto traits) {
+        std::vector<std::unique_ptr<typename decltype(traits)::Engine>> engines(workers);
+        parallelForEach(blocks, workers, [&](size_t block, unsigned w) {
+            if (cancel) return;
+            runBlock(traits, engines, block, w);
+
+            std::lock_guard<std::mutex> lock(progressMutex);
+            blocksDone++;
+            if (onProgress) onProgress(static_cast<double>(blocksDone) / blocks);
+        });
+    });
+
+    if (ffts) *ffts = transforms;
+    return image;
+}
+
+OverviewResult OverviewRenderer::render(
+    const InputSource& source,
+    const OverviewConfig& config,
+    const std::string& path,
+    const ProgressCallback& onProgress,
+    const std::atomic<bool>& cancel
+) {
+    ColorMap colors(config.colormap);
+    OverviewResult result;
+    auto image = computeImage(source, config, onProgress, cancel, &result.ffts);
+    if (cancel) {
+        result.cancelled = true;
+        return result;
+    }
+
+    ColorMap::autoRange(image.data(), image.size(), result.minDb, result.maxDb);
+    if (!std::isnan(config.minDb)) result.minDb = config.minDb;
+    if (!std::isnan(config.maxDb)) result.maxDb = config.maxDb;
+
+    const size_t width = config.width;
+    std::vector<uint8_t> rgba(image.size() * 4);
+    parallelFor(config.height, parallelWorkers(config.height, 64), [&](size_t begin, size_t end, unsigned) {
+        colors.apply(image.data() + begin * width, (end - begin) * width,
+                     result.minDb, result.maxDb, rgba.data() + begin * width * 4);
+    });
+    PngWriter::write(path, config.width, config.height, rgba.data());
+    return result;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "input_source.h"
+
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct OverviewConfig {
+    int width = 2048;            // columns (time)
+    int height = 512;            // rows (frequency)
+    int fftSize = 1024;
+    std::string colormap = "plasma-dark";
+    size_t start = 0;
+    size_t end = 0;              // 0 = end of file
+    unsigned channel = 0;        // of an interleaved multi-channel file
+    // Colormap range; NaN takes that end from the data (ColorMap::autoRange)
+    float minDb = NAN;
+    float maxDb = NAN;
+};
+
+struct OverviewResult {
+    float minDb = 0.0f;          // range the colormap spans
+    float maxDb = 0.0f;
+    size_t ffts = 0;             // transforms computed
+    bool cancelled = false;
+};
+
+// One image of a whole capture at a chosen resolution. Each column covers
+// its share of the range with back-to-back FFTs and keeps the peak power
+// per bin, so short bursts survive any amount of shrinking; bins then
+// max-pool down to the image height. Columns are split into contiguous
+// runs across threads, so every thread reads its part of the file in
+// order and the work scales with the file, not with a tile grid.
+class OverviewRenderer {
+public:
+    // Fraction of the columns done; calls are serialized
+    using ProgressCallback = std::function<void(double)>;
+
+    // height x width dB values, row 0 = highest frequency; the rows span
+    // DC to Nyquist for real formats. Throws std::runtime_error for an
+    // empty range, invalid sizes or a channel out of range.
+    static std::vector<float> computeImage(
+        const InputSource& source,
+        const OverviewConfig& config,
+        const ProgressCallback& onProgress,
+        const std::atomic<bool>& cancel,
+        size_t* ffts = nullptr
+    );
+
+    // computeImage, coloured like the spectrogram and written as a PNG.
+    // Nothing is written when cancelled.
+    static OverviewResult render(
+        const InputSource& source,
+        const OverviewConfig& config,
+        const std::string& path,
+        const ProgressCallback& onProgress,
+        const std::atomic<bool>& cancel
+    );
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads for count independent items, never more than one thread
+// per minPerThread items so small jobs stay on the calling thread
+inline unsigned parallelWorkers(size_t count, size_t minPerThread = 1) {
+    unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    size_t byWork = std::max<size_t>(1, count / std::max<size_t>(1, minPerThread));
+    return static_cast<unsigned>(std::min<size_t>(hw, byWork));
+}
+
+// Split [0, count) into one contiguous range per worker and run
+// fn(begin, end, worker) on each. Worker 0 runs on the calling thread.
+// The first exception thrown by any worker is rethrown after all join.
+template <typename Fn>
+void parallelFor(size_t count, unsigned workers, Fn&& fn) {
+    if (count == 0) return;
+    workers = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(workers, count)));
+
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto run = [&](unsigned w) {
+        size_t begin = count * w / workers;
+        size_t end = count * (w + 1) / workers;
+        try {
+            fn(begin, end, w);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned w = 1; w < workers; w++) {
+        threads.emplace_back(run, w);
+    }
+    run(0);
+    for (auto& t : threads) t.join();
+
+    if (error) std::rethrow_exception(error);
+}
+
+// Run fn(item, worker) for every item in [0, count), handing items out one
+// at a time so uneven items balance across workers. Same error handling
+// as parallelFor.
+template <typename Fn>
+void parallelForEach(size_t count, unsigned workers, Fn&& fn) {
+    std::atomic<size_t> next{0};
+    parallelFor(workers, workers, [&](size_t, size_t, unsigned w) {
+        for (size_t item = next++; item < count; item = next++) {
+            fn(item, w);
+        }
+    });
+}
@@ -0,0 +1,342 @@
+#include "perf_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+// Histogram: SUB_BUCKETS per power of two of nanoseconds
+static const int SUB_BITS = 3;
+static const int SUB_BUCKETS = 1 << SUB_BITS;
+static const int OCTAVES = 48;  // up to 2^48 ns, about three days
+static const int NUM_BUCKETS = OCTAVES * SUB_BUCKETS;
+static const int NUM_STAGES = static_cast<int>(PerfStage::Count);
+
+// Trace events kept per thread; older ones are overwritten
+static const size_t TRACE_CAPACITY = 1 << 16;
+
+static const char* const STAGE_NAMES[NUM_STAGES] = {
+    "queueWait", "tile", "read", "window", "fft", "log", "copyToJS", "correlate", "export", "search"
+};
+
+const char* perfStageName(PerfStage stage) {
+    int i = static_cast<int>(stage);
+    return i >= 0 && i < NUM_STAGES ? STAGE_NAMES[i] : "unknown";
+}
+
+namespace {
+
+using Counter = std::atomic<uint64_t>;
+
+// Single writer (the owning thread), so a relaxed load + store replaces
+// the locked read-modify-write
+inline void bump(Counter& c, uint64_t v) {
+    c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+int bucketFor(uint64_t ns) {
+    if (ns < SUB_BUCKETS) return static_cast<int>(ns);
+    int msb = 63 - __builtin_clzll(ns);
+    int sub = static_cast<int>((ns >> (msb - SUB_BITS)) & (SUB_BUCKETS - 1));
+    int bucket = (msb - SUB_BITS + 1) * SUB_BUCKETS + sub;
+    return std::min(bucket, NUM_BUCKETS - 1);
+}
+
+// Midpoint of a bucket, in ns
+uint64_t bucketValue(int bucket) {
+    if (bucket < SUB_BUCKETS) return static_cast<uint64_t>(bucket);
+    int octave = bucket / SUB_BUCKETS - 1 + SUB_BITS;
+    int sub = bucket % SUB_BUCKETS;
+    uint64_t low = (uint64_t(SUB_BUCKETS) + sub) << (octave - SUB_BITS);
+    uint64_t width = uint64_t(1) << (octave - SUB_BITS);
+    return low + width / 2;
+}
+
+struct StageCounters {
+    Counter buckets[NUM_BUCKETS];
+    Counter count;
+    Counter totalNs;
+    Counter maxNs;
+    Counter bytes;
+    Counter minorFaults;
+    Counter majorFaults;
+};
+
+// One event packed into two words so readers never see a torn write
+struct TraceEvent {
+    Counter startNs;
+    Counter durAndStage;  // duration << 8 | stage
+};
+
+struct ThreadBlock {
+    explicit ThreadBlock(uint32_t id) : id(id) {
+        for (auto& s : stages) {
+            for (auto& b : s.buckets) b.store(0, std::memory_order_relaxed);
+            s.count = 0; s.totalNs = 0; s.maxNs = 0; s.bytes = 0;
+            s.minorFaults = 0; s.majorFaults = 0;
+        }
+    }
+
+    uint32_t id;
+    StageCounters stages[NUM_STAGES];
+    // Allocated (under the registry lock) the first time this block
+    // records with tracing on
+    std::unique_ptr<TraceEvent[]> trace;
+    Counter traceCount{0};
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBlock>> blocks;
+    std::vector<ThreadBlock*> free;
+    // Totals at the last reset, subtracted from later snapshots
+    std::vector<PerfStageStats> baseline = std::vector<PerfStageStats>(NUM_STAGES);
+    std::vector<std::vector<uint64_t>> baselineBuckets =
+        std::vector<std::vector<uint64_t>>(NUM_STAGES, std::vector<uint64_t>(NUM_BUCKETS, 0));
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+std::atomic<bool> g_detailed{false};
+std::atomic<bool> g_tracing{false};
+const auto g_epoch = std::chrono::steady_clock::now();
+
+// Claims a block for the current thread and returns it when the thread exits
+struct ThreadHandle {
+    ThreadBlock* block;
+
+    ThreadHandle() {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (!r.free.empty()) {
+            block = r.free.back();
+            r.free.pop_back();
+        } else {
+            r.blocks.push_back(std::make_unique<ThreadBlock>(static_cast<uint32_t>(r.blocks.size() + 1)));
+            block = r.blocks.back().get();
+        }
+    }
+
+    ~ThreadHandle() {
+        auto& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.free.push_back(block);
+    }
+};
+
+ThreadBlock& threadBlock() {
+    thread_local ThreadHandle handle;
+    return *handle.block;
+}
+
+bool threadFaults(uint64_t& minor, uint64_t& major) {
+#if defined(__linux__) && defined(RUSAGE_THREAD)
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) return false;
+    minor = static_cast<uint64_t>(usage.ru_minflt);
+    major = static_cast<uint64_t>(usage.ru_majflt);
+    return true;
+#else
+    (void)minor;
+    (void)major;
+    return false;
+#endif
+}
+
+}  // namespace
+
+uint64_t PerfStats::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - g_epoch).count());
+}
+
+void PerfStats::record(PerfStage stage, uint64_t startNs, uint64_t endNs, uint64_t bytes) {
+    int s = static_cast<int>(stage);
+    if (s < 0 || s >= NUM_STAGES) return;
+    uint64_t ns = endNs > startNs ? endNs - startNs : 0;
+
+    ThreadBlock& block = threadBlock();
+    StageCounters& c = block.stages[s];
+    bump(c.buckets[bucketFor(ns)], 1);
+    bump(c.count, 1);
+    bump(c.totalNs, ns);
+    bump(c.bytes, bytes);
+    if (ns > c.maxNs.load(std::memory_order_relaxed)) c.maxNs.store(ns, std::memory_order_relaxed);
+
+    if (g_tracing.load(std::memory_order_relaxed)) {
+        if (!block.trace) {
+            // writeTrace reads the pointer under the registry lock
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            block.trace.reset(new TraceEvent[TRACE_CAPACITY]());
+        }
+        uint64_t n = block.traceCount.load(std::memory_order_relaxed);
+        TraceEvent& e = block.trace[n % TRACE_CAPACITY];
+        e.startNs.store(startNs, std::memory_order_relaxed);
+        e.durAndStage.store(ns << 8 | static_cast<uint64_t>(s), std::memory_order_relaxed);
+        block.traceCount.store(n + 1, std::memory_order_release);
+    }
+}
+
+void PerfStats::recordFaults(PerfStage stage, uint64_t minor, uint64_t major) {
+    int s = static_cast<int>(stage);
+    if (s < 0 || s >= NUM_STAGES) return;
+    StageCounters& c = threadBlock().stages[s];
+    bump(c.minorFaults, minor);
+    bump(c.majorFaults, major);
+}
+
+std::vector<PerfStageStats> PerfStats::snapshot() {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    std::vector<PerfStageStats> result;
+    std::vector<uint64_t> buckets(NUM_BUCKETS);
+    for (int s = 0; s < NUM_STAGES; s++) {
+        PerfStageStats stats;
+        stats.stage = STAGE_NAMES[s];
+        std::fill(buckets.begin(), buckets.end(), 0);
+        for (auto& block : r.blocks) {
+            const StageCounters& c = block->stages[s];
+            for (int b = 0; b < NUM_BUCKETS; b++) buckets[b] += c.buckets[b].load(std::memory_order_relaxed);
+            stats.count += c.count.load(std::memory_order_relaxed);
+            stats.totalNs += c.totalNs.load(std::memory_order_relaxed);
+            stats.maxNs = std::max(stats.maxNs, c.maxNs.load(std::memory_order_relaxed));
+            stats.bytes += c.bytes.load(std::memory_order_relaxed);
+            stats.minorFaults += c.minorFaults.load(std::memory_order_relaxed);
+            stats.majorFaults += c.majorFaults.load(std::memory_order_relaxed);
+        }
+
+        const PerfStageStats& base = r.baseline[s];
+        stats.count -= std::min(stats.count, base.count);
+        stats.totalNs -= std::min(stats.totalNs, base.totalNs);
+        stats.bytes -= std::min(stats.bytes, base.bytes);
+        stats.minorFaults -= std::min(stats.minorFaults, base.minorFaults);
+        stats.majorFaults -= std::min(stats.majorFaults, base.majorFaults);
+        if (stats.count == 0) continue;
+
+        uint64_t histCount = 0;
+        for (int b = 0; b < NUM_BUCKETS; b++) {
+            buckets[b] -= std::min(buckets[b], r.baselineBuckets[s][b]);
+            histCount += buckets[b];
+        }
+        auto percentile = [&](double p) -> uint64_t {
+            uint64_t target = static_cast<uint64_t>(p * (histCount - 1));
+            uint64_t seen = 0;
+            for (int b = 0; b < NUM_BUCKETS; b++) {
+                seen += buckets[b];
+                if (seen > target) return std::min(bucketValue(b), stats.maxNs);
+            }
+            return stats.maxNs;
+        };
+        if (histCount > 0) {
+            stats.p50Ns = percentile(0.50);
+            stats.p90Ns = percentile(0.90);
+            stats.p99Ns = percentile(0.99);
+        }
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+void PerfStats::reset() {
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    // Counters belong to their threads, so reset by remembering where they
+    // stand; only the running maximum is cleared in place
+    for (int s = 0; s < NUM_STAGES; s++) {
+        PerfStageStats base;
+        std::fill(r.baselineBuckets[s].begin(), r.baselineBuckets[s].end(), 0);
+        for (auto& block : r.blocks) {
+            StageCounters& c = block->stages[s];
+            for (int b = 0; b < NUM_BUCKETS; b++) {
+                r.baselineBuckets[s][b] += c.buckets[b].load(std::memory_order_relaxed);
+            }
+            base.count += c.count.load(std::memory_order_relaxed);
+            base.totalNs += c.totalNs.load(std::memory_order_relaxed);
+            base.bytes += c.bytes.load(std::memory_order_relaxed);
+            base.minorFaults += c.minorFaults.load(std::memory_order_relaxed);
+            base.majorFaults += c.majorFaults.load(std::memory_order_relaxed);
+            c.maxNs.store(0, std::memory_order_relaxed);
+        }
+        r.baseline[s] = base;
+    }
+}
+
+void PerfStats::setDetailed(bool enabled) { g_detailed = enabled; }
+bool PerfStats::detailed() { return g_detailed.load(std::memory_order_relaxed); }
+void PerfStats::setTracing(bool enabled) { g_tracing = enabled; }
+bool PerfStats::tracing() { return g_tracing.load(std::memory_order_relaxed); }
+
+bool PerfStats::isDetailedStage(PerfStage stage) {
+    return stage == PerfStage::Read || stage == PerfStage::Window ||
+           stage == PerfStage::FFT || stage == PerfStage::Log;
+}
+
+size_t PerfStats::writeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.good()) {
+        throw std::runtime_error("Cannot write trace: " + path);
+    }
+
+    auto& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    // Complete ("X") events in microseconds, one track per thread block
+    size_t written = 0;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"snail native\"}}";
+    for (auto& block : r.blocks) {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << block->id
+            << ",\"args\":{\"name\":\"worker " << block->id << "\"}}";
+        if (!block->trace) continue;
+
+        uint64_t n = block->traceCount.load(std::memory_order_acquire);
+        uint64_t first = n > TRACE_CAPACITY ? n - TRACE_CAPACITY : 0;
+        for (uint64_t i = first; i < n; i++) {
+            const TraceEvent& e = block->trace[i % TRACE_CAPACITY];
+            uint64_t start = e.startNs.load(std::memory_order_relaxed);
+            uint64_t packed = e.durAndStage.load(std::memory_order_relaxed);
+            int stage = static_cast<int>(packed & 0xff);
+            if (stage >= NUM_STAGES) continue;
+            out << ",\n{\"name\":\"" << STAGE_NAMES[stage] << "\",\"cat\":\"snail\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                << block->id << ",\"ts\":" << start / 1000.0 << ",\"dur\":" << (packed >> 8) / 1000.0 << "}";
+            written++;
+        }
+    }
+    out << "\n]}\n";
+    if (!out.good()) {
+        throw std::runtime_error("Failed to write trace: " + path);
+    }
+    return written;
+}
+
+PerfScope::PerfScope(PerfStage stage, uint64_t bytes, bool faults)
+    : stage_(stage),
+      active_(!PerfStats::isDetailedStage(stage) || PerfStats::detailed()),
+      faults_(faults),
+      bytes_(bytes) {
+    if (!active_) return;
+    if (faults_) faults_ = threadFaults(minorStart_, majorStart_);
+    startNs_ = PerfStats::nowNs();
+}
+
+PerfScope::~PerfScope() {
+    if (!active_) return;
+    PerfStats::record(stage_, startNs_, PerfStats::nowNs(), bytes_);
+    uint64_t minor, major;
+    if (faults_ && threadFaults(minor, major)) {
+        PerfStats::recordFaults(stage_, minor - minorStart_, major - majorStart_);
+    }
+}
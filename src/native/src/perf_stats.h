@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Instrumented stages of the hot paths
+enum class PerfStage : int {
+    QueueWait,  // async worker queued until it started running
+    Tile,       // whole tile (SpectrogramWorker::Execute)
+    Read,       // backend read + sample conversion (detailed)
+    Window,     // window multiply (detailed)
+    FFT,        // FFTW execute (detailed)
+    Log,        // power to dB (detailed)
+    CopyToJS,   // result copied into a JS typed array
+    Correlate,  // whole correlation (CorrelationWorker::Execute)
+    Export,     // whole SigMF export
+    Search,     // whole sample search (SampleSearchWorker::Execute)
+    Count
+};
+
+const char* perfStageName(PerfStage stage);
+
+struct PerfStageStats {
+    std::string stage;
+    uint64_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+    uint64_t p50Ns = 0;  // percentiles to within one histogram bucket (~9%)
+    uint64_t p90Ns = 0;
+    uint64_t p99Ns = 0;
+    uint64_t bytes = 0;  // bytes touched
+    uint64_t minorFaults = 0;
+    uint64_t majorFaults = 0;
+};
+
+// Process-wide timing histograms. Each thread records into its own block,
+// so the hot path is a few relaxed atomic loads and stores with no shared
+// cache lines and no locks; blocks of finished threads are handed to new
+// ones, which keeps the count at the peak number of live threads.
+// Snapshots sum all blocks.
+//
+// Coarse stages are always on. Detailed stages (per line or per read) cost
+// a clock read each and only record when enabled. With tracing on, every
+// recorded interval also lands in a per-thread ring for writeTrace.
+class PerfStats {
+public:
+    static uint64_t nowNs();
+
+    static void record(PerfStage stage, uint64_t startNs, uint64_t endNs, uint64_t bytes = 0);
+    static void recordFaults(PerfStage stage, uint64_t minor, uint64_t major);
+
+    // Stages with at least one sample since the last reset
+    static std::vector<PerfStageStats> snapshot();
+    static void reset();
+
+    static void setDetailed(bool enabled);
+    static bool detailed();
+    static void setTracing(bool enabled);
+    static bool tracing();
+
+    // Chrome trace-event JSON (opens in Perfetto or chrome://tracing) with
+    // the most recent events of each thread. Returns the number written;
+    // throws std::runtime_error if the file cannot be written.
+    static size_t writeTrace(const std::string& path);
+
+    static bool isDetailedStage(PerfStage stage);
+};
+
+// Times its own lifetime as one interval of stage. Detailed stages are
+// skipped entirely unless enabled. With faults set, page faults taken by
+// this thread during the scope are counted too (Linux only).
+class PerfScope {
+public:
+    explicit PerfScope(PerfStage stage, uint64_t bytes = 0, bool faults = false);
+    ~PerfScope();
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+    void addBytes(uint64_t bytes) { bytes_ += bytes; }
+
+private:
+    PerfStage stage_;
+    bool active_;
+    bool faults_;
+    uint64_t startNs_ = 0;
+    uint64_t bytes_;
+    uint64_t minorStart_ = 0;
+    uint64_t majorStart_ = 0;
+};
@@ -0,0 +1,151 @@
+#include "png_writer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#ifdef SNAIL_HAVE_PNG
+#include <png.h>
+#endif
+
+namespace {
+
+struct FileCloser {
+    void operator()(FILE* f) const { std::fclose(f); }
+};
+using FilePtr = std::unique_ptr<FILE, FileCloser>;
+
+#ifndef SNAIL_HAVE_PNG
+
+uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0) {
+    static uint32_t table[256] = {0};
+    static bool ready = [] {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        return true;
+    }();
+    (void)ready;
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+void putBE32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(v >> 24);
+    out.push_back(v >> 16);
+    out.push_back(v >> 8);
+    out.push_back(v);
+}
+
+void writeChunk(FILE* f, const char type[4], const std::vector<uint8_t>& body) {
+    std::vector<uint8_t> chunk;
+    chunk.reserve(body.size() + 12);
+    putBE32(chunk, static_cast<uint32_t>(body.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), body.begin(), body.end());
+    putBE32(chunk, crc32(chunk.data() + 4, body.size() + 4));
+    if (std::fwrite(chunk.data(), 1, chunk.size(), f) != chunk.size()) {
+        throw std::runtime_error("PNG write failed");
+    }
+}
+
+#endif
+
+}  // namespace
+
+#ifdef SNAIL_HAVE_PNG
+
+void PngWriter::write(const std::string& path, int width, int height, const uint8_t* rgba) {
+    if (width <= 0 || height <= 0) throw std::runtime_error("Empty image");
+    FilePtr file(std::fopen(path.c_str(), "wb"));
+    if (!file) throw std::runtime_error("Cannot create " + path);
+
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop info = png ? png_create_info_struct(png) : nullptr;
+    if (!info) {
+        png_destroy_write_struct(&png, nullptr);
+        throw std::runtime_error("Cannot initialize libpng");
+    }
+    // libpng reports errors by longjmp; nothing with a destructor may be
+    // created between here and png_write_end
+    if (setjmp(png_jmpbuf(png))) {
+        png_destroy_write_struct(&png, &info);
+        throw std::runtime_error("PNG write failed: " + path);
+    }
+
+    png_init_io(png, file.get());
+    // Spectrogram noise barely compresses; favour speed
+    png_set_compression_level(png, 3);
+    png_set_IHDR(png, info, width, height, 8, PNG_COLOR_TYPE_RGBA,
+                 PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png, info);
+    for (int y = 0; y < height; y++) {
+        png_write_row(png, const_cast<png_bytep>(rgba + static_cast<size_t>(y) * width * 4));
+    }
+    png_write_end(png, nullptr);
+    png_destroy_write_struct(&png, &info);
+
+    if (std::fflush(file.get()) != 0) throw std::runtime_error("PNG write failed: " + path);
+}
+
+#else
+
+void PngWriter::write(const std::string& path, int width, int height, const uint8_t* rgba) {
+    if (width <= 0 || height <= 0) throw std::runtime_error("Empty image");
+    FilePtr file(std::fopen(path.c_str(), "wb"));
+    if (!file) throw std::runtime_error("Cannot create " + path);
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (std::fwrite(signature, 1, 8, file.get()) != 8) throw std::runtime_error("PNG write failed: " + path);
+
+    std::vector<uint8_t> ihdr;
+    putBE32(ihdr, width);
+    putBE32(ihdr, height);
+    ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0});  // 8-bit RGBA, no interlace
+    writeChunk(file.get(), "IHDR", ihdr);
+
+    // zlib stream of stored deflate blocks over filter-0 rows, one IDAT
+    // chunk per group of rows to keep memory bounded
+    const size_t rowBytes = static_cast<size_t>(width) * 4 + 1;
+    const size_t rowsPerChunk = std::max<size_t>(1, (size_t(1) << 20) / rowBytes);
+    uint32_t adlerA = 1, adlerB = 0;
+    std::vector<uint8_t> raw, idat;
+    idat = {0x78, 0x01};
+    for (int y0 = 0; y0 < height; y0 += static_cast<int>(rowsPerChunk)) {
+        int y1 = std::min<int>(height, y0 + static_cast<int>(rowsPerChunk));
+        raw.clear();
+        for (int y = y0; y < y1; y++) {
+            raw.push_back(0);
+            const uint8_t* row = rgba + static_cast<size_t>(y) * width * 4;
+            raw.insert(raw.end(), row, row + static_cast<size_t>(width) * 4);
+        }
+        for (uint8_t v : raw) {
+            adlerA = (adlerA + v) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+        bool lastGroup = y1 == height;
+        for (size_t at = 0; at < raw.size(); at += 65535) {
+            size_t n = std::min<size_t>(65535, raw.size() - at);
+            bool last = lastGroup && at + n == raw.size();
+            idat.push_back(last ? 1 : 0);
+            idat.push_back(n & 0xFF);
+            idat.push_back(n >> 8);
+            idat.push_back(~n & 0xFF);
+            idat.push_back((~n >> 8) & 0xFF);
+            idat.insert(idat.end(), raw.begin() + at, raw.begin() + at + n);
+        }
+        if (lastGroup) putBE32(idat, (adlerB << 16) | adlerA);
+        writeChunk(file.get(), "IDAT", idat);
+        idat.clear();
+    }
+    writeChunk(file.get(), "IEND", {});
+
+    if (std::fflush(file.get()) != 0) throw std::runtime_error("PNG write failed: " + path);
+}
+
+#endif
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class PngWriter {
+public:
+    // Write an 8-bit RGBA image, rows top to bottom. Compressed through
+    // libpng when the build found it, stored (uncompressed) deflate
+    // otherwise. Throws std::runtime_error if the file cannot be written.
+    static void write(const std::string& path, int width, int height, const uint8_t* rgba);
+};
@@ -0,0 +1,126 @@
+#include "psd_engine.h"
+#include "format_traits.h"
+#include "parallel.h"
+#include "perf_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// Segments per worker below which extra threads cost more than they save
+static const size_t MIN_SEGMENTS_PER_THREAD = 64;
+// Segments of read-ahead hinted to the backend at a time
+static const size_t PREFETCH_SEGMENTS = 64;
+
+PSDMode psdModeFromName(const std::string& name) {
+    if (name.empty() || name == "average") return PSDMode::Average;
+    if (name == "max") return PSDMode::MaxHold;
+    if (name == "min") return PSDMode::MinHold;
+    throw std::runtime_error("Unknown PSD mode: " + name);
+}
+
+PSDResult PSDEngine::compute(
+    const InputSource& source,
+    size_t start, size_t end,
+    int fftSize,
+    double overlap,
+    WindowType window,
+    PSDMode mode,
+    unsigned channel
+) {
+    if (fftSize <= 0) {
+        throw std::runtime_error("Invalid FFT size");
+    }
+    if (channel >= source.channels()) {
+        throw std::runtime_error("Channel out of range: " + std::to_string(channel));
+    }
+    end = std::min({end, source.totalSamples(), source.nextCaptureStart(start)});
+    if (start >= end) {
+        throw std::runtime_error("Empty PSD range");
+    }
+
+    const size_t n = fftSize;
+    overlap = std::min(std::max(overlap, 0.0), 0.99);
+    const size_t step = std::max<size_t>(1, static_cast<size_t>(n * (1.0 - overlap)));
+    const size_t length = end - start;
+    // A selection shorter than one FFT still yields one (zero-padded) segment
+    const size_t segments = length <= n ? 1 : (length - n) / step + 1;
+
+    // Real formats run an r2c transform and keep the bins from DC up
+    const size_t bins = source.isComplex() ? n : n / 2;
+    unsigned workers = parallelWorkers(segments, MIN_SEGMENTS_PER_THREAD);
+    const float initial = mode == PSDMode::MaxHold ? 0.0f
+                        : mode == PSDMode::MinHold ? std::numeric_limits<float>::max()
+                        : 0.0f;
+    std::vector<std::vector<double>> sums(mode == PSDMode::Average ? workers : 0);
+    std::vector<std::vector<float>> holds(mode == PSDMode::Average ? 0 : workers);
+
+    dispatchFormat(source.format(), [&](auto traits) {
+        using Traits = decltype(traits);
+        parallelFor(segments, workers, [&](size_t first, size_t last, unsigned w) {
+            typename Traits::Engine fft(fftSize, window);
+            std::vector<uint8_t> staging;
+            std::vector<float> power(bins);
+            if (mode == PSDMode::Average) {
+                sums[w].assign(bins, 0.0);
+            } else {
+                holds[w].assign(bins, initial);
+            }
+
+            for (size_t seg = first; seg < last; seg++) {
+                size_t offset = start + seg * step;
+                if ((seg - first) % PREFETCH_SEGMENTS == 0) {
+                    size_t ahead = std::min(last - seg, PREFETCH_SEGMENTS);
+                    source.prefetch(offset, (ahead - 1) * step + n);
+                }
+
+                // Samples past the selection are zeroed rather than read
+                size_t valid = std::min(n, end - offset);
+                const void* raw;
+                {
+                    PerfScope perf(PerfStage::Read, valid * source.frameSize());
+                    raw = Traits::channelData(source.rawSamples(offset, valid, staging), channel);
+                }
+                Traits::loadWindowed(raw, valid, fft.window(), fft.input(), n, source.channels());
+                fft.executeLinearPower(power.data());
+
+                if (mode == PSDMode::Average) {
+                    auto& acc = sums[w];
+                    for (size_t i = 0; i < bins; i++) acc[i] += power[i];
+                } else if (mode == PSDMode::MaxHold) {
+                    auto& acc = holds[w];
+                    for (size_t i = 0; i < bins; i++) acc[i] = std::max(acc[i], power[i]);
+                } else {
+                    auto& acc = holds[w];
+                    for (size_t i = 0; i < bins; i++) acc[i] = std::min(acc[i], power[i]);
+                }
+            }
+        });
+    });
+
+    // Reduce the per-worker accumulators and convert to dB
+    PSDResult result;
+    result.segments = segments;
+    result.end = end;
+    result.centerFrequency = source.captureAt(start).frequency;
+    result.spectrum.resize(bins);
+    const float logMultiplier = 10.0f / log2f(10.0f);
+    for (size_t i = 0; i < bins; i++) {
+        float power;
+        if (mode == PSDMode::Average) {
+            double total = 0.0;
+            for (auto& acc : sums) total += acc[i];
+            power = static_cast<float>(total / segments);
+        } else {
+            power = holds[0][i];
+            for (auto& acc : holds) {
+                power = mode == PSDMode::MaxHold ? std::max(power, acc[i]) : std::min(power, acc[i]);
+            }
+        }
+        // Avoid log of zero
+        if (power < 1e-20f) power = 1e-20f;
+        result.spectrum[i] = log2f(power) * logMultiplier;
+    }
+    return result;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "input_source.h"
+#include "fft_engine.h"
+
+#include <string>
+#include <vector>
+
+enum class PSDMode {
+    Average,  // Welch: mean of the segment periodograms
+    MaxHold,
+    MinHold
+};
+
+// "average", "max", "min"
+PSDMode psdModeFromName(const std::string& name);
+
+struct PSDResult {
+    // fftSize dB values, DC-centered; fftSize / 2 from DC up for real formats
+    std::vector<float> spectrum;
+    size_t segments = 0;
+    size_t end = 0;               // end of the samples actually used
+    double centerFrequency = 0;   // tuning of the capture they came from
+};
+
+class PSDEngine {
+public:
+    // Welch-style spectrum over samples [start, end). Segments of fftSize
+    // step by fftSize * (1 - overlap) and are split across cores; each
+    // worker streams its range from the source into its own accumulator,
+    // so memory stays O(fftSize * threads) however long the selection.
+    // A selection spanning a retune is cut at the end of the capture
+    // holding start, since bins from two tunings cannot be averaged.
+    // channel selects one channel of an interleaved file.
+    static PSDResult compute(
+        const InputSource& source,
+        size_t start, size_t end,
+        int fftSize,
+        double overlap,
+        WindowType window,
+        PSDMode mode,
+        unsigned channel = 0
+    );
+};
@@ -0,0 +1,144 @@
+#include "reassigned_engine.h"
+#include "parallel.h"
+#include "buffer_pool.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const double Tau = M_PI * 2.0;
+
+// Lines reassigned from outside the tile can land inside it; analyse this
+// many extra lines on each side (bounded so tiny strides stay affordable)
+static const int MAX_MARGIN_LINES = 32;
+// Lines per worker below which threading is not worth it
+static const size_t MIN_LINES_PER_THREAD = 16;
+
+ReassignedEngine::ReassignedEngine(int fftSize) : fftSize_(fftSize) {
+    const int n = fftSize_;
+    window_.resize(n);
+    rampWindow_.resize(n);
+    derivWindow_.resize(n);
+    const double centre = (n - 1) / 2.0;
+    const double scale = Tau / (n - 1);
+    for (int i = 0; i < n; i++) {
+        double h = 0.5 * (1.0 - cos(scale * i));
+        window_[i] = static_cast<float>(h);
+        rampWindow_[i] = static_cast<float>((i - centre) * h);
+        derivWindow_[i] = static_cast<float>(0.5 * scale * sin(scale * i));
+    }
+
+    fftwIn_ = static_cast<fftwf_complex*>(BufferPool::acquire(sizeof(fftwf_complex) * n * 3));
+    fftwOut_ = static_cast<fftwf_complex*>(BufferPool::acquire(sizeof(fftwf_complex) * n * 3));
+    std::lock_guard<std::mutex> lock(g_fftwMutex);
+    plan_ = fftwf_plan_many_dft(1, &fftSize_, 3,
+                                fftwIn_, nullptr, 1, n,
+                                fftwOut_, nullptr, 1, n,
+                                FFTW_FORWARD, FFTW_ESTIMATE);
+}
+
+ReassignedEngine::~ReassignedEngine() {
+    {
+        std::lock_guard<std::mutex> lock(g_fftwMutex);
+        if (plan_) fftwf_destroy_plan(plan_);
+    }
+    BufferPool::release(fftwIn_, sizeof(fftwf_complex) * fftSize_ * 3);
+    BufferPool::release(fftwOut_, sizeof(fftwf_complex) * fftSize_ * 3);
+}
+
+void ReassignedEngine::computeFrame(const std::complex<float>* input,
+                                    float* power, float* timeShift, float* freqShift) {
+    const int n = fftSize_;
+    fftwf_complex* inH = fftwIn_;
+    fftwf_complex* inT = fftwIn_ + n;
+    fftwf_complex* inD = fftwIn_ + 2 * n;
+    for (int i = 0; i < n; i++) {
+        float re = input[i].real();
+        float im = input[i].imag();
+        inH[i][0] = re * window_[i];
+        inH[i][1] = im * window_[i];
+        inT[i][0] = re * rampWindow_[i];
+        inT[i][1] = im * rampWindow_[i];
+        inD[i][0] = re * derivWindow_[i];
+        inD[i][1] = im * derivWindow_[i];
+    }
+
+    // Window, time-ramped and derivative transforms in one batched pass
+    fftwf_execute(plan_);
+
+    const fftwf_complex* xH = fftwOut_;
+    const fftwf_complex* xT = fftwOut_ + n;
+    const fftwf_complex* xD = fftwOut_ + 2 * n;
+    const float invFFTSize = 1.0f / n;
+    const float binsPerRadian = static_cast<float>(n / Tau);
+
+    for (int i = 0; i < n; i++) {
+        int k = (i + n - (n >> 1)) % n; // DC-center rearrangement
+        float hr = xH[k][0], hi = xH[k][1];
+        float mag2 = hr * hr + hi * hi;
+        power[i] = mag2 * invFFTSize * invFFTSize;
+        if (mag2 < 1e-30f) {
+            timeShift[i] = 0.0f;
+            freqShift[i] = 0.0f;
+            continue;
+        }
+        // X_T * conj(X_H) / |X_H|^2 and X_D * conj(X_H) / |X_H|^2
+        float tRe = (xT[k][0] * hr + xT[k][1] * hi) / mag2;
+        float dIm = (xD[k][1] * hr - xD[k][0] * hi) / mag2;
+        timeShift[i] = tRe;
+        freqShift[i] = -dIm * binsPerRadian;
+    }
+}
+
+void ReassignedEngine::computeTile(const InputSource& source, size_t startSample,
+                                   int fftSize, int stride, int numLines, float* output,
+                                   unsigned channel) {
+    const size_t n = fftSize;
+    const size_t cells = static_cast<size_t>(numLines) * n;
+    const int margin = std::min(MAX_MARGIN_LINES, (fftSize / 2 + stride - 1) / stride);
+
+    // Analysed lines run from -margin to numLines + margin (relative to the tile)
+    int firstLine = -std::min<int>(margin, static_cast<int>(startSample / stride));
+    size_t lineCount = static_cast<size_t>(numLines + margin - firstLine);
+
+    unsigned workers = parallelWorkers(lineCount, MIN_LINES_PER_THREAD);
+    std::vector<PooledBuffer<float>> grids(workers);
+
+    parallelFor(lineCount, workers, [&](size_t begin, size_t end, unsigned w) {
+        ReassignedEngine engine(fftSize);
+        std::vector<std::complex<float>> samples(n);
+        std::vector<float> power(n), timeShift(n), freqShift(n);
+        auto& grid = grids[w];
+        grid = PooledBuffer<float>(cells);
+        std::fill(grid.begin(), grid.end(), 0.0f);
+
+        for (size_t idx = begin; idx < end; idx++) {
+            int line = firstLine + static_cast<int>(idx);
+            size_t offset = startSample + static_cast<ptrdiff_t>(line) * stride;
+            source.getSamplesInCapture(offset, n, samples.data(), channel);
+            engine.computeFrame(samples.data(), power.data(), timeShift.data(), freqShift.data());
+
+            for (size_t i = 0; i < n; i++) {
+                if (power[i] <= 0.0f) continue;
+                long targetLine = lroundf(line + timeShift[i] / stride);
+                long targetBin = lroundf(i + freqShift[i]);
+                if (targetLine < 0 || targetLine >= numLines) continue;
+                if (targetBin < 0 || targetBin >= static_cast<long>(n)) continue;
+                grid[targetLine * n + targetBin] += power[i];
+            }
+        }
+    });
+
+    // Sum the per-worker grids and convert to dB
+    const float logMultiplier = 10.0f / log2f(10.0f);
+    for (size_t c = 0; c < cells; c++) {
+        float total = 0.0f;
+        for (auto& grid : grids) total += grid[c];
+        // Avoid log of zero
+        if (total < 1e-20f) total = 1e-20f;
+        output[c] = log2f(total) * logMultiplier;
+    }
+}
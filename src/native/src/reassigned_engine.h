@@ -0,0 +1,40 @@
+#pragma once
+
+#include "input_source.h"
+#include "fft_engine.h"
+
+#include <complex>
+#include <vector>
+
+// Time-frequency reassignment (Auger & Flandrin). Each STFT bin's energy
+// is moved to the centre of gravity of the signal energy it saw, which
+// sharpens chirps and short bursts far beyond the window's resolution.
+class ReassignedEngine {
+public:
+    explicit ReassignedEngine(int fftSize);
+    ~ReassignedEngine();
+
+    // One frame. power is the DC-centered linear power (same scale as
+    // FFTEngine); timeShift is in samples relative to the frame centre and
+    // freqShift in bins. Shifts are zero where the bin holds no energy.
+    void computeFrame(const std::complex<float>* input,
+                      float* power, float* timeShift, float* freqShift);
+
+    // Tile of numLines DC-centered dB lines starting at startSample,
+    // accumulated in parallel across lines
+    static void computeTile(const InputSource& source, size_t startSample,
+                            int fftSize, int stride, int numLines, float* output,
+                            unsigned channel = 0);
+
+    int size() const { return fftSize_; }
+
+private:
+    int fftSize_;
+    std::vector<float> window_;       // Hann h(n)
+    std::vector<float> rampWindow_;   // (n - centre) * h(n)
+    std::vector<float> derivWindow_;  // dh/dn
+    // Three contiguous N-point inputs/outputs transformed by one plan
+    fftwf_complex* fftwIn_ = nullptr;
+    fftwf_complex* fftwOut_ = nullptr;
+    fftwf_plan plan_ = nullptr;
+};
@@ -0,0 +1,366 @@
+#include "sample_search.h"
+#include "format_traits.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+// Sample positions per parallel work item
+const size_t CHUNK_SAMPLES = size_t(1) << 20;
+// Power and clip tests check a block at once with a vectorizable
+// reduction, and only look at single samples in blocks that hit
+const size_t BLOCK_SAMPLES = 4096;
+
+// Matching positions first..last, inclusive, and the extreme power among
+// them in the scan's own units
+struct Run {
+    size_t first = 0;
+    size_t last = 0;
+    double peak = 0.0;
+};
+
+// A format's samples as exact numbers: integer formats keep their raw
+// values, with cu8 scaled by 5 so its 127.4 offset stays integral, and
+// square them into an unsigned power that cannot overflow. unit is the
+// full-scale fraction of one step of value().
+template <typename Traits>
+struct RawDomain {
+    using Raw = typename Traits::RawType;
+    static constexpr bool isFloat = std::is_floating_point<Raw>::value;
+    static constexpr bool isUnsigned = std::is_same<Raw, uint8_t>::value;
+    static constexpr bool wide = std::is_same<Raw, int32_t>::value;
+
+    using Value = typename std::conditional<isFloat, Raw,
+                  typename std::conditional<wide, int64_t, int32_t>::type>::type;
+    using Power = typename std::conditional<isFloat, Raw,
+                  typename std::conditional<wide, uint64_t, uint32_t>::type>::type;
+    // Window sums: exact for the narrow formats, double where a sum of
+    // int32 powers could overflow
+    using Sum = typename std::conditional<isFloat || wide, double, uint64_t>::type;
+
+    static constexpr int gain = isUnsigned ? 5 : 1;
+    static constexpr int bias = isUnsigned ? 637 : 0;
+    static constexpr double unit = static_cast<double>(Traits::scale) / gain;
+
+    // Components at or beyond these are clipped, matching the clipLevel of
+    // the SampleAdapters; floats clip at +-1
+    static constexpr Raw clipLow = isFloat ? Raw(-1) : isUnsigned ? Raw(0) : Raw(-std::numeric_limits<Raw>::max());
+    static constexpr Raw clipHigh = isFloat ? Raw(1) : std::numeric_limits<Raw>::max();
+
+    static Value value(Raw v) {
+        return isFloat ? static_cast<Value>(v) : static_cast<Value>(v) * gain - bias;
+    }
+
+    static Power power(const Raw* s) {
+        Value i = value(s[0]);
+        Value q = Traits::complex ? value(s[Traits::complex ? 1 : 0]) : Value(0);
+        return static_cast<Power>(i * i) + static_cast<Power>(q * q);
+    }
+
+    static bool clipped(const Raw* s) {
+        bool c = s[0] <= clipLow || s[0] >= clipHigh;
+        if (Traits::complex) {
+            const Raw q = s[Traits::complex ? 1 : 0];
+            c = c || q <= clipLow || q >= clipHigh;
+        }
+        return c;
+    }
+
+    // Smallest value of type T at or over x, clamped to T's range
+    template <typename T>
+    static T ceilTo(double x) {
+        if (std::is_floating_point<T>::value) return static_cast<T>(x);
+        if (x <= 0.0) return T(0);
+        if (x >= static_cast<double>(std::numeric_limits<T>::max())) return std::numeric_limits<T>::max();
+        return static_cast<T>(std::ceil(x));
+    }
+};
+
+// Collects matching positions into runs, joining those at most maxGap
+// positions apart
+class RunBuilder {
+public:
+    RunBuilder(size_t maxGap, size_t maxRuns, bool below, std::vector<Run>& runs)
+        : maxGap_(maxGap), maxRuns_(maxRuns), below_(below), runs_(runs) {}
+
+    // False once maxRuns runs are closed and another one starts
+    bool add(size_t pos, double power) {
+        if (open_ && pos - current_.last - 1 <= maxGap_) {
+            current_.last = pos;
+            current_.peak = below_ ? std::min(current_.peak, power) : std::max(current_.peak, power);
+            return true;
+        }
+        if (open_) runs_.push_back(current_);
+        if (runs_.size() >= maxRuns_) {
+            open_ = false;
+            return false;
+        }
+        current_ = {pos, pos, power};
+        open_ = true;
+        return true;
+    }
+
+    void finish() {
+        if (open_) runs_.push_back(current_);
+        open_ = false;
+    }
+
+private:
+    size_t maxGap_;
+    size_t maxRuns_;
+    bool below_;
+    std::vector<Run>& runs_;
+    Run current_;
+    bool open_ = false;
+};
+
+template <typename Traits>
+class ChunkScanner {
+    using D = RawDomain<Traits>;
+    using Raw = typename Traits::RawType;
+    using Power = typename D::Power;
+    using Sum = typename D::Sum;
+
+public:
+    ChunkScanner(const InputSource& source, const SampleSearchConfig& config, size_t window, size_t maxRuns)
+        : source_(source), config_(config), window_(window), maxRuns_(maxRuns) {
+        // Threshold power in the domain's units
+        const double threshold = std::pow(10.0, config.thresholdDb / 10.0) / (D::unit * D::unit);
+        threshold_ = D::template ceilTo<Power>(threshold);
+        sumThreshold_ = D::template ceilTo<Sum>(threshold * static_cast<double>(window));
+    }
+
+    // Positions [first, last) of the search, each testing the sample
+    // there or, for average power, the window starting there
+    void scan(size_t first, size_t last, std::vector<uint8_t>& staging, std::vector<Run>& runs) {
+        const size_t count = last - first;
+        const size_t span = count + window_ - 1;
+        const Raw* src = static_cast<const Raw*>(
+            Traits::channelData(source_.rawSamples(first, span, staging), config_.channel));
+        RunBuilder builder(config_.maxGap, maxRuns_, config_.below, runs);
+
+        // step is the channel count, a compile-time constant for the
+        // common layouts as in the format loaders
+        withStep(source_.channels(), [&](auto step) {
+            switch (config_.condition) {
+            case SampleCondition::Power:
+                scanPower(src, step, first, count, builder);
+                break;
+            case SampleCondition::AveragePower:
+                scanAverage(src, step, first, count, builder);
+                break;
+            case SampleCondition::Clip:
+                scanClip(src, step, first, count, builder);
+                break;
+            }
+        });
+        builder.finish();
+    }
+
+private:
+    // Sample i of the channel, step frames apart
+    template <typename Step>
+    static const Raw* at(const Raw* src, size_t i, Step step) {
+        return src + i * step * Traits::components;
+    }
+
+    bool matches(Power p) const { return config_.below ? p < threshold_ : p >= threshold_; }
+
+    template <typename Step>
+    void scanPower(const Raw* src, Step step, size_t first, size_t count, RunBuilder& builder) {
+        for (size_t b = 0; b < count; b += BLOCK_SAMPLES) {
+            const size_t n = std::min(BLOCK_SAMPLES, count - b);
+            const Raw* block = at(src, b, step);
+            // The block's strongest (or weakest) sample decides whether
+            // any can match
+            Power extreme = D::power(block);
+            if (config_.below) {
+                for (size_t i = 1; i < n; i++) extreme = std::min(extreme, D::power(at(block, i, step)));
+            } else {
+                for (size_t i = 1; i < n; i++) extreme = std::max(extreme, D::power(at(block, i, step)));
+            }
+            if (!matches(extreme)) continue;
+            for (size_t i = 0; i < n; i++) {
+                Power p = D::power(at(block, i, step));
+                if (matches(p) && !builder.add(first + b + i, static_cast<double>(p))) return;
+            }
+        }
+    }
+
+    template <typename Step>
+    void scanClip(const Raw* src, Step step, size_t first, size_t count, RunBuilder& builder) {
+        for (size_t b = 0; b < count; b += BLOCK_SAMPLES) {
+            const size_t n = std::min(BLOCK_SAMPLES, count - b);
+            const Raw* block = at(src, b, step);
+            unsigned hits = 0;
+            for (size_t i = 0; i < n; i++) hits += D::clipped(at(block, i, step));
+            if (!hits) continue;
+            for (size_t i = 0; i < n; i++) {
+                const Raw* s = at(block, i, step);
+                if (D::clipped(s) && !builder.add(first + b + i, static_cast<double>(D::power(s)))) return;
+            }
+        }
+    }
+
+    // Running window sum; exact for integer formats, so it never drifts
+    template <typename Step>
+    void scanAverage(const Raw* src, Step step, size_t first, size_t count, RunBuilder& builder) {
+        Sum sum = 0;
+        for (size_t i = 0; i < window_; i++) sum += D::power(at(src, i, step));
+        for (size_t i = 0; ; i++) {
+            bool match = config_.below ? sum < sumThreshold_ : sum >= sumThreshold_;
+            if (match && !builder.add(first + i, static_cast<double>(sum) / window_)) return;
+            if (i + 1 >= count) break;
+            sum += D::power(at(src, i + window_, step));
+            sum -= D::power(at(src, i, step));
+        }
+    }
+
+    const InputSource& source_;
+    const SampleSearchConfig& config_;
+    size_t window_;
+    size_t maxRuns_;
+    Power threshold_;
+    Sum sumThreshold_;
+};
+
+template <typename Traits>
+SampleSearchResult runFormat(const InputSource& source, const SampleSearchConfig& config, size_t window,
+                             const SampleSearch::ProgressCallback& onProgress, const std::atomic<bool>& cancel) {
+    using D = RawDomain<Traits>;
+    const size_t end = config.end == 0 ? source.totalSamples() : std::min(config.end, source.totalSamples());
+    const size_t start = config.start;
+    const size_t positions = end - start - window + 1;
+    const size_t chunks = (positions + CHUNK_SAMPLES - 1) / CHUNK_SAMPLES;
+    const bool all = config.mode == SampleSearchMode::All;
+    // A chunk never needs more runs than could make the final list
+    const size_t maxRuns = all ? config.maxRanges + 1 : 2;
+    const size_t maxGap = config.maxGap;
+
+    std::vector<std::vector<Run>> found(chunks);
+    std::vector<char> scanned(chunks, 0);
+    auto scanChunk = [&](size_t c, std::vector<uint8_t>& staging) {
+        size_t first = start + c * CHUNK_SAMPLES;
+        size_t last = std::min(first + CHUNK_SAMPLES, start + positions);
+        ChunkScanner<Traits>(source, config, window, maxRuns).scan(first, last, staging, found[c]);
+        scanned[c] = 1;
+    };
+
+    // Whether chunk c settles where the search ends: for first and next a
+    // range the mode does not pass over, for all a full list of its own
+    auto settles = [&](size_t c) {
+        const auto& runs = found[c];
+        if (all) return runs.size() > config.maxRanges;
+        if (runs.empty()) return false;
+        return config.mode == SampleSearchMode::First || runs.size() > 1 || runs[0].first != start;
+    };
+
+    // Chunks go out in file order; once one settles, later ones are skipped
+    std::atomic<size_t> stopAfter{chunks};
+    std::mutex progressMutex;
+    size_t chunksDone = 0;
+    unsigned workers = parallelWorkers(chunks);
+    std::vector<std::vector<uint8_t>> staging(workers);
+    parallelForEach(chunks, workers, [&](size_t c, unsigned w) {
+        if (cancel || c > stopAfter.load()) return;
+        // Read ahead of the chunk this worker will likely take next
+        if (c + workers < chunks) {
+            source.prefetch(start + (c + workers) * CHUNK_SAMPLES, CHUNK_SAMPLES + window - 1);
+        }
+        scanChunk(c, staging[w]);
+        if (settles(c)) {
+            size_t seen = stopAfter.load();
+            while (c < seen && !stopAfter.compare_exchange_weak(seen, c)) {}
+        }
+        std::lock_guard<std::mutex> lock(progressMutex);
+        chunksDone++;
+        if (onProgress) onProgress(static_cast<double>(chunksDone) / chunks);
+    });
+
+    // Join runs across chunk edges in order. Chunks skipped above are
+    // scanned here only if the answer's last run reaches into them.
+    SampleSearchResult result;
+    std::vector<Run> runs;
+    for (size_t c = 0; c < chunks; c++) {
+        if (cancel) {
+            result.cancelled = true;
+            break;
+        }
+        if (!scanned[c]) scanChunk(c, staging[0]);
+        const size_t chunkEnd = std::min(start + (c + 1) * CHUNK_SAMPLES, start + positions);
+        result.scanned = chunkEnd - start;
+        for (const auto& r : found[c]) {
+            if (!runs.empty() && r.first - runs.back().last - 1 <= maxGap) {
+                Run& prev = runs.back();
+                prev.last = r.last;
+                prev.peak = config.below ? std::min(prev.peak, r.peak) : std::max(prev.peak, r.peak);
+            } else {
+                runs.push_back(r);
+            }
+        }
+        std::vector<Run>().swap(found[c]);
+
+        if (all) {
+            // Only the last run can still grow
+            if (runs.size() > config.maxRanges) {
+                runs.resize(config.maxRanges);
+                result.truncated = true;
+                break;
+            }
+            continue;
+        }
+        size_t answer = config.mode == SampleSearchMode::Next && !runs.empty() && runs[0].first == start ? 1 : 0;
+        if (runs.size() > answer &&
+            (runs.size() > answer + 1 || runs[answer].last + maxGap + 1 < chunkEnd)) {
+            runs = {runs[answer]};
+            break;
+        }
+        if (c + 1 == chunks) {
+            // The file ended inside the answer, or there is none
+            if (runs.size() > answer) runs = {runs[answer]};
+            else runs.clear();
+        }
+    }
+    if (result.cancelled) runs.clear();
+
+    // Average power runs cover the windows starting at their positions
+    const double unitPower = D::unit * D::unit;
+    for (const auto& r : runs) {
+        SampleRange range;
+        range.sampleStart = r.first;
+        range.sampleCount = r.last - r.first + window;
+        range.peakDb = static_cast<float>(10.0 * std::log10(std::max(r.peak * unitPower, 1e-30)));
+        result.ranges.push_back(range);
+    }
+    return result;
+}
+
+} // namespace
+
+SampleSearchResult SampleSearch::run(
+    const InputSource& source,
+    const SampleSearchConfig& config,
+    const ProgressCallback& onProgress,
+    const std::atomic<bool>& cancel
+) {
+    if (config.channel >= source.channels()) {
+        throw std::runtime_error("Channel out of range: " + std::to_string(config.channel));
+    }
+    const size_t window = config.condition == SampleCondition::AveragePower ? config.window : 1;
+    if (window == 0) throw std::runtime_error("Averaging window must be at least one sample");
+    size_t end = config.end == 0 ? source.totalSamples() : std::min(config.end, source.totalSamples());
+    if (config.start >= end) throw std::runtime_error("Empty search range");
+    if (end - config.start < window) {
+        throw std::runtime_error("Search range is shorter than the averaging window");
+    }
+
+    return dispatchFormat(source.format(), [&](auto traits) {
+        return runFormat<decltype(traits)>(source, config, window, onProgress, cancel);
+    });
+}
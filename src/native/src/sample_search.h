@@ -0,0 +1,67 @@
+#pragma once
+
+#include "input_source.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+// What a sample has to show to match
+enum class SampleCondition {
+    Power,          // instantaneous power |x|^2 against thresholdDb
+    AveragePower,   // power averaged over window samples against thresholdDb
+    Clip            // I or Q at the format's full scale (|x| >= 1 for floats)
+};
+
+enum class SampleSearchMode {
+    First,   // the earliest range at or after start
+    Next,    // the same, but a range already under way at start is passed over
+    All      // every range, up to maxRanges
+};
+
+struct SampleSearchConfig {
+    SampleCondition condition = SampleCondition::Power;
+    SampleSearchMode mode = SampleSearchMode::First;
+    double thresholdDb = -20.0;  // dBFS
+    bool below = false;          // match power under the threshold instead of at or over it
+    size_t window = 1024;        // average power window, samples
+    size_t start = 0;
+    size_t end = 0;              // 0 = end of file
+    size_t maxGap = 0;           // matches at most this many samples apart join one range
+    size_t maxRanges = 10000;
+    unsigned channel = 0;
+};
+
+struct SampleRange {
+    size_t sampleStart = 0;
+    size_t sampleCount = 0;      // for average power, through the end of the last matching window
+    float peakDb = 0.0f;         // strongest (or for below, weakest) matching power, dBFS
+};
+
+struct SampleSearchResult {
+    std::vector<SampleRange> ranges;
+    size_t scanned = 0;          // samples tested before the search could stop
+    bool truncated = false;      // all mode: more than maxRanges ranges
+    bool cancelled = false;
+};
+
+// Time-domain threshold search straight over the stored samples. Each
+// format is tested in its own number type: integer formats compare their
+// squared raw values against the threshold mapped into raw units, so no
+// sample is converted to float. The range is cut into chunks scanned in
+// parallel in file order; first and next stop handing out chunks once one
+// holds the answer, so a hit near the start returns without reading the
+// rest of the file.
+class SampleSearch {
+public:
+    using ProgressCallback = std::function<void(double)>;
+
+    // Throws std::runtime_error for an empty range, a zero window or a
+    // channel out of range
+    static SampleSearchResult run(
+        const InputSource& source,
+        const SampleSearchConfig& config,
+        const ProgressCallback& onProgress,
+        const std::atomic<bool>& cancel
+    );
+};
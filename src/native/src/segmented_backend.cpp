@@ -0,0 +1,71 @@
+#include "segmented_backend.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+SegmentedBackend::SegmentedBackend(std::vector<std::unique_ptr<DataBackend>> segments, size_t sampleSize)
+    : segments_(std::move(segments)), sampleSize_(sampleSize) {
+    if (segments_.empty()) {
+        throw std::runtime_error("No segments to open");
+    }
+
+    size_t offset = 0;
+    for (auto& seg : segments_) {
+        starts_.push_back(offset);
+        offset += seg->size() / sampleSize_ * sampleSize_;
+    }
+    size_.store(offset);
+}
+
+size_t SegmentedBackend::locate(size_t offset) const {
+    auto it = std::upper_bound(starts_.begin(), starts_.end(), offset);
+    return static_cast<size_t>(it - starts_.begin()) - 1;
+}
+
+size_t SegmentedBackend::segmentEnd(size_t index) const {
+    return index + 1 < starts_.size() ? starts_[index + 1] : size();
+}
+
+const void* SegmentedBackend::span(size_t offset, size_t length) const {
+    size_t i = locate(offset);
+    if (offset + length > segmentEnd(i)) return nullptr;
+    return segments_[i]->span(offset - starts_[i], length);
+}
+
+void SegmentedBackend::read(size_t offset, size_t length, void* dest) const {
+    if (offset + length > size()) {
+        throw std::runtime_error("Read beyond end of file");
+    }
+
+    auto out = static_cast<uint8_t*>(dest);
+    while (length > 0) {
+        size_t i = locate(offset);
+        size_t chunk = std::min(length, segmentEnd(i) - offset);
+        segments_[i]->read(offset - starts_[i], chunk, out);
+        offset += chunk;
+        out += chunk;
+        length -= chunk;
+    }
+}
+
+void SegmentedBackend::prefetch(size_t offset, size_t length) const {
+    size_t total = size();
+    if (offset >= total) return;
+    length = std::min(length, total - offset);
+
+    while (length > 0) {
+        size_t i = locate(offset);
+        size_t chunk = std::min(length, segmentEnd(i) - offset);
+        segments_[i]->prefetch(offset - starts_[i], chunk);
+        offset += chunk;
+        length -= chunk;
+    }
+}
+
+size_t SegmentedBackend::refresh() {
+    size_t last = segments_.back()->refresh();
+    size_t total = starts_.back() + last / sampleSize_ * sampleSize_;
+    size_.store(total, std::memory_order_release);
+    return total;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "data_backend.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Concatenates ordered segment files (rolled recordings, SigMF collection
+// streams) into one contiguous byte space. Each segment is trimmed to whole
+// samples so no sample straddles a file boundary.
+class SegmentedBackend : public DataBackend {
+public:
+    SegmentedBackend(std::vector<std::unique_ptr<DataBackend>> segments, size_t sampleSize);
+
+    const char* name() const override { return segments_.front()->name(); }
+    size_t size() const override { return size_.load(std::memory_order_acquire); }
+    const void* span(size_t offset, size_t length) const override;
+    void read(size_t offset, size_t length, void* dest) const override;
+    void prefetch(size_t offset, size_t length) const override;
+
+    // Only the last segment can still be recording
+    size_t refresh() override;
+
+    size_t segmentCount() const { return segments_.size(); }
+
+private:
+    // Index of the segment holding byte offset, O(log n)
+    size_t locate(size_t offset) const;
+    size_t segmentEnd(size_t index) const;
+
+    std::vector<std::unique_ptr<DataBackend>> segments_;
+    std::vector<size_t> starts_;  // byte offset of each segment in the virtual file
+    size_t sampleSize_;
+    std::atomic<size_t> size_{0};
+};
@@ -1,57 +1,173 @@
 #include "sigmf_parser.h"
+#include <cmath>
 #include <fstream>
+#include <sstream>
+#include <stdexcept>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
-SigMFMetadata SigMFParser::parse(const std::string& jsonContent) {
-    SigMFMetadata meta;
+namespace {
+
+// Tracks where in the document each event lands and keeps only the
+// fields snail uses; everything else (extensions, nested objects) is
+// skipped without being materialized.
+class MetaHandler : public nlohmann::json_sax<json> {
+public:
+    MetaHandler(SigMFMetadata& meta, const SigMFParser::AnnotationCallback& onAnnotation)
+        : meta_(meta), onAnnotation_(onAnnotation) {}
+
+    bool start_object(std::size_t) override {
+        Context next = Context::Skip;
+        switch (current()) {
+            case Context::Root: next = Context::Top; break;
+            case Context::Top:
+                if (key_ == "global") next = Context::Global;
+                break;
+            case Context::CaptureList:
+                meta_.captures.emplace_back();
+                next = Context::Capture;
+                break;
+            case Context::AnnotationList:
+                annotation_ = SigMFAnnotation();
+                next = Context::Annotation;
+                break;
+            default: break;
+        }
+        stack_.push_back(next);
+        return true;
+    }
+
+    bool end_object() override {
+        if (current() == Context::Annotation) onAnnotation_(std::move(annotation_));
+        stack_.pop_back();
+        return true;
+    }
 
-    auto doc = json::parse(jsonContent);
-
-    // Global section
-    if (doc.contains("global")) {
-        auto& global = doc["global"];
-        if (global.contains("core:datatype"))
-            meta.datatype = global["core:datatype"].get<std::string>();
-        if (global.contains("core:sample_rate"))
-            meta.sampleRate = global["core:sample_rate"].get<double>();
-        if (global.contains("core:description"))
-            meta.description = global["core:description"].get<std::string>();
-        if (global.contains("core:author"))
-            meta.author = global["core:author"].get<std::string>();
-    }
-
-    // Captures section
-    if (doc.contains("captures") && doc["captures"].is_array() && !doc["captures"].empty()) {
-        auto& cap = doc["captures"][0];
-        if (cap.contains("core:frequency"))
-            meta.centerFrequency = cap["core:frequency"].get<double>();
-    }
-
-    // Annotations section
-    if (doc.contains("annotations") && doc["annotations"].is_array()) {
-        for (auto& ann : doc["annotations"]) {
-            SigMFAnnotation a;
-            a.sampleStart = ann.value("core:sample_start", size_t(0));
-            a.sampleCount = ann.value("core:sample_count", size_t(0));
-            a.freqLowerEdge = ann.value("core:freq_lower_edge", 0.0);
-            a.freqUpperEdge = ann.value("core:freq_upper_edge", 0.0);
-            a.label = ann.value("core:label", std::string());
-            a.comment = ann.value("core:comment", std::string());
-            meta.annotations.push_back(a);
+    bool start_array(std::size_t) override {
+        Context next = Context::Skip;
+        if (current() == Context::Top) {
+            if (key_ == "captures") next = Context::CaptureList;
+            else if (key_ == "annotations") next = Context::AnnotationList;
         }
+        stack_.push_back(next);
+        return true;
+    }
+
+    bool end_array() override {
+        stack_.pop_back();
+        return true;
     }
 
+    bool key(string_t& key) override {
+        key_ = key;
+        return true;
+    }
+
+    bool number_integer(number_integer_t value) override {
+        return number(static_cast<double>(value), value < 0 ? 0 : static_cast<size_t>(value));
+    }
+
+    bool number_unsigned(number_unsigned_t value) override {
+        return number(static_cast<double>(value), static_cast<size_t>(value));
+    }
+
+    bool number_float(number_float_t value, const string_t&) override {
+        return number(value, value < 0 ? 0 : static_cast<size_t>(value));
+    }
+
+    bool string(string_t& value) override {
+        switch (current()) {
+            case Context::Global:
+                if (key_ == "core:datatype") meta_.datatype = value;
+                else if (key_ == "core:description") meta_.description = value;
+                else if (key_ == "core:author") meta_.author = value;
+                break;
+            case Context::Capture:
+                if (key_ == "core:datetime") meta_.captures.back().datetime = value;
+                break;
+            case Context::Annotation:
+                if (key_ == "core:label") annotation_.label = std::move(value);
+                else if (key_ == "core:comment") annotation_.comment = std::move(value);
+                break;
+            default: break;
+        }
+        return true;
+    }
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool binary(binary_t&) override { return true; }
+
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& e) override {
+        throw std::runtime_error("Invalid SigMF metadata at byte " + std::to_string(position) + ": " + e.what());
+    }
+
+private:
+    enum class Context { Root, Top, Global, CaptureList, Capture, AnnotationList, Annotation, Skip };
+
+    Context current() const { return stack_.empty() ? Context::Root : stack_.back(); }
+
+    bool number(double value, size_t count) {
+        switch (current()) {
+            case Context::Global:
+                if (key_ == "core:sample_rate") meta_.sampleRate = value;
+                else if (key_ == "core:num_channels") meta_.numChannels = count;
+                break;
+            case Context::Capture:
+                if (key_ == "core:sample_start") meta_.captures.back().sampleStart = count;
+                else if (key_ == "core:frequency") meta_.captures.back().frequency = value;
+                else if (key_ == "core:global_index") {
+                    meta_.captures.back().globalIndex = count;
+                    meta_.captures.back().hasGlobalIndex = true;
+                }
+                break;
+            case Context::Annotation:
+                if (key_ == "core:sample_start") annotation_.sampleStart = count;
+                else if (key_ == "core:sample_count") annotation_.sampleCount = count;
+                else if (key_ == "core:freq_lower_edge") annotation_.freqLowerEdge = value;
+                else if (key_ == "core:freq_upper_edge") annotation_.freqUpperEdge = value;
+                break;
+            default: break;
+        }
+        return true;
+    }
+
+    SigMFMetadata& meta_;
+    const SigMFParser::AnnotationCallback& onAnnotation_;
+    std::vector<Context> stack_;
+    std::string key_;
+    SigMFAnnotation annotation_;
+};
+
+}  // namespace
+
+SigMFMetadata SigMFParser::parseStream(std::istream& in, const AnnotationCallback& onAnnotation) {
+    SigMFMetadata meta;
+    MetaHandler handler(meta, onAnnotation);
+    json::sax_parse(in, &handler);
+
+    if (!meta.captures.empty() && !std::isnan(meta.captures.front().frequency)) {
+        meta.centerFrequency = meta.captures.front().frequency;
+    }
+    return meta;
+}
+
+SigMFMetadata SigMFParser::parse(const std::string& jsonContent) {
+    std::istringstream in(jsonContent);
+    std::vector<SigMFAnnotation> annotations;
+    SigMFMetadata meta = parseStream(in, [&](SigMFAnnotation&& a) { annotations.push_back(std::move(a)); });
+    meta.annotations = std::move(annotations);
     return meta;
 }
 
 SigMFMetadata SigMFParser::parseFile(const std::string& metaPath) {
-    std::ifstream file(metaPath);
+    std::ifstream file(metaPath, std::ios::binary);
     if (!file.good()) {
         throw std::runtime_error("Cannot open SigMF meta file: " + metaPath);
     }
-    std::string content((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    return parse(content);
+    std::vector<SigMFAnnotation> annotations;
+    SigMFMetadata meta = parseStream(file, [&](SigMFAnnotation&& a) { annotations.push_back(std::move(a)); });
+    meta.annotations = std::move(annotations);
+    return meta;
 }
@@ -1,28 +1,53 @@
 #pragma once
 
+#include <functional>
+#include <istream>
+#include <limits>
 #include <string>
 #include <vector>
 
 struct SigMFAnnotation {
-    size_t sampleStart;
-    size_t sampleCount;
-    double freqLowerEdge;
-    double freqUpperEdge;
+    size_t sampleStart = 0;
+    size_t sampleCount = 0;
+    // NaN when the annotation has no frequency extent (covers the whole band)
+    double freqLowerEdge = std::numeric_limits<double>::quiet_NaN();
+    double freqUpperEdge = std::numeric_limits<double>::quiet_NaN();
     std::string label;
     std::string comment;
 };
 
+struct SigMFCapture {
+    size_t sampleStart = 0;
+    double frequency = std::numeric_limits<double>::quiet_NaN();  // NaN when absent
+    size_t globalIndex = 0;      // position in the recording's global sample stream
+    bool hasGlobalIndex = false;
+    std::string datetime;
+};
+
 struct SigMFMetadata {
     std::string datatype;
     double sampleRate = 0;
-    double centerFrequency = 0;
+    double centerFrequency = 0;  // frequency of the first capture
+    size_t numChannels = 1;      // samples interleaved per frame
     std::string description;
     std::string author;
-    std::vector<SigMFAnnotation> annotations;
+    std::vector<SigMFCapture> captures;
+    std::vector<SigMFAnnotation> annotations;  // empty when streamed to a callback
 };
 
+// Streaming (SAX) parser: the metadata is never held as a JSON DOM, so
+// files with millions of annotations parse in one pass at the memory
+// cost of whatever the caller keeps.
 class SigMFParser {
 public:
+    using AnnotationCallback = std::function<void(SigMFAnnotation&&)>;
+
+    // Global and captures fill the result; each annotation is handed to
+    // onAnnotation as soon as its object closes. Throws std::runtime_error
+    // on malformed JSON (annotations before the error are still delivered).
+    static SigMFMetadata parseStream(std::istream& in, const AnnotationCallback& onAnnotation);
+
+    // Convenience forms that collect annotations into the result
     static SigMFMetadata parse(const std::string& jsonContent);
     static SigMFMetadata parseFile(const std::string& metaPath);
 };
@@ -1,4 +1,6 @@
 #include "sigmf_writer.h"
+#include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <stdexcept>
 #include <nlohmann/json.hpp>
@@ -21,7 +23,10 @@ void SigMFWriter::write(
                        sampleCount * sizeof(std::complex<float>));
     }
 
-    // Write .sigmf-meta (JSON metadata)
+    writeMeta(config);
+}
+
+void SigMFWriter::writeMeta(const SigMFWriteConfig& config) {
     std::string metaPath = config.outputPath + ".sigmf-meta";
     {
         json meta;
@@ -42,13 +47,31 @@ void SigMFWriter::write(
         }
 
         // Captures
-        json capture = {
-            {"core:sample_start", 0}
-        };
-        if (config.centerFrequency != 0) {
-            capture["core:frequency"] = config.centerFrequency;
+        meta["captures"] = json::array();
+        if (config.captures.empty()) {
+            json capture = {
+                {"core:sample_start", 0}
+            };
+            if (config.centerFrequency != 0) {
+                capture["core:frequency"] = config.centerFrequency;
+            }
+            meta["captures"].push_back(capture);
+        }
+        for (auto& c : config.captures) {
+            json capture = {
+                {"core:sample_start", c.sampleStart}
+            };
+            if (!std::isnan(c.frequency) && c.frequency != 0) {
+                capture["core:frequency"] = c.frequency;
+            }
+            if (c.hasGlobalIndex) {
+                capture["core:global_index"] = c.globalIndex;
+            }
+            if (!c.datetime.empty()) {
+                capture["core:datetime"] = c.datetime;
+            }
+            meta["captures"].push_back(capture);
         }
-        meta["captures"] = json::array({capture});
 
         // Annotations (if we have a meaningful range)
         meta["annotations"] = json::array();
@@ -66,3 +89,26 @@ void SigMFWriter::write(
         metaFile << meta.dump(2);
     }
 }
+
+std::vector<SigMFCapture> SigMFWriter::rebaseCaptures(
+    const std::vector<SigMFCapture>& captures,
+    size_t start,
+    size_t end
+) {
+    std::vector<SigMFCapture> out;
+    for (size_t i = 0; i < captures.size(); i++) {
+        if (captures[i].sampleStart >= end) break;
+        size_t next = i + 1 < captures.size() ? captures[i + 1].sampleStart : SIZE_MAX;
+        if (next <= start) continue;
+        SigMFCapture c = captures[i];
+        if (c.sampleStart < start) {
+            c.globalIndex += start - c.sampleStart;
+            c.datetime.clear();
+            c.sampleStart = 0;
+        } else {
+            c.sampleStart -= start;
+        }
+        out.push_back(std::move(c));
+    }
+    return out;
+}
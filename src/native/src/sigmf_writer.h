@@ -1,5 +1,7 @@
 #pragma once
 
+#include "sigmf_parser.h"
+
 #include <complex>
 #include <string>
 #include <vector>
@@ -9,6 +11,9 @@ struct SigMFWriteConfig {
     std::string datatype;       // e.g., "cf32_le"
     double sampleRate = 0;
     double centerFrequency = 0;
+    // Capture segments relative to the exported data; when empty a single
+    // capture at centerFrequency is written
+    std::vector<SigMFCapture> captures;
     std::string description;
     std::string author;
     size_t sampleStart = 0;     // annotation sample start
@@ -23,4 +28,17 @@ public:
         const std::complex<float>* samples,
         size_t sampleCount
     );
+
+    // Write only the .sigmf-meta file, for callers that stream the data
+    // file themselves
+    static void writeMeta(const SigMFWriteConfig& config);
+
+    // A source's capture segments overlapping [start, end), rebased so the
+    // export begins at sample 0. A segment cut by start keeps its tuning;
+    // its global index moves with it, but the datetime no longer applies.
+    static std::vector<SigMFCapture> rebaseCaptures(
+        const std::vector<SigMFCapture>& captures,
+        size_t start,
+        size_t end
+    );
 };
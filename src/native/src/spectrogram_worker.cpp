@@ -1,60 +1,42 @@
 #include "spectrogram_worker.h"
-#include <algorithm>
-
-// Tile contains multiple FFT lines
-static const int TILE_LINES = 256;
+#include "perf_stats.h"
+#include <cstring>
+#include <utility>
 
 SpectrogramWorker::SpectrogramWorker(
     Napi::Env env,
     Napi::Promise::Deferred deferred,
-    InputSource& source,
+    std::shared_ptr<const InputSource> source,
     size_t startSample,
     int fftSize,
-    int stride
+    int stride,
+    const TileOptions& options
 ) : Napi::AsyncWorker(env),
     deferred_(deferred),
-    source_(source),
+    source_(std::move(source)),
     startSample_(startSample),
     fftSize_(fftSize),
-    stride_(stride) {}
+    stride_(stride),
+    options_(options),
+    queuedNs_(PerfStats::nowNs()) {}
 
 void SpectrogramWorker::Execute() {
-    FFTEngine fft(fftSize_);
-
-    int stride = stride_;
-    int numLines = TILE_LINES;
-
-    // Compute lines for all samples, including partial windows at the end
-    // (getSamples zero-pads beyond the file boundary)
-    size_t maxLines = 0;
-    size_t total = source_.totalSamples();
-    if (startSample_ < total) {
-        maxLines = (total - startSample_ - 1) / stride + 1;
-    }
-    numLines = std::min(numLines, static_cast<int>(maxLines));
-    if (numLines <= 0) {
-        SetError("No samples available for tile");
-        return;
-    }
-
-    result_.resize(numLines * fftSize_);
-
-    // Buffer for reading samples
-    std::vector<std::complex<float>> sampleBuf(fftSize_);
-
-    for (int line = 0; line < numLines; line++) {
-        size_t sampleOffset = startSample_ + line * stride;
-        source_.getSamples(sampleOffset, fftSize_, sampleBuf.data());
-
-        // Compute power spectrum for this line
-        fft.computePowerSpectrum(sampleBuf.data(), result_.data() + line * fftSize_);
-    }
+    // Waiting for budget counts as queueing
+    budget_ = MemoryBudget::reserve(TileEngine::workingBytes(*source_, fftSize_, options_));
+    PerfStats::record(PerfStage::QueueWait, queuedNs_, PerfStats::nowNs());
+    PerfScope perf(PerfStage::Tile, 0, true);
+    result_ = TileEngine::compute(*source_, startSample_, fftSize_, stride_, options_);
+    // Input bytes covered by the tile's FFT windows
+    perf.addBytes(result_.size() * source_->sampleSize());
 }
 
 void SpectrogramWorker::OnOK() {
     auto env = Env();
     auto buf = Napi::Float32Array::New(env, result_.size());
-    std::memcpy(buf.Data(), result_.data(), result_.size() * sizeof(float));
+    {
+        PerfScope perf(PerfStage::CopyToJS, result_.size() * sizeof(float));
+        std::memcpy(buf.Data(), result_.data(), result_.size() * sizeof(float));
+    }
     deferred_.Resolve(buf);
 }
 
@@ -2,7 +2,14 @@
 
 #include <napi.h>
 #include "input_source.h"
-#include "fft_engine.h"
+#include "tile_engine.h"
+#include "buffer_pool.h"
+#include "memory_budget.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 // Async worker that computes an FFT tile (multiple FFT lines)
 class SpectrogramWorker : public Napi::AsyncWorker {
@@ -10,10 +17,11 @@ public:
     SpectrogramWorker(
         Napi::Env env,
         Napi::Promise::Deferred deferred,
-        InputSource& source,
+        std::shared_ptr<const InputSource> source,
         size_t startSample,
         int fftSize,
-        int stride
+        int stride,
+        const TileOptions& options = TileOptions()
     );
 
     void Execute() override;
@@ -22,9 +30,14 @@ public:
 
 private:
     Napi::Promise::Deferred deferred_;
-    InputSource& source_;
+    // Shared so a reopen of the file cannot free it mid-tile
+    std::shared_ptr<const InputSource> source_;
     size_t startSample_;
     int fftSize_;
     int stride_;
-    std::vector<float> result_;
+    TileOptions options_;
+    uint64_t queuedNs_;
+    // Held until the result is copied out
+    MemoryReservation budget_;
+    PooledBuffer<float> result_;
 };
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Lock-free single-producer / single-consumer byte ring.
+// Positions grow monotonically; capacity is rounded up to a power of two
+// so wrapping is a mask.
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        buffer_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    size_t capacity() const { return buffer_.size(); }
+
+    // Producer: bytes that can be written without overtaking the consumer
+    size_t writable() const {
+        return capacity() - (head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_acquire));
+    }
+
+    // Consumer: bytes ready to read
+    size_t readable() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+    }
+
+    // Producer: write exactly length bytes; caller checks writable() first
+    void write(const void* src, size_t length) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        copyIn(head & mask_, static_cast<const uint8_t*>(src), length);
+        head_.store(head + length, std::memory_order_release);
+    }
+
+    // Consumer: read exactly length bytes; caller checks readable() first
+    void read(void* dest, size_t length) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        copyOut(tail & mask_, static_cast<uint8_t*>(dest), length);
+        tail_.store(tail + length, std::memory_order_release);
+    }
+
+    // Consumer: discard length bytes without copying them
+    void skip(size_t length) {
+        tail_.store(tail_.load(std::memory_order_relaxed) + length, std::memory_order_release);
+    }
+
+private:
+    void copyIn(size_t pos, const uint8_t* src, size_t length) {
+        size_t first = std::min(length, capacity() - pos);
+        std::memcpy(buffer_.data() + pos, src, first);
+        std::memcpy(buffer_.data(), src + first, length - first);
+    }
+
+    void copyOut(size_t pos, uint8_t* dest, size_t length) {
+        size_t first = std::min(length, capacity() - pos);
+        std::memcpy(dest, buffer_.data() + pos, first);
+        std::memcpy(dest + first, buffer_.data(), length - first);
+    }
+
+    std::vector<uint8_t> buffer_;
+    size_t mask_;
+    // Separate cache lines so producer and consumer do not false-share
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
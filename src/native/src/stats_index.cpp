@@ -0,0 +1,448 @@
+#include "stats_index.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <sys/stat.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Instantaneous power histogram: HIST_BINS bins of HIST_STEP_DB from HIST_MIN_DB
+static const int HIST_BINS = 400;
+static const float HIST_MIN_DB = -160.0f;
+static const float HIST_STEP_DB = 0.5f;
+
+// Independent accumulators per reduction, so the summary loop vectorizes
+// without reassociating a single float sum
+static const int LANES = 8;
+
+static const char CACHE_MAGIC[8] = {'S', 'N', 'A', 'I', 'L', 'S', 'T', 'X'};
+static const uint32_t CACHE_VERSION = 1;
+
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t blockSamples;
+    uint64_t fileSize;
+    uint64_t totalSamples;
+    int64_t mtime;
+    uint64_t numBlocks;
+    char format[8];
+};
+
+// Histogram bin for every power value, indexed by the float's exponent and
+// top 7 mantissa bits (power is never negative, so the sign bit is clear).
+// Resolution is ~0.03 dB, well inside a bin, and costs no log per sample.
+static const uint16_t* powerBinTable() {
+    static const std::vector<uint16_t> table = [] {
+        std::vector<uint16_t> t(1 << 15);
+        for (int idx = 0; idx < (1 << 15); idx++) {
+            int exponent = idx >> 7;
+            int mantissa = idx & 127;
+            int bin;
+            if (exponent == 0) {
+                bin = 0;  // zero and denormals
+            } else if (exponent == 255) {
+                bin = HIST_BINS - 1;  // inf/nan
+            } else {
+                double power = std::ldexp(1.0 + (mantissa + 0.5) / 128.0, exponent - 127);
+                double db = 10.0 * std::log10(power);
+                bin = static_cast<int>(std::floor((db - HIST_MIN_DB) / HIST_STEP_DB));
+                bin = std::max(0, std::min(HIST_BINS - 1, bin));
+            }
+            t[idx] = static_cast<uint16_t>(bin);
+        }
+        return t;
+    }();
+    return table.data();
+}
+
+template <typename Count>
+static float histogramPercentile(const Count* hist, uint64_t total, double q) {
+    if (total == 0) return HIST_MIN_DB;
+    double target = q * total;
+    double cumulative = 0.0;
+    for (int b = 0; b < HIST_BINS; b++) {
+        if (hist[b] == 0) continue;
+        if (cumulative + hist[b] >= target) {
+            double frac = (target - cumulative) / hist[b];
+            return static_cast<float>(HIST_MIN_DB + (b + frac) * HIST_STEP_DB);
+        }
+        cumulative += hist[b];
+    }
+    return HIST_MIN_DB + HIST_BINS * HIST_STEP_DB;
+}
+
+static float toDb(double power) {
+    return static_cast<float>(10.0 * std::log10(std::max(power, 1e-20)));
+}
+
+// Summarize n samples into out, counting instantaneous power into hist
+static void summarizeBlock(const std::complex<float>* samples, size_t n, float clipLevel,
+                           BlockStats& out, uint32_t* hist) {
+    const float* x = reinterpret_cast<const float*>(samples);
+    const float clip = clipLevel > 0.0f ? clipLevel : std::numeric_limits<float>::infinity();
+
+    float sumP[LANES] = {}, peak[LANES] = {};
+    float sumI[LANES] = {}, sumQ[LANES] = {};
+    float sumII[LANES] = {}, sumQQ[LANES] = {}, sumIQ[LANES] = {};
+    uint32_t clipped[LANES] = {};
+
+    size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        for (int l = 0; l < LANES; l++) {
+            float re = x[2 * (i + l)];
+            float im = x[2 * (i + l) + 1];
+            float ii = re * re;
+            float qq = im * im;
+            float p = ii + qq;
+            sumP[l] += p;
+            peak[l] = std::max(peak[l], p);
+            sumI[l] += re;
+            sumQ[l] += im;
+            sumII[l] += ii;
+            sumQQ[l] += qq;
+            sumIQ[l] += re * im;
+            clipped[l] += (std::fabs(re) >= clip) | (std::fabs(im) >= clip);
+        }
+    }
+    for (; i < n; i++) {
+        float re = x[2 * i];
+        float im = x[2 * i + 1];
+        float p = re * re + im * im;
+        sumP[0] += p;
+        peak[0] = std::max(peak[0], p);
+        sumI[0] += re;
+        sumQ[0] += im;
+        sumII[0] += re * re;
+        sumQQ[0] += im * im;
+        sumIQ[0] += re * im;
+        clipped[0] += (std::fabs(re) >= clip) | (std::fabs(im) >= clip);
+    }
+
+    double tP = 0, tI = 0, tQ = 0, tII = 0, tQQ = 0, tIQ = 0;
+    float tPeak = 0;
+    uint32_t tClipped = 0;
+    for (int l = 0; l < LANES; l++) {
+        tP += sumP[l];
+        tI += sumI[l];
+        tQ += sumQ[l];
+        tII += sumII[l];
+        tQQ += sumQQ[l];
+        tIQ += sumIQ[l];
+        tPeak = std::max(tPeak, peak[l]);
+        tClipped += clipped[l];
+    }
+
+    const uint16_t* binOf = powerBinTable();
+    std::fill(hist, hist + HIST_BINS, 0u);
+    for (size_t k = 0; k < n; k++) {
+        float p = x[2 * k] * x[2 * k] + x[2 * k + 1] * x[2 * k + 1];
+        uint32_t bits;
+        std::memcpy(&bits, &p, sizeof(bits));
+        hist[binOf[bits >> 16]]++;
+    }
+
+    double inv = n ? 1.0 / n : 0.0;
+    out.samples = static_cast<uint32_t>(n);
+    out.clipped = tClipped;
+    out.meanPower = static_cast<float>(tP * inv);
+    out.peakPower = tPeak;
+    out.p10Db = histogramPercentile(hist, n, 0.10);
+    out.p50Db = histogramPercentile(hist, n, 0.50);
+    out.p90Db = histogramPercentile(hist, n, 0.90);
+    out.p99Db = histogramPercentile(hist, n, 0.99);
+    out.meanI = static_cast<float>(tI * inv);
+    out.meanQ = static_cast<float>(tQ * inv);
+    out.powerI = static_cast<float>(tII * inv);
+    out.powerQ = static_cast<float>(tQQ * inv);
+    out.crossIQ = static_cast<float>(tIQ * inv);
+}
+
+StatsIndex::~StatsIndex() {
+    stop();
+}
+
+void StatsIndex::start(const InputSource& source, const std::string& path, const std::string& cacheDir) {
+    stop();
+
+    source_ = &source;
+    path_ = path;
+    totalSamples_ = source.totalSamples();
+    blocks_.assign((totalSamples_ + BLOCK_SAMPLES - 1) / BLOCK_SAMPLES, BlockStats{});
+
+    struct stat st;
+    mtime_ = ::stat(path.c_str(), &st) == 0 ? static_cast<int64_t>(st.st_mtime) : 0;
+
+    cachePath_.clear();
+    if (!cacheDir.empty()) {
+        std::string key = path + '\n' + std::to_string(source.fileSize()) + '\n' +
+                          std::to_string(mtime_) + '\n' + source.format() + '\n' +
+                          std::to_string(source.channels());
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016zx.stats", std::hash<std::string>{}(key));
+        cachePath_ = cacheDir + "/" + name;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        error_.clear();
+    }
+    cancel_ = false;
+    blocksDone_ = 0;
+    fromCache_ = false;
+    state_.store(State::Building, std::memory_order_release);
+    thread_ = std::thread(&StatsIndex::build, this);
+}
+
+void StatsIndex::stop() {
+    cancel_ = true;
+    if (thread_.joinable()) thread_.join();
+    source_ = nullptr;
+    blocks_.clear();
+    histogram_.clear();
+    sortedBlockDb_.clear();
+    state_.store(State::Idle, std::memory_order_release);
+}
+
+double StatsIndex::progress() const {
+    if (state() == State::Ready) return 1.0;
+    if (blocks_.empty()) return 0.0;
+    return static_cast<double>(blocksDone_.load()) / blocks_.size();
+}
+
+std::string StatsIndex::error() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return error_;
+}
+
+void StatsIndex::build() {
+    try {
+        if (loadCache()) {
+            fromCache_ = true;
+            finish();
+            state_.store(State::Ready, std::memory_order_release);
+            return;
+        }
+
+        const size_t numBlocks = blocks_.size();
+        const float clipLevel = source_->clipLevel();
+
+        // Leave a core for tile rendering, which the user is waiting on
+        unsigned workers = parallelWorkers(numBlocks);
+        if (workers > 1) workers--;
+
+        std::vector<std::vector<std::complex<float>>> buffers(workers);
+        std::vector<std::vector<uint32_t>> blockHists(workers, std::vector<uint32_t>(HIST_BINS));
+        std::vector<std::vector<uint64_t>> totals(workers, std::vector<uint64_t>(HIST_BINS, 0));
+
+        parallelForEach(numBlocks, workers, [&](size_t b, unsigned w) {
+            if (cancel_) return;
+            size_t start = b * BLOCK_SAMPLES;
+            size_t n = std::min(BLOCK_SAMPLES, totalSamples_ - start);
+            auto& buf = buffers[w];
+            buf.resize(n);
+            source_->getSamples(start, n, buf.data());
+
+            uint32_t* hist = blockHists[w].data();
+            summarizeBlock(buf.data(), n, clipLevel, blocks_[b], hist);
+            for (int k = 0; k < HIST_BINS; k++) totals[w][k] += hist[k];
+            blocksDone_++;
+        });
+        if (cancel_) return;
+
+        histogram_.assign(HIST_BINS, 0);
+        for (const auto& t : totals) {
+            for (int k = 0; k < HIST_BINS; k++) histogram_[k] += t[k];
+        }
+
+        finish();
+        saveCache();
+        state_.store(State::Ready, std::memory_order_release);
+    } catch (const std::exception& e) {
+        {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            error_ = e.what();
+        }
+        state_.store(State::Failed, std::memory_order_release);
+    }
+}
+
+void StatsIndex::finish() {
+    sortedBlockDb_.resize(blocks_.size());
+    for (size_t b = 0; b < blocks_.size(); b++) {
+        sortedBlockDb_[b] = toDb(blocks_[b].meanPower);
+    }
+    std::sort(sortedBlockDb_.begin(), sortedBlockDb_.end());
+}
+
+bool StatsIndex::loadCache() {
+    if (cachePath_.empty()) return false;
+    std::ifstream in(cachePath_, std::ios::binary);
+    if (!in) return false;
+
+    CacheHeader h;
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) return false;
+    if (std::memcmp(h.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        h.version != CACHE_VERSION ||
+        h.blockSamples != BLOCK_SAMPLES ||
+        h.fileSize != source_->fileSize() ||
+        h.totalSamples != totalSamples_ ||
+        h.mtime != mtime_ ||
+        h.numBlocks != blocks_.size() ||
+        std::strncmp(h.format, source_->format().c_str(), sizeof(h.format)) != 0) {
+        return false;
+    }
+
+    // blocks_ is already sized to match; a short read leaves it to be rebuilt
+    histogram_.assign(HIST_BINS, 0);
+    if (!in.read(reinterpret_cast<char*>(blocks_.data()), blocks_.size() * sizeof(BlockStats)) ||
+        !in.read(reinterpret_cast<char*>(histogram_.data()), histogram_.size() * sizeof(uint64_t))) {
+        return false;
+    }
+    blocksDone_ = blocks_.size();
+    return true;
+}
+
+void StatsIndex::saveCache() const {
+    if (cachePath_.empty()) return;
+
+    CacheHeader h = {};
+    std::memcpy(h.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    h.version = CACHE_VERSION;
+    h.blockSamples = BLOCK_SAMPLES;
+    h.fileSize = source_->fileSize();
+    h.totalSamples = totalSamples_;
+    h.mtime = mtime_;
+    h.numBlocks = blocks_.size();
+    std::strncpy(h.format, source_->format().c_str(), sizeof(h.format));
+
+    // Write aside and rename so a crash never leaves a truncated index behind.
+    // Caching is best effort: failures just mean a rebuild next time.
+    mkdir(cachePath_.substr(0, cachePath_.rfind('/')).c_str(), 0755);
+    std::string tmpPath = cachePath_ + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) return;
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        out.write(reinterpret_cast<const char*>(blocks_.data()), blocks_.size() * sizeof(BlockStats));
+        out.write(reinterpret_cast<const char*>(histogram_.data()), histogram_.size() * sizeof(uint64_t));
+        if (!out) {
+            out.close();
+            std::remove(tmpPath.c_str());
+            return;
+        }
+    }
+    std::rename(tmpPath.c_str(), cachePath_.c_str());
+}
+
+bool StatsIndex::autoRange(size_t start, size_t end, int fftSize, PowerRange& out) const {
+    if (state() != State::Ready || blocks_.empty() || fftSize <= 0) return false;
+
+    end = std::min(end, totalSamples_);
+    if (start >= end) return false;
+    size_t first = start / BLOCK_SAMPLES;
+    size_t last = (end - 1) / BLOCK_SAMPLES;
+
+    std::vector<float> medians;
+    medians.reserve(last - first + 1);
+    float top = -std::numeric_limits<float>::infinity();
+    for (size_t b = first; b <= last; b++) {
+        medians.push_back(blocks_[b].p50Db);
+        top = std::max(top, blocks_[b].p99Db);
+    }
+    std::nth_element(medians.begin(), medians.begin() + medians.size() / 2, medians.end());
+
+    // The median of complex Gaussian noise power sits ln 2 (1.6 dB) below
+    // its mean. A Hann-windowed bin scaled by 1/N holds 0.375/N of the
+    // noise power and a quarter of a tone's.
+    double noiseDb = medians[medians.size() / 2] + 10.0 * std::log10(1.0 / std::log(2.0));
+    double noiseBinDb = noiseDb + 10.0 * std::log10(0.375 / fftSize);
+    double toneBinDb = top + 10.0 * std::log10(0.25);
+
+    out.minDb = static_cast<float>(noiseBinDb - 3.0);
+    out.maxDb = static_cast<float>(std::max(toneBinDb, noiseBinDb + 20.0));
+    return true;
+}
+
+int64_t StatsIndex::findSignal(size_t from, int direction, double thresholdDb) const {
+    if (state() != State::Ready || blocks_.empty()) return -1;
+
+    const float floorDb = sortedBlockDb_[sortedBlockDb_.size() / 2];
+    const float level = static_cast<float>(floorDb + thresholdDb);
+    auto active = [&](int64_t b) { return toDb(blocks_[b].meanPower) > level; };
+
+    const int64_t n = static_cast<int64_t>(blocks_.size());
+    const int step = direction < 0 ? -1 : 1;
+    int64_t b = std::min<int64_t>(from / BLOCK_SAMPLES, n - 1);
+
+    // Skip the signal already under the cursor, then the quiet gap after it
+    while (b >= 0 && b < n && active(b)) b += step;
+    while (b >= 0 && b < n && !active(b)) b += step;
+    if (b < 0 || b >= n) return -1;
+
+    // Searching back lands on the end of a run; report where it starts
+    if (step < 0) {
+        while (b > 0 && active(b - 1)) b--;
+    }
+    return b * static_cast<int64_t>(BLOCK_SAMPLES);
+}
+
+bool StatsIndex::healthReport(HealthReport& out) const {
+    if (state() != State::Ready || blocks_.empty()) return false;
+
+    double total = 0, sumP = 0, sumI = 0, sumQ = 0, sumII = 0, sumQQ = 0, sumIQ = 0;
+    float peak = 0;
+    uint64_t clipped = 0;
+    for (const auto& b : blocks_) {
+        double n = b.samples;
+        total += n;
+        sumP += b.meanPower * n;
+        sumI += b.meanI * n;
+        sumQ += b.meanQ * n;
+        sumII += b.powerI * n;
+        sumQQ += b.powerQ * n;
+        sumIQ += b.crossIQ * n;
+        peak = std::max(peak, b.peakPower);
+        clipped += b.clipped;
+    }
+
+    double meanPower = sumP / total;
+    double meanI = sumI / total;
+    double meanQ = sumQ / total;
+    double varI = sumII / total - meanI * meanI;
+    double varQ = sumQQ / total - meanQ * meanQ;
+    double cov = sumIQ / total - meanI * meanQ;
+
+    out.complex = source_->isComplex();
+    out.meanPowerDb = toDb(meanPower);
+    out.peakPowerDb = toDb(peak);
+    out.noiseFloorDb = sortedBlockDb_[sortedBlockDb_.size() / 2];
+    out.dcOffsetI = meanI;
+    out.dcOffsetQ = meanQ;
+    out.dcOffsetDb = toDb((meanI * meanI + meanQ * meanQ) / std::max(meanPower, 1e-20));
+    out.iqGainDb = 0.0;
+    out.iqPhaseDeg = 0.0;
+    if (out.complex && varI > 0 && varQ > 0) {
+        out.iqGainDb = 10.0 * std::log10(varI / varQ);
+        double corr = std::max(-1.0, std::min(1.0, cov / std::sqrt(varI * varQ)));
+        out.iqPhaseDeg = std::asin(corr) * 180.0 / M_PI;
+    }
+    out.clippedSamples = clipped;
+    out.clippedFraction = clipped / total;
+
+    uint64_t histTotal = 0;
+    for (uint64_t c : histogram_) histTotal += c;
+    out.p10Db = histogramPercentile(histogram_.data(), histTotal, 0.10);
+    out.p50Db = histogramPercentile(histogram_.data(), histTotal, 0.50);
+    out.p90Db = histogramPercentile(histogram_.data(), histTotal, 0.90);
+    out.p99Db = histogramPercentile(histogram_.data(), histTotal, 0.99);
+    return true;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "input_source.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Summary of one BLOCK_SAMPLES run of samples. Power is |x|^2 of the
+// normalized samples, so 0 dB is a full-scale complex sinusoid.
+struct BlockStats {
+    uint32_t samples;
+    uint32_t clipped;                  // samples with a component on the rail
+    float meanPower;                   // linear
+    float peakPower;                   // linear
+    float p10Db, p50Db, p90Db, p99Db;  // percentiles of instantaneous power
+    float meanI, meanQ;
+    float powerI, powerQ, crossIQ;     // E[I^2], E[Q^2], E[IQ]
+};
+
+struct PowerRange {
+    float minDb;
+    float maxDb;
+};
+
+struct HealthReport {
+    bool complex;
+    double meanPowerDb;
+    double peakPowerDb;
+    double noiseFloorDb;     // median block power
+    double dcOffsetI;
+    double dcOffsetQ;
+    double dcOffsetDb;       // DC power relative to total power
+    double iqGainDb;         // I/Q amplitude imbalance, 0 = balanced
+    double iqPhaseDeg;       // quadrature error, 0 = orthogonal
+    uint64_t clippedSamples; // 0 when the format has no full scale
+    double clippedFraction;
+    double p10Db, p50Db, p90Db, p99Db;
+};
+
+// Per-block power statistics built once per file in the background and
+// cached on disk, so colormap auto-range, signal navigation and the
+// capture health report are lookups rather than passes over the data.
+class StatsIndex {
+public:
+    static const size_t BLOCK_SAMPLES = 65536;
+
+    enum class State { Idle, Building, Ready, Failed };
+
+    ~StatsIndex();
+
+    // Index the source just opened from path. An index cached under
+    // cacheDir for the same file is loaded instead of rebuilt; an empty
+    // cacheDir disables caching. The source must stay open until stop().
+    void start(const InputSource& source, const std::string& path, const std::string& cacheDir);
+    // Abandon any build in progress and drop the index
+    void stop();
+
+    State state() const { return state_.load(std::memory_order_acquire); }
+    double progress() const;
+    bool fromCache() const { return fromCache_; }
+    std::string error() const;
+
+    // Suggested spectrogram colormap range for samples [start, end) at
+    // fftSize (FFTEngine's Hann window and 1/N scaling). False until ready.
+    bool autoRange(size_t start, size_t end, int fftSize, PowerRange& out) const;
+
+    // First sample of the next block run more than thresholdDb above the
+    // noise floor, searching forward (direction > 0) or back from the
+    // block holding from and skipping the run already there. -1 if none.
+    int64_t findSignal(size_t from, int direction, double thresholdDb) const;
+
+    bool healthReport(HealthReport& out) const;
+
+private:
+    void build();
+    bool loadCache();
+    void saveCache() const;
+    // Derive the sorted block powers once blocks_ is complete
+    void finish();
+
+    const InputSource* source_ = nullptr;
+    std::string cachePath_;
+    std::string path_;
+    int64_t mtime_ = 0;
+    size_t totalSamples_ = 0;
+    std::atomic<bool> fromCache_{false};
+
+    std::vector<BlockStats> blocks_;
+    std::vector<uint64_t> histogram_;  // instantaneous power over the whole file
+    std::vector<float> sortedBlockDb_;  // block mean power, ascending
+
+    std::thread thread_;
+    std::atomic<bool> cancel_{false};
+    std::atomic<State> state_{State::Idle};
+    std::atomic<size_t> blocksDone_{0};
+    mutable std::mutex errorMutex_;
+    std::string error_;
+};
@@ -0,0 +1,275 @@
+#include "stream_source.h"
+#include "fft_engine.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Bytes pulled from the input per read() call
+static const size_t READ_CHUNK = 1 << 20;
+// Samples converted per pass of the processing loop
+static const size_t CONVERT_CHUNK = 1 << 16;
+
+StreamSource::StreamSource(const StreamConfig& config, LineCallback onLines, EndCallback onEnd)
+    : config_(config),
+      onLines_(std::move(onLines)),
+      onEnd_(std::move(onEnd)),
+      adapter_(createAdapter(config.format)),
+      ring_(std::max<size_t>(config.ringBytes, 2 * READ_CHUNK)) {
+    if (config_.fftSize <= 0 || config_.stride <= 0) {
+        throw std::runtime_error("Invalid FFT size or stride");
+    }
+    config_.linesPerBatch = std::max(1, config_.linesPerBatch);
+    fft_ = std::make_unique<FFTEngine>(config_.fftSize);
+}
+
+StreamSource::~StreamSource() {
+    stop();
+}
+
+int StreamSource::openInput() {
+    if (config_.path == "-") {
+        int fd = dup(STDIN_FILENO);
+        if (fd < 0) throw std::runtime_error("Failed to open stdin");
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        return fd;
+    }
+
+    struct stat st;
+    if (stat(config_.path.c_str(), &st) < 0) {
+        throw std::runtime_error("Failed to open stream: " + config_.path);
+    }
+
+    if (S_ISSOCK(st.st_mode)) {
+        sockaddr_un addr{};
+        if (config_.path.size() >= sizeof(addr.sun_path)) {
+            throw std::runtime_error("Socket path too long: " + config_.path);
+        }
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) throw std::runtime_error("Failed to create socket");
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, config_.path.c_str(), sizeof(addr.sun_path) - 1);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 && errno != EINPROGRESS) {
+            ::close(fd);
+            throw std::runtime_error("Failed to connect to socket: " + config_.path);
+        }
+        return fd;
+    }
+
+    // Non-blocking open so a FIFO without a writer does not hang start();
+    // poll() then waits for the writer to appear
+    int fd = ::open(config_.path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) throw std::runtime_error("Failed to open stream: " + config_.path);
+    return fd;
+}
+
+void StreamSource::start() {
+    fd_ = openInput();
+    running_ = true;
+    reader_ = std::thread(&StreamSource::readLoop, this);
+    processor_ = std::thread(&StreamSource::processLoop, this);
+}
+
+void StreamSource::stop() {
+    stop_ = true;
+    if (reader_.joinable()) reader_.join();
+    if (processor_.joinable()) processor_.join();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+StreamStats StreamSource::stats() const {
+    StreamStats s;
+    s.running = running_;
+    s.bytesIn = bytesIn_;
+    s.samplesIn = samplesIn_;
+    s.linesOut = linesOut_;
+    s.overruns = overruns_;
+    s.droppedBytes = droppedBytes_;
+    s.linesDropped = linesDropped_;
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    s.error = error_;
+    return s;
+}
+
+void StreamSource::fail(const std::string& error) {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    if (error_.empty()) error_ = error;
+}
+
+void StreamSource::readLoop() {
+    const size_t sampleSize = adapter_->sampleSize();
+    std::vector<uint8_t> buf(READ_CHUNK + sampleSize);
+    size_t carry = 0;  // bytes of a partial sample left over from the last read
+    uint64_t written = 0;  // samples put in the ring
+
+    while (!stop_) {
+        // Short timeout keeps stop() responsive on an idle input
+        pollfd pfd{fd_, POLLIN, 0};
+        int ready = poll(&pfd, 1, 100);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            fail(std::string("poll: ") + std::strerror(errno));
+            break;
+        }
+        if (ready == 0) continue;
+
+        ssize_t n = ::read(fd_, buf.data() + carry, READ_CHUNK);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            fail(std::string("read: ") + std::strerror(errno));
+            break;
+        }
+        if (n == 0) break;
+        bytesIn_ += n;
+
+        // Only whole samples enter the ring so the consumer never has to realign
+        size_t avail = carry + static_cast<size_t>(n);
+        size_t whole = avail - avail % sampleSize;
+        if (whole > 0) {
+            if (ring_.writable() >= whole) {
+                ring_.write(buf.data(), whole);
+                written += whole / sampleSize;
+            } else {
+                // Consumer is behind: drop this read rather than stall the
+                // input, and tell it where the hole is so it can skip it
+                overruns_++;
+                droppedBytes_ += whole;
+                std::lock_guard<std::mutex> lock(gapMutex_);
+                if (!gaps_.empty() && gaps_.back().at == written) {
+                    gaps_.back().samples += whole / sampleSize;
+                } else {
+                    gaps_.push_back({written, whole / sampleSize});
+                }
+            }
+        }
+        carry = avail - whole;
+        if (carry > 0) std::memmove(buf.data(), buf.data() + whole, carry);
+    }
+    eof_ = true;
+}
+
+void StreamSource::processLoop() {
+    try {
+        process();
+    } catch (const std::exception& e) {
+        // Out of memory mid-stream: end it with the error rather than
+        // terminate the process; the reader has nothing left to feed
+        fail(e.what());
+        stop_ = true;
+    }
+    running_ = false;
+    if (onEnd_) {
+        onEnd_(stats().error);
+    }
+}
+
+void StreamSource::process() {
+    const size_t sampleSize = adapter_->sampleSize();
+    const size_t fftSize = config_.fftSize;
+    const size_t stride = config_.stride;
+    const size_t batchLines = config_.linesPerBatch;
+
+    FFTEngine& fft = *fft_;
+    std::vector<uint8_t> raw(CONVERT_CHUNK * sampleSize);
+    // Converted samples not yet consumed by a line; the front is the next window
+    std::vector<std::complex<float>> window;
+    window.reserve(fftSize + CONVERT_CHUNK);
+    size_t skip = 0;          // samples to discard before the next window (stride > fftSize)
+    uint64_t position = 0;    // stream index of window[0]
+    uint64_t taken = 0;       // samples taken from the ring
+
+    std::vector<float> batch;
+    batch.reserve(batchLines * fftSize);
+    uint64_t batchStart = 0;
+
+    auto flush = [&] {
+        if (batch.empty()) return;
+        int lines = static_cast<int>(batch.size() / fftSize);
+        std::vector<float> out;
+        out.reserve(batchLines * fftSize);
+        std::swap(out, batch);
+        if (onLines_(std::move(out), lines, batchStart)) {
+            linesOut_ += lines;
+        } else {
+            linesDropped_ += lines;
+        }
+    };
+
+    while (!stop_) {
+        size_t readable = ring_.readable();
+        if (readable < sampleSize) {
+            if (eof_ && ring_.readable() < sampleSize) break;
+            // Deliver what we have instead of waiting for a full batch
+            flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        size_t count = std::min(readable / sampleSize, CONVERT_CHUNK);
+        uint64_t dropped = 0;
+        {
+            // Read up to the next gap, never across it
+            std::lock_guard<std::mutex> lock(gapMutex_);
+            if (!gaps_.empty() && gaps_.front().at == taken) {
+                dropped = gaps_.front().samples;
+                gaps_.pop_front();
+            } else if (!gaps_.empty()) {
+                count = std::min<uint64_t>(count, gaps_.front().at - taken);
+            }
+        }
+        if (dropped > 0) {
+            // Samples either side of the gap must not share a window or a
+            // batch: deliver what is done and start again after it
+            flush();
+            position += window.size() + dropped;
+            window.clear();
+            skip = skip > dropped ? skip - dropped : 0;
+            continue;
+        }
+
+        if (skip > 0) {
+            size_t n = std::min(skip, count);
+            ring_.skip(n * sampleSize);
+            samplesIn_ += n;
+            taken += n;
+            position += n;
+            skip -= n;
+            continue;
+        }
+
+        ring_.read(raw.data(), count * sampleSize);
+        samplesIn_ += count;
+        taken += count;
+        size_t have = window.size();
+        window.resize(have + count);
+        adapter_->copyRange(raw.data(), 0, count, window.data() + have);
+
+        size_t consumed = 0;
+        while (window.size() - consumed >= fftSize) {
+            if (batch.empty()) batchStart = position + consumed;
+            size_t at = batch.size();
+            batch.resize(at + fftSize);
+            fft.computePowerSpectrum(window.data() + consumed, batch.data() + at);
+            if (batch.size() >= batchLines * fftSize) flush();
+
+            size_t step = std::min(stride, window.size() - consumed);
+            consumed += step;
+            skip = stride - step;
+        }
+        window.erase(window.begin(), window.begin() + consumed);
+        position += consumed;
+    }
+
+    flush();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "input_source.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class FFTEngine;
+
+struct StreamConfig {
+    std::string path;              // FIFO or UNIX socket path, "-" for stdin
+    std::string format = "cs16";
+    int fftSize = 1024;
+    int stride = 1024;             // samples between spectrogram lines
+    size_t ringBytes = 256 << 20;  // ~1.3 s of cs16 at 50 MS/s
+    int linesPerBatch = 32;        // lines delivered per callback
+};
+
+struct StreamStats {
+    bool running = false;
+    uint64_t bytesIn = 0;
+    uint64_t samplesIn = 0;
+    uint64_t linesOut = 0;
+    uint64_t overruns = 0;      // reads dropped because the ring was full
+    uint64_t droppedBytes = 0;
+    uint64_t linesDropped = 0; // lines the consumer could not keep up with
+    std::string error;
+};
+
+// Live input: a reader thread drains the FIFO/socket/stdin into an SPSC
+// ring buffer and never blocks on processing; a processing thread pulls
+// samples out and computes spectrogram lines as soon as a window is full.
+class StreamSource {
+public:
+    // Receives numLines * fftSize dB values; firstSample indexes the first line
+    // in the input, counting samples dropped on overrun. A batch never spans
+    // dropped samples, so its lines are evenly spaced.
+    // Returns false when the consumer is saturated and the batch was discarded.
+    using LineCallback = std::function<bool(std::vector<float>&& lines, int numLines, uint64_t firstSample)>;
+    // Called once from the processing thread when the stream ends
+    using EndCallback = std::function<void(const std::string& error)>;
+
+    // Throws std::runtime_error for a bad config or if the FFT cannot be set up
+    StreamSource(const StreamConfig& config, LineCallback onLines, EndCallback onEnd);
+    ~StreamSource();
+
+    void start();
+    void stop();
+    StreamStats stats() const;
+
+private:
+    int openInput();
+    void readLoop();
+    void processLoop();
+    void process();
+    void fail(const std::string& error);
+
+    StreamConfig config_;
+    LineCallback onLines_;
+    EndCallback onEnd_;
+    std::unique_ptr<SampleAdapter> adapter_;
+    SpscRing ring_;
+    // Built up front so a plan or memory failure rejects startStream
+    std::unique_ptr<FFTEngine> fft_;
+
+    std::thread reader_;
+    std::thread processor_;
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> eof_{false};
+    std::atomic<bool> running_{false};
+    int fd_ = -1;
+
+    std::atomic<uint64_t> bytesIn_{0};
+    std::atomic<uint64_t> linesOut_{0};
+    std::atomic<uint64_t> samplesIn_{0};
+    std::atomic<uint64_t> overruns_{0};
+    std::atomic<uint64_t> droppedBytes_{0};
+    std::atomic<uint64_t> linesDropped_{0};
+
+    // Samples the reader dropped, and how many samples it had put in the
+    // ring before dropping them
+    struct Gap {
+        uint64_t at;
+        uint64_t samples;
+    };
+    std::mutex gapMutex_;
+    std::deque<Gap> gaps_;
+    mutable std::mutex errorMutex_;
+    std::string error_;
+};
@@ -0,0 +1,130 @@
+#include "tile_engine.h"
+#include "fft_engine.h"
+#include "reassigned_engine.h"
+#include "zoom_engine.h"
+#include "format_traits.h"
+#include "perf_stats.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+int TileEngine::lineBins(const InputSource& source, int fftSize, const TileOptions& options) {
+    // Zoom tiles mix the band down to complex baseband first, so they stay
+    // two-sided whatever the input
+    if (!source.isComplex() && options.mode != "zoom") return fftSize / 2;
+    return fftSize;
+}
+
+size_t TileEngine::workingBytes(const InputSource& source, int fftSize, const TileOptions& options) {
+    const size_t grid = static_cast<size_t>(TILE_LINES) * fftSize * sizeof(float);
+    const size_t result = static_cast<size_t>(TILE_LINES) * lineBins(source, fftSize, options) * sizeof(float);
+    // FFT input, output and window, plus the raw staging for one line
+    const size_t line = static_cast<size_t>(fftSize) * (2 * sizeof(std::complex<float>) + sizeof(float) +
+                                                       source.frameSize());
+    if (options.mode == "reassigned") {
+        // A grid per worker to reassign into, plus the full-width copy
+        // cropped for real formats
+        const unsigned workers = parallelWorkers(TILE_LINES);
+        return result + (workers + 1) * grid + workers * 3 * line;
+    }
+    if (options.mode == "dechirp") return result + grid + 2 * line;
+    if (options.mode == "zoom") {
+        // The mixed, decimated span behind every line
+        return result + grid + 2 * line;
+    }
+    return result + line;
+}
+
+PooledBuffer<float> TileEngine::compute(
+    const InputSource& source,
+    size_t startSample,
+    int fftSize,
+    int stride,
+    const TileOptions& options
+) {
+    // Compute lines for all samples, including partial windows at the end
+    // (getSamples zero-pads beyond the file boundary)
+    size_t maxLines = 0;
+    size_t total = source.totalSamples();
+    if (startSample < total) {
+        maxLines = (total - startSample - 1) / stride + 1;
+    }
+    int numLines = static_cast<int>(std::min<size_t>(maxLines, TILE_LINES));
+    if (numLines <= 0) {
+        throw std::runtime_error("No samples available for tile");
+    }
+    if (options.channel >= source.channels()) {
+        throw std::runtime_error("Channel out of range: " + std::to_string(options.channel));
+    }
+
+    const int bins = lineBins(source, fftSize, options);
+    PooledBuffer<float> result(static_cast<size_t>(numLines) * bins);
+
+    // Queue reads for every line up front so I/O overlaps the FFTs below
+    // (no-op beyond madvise for mmap'd files)
+    for (int line = 0; line < numLines; line++) {
+        source.prefetch(startSample + static_cast<size_t>(line) * stride, fftSize);
+    }
+
+    if (options.mode == "reassigned" || options.mode == "dechirp") {
+        auto computeFull = [&](float* output) {
+            if (options.mode == "reassigned") {
+                ReassignedEngine::computeTile(source, startSample, fftSize, stride, numLines, output,
+                                              options.channel);
+            } else {
+                ChirpEngine::computeTile(source, startSample, fftSize, stride, numLines, options.chirp,
+                                         output, options.channel);
+            }
+        };
+        if (bins == fftSize) {
+            computeFull(result.data());
+            return result;
+        }
+        // Both need the complex transforms; keep the DC-up half of each
+        // line so the layout matches the real STFT tiles
+        PooledBuffer<float> full(static_cast<size_t>(numLines) * fftSize);
+        computeFull(full.data());
+        for (int line = 0; line < numLines; line++) {
+            const float* src = full.data() + static_cast<size_t>(line) * fftSize + fftSize / 2;
+            std::copy(src, src + bins, result.data() + static_cast<size_t>(line) * bins);
+        }
+        return result;
+    }
+    if (options.mode == "zoom") {
+        ZoomEngine::computeTile(source, startSample, fftSize, stride, numLines,
+                                options.fLow, options.fHigh, result.data(), options.channel);
+        return result;
+    }
+    if (options.mode != "stft") {
+        throw std::runtime_error("Unknown tile mode: " + options.mode);
+    }
+
+    // Each line converts and windows straight from the stored samples into
+    // the FFT input, with the loop compiled per format; real formats run an
+    // r2c transform into half-width lines. Other channels' samples in each
+    // stored frame are stepped over during the same pass.
+    const size_t channels = source.channels();
+    thread_local std::vector<uint8_t> staging;
+    dispatchFormat(source.format(), [&](auto traits) {
+        using Traits = decltype(traits);
+        typename Traits::Engine fft(fftSize);
+        for (int line = 0; line < numLines; line++) {
+            size_t sampleOffset = startSample + static_cast<size_t>(line) * stride;
+            // A line belongs to the capture it starts in; a window running over
+            // a retune is cut there rather than smearing both tunings together
+            size_t valid = source.validInCapture(sampleOffset, fftSize);
+            const void* raw = nullptr;
+            if (valid) {
+                PerfScope perf(PerfStage::Read, valid * source.frameSize());
+                raw = Traits::channelData(source.rawSamples(sampleOffset, valid, staging), options.channel);
+            }
+            {
+                PerfScope perf(PerfStage::Window);
+                Traits::loadWindowed(raw, valid, fft.window(), fft.input(), fftSize, channels);
+            }
+            fft.executePowerSpectrum(result.data() + static_cast<size_t>(line) * bins);
+        }
+    });
+    return result;
+}
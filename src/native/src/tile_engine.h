@@ -0,0 +1,48 @@
+#pragma once
+
+#include "input_source.h"
+#include "chirp_engine.h"
+#include "buffer_pool.h"
+
+#include <string>
+#include <vector>
+
+// How tile lines are computed
+struct TileOptions {
+    // "stft" (plain windowed FFT), "reassigned" (sharpened, ~3x cost),
+    // "zoom" (band [fLow, fHigh] only, via mix + decimate + FFT) or
+    // "dechirp" (windows multiplied by the conjugate chirp before the FFT)
+    std::string mode = "stft";
+    double fLow = 0.0;   // normalized frequency, cycles/sample
+    double fHigh = 0.0;
+    ChirpParams chirp;   // dechirp mode
+    // Channel of an interleaved multi-channel file
+    unsigned channel = 0;
+};
+
+class TileEngine {
+public:
+    // Lines per tile
+    static const int TILE_LINES = 256;
+
+    // Values per line: fftSize, or fftSize / 2 for real formats outside zoom
+    // mode, whose lines keep only the bins from DC up to just below Nyquist
+    static int lineBins(const InputSource& source, int fftSize, const TileOptions& options);
+
+    // Estimated peak memory of compute(), result included, for reserving
+    // from MemoryBudget before starting
+    static size_t workingBytes(const InputSource& source, int fftSize, const TileOptions& options);
+
+    // Up to TILE_LINES lines of lineBins() dB values, stride samples apart
+    // from startSample; fewer at the end of the file. Throws
+    // std::runtime_error when no samples remain, the mode is unknown or the
+    // channel is out of range. The buffer comes from BufferPool, so tiles
+    // requested while scrolling reuse the memory of tiles already sent.
+    static PooledBuffer<float> compute(
+        const InputSource& source,
+        size_t startSample,
+        int fftSize,
+        int stride,
+        const TileOptions& options = TileOptions()
+    );
+};
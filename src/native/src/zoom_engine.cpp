@@ -0,0 +1,164 @@
+#include "zoom_engine.h"
+#include "fft_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <liquid/liquid.h>
+#include <stdexcept>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const double Tau = M_PI * 2.0;
+
+// Anti-alias filter: half-length in decimated samples and stopband (dB)
+static const int FILTER_SEMI_LENGTH = 4;
+static const float FILTER_ATTENUATION = 60.0f;
+// Input samples converted and decimated per pass
+static const size_t CHUNK_SAMPLES = 1 << 16;
+// Beyond this the anti-alias filter gets too long to be worth it
+static const int MAX_DECIMATION = 1 << 16;
+
+int ZoomEngine::decimationFor(double fLow, double fHigh) {
+    double bandwidth = fHigh - fLow;
+    if (!(bandwidth > 0.0) || bandwidth > 1.0) {
+        throw std::runtime_error("Invalid zoom band");
+    }
+    // Tolerance so e.g. a 0.001-wide band gives 1000, not 999
+    double m = std::floor(1.0 / bandwidth + 1e-9);
+    return static_cast<int>(std::min<double>(std::max(1.0, m), MAX_DECIMATION));
+}
+
+// Decimated, band-shifted samples for input positions first + j * M.
+// Positions before 0 or past the end read as zeros.
+static std::vector<std::complex<float>> decimateSpan(
+    const InputSource& source, int64_t first, size_t count, int decimation, double centre,
+    unsigned channel
+) {
+    const int64_t m = decimation;
+    const unsigned taps = static_cast<unsigned>(2 * FILTER_SEMI_LENGTH * m + 1);
+    const int64_t delay = FILTER_SEMI_LENGTH * m;
+
+    std::vector<float> h(taps);
+    liquid_firdes_kaiser(taps, 0.5f / m, FILTER_ATTENUATION, 0.0f, h.data());
+    // Unity DC gain so tones read the same level as in the full-band view
+    float sum = 0.0f;
+    for (float v : h) sum += v;
+    for (float& v : h) v /= sum;
+    firdecim_crcf decim = firdecim_crcf_create(static_cast<unsigned>(m), h.data(), taps);
+
+    // Each output is centred delay samples behind the newest input, so the
+    // feed starts early enough that output 0 lands on first with a full
+    // filter history; the first warmup outputs are discarded
+    const int64_t warmup = 2 * FILTER_SEMI_LENGTH;
+    int64_t feed = first + delay - (m - 1) - warmup * m;
+    size_t totalIn = static_cast<size_t>((count + warmup) * m);
+
+    nco_crcf mix = nco_crcf_create(LIQUID_NCO);
+    nco_crcf_set_frequency(mix, static_cast<float>(Tau * centre));
+    // Phase referenced to absolute sample index so adjacent tiles line up
+    nco_crcf_set_phase(mix, static_cast<float>(std::fmod(Tau * centre * static_cast<double>(feed), Tau)));
+
+    std::vector<std::complex<float>> out;
+    out.reserve(count);
+    // Whole decimation blocks per chunk keep the filter phase aligned
+    const size_t chunkSamples = std::max<size_t>(m, CHUNK_SAMPLES / m * m);
+    std::vector<std::complex<float>> chunk(chunkSamples);
+    size_t total = source.totalSamples();
+    int64_t produced = 0;
+
+    for (size_t done = 0; done < totalIn; ) {
+        size_t n = std::min(totalIn - done, chunkSamples);
+        int64_t pos = feed + static_cast<int64_t>(done);
+
+        // Zero-fill the part before sample 0; getSamples zero-pads past the end
+        size_t lead = pos < 0 ? static_cast<size_t>(std::min<int64_t>(-pos, n)) : 0;
+        std::fill(chunk.begin(), chunk.begin() + lead, std::complex<float>(0.0f, 0.0f));
+        if (lead < n) {
+            size_t readStart = static_cast<size_t>(pos + static_cast<int64_t>(lead));
+            size_t readLen = n - lead;
+            if (readStart >= total) {
+                std::fill(chunk.begin() + lead, chunk.begin() + n, std::complex<float>(0.0f, 0.0f));
+            } else {
+                source.getSamples(readStart, readLen, chunk.data() + lead, channel);
+            }
+        }
+
+        auto* data = reinterpret_cast<liquid_float_complex*>(chunk.data());
+        nco_crcf_mix_block_down(mix, data, data, static_cast<unsigned>(n));
+        for (size_t b = 0; b < n; b += m) {
+            liquid_float_complex y;
+            firdecim_crcf_execute(decim, data + b, &y);
+            if (produced++ >= warmup) {
+                out.push_back(*reinterpret_cast<std::complex<float>*>(&y));
+            }
+        }
+        done += n;
+    }
+
+    nco_crcf_destroy(mix);
+    firdecim_crcf_destroy(decim);
+    return out;
+}
+
+void ZoomEngine::computeTile(const InputSource& source, size_t startSample,
+                             int fftSize, int stride, int numLines,
+                             double fLow, double fHigh, float* output,
+                             unsigned channel) {
+    const int m = decimationFor(fLow, fHigh);
+    const double centre = (fLow + fHigh) / 2.0;
+    const int64_t span = static_cast<int64_t>(fftSize) * m;
+    FFTEngine fft(fftSize);
+
+    // Input position of line l's first zoom sample
+    auto lineStart = [&](int line) {
+        return static_cast<int64_t>(startSample) + static_cast<int64_t>(line) * stride
+             + fftSize / 2 - span / 2;
+    };
+
+    // Zoom samples outside the capture holding the line's centre are zeroed
+    // so a window spanning a retune shows one tuning. The decimation filter
+    // still runs across the boundary, leaving a short transient at the edge.
+    const bool retuned = source.captures().size() > 1;
+    auto keepCapture = [&](int line, int64_t first, std::complex<float>* data) {
+        size_t mid = startSample + static_cast<size_t>(line) * stride + fftSize / 2;
+        int64_t lo = static_cast<int64_t>(source.captureAt(mid).sampleStart);
+        size_t next = source.nextCaptureStart(mid);
+        int64_t hi = next == SIZE_MAX ? INT64_MAX : static_cast<int64_t>(next);
+        for (int j = 0; j < fftSize; j++) {
+            int64_t pos = first + static_cast<int64_t>(j) * m;
+            if (pos < lo || pos >= hi) data[j] = std::complex<float>(0.0f, 0.0f);
+        }
+    };
+
+    if (stride < span) {
+        // Overlapping lines: decimate the whole tile once and slice it.
+        // Line starts are rounded to the nearest decimated sample.
+        int64_t first = lineStart(0);
+        size_t count = static_cast<size_t>(((numLines - 1) * static_cast<int64_t>(stride)) / m + fftSize + 1);
+        auto zoomed = decimateSpan(source, first, count, m, centre, channel);
+        std::vector<std::complex<float>> lineBuf(retuned ? fftSize : 0);
+        for (int line = 0; line < numLines; line++) {
+            size_t at = static_cast<size_t>(std::llround(static_cast<double>(line) * stride / m));
+            at = std::min(at, zoomed.size() - fftSize);
+            const std::complex<float>* data = zoomed.data() + at;
+            if (retuned) {
+                std::copy(data, data + fftSize, lineBuf.begin());
+                keepCapture(line, first + static_cast<int64_t>(at) * m, lineBuf.data());
+                data = lineBuf.data();
+            }
+            fft.computePowerSpectrum(data, output + static_cast<size_t>(line) * fftSize);
+        }
+        return;
+    }
+
+    // Lines far apart: decimate only what each line needs
+    for (int line = 0; line < numLines; line++) {
+        auto zoomed = decimateSpan(source, lineStart(line), fftSize, m, centre, channel);
+        if (retuned) keepCapture(line, lineStart(line), zoomed.data());
+        fft.computePowerSpectrum(zoomed.data(), output + static_cast<size_t>(line) * fftSize);
+    }
+}
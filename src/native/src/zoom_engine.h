@@ -0,0 +1,23 @@
+#pragma once
+
+#include "input_source.h"
+
+// Zoom-FFT: mixes the band of interest to baseband, low-pass decimates it
+// and only then transforms, so a narrow band gets full vertical resolution
+// with an fftSize-point FFT instead of a giant full-band one.
+class ZoomEngine {
+public:
+    // Decimation for the normalized band [fLow, fHigh] (cycles/sample).
+    // The displayed band is centre +- 0.5 / decimation, i.e. at least as
+    // wide as requested (wider still for bands under 1/65536 of the sample
+    // rate). Must match zoomBandLayout() in src/shared.
+    static int decimationFor(double fLow, double fHigh);
+
+    // Tile of numLines DC-centered dB lines. Line l is centred on the same
+    // sample as the plain STFT line (startSample + l * stride + fftSize / 2)
+    // but spans fftSize * decimation input samples.
+    static void computeTile(const InputSource& source, size_t startSample,
+                            int fftSize, int stride, int numLines,
+                            double fLow, double fHigh, float* output,
+                            unsigned channel = 0);
+};
@@ -0,0 +1,319 @@
+// snail_test: checks for the native memory management: BufferPool limits
+// and thread caches, MemoryBudget admission order and the degraded paths
+// requests take when the budget is short. Exits nonzero if any check
+// fails; see CMakeLists.txt.
+
+#include "buffer_pool.h"
+#include "memory_budget.h"
+#include "block_cache.h"
+#include "fft_engine.h"
+#include "correlation_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_failures++;                                                        \
+        }                                                                        \
+    } while (0)
+
+template <typename Fn>
+bool throwsRuntimeError(Fn&& fn) {
+    try {
+        fn();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// Polls until pred holds, giving up after a few seconds
+template <typename Pred>
+bool waitFor(Pred&& pred) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Every case starts from an empty pool and no limits
+void resetState() {
+    MemoryBudget::setLimit(0);
+    BufferPool::trim();
+    BufferPool::resetStats();
+    MemoryBudget::resetStats();
+}
+
+void testPoolLimit() {
+    const size_t MiB = size_t(1) << 20;
+    BufferPool::setLimit(MiB);
+
+    {
+        PooledBuffer<uint8_t> half(MiB / 2);
+        CHECK(BufferPool::stats().inUse == MiB / 2);
+        CHECK(throwsRuntimeError([&] { PooledBuffer<uint8_t> over(MiB); }));
+        // The failed acquire is not left counted
+        CHECK(BufferPool::stats().inUse == MiB / 2);
+    }
+    CHECK(BufferPool::stats().inUse == 0);
+
+    // Pooled buffers are freed to make room rather than failing
+    { PooledBuffer<uint8_t> a(MiB / 2); }
+    CHECK(BufferPool::stats().pooled == MiB / 2);
+    { PooledBuffer<uint8_t> whole(MiB); }
+    auto s = BufferPool::stats();
+    CHECK(s.trims >= 1);
+    CHECK(s.inUse == 0);
+    CHECK(s.peakTotal <= MiB);
+
+    // An engine whose second buffer does not fit releases the first
+    BufferPool::trim();
+    BufferPool::setLimit(MiB + MiB / 2);
+    CHECK(throwsRuntimeError([] { FFTEngine engine(1 << 17); }));
+    CHECK(BufferPool::stats().inUse == 0);
+    CHECK(throwsRuntimeError([] { RealFFTEngine engine(1 << 18); }));
+    CHECK(BufferPool::stats().inUse == 0);
+}
+
+void testThreadCacheDrains() {
+    const size_t bytes = size_t(64) << 10;
+
+    // A worker's releases stay in its own cache until it exits
+    std::thread([&] {
+        { PooledBuffer<uint8_t> buffer(bytes); }
+        CHECK(BufferPool::stats().pooled == bytes);
+    }).join();
+    auto s = BufferPool::stats();
+    CHECK(s.pooled == bytes);
+    CHECK(s.misses == 1);
+
+    // ...then the next worker picks it up from the shared pool
+    std::thread([&] { PooledBuffer<uint8_t> buffer(bytes); }).join();
+    s = BufferPool::stats();
+    CHECK(s.hits == 1);
+    CHECK(s.misses == 1);
+    CHECK(s.inUse == 0);
+}
+
+void testBudgetFifo() {
+    MemoryBudget::setLimit(100);
+    auto held = MemoryBudget::reserve(50);
+
+    std::mutex mutex;
+    std::vector<char> order;
+    auto record = [&](char who) {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(who);
+    };
+
+    // a cannot fit while held is out; b could, but arrived after a
+    std::thread a([&] {
+        auto r = MemoryBudget::reserve(80);
+        record('a');
+    });
+    CHECK(waitFor([] { return MemoryBudget::stats().queued == 1; }));
+    std::thread b([&] {
+        auto r = MemoryBudget::reserve(25);
+        record('b');
+    });
+    CHECK(waitFor([] { return MemoryBudget::stats().queued == 2; }));
+
+    // Nothing jumps the queue, not even without waiting
+    CHECK(!MemoryBudget::tryReserve(10));
+    CHECK(!MemoryBudget::reserveUpTo(10));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CHECK(order.empty());
+    }
+
+    held.reset();
+    a.join();
+    b.join();
+    CHECK((order == std::vector<char>{'a', 'b'}));
+
+    auto s = MemoryBudget::stats();
+    CHECK(s.waits == 2);
+    CHECK(s.queued == 0);
+    CHECK(s.reserved == 0);
+    CHECK(s.peakReserved <= 100);
+
+    CHECK(throwsRuntimeError([] { MemoryBudget::reserve(101); }));
+    CHECK(MemoryBudget::stats().rejected == 1);
+}
+
+void testBudgetDegrades() {
+    MemoryBudget::setLimit(100);
+    auto held = MemoryBudget::reserve(70);
+
+    CHECK(!MemoryBudget::tryReserve(50));
+    auto partial = MemoryBudget::reserveUpTo(50);
+    CHECK(partial.bytes() == 30);
+    CHECK(!MemoryBudget::reserveUpTo(50));
+    CHECK(MemoryBudget::stats().reserved == 100);
+
+    partial.reset();
+    held.reset();
+    auto whole = MemoryBudget::tryReserve(50);
+    CHECK(whole.bytes() == 50);
+
+    MemoryBudget::noteDegraded();
+    CHECK(MemoryBudget::stats().degraded == 1);
+}
+
+// Open files' caches must never leave a request queued for room that
+// only closing a file would free
+void testCacheBudget() {
+    MemoryBudget::setLimit(1000);
+
+    // Caches get half the limit between them
+    BlockCache first(1000);
+    BlockCache second(1000);
+    CHECK(first.capacity() == 500);
+    CHECK(second.capacity() == 0);
+    CHECK(MemoryBudget::stats().cached == 500);
+
+    // A tile still finds room
+    auto tile = MemoryBudget::reserve(500);
+    CHECK(tile.bytes() == 500);
+
+    // Lowering the limit under the caches wakes and rejects the waiter
+    std::atomic<bool> rejected{false};
+    std::thread waiter([&] {
+        rejected = throwsRuntimeError([] { MemoryBudget::reserve(300); });
+    });
+    CHECK(waitFor([] { return MemoryBudget::stats().queued == 1; }));
+    MemoryBudget::setLimit(600);
+    waiter.join();
+    CHECK(rejected);
+    tile.reset();
+
+    // ...and a new request that could never fit is rejected up front
+    CHECK(throwsRuntimeError([] { MemoryBudget::reserve(200); }));
+    CHECK(MemoryBudget::reserve(100).bytes() == 100);
+    CHECK(MemoryBudget::stats().rejected == 2);
+    CHECK(MemoryBudget::stats().queued == 0);
+}
+
+// Correlation falls back to streaming when its one-shot working set does
+// not fit, sized by the same CorrelationEngine helpers the Correlate
+// worker uses. The BufferPool limit set with the budget makes any
+// allocation beyond those estimates throw.
+void testCorrelationFallback() {
+    const size_t signalLen = 4096;
+    const size_t tmplLen = 256;
+
+    std::mt19937 rng(1);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<std::complex<float>> signal(signalLen);
+    std::vector<float> realSignal(signalLen);
+    for (size_t i = 0; i < signalLen; i++) {
+        signal[i] = {noise(rng), noise(rng)};
+        realSignal[i] = noise(rng);
+    }
+    std::vector<std::complex<float>> tmpl(signal.begin() + 1000, signal.begin() + 1000 + tmplLen);
+    std::vector<float> realTmpl(realSignal.begin() + 3000, realSignal.begin() + 3000 + tmplLen);
+
+    auto expected = CorrelationEngine::crossCorrelate(signal.data(), signalLen, tmpl.data(), tmplLen);
+    auto expectedReal = CorrelationEngine::crossCorrelateReal(realSignal.data(), signalLen, realTmpl.data(), tmplLen);
+
+    auto matches = [](const std::vector<float>& got, const std::vector<float>& want) {
+        if (got.size() != want.size()) return false;
+        float peak = *std::max_element(want.begin(), want.end());
+        for (size_t i = 0; i < want.size(); i++) {
+            if (std::abs(got[i] - want[i]) > 1e-3f * peak) return false;
+        }
+        return true;
+    };
+
+    for (bool real : {false, true}) {
+        BufferPool::trim();
+        const size_t oneShot = CorrelationEngine::oneShotBytes(signalLen, tmplLen, real);
+        MemoryBudget::setLimit(oneShot / 2);
+
+        auto budget = MemoryBudget::tryReserve(oneShot);
+        CHECK(!budget);
+        MemoryBudget::noteDegraded();
+
+        size_t chunkLags = CorrelationEngine::chunkLagsWithin(
+            signalLen, tmplLen, real, signalLen, MemoryBudget::requestLimit());
+        size_t working = CorrelationEngine::chunkedBytes(signalLen, tmplLen, real, chunkLags);
+        CHECK(chunkLags < signalLen);
+        CHECK(working <= oneShot / 2);
+        budget = MemoryBudget::reserve(working);
+
+        std::vector<float> got;
+        if (real) {
+            got = CorrelationEngine::crossCorrelateRealChunked(
+                [&](size_t start, size_t count, float* dest) {
+                    std::copy_n(realSignal.begin() + start, count, dest);
+                },
+                signalLen, realTmpl.data(), tmplLen, chunkLags);
+            CHECK(matches(got, expectedReal));
+        } else {
+            got = CorrelationEngine::crossCorrelateChunked(
+                [&](size_t start, size_t count, std::complex<float>* dest) {
+                    std::copy_n(signal.begin() + start, count, dest);
+                },
+                signalLen, tmpl.data(), tmplLen, chunkLags);
+            CHECK(matches(got, expected));
+        }
+        budget.reset();
+        MemoryBudget::setLimit(0);
+    }
+    CHECK(MemoryBudget::stats().degraded == 2);
+}
+
+} // namespace
+
+int main() {
+    struct Case {
+        const char* name;
+        void (*run)();
+    };
+    const Case cases[] = {
+        {"pool limit", testPoolLimit},
+        {"thread cache drains", testThreadCacheDrains},
+        {"budget fifo", testBudgetFifo},
+        {"budget degrades", testBudgetDegrades},
+        {"cache budget", testCacheBudget},
+        {"correlation fallback", testCorrelationFallback},
+    };
+
+    int failed = 0;
+    for (auto& c : cases) {
+        resetState();
+        int before = g_failures;
+        try {
+            c.run();
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "  unexpected exception: %s\n", e.what());
+            g_failures++;
+        }
+        bool ok = g_failures == before;
+        if (!ok) failed++;
+        std::fprintf(stderr, "snail_test: %s %s\n", ok ? "ok  " : "FAIL", c.name);
+    }
+    resetState();
+    std::fprintf(stderr, "snail_test: %d of %zu cases failed\n", failed, sizeof(cases) / sizeof(cases[0]));
+    return failed ? 1 : 0;
+}
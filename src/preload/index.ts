@@ -1,14 +1,49 @@
 import { contextBridge, ipcRenderer, webUtils } from 'electron'
 import { IPC } from '../shared/ipc-channels'
-import type { SampleFormat, SigMFAnnotation, FileInfo, FFTTileRequest, ExportConfig, CorrelateRequest } from '../shared/sample-formats'
+import type { SampleFormat, SigMFAnnotation, AnnotationQuery, AnnotationQueryResult, AnnotationPageRequest, FileInfo, FFTTileRequest, ExportConfig, CorrelateRequest, OfdmSearchRequest, OfdmCandidate, PSDRequest, PSDResult, CrossSpectrumRequest, CrossSpectrumResult, DetectionConfig, DetectionUpdate, DetectionResult, OverviewOptions, OverviewResult, ChirpSearchConfig, ChirpSearchResult, SampleSearchConfig, SampleSearchResult, StatsStatus, PowerRange, HealthReport, PerfStats, PerfOptions, OpenFileOptions, RefreshResult, StreamConfig, StreamEvent, StreamStats } from '../shared/sample-formats'
 
 export interface SnailAPI {
-  openFile: (path: string, format?: SampleFormat) => Promise<FileInfo>
-  getSamples: (start: number, length: number, stride?: number) => Promise<Float32Array>
+  openFile: (path: string, format?: SampleFormat, options?: OpenFileOptions) => Promise<FileInfo>
+  refreshFile: () => Promise<RefreshResult>
+  getSamples: (start: number, length: number, stride?: number, channel?: number) => Promise<Float32Array>
   computeFFTTile: (req: FFTTileRequest) => Promise<Float32Array>
   exportSigMF: (config: ExportConfig) => Promise<{ success: boolean; error?: string }>
   correlate: (req: CorrelateRequest) => Promise<Float32Array>
+  searchOfdm: (req: OfdmSearchRequest) => Promise<OfdmCandidate[]>
+  computePSD: (req: PSDRequest) => Promise<PSDResult>
+  computeCrossSpectrum: (req: CrossSpectrumRequest) => Promise<CrossSpectrumResult>
+  detectBursts: (config: DetectionConfig) => Promise<DetectionResult>
+  cancelDetection: () => Promise<void>
+  onDetectionUpdate: (listener: (update: DetectionUpdate) => void) => () => void
+  // Asks for a path, then renders the whole file to a PNG; null if cancelled
+  renderOverview: (options: OverviewOptions, defaultName?: string) => Promise<OverviewResult | null>
+  cancelOverview: () => Promise<void>
+  onOverviewProgress: (listener: (progress: number) => void) => () => void
+  findChirpSymbols: (config: ChirpSearchConfig) => Promise<ChirpSearchResult>
+  cancelChirpSearch: () => Promise<void>
+  onChirpProgress: (listener: (progress: number) => void) => () => void
+  searchSamples: (config: SampleSearchConfig) => Promise<SampleSearchResult>
+  cancelSampleSearch: () => Promise<void>
+  onSampleSearchProgress: (listener: (progress: number) => void) => () => void
+  queryAnnotations: (query: AnnotationQuery) => Promise<AnnotationQueryResult>
+  getAnnotationPage: (req: AnnotationPageRequest) => Promise<AnnotationQueryResult>
+  addAnnotations: (annotations: SigMFAnnotation[]) => Promise<number[]>
+  updateAnnotation: (id: number, annotation: SigMFAnnotation) => Promise<boolean>
+  removeAnnotation: (id: number) => Promise<boolean>
+  getStatsStatus: () => Promise<StatsStatus>
+  getAutoRange: (start: number, end: number, fftSize: number) => Promise<PowerRange | null>
+  findSignal: (from: number, direction: 1 | -1, thresholdDb?: number) => Promise<number>
+  getHealthReport: () => Promise<HealthReport | null>
+  getPerfStats: () => Promise<PerfStats>
+  resetPerfStats: () => Promise<void>
+  setPerfOptions: (options: PerfOptions) => Promise<void>
+  // Asks for a path, then writes a Chrome trace (Perfetto); null if cancelled
+  dumpPerfTrace: () => Promise<{ path: string; events: number } | null>
   readFileSamples: (path: string, format: string, start: number, length: number) => Promise<Float32Array>
+  startStream: (config: StreamConfig) => Promise<void>
+  stopStream: () => Promise<StreamStats>
+  getStreamStats: () => Promise<StreamStats>
+  onStreamEvent: (listener: (event: StreamEvent) => void) => () => void
   saveAnnotation: (filePath: string, annotation: SigMFAnnotation) => Promise<{ success: boolean }>
   showOpenDialog: () => Promise<string | null>
   showSaveDialog: (defaultName?: string) => Promise<string | null>
@@ -16,12 +51,65 @@ export interface SnailAPI {
 }
 
 const api: SnailAPI = {
-  openFile: (path, format) => ipcRenderer.invoke(IPC.OPEN_FILE, path, format),
-  getSamples: (start, length, stride) => ipcRenderer.invoke(IPC.GET_SAMPLES, start, length, stride),
+  openFile: (path, format, options) => ipcRenderer.invoke(IPC.OPEN_FILE, path, format, options),
+  refreshFile: () => ipcRenderer.invoke(IPC.REFRESH_FILE),
+  getSamples: (start, length, stride, channel) => ipcRenderer.invoke(IPC.GET_SAMPLES, start, length, stride, channel),
   computeFFTTile: (req) => ipcRenderer.invoke(IPC.COMPUTE_FFT_TILE, req),
   exportSigMF: (config) => ipcRenderer.invoke(IPC.EXPORT_SIGMF, config),
   correlate: (req) => ipcRenderer.invoke(IPC.CORRELATE, req),
+  searchOfdm: (req) => ipcRenderer.invoke(IPC.SEARCH_OFDM, req),
+  computePSD: (req) => ipcRenderer.invoke(IPC.COMPUTE_PSD, req),
+  computeCrossSpectrum: (req) => ipcRenderer.invoke(IPC.COMPUTE_CROSS_SPECTRUM, req),
+  detectBursts: (config) => ipcRenderer.invoke(IPC.DETECT_BURSTS, config),
+  cancelDetection: () => ipcRenderer.invoke(IPC.CANCEL_DETECTION),
+  onDetectionUpdate: (listener) => {
+    const handler = (_event: Electron.IpcRendererEvent, data: DetectionUpdate) => listener(data)
+    ipcRenderer.on(IPC.DETECTION_UPDATE, handler)
+    return () => ipcRenderer.removeListener(IPC.DETECTION_UPDATE, handler)
+  },
+  renderOverview: (options, defaultName) => ipcRenderer.invoke(IPC.RENDER_OVERVIEW, options, defaultName),
+  cancelOverview: () => ipcRenderer.invoke(IPC.CANCEL_OVERVIEW),
+  onOverviewProgress: (listener) => {
+    const handler = (_event: Electron.IpcRendererEvent, progress: number) => listener(progress)
+    ipcRenderer.on(IPC.OVERVIEW_PROGRESS, handler)
+    return () => ipcRenderer.removeListener(IPC.OVERVIEW_PROGRESS, handler)
+  },
+  findChirpSymbols: (config) => ipcRenderer.invoke(IPC.FIND_CHIRP_SYMBOLS, config),
+  cancelChirpSearch: () => ipcRenderer.invoke(IPC.CANCEL_CHIRP_SEARCH),
+  onChirpProgress: (listener) => {
+    const handler = (_event: Electron.IpcRendererEvent, progress: number) => listener(progress)
+    ipcRenderer.on(IPC.CHIRP_PROGRESS, handler)
+    return () => ipcRenderer.removeListener(IPC.CHIRP_PROGRESS, handler)
+  },
+  searchSamples: (config) => ipcRenderer.invoke(IPC.SEARCH_SAMPLES, config),
+  cancelSampleSearch: () => ipcRenderer.invoke(IPC.CANCEL_SAMPLE_SEARCH),
+  onSampleSearchProgress: (listener) => {
+    const handler = (_event: Electron.IpcRendererEvent, progress: number) => listener(progress)
+    ipcRenderer.on(IPC.SAMPLE_SEARCH_PROGRESS, handler)
+    return () => ipcRenderer.removeListener(IPC.SAMPLE_SEARCH_PROGRESS, handler)
+  },
+  queryAnnotations: (query) => ipcRenderer.invoke(IPC.QUERY_ANNOTATIONS, query),
+  getAnnotationPage: (req) => ipcRenderer.invoke(IPC.ANNOTATION_PAGE, req),
+  addAnnotations: (annotations) => ipcRenderer.invoke(IPC.ADD_ANNOTATIONS, annotations),
+  updateAnnotation: (id, annotation) => ipcRenderer.invoke(IPC.UPDATE_ANNOTATION, id, annotation),
+  removeAnnotation: (id) => ipcRenderer.invoke(IPC.REMOVE_ANNOTATION, id),
+  getStatsStatus: () => ipcRenderer.invoke(IPC.STATS_STATUS),
+  getAutoRange: (start, end, fftSize) => ipcRenderer.invoke(IPC.AUTO_RANGE, start, end, fftSize),
+  findSignal: (from, direction, thresholdDb) => ipcRenderer.invoke(IPC.FIND_SIGNAL, from, direction, thresholdDb),
+  getHealthReport: () => ipcRenderer.invoke(IPC.HEALTH_REPORT),
+  getPerfStats: () => ipcRenderer.invoke(IPC.PERF_STATS),
+  resetPerfStats: () => ipcRenderer.invoke(IPC.RESET_PERF_STATS),
+  setPerfOptions: (options) => ipcRenderer.invoke(IPC.SET_PERF_OPTIONS, options),
+  dumpPerfTrace: () => ipcRenderer.invoke(IPC.DUMP_PERF_TRACE),
   readFileSamples: (path, format, start, length) => ipcRenderer.invoke(IPC.READ_FILE_SAMPLES, path, format, start, length),
+  startStream: (config) => ipcRenderer.invoke(IPC.START_STREAM, config),
+  stopStream: () => ipcRenderer.invoke(IPC.STOP_STREAM),
+  getStreamStats: () => ipcRenderer.invoke(IPC.STREAM_STATS),
+  onStreamEvent: (listener) => {
+    const handler = (_event: Electron.IpcRendererEvent, data: StreamEvent) => listener(data)
+    ipcRenderer.on(IPC.STREAM_EVENT, handler)
+    return () => ipcRenderer.removeListener(IPC.STREAM_EVENT, handler)
+  },
   saveAnnotation: (filePath, annotation) => ipcRenderer.invoke(IPC.SAVE_ANNOTATION, filePath, annotation),
   showOpenDialog: () => ipcRenderer.invoke(IPC.SHOW_OPEN_DIALOG),
   showSaveDialog: (defaultName?) => ipcRenderer.invoke(IPC.SHOW_SAVE_DIALOG, defaultName),
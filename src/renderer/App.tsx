@@ -12,6 +12,7 @@ import { ScrollBar } from './components/ScrollBar'
 import { StatusBar } from './components/StatusBar'
 import { ExportDialog } from './components/ExportDialog'
 import { AnnotationDialog } from './components/AnnotationDialog'
+import { useVisibleAnnotations } from './hooks/useAnnotations'
 
 export default function App(): React.ReactElement {
   const fileInfo = useStore((s) => s.fileInfo)
@@ -32,6 +33,8 @@ export default function App(): React.ReactElement {
   const showAnnotation = useStore((s) => s.showAnnotationDialog)
   const setShowAnnotation = useStore((s) => s.setShowAnnotationDialog)
 
+  useVisibleAnnotations()
+
   const handleDrop = useCallback(async (e: React.DragEvent) => {
     e.preventDefault()
     const file = e.dataTransfer.files[0]
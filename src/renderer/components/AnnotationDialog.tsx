@@ -1,6 +1,8 @@
 import React, { useState } from 'react'
 import { useStore } from '../state/store'
 import type { SigMFAnnotation } from '../../shared/sample-formats'
+import { displayBandHz } from '../../shared/zoom-band'
+import { addAnnotations } from '../hooks/useAnnotations'
 
 interface AnnotationDialogProps {
   onClose: () => void
@@ -10,13 +12,13 @@ export function AnnotationDialog({ onClose }: AnnotationDialogProps): React.Reac
   const fileInfo = useStore((s) => s.fileInfo)
   const cursors = useStore((s) => s.cursors)
   const sampleRate = useStore((s) => s.sampleRate)
+  const zoomBand = useStore((s) => s.zoomBand)
   const fftSize = useStore((s) => s.fftSize)
   const zoomLevel = useStore((s) => s.zoomLevel)
   const scrollOffset = useStore((s) => s.scrollOffset)
   const viewHeight = useStore((s) => s.viewHeight)
   const yZoomLevel = useStore((s) => s.yZoomLevel)
   const yScrollOffset = useStore((s) => s.yScrollOffset)
-  const addAnnotation = useStore((s) => s.addAnnotation)
 
   const [label, setLabel] = useState('')
   const [comment, setComment] = useState('')
@@ -65,8 +67,9 @@ export function AnnotationDialog({ onClose }: AnnotationDialogProps): React.Reac
         // Use viewHeight from store which is the source of truth for the canvas size
         // Must match CursorOverlay/FrequencyAxis mapping: accounts for Y zoom and scroll
         const yNormOffset = yScrollOffset / (fftSize / 2)
-        const freqUpper = (0.5 - yNormOffset - Math.min(cursors.y1, cursors.y2) / viewHeight / yZoomLevel) * sampleRate
-        const freqLower = (0.5 - yNormOffset - Math.max(cursors.y1, cursors.y2) / viewHeight / yZoomLevel) * sampleRate
+        const band = displayBandHz(sampleRate, zoomBand, fileInfo.format)
+        const freqUpper = band.centre + (0.5 - yNormOffset - Math.min(cursors.y1, cursors.y2) / viewHeight / yZoomLevel) * band.rate
+        const freqLower = band.centre + (0.5 - yNormOffset - Math.max(cursors.y1, cursors.y2) / viewHeight / yZoomLevel) * band.rate
         annotation.freqLowerEdge = freqLower
         annotation.freqUpperEdge = freqUpper
       }
@@ -77,7 +80,7 @@ export function AnnotationDialog({ onClose }: AnnotationDialogProps): React.Reac
       }
 
       await window.snailAPI.saveAnnotation(fileInfo.path, annotation)
-      addAnnotation(annotation)
+      await addAnnotations([annotation])
       onClose()
     } catch (err: any) {
       setError(err.message)
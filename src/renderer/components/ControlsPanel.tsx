@@ -1,15 +1,43 @@
-import React from 'react'
+import React, { useState } from 'react'
 import { useStore, type XAxisMode, type CursorState } from '../state/store'
-import type { SigMFAnnotation } from '../../shared/sample-formats'
+import type { SampleFormat, SigMFAnnotation, TileMode } from '../../shared/sample-formats'
 import { formatTimeValue, formatFrequency } from '../../shared/units'
+import { displayBandHz, type ZoomBand } from '../../shared/zoom-band'
+import { captureAt } from '../../shared/captures'
+import type { ColorMapType } from '../webgl/ColorMap'
+import { useBurstDetection } from '../hooks/useBurstDetection'
+import { useStatsIndex } from '../hooks/useStatsIndex'
+import { usePerfStats } from '../hooks/usePerfStats'
+import { useOverview } from '../hooks/useOverview'
+import { useChirpSearch } from '../hooks/useChirpSearch'
+import { useSampleSearch } from '../hooks/useSampleSearch'
 
 const ANNOTATION_COLORS = ['#FF6B6B', '#4DABF7', '#51CF66', '#FFD43B', '#CC5DE8', '#FF922B']
 
 const FFT_SIZES = [16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192]
 
+const MEMORY_LIMITS: { value: number; label: string }[] = [
+  { value: 0, label: 'Unlimited' },
+  { value: 512e6, label: '512 MB' },
+  { value: 1e9, label: '1 GB' },
+  { value: 2e9, label: '2 GB' },
+  { value: 4e9, label: '4 GB' },
+  { value: 8e9, label: '8 GB' }
+]
+
+const TILE_MODES: { value: TileMode; label: string }[] = [
+  { value: 'stft', label: 'STFT' },
+  { value: 'reassigned', label: 'Reassigned (sharp)' },
+  { value: 'zoom', label: 'Zoom band (visible range)' },
+  { value: 'dechirp', label: 'Dechirp (LoRa)' }
+]
+
 export function ControlsPanel(): React.ReactElement {
   const fileInfo = useStore((s) => s.fileInfo)
   const fftSize = useStore((s) => s.fftSize)
+  const tileMode = useStore((s) => s.tileMode)
+  const channel = useStore((s) => s.channel)
+  const zoomBand = useStore((s) => s.zoomBand)
   const zoomLevel = useStore((s) => s.zoomLevel)
   const powerMin = useStore((s) => s.powerMin)
   const powerMax = useStore((s) => s.powerMax)
@@ -20,17 +48,22 @@ export function ControlsPanel(): React.ReactElement {
   const scrollOffset = useStore((s) => s.scrollOffset)
   const viewHeight = useStore((s) => s.viewHeight)
   const annotations = useStore((s) => s.annotations)
+  const annotationTotal = useStore((s) => s.annotationTotal)
   const annotationsVisible = useStore((s) => s.annotationsVisible)
   const viewWidth = useStore((s) => s.viewWidth)
   const yZoomLevel = useStore((s) => s.yZoomLevel)
   const yScrollOffset = useStore((s) => s.yScrollOffset)
-  const selectedAnnotationIndex = useStore((s) => s.selectedAnnotationIndex)
-  const setSelectedAnnotationIndex = useStore((s) => s.setSelectedAnnotationIndex)
+  const selectedAnnotation = useStore((s) => s.selectedAnnotation)
+  const setSelectedAnnotation = useStore((s) => s.setSelectedAnnotation)
 
   const setFFTSize = useStore((s) => s.setFFTSize)
+  const setTileMode = useStore((s) => s.setTileMode)
+  const setChannel = useStore((s) => s.setChannel)
   const setZoomLevel = useStore((s) => s.setZoomLevel)
   const setPowerMin = useStore((s) => s.setPowerMin)
   const setPowerMax = useStore((s) => s.setPowerMax)
+  const colorMap = useStore((s) => s.colorMap)
+  const setColorMap = useStore((s) => s.setColorMap)
   const setSampleRate = useStore((s) => s.setSampleRate)
   const setXAxisMode = useStore((s) => s.setXAxisMode)
   const setCursorsEnabled = useStore((s) => s.setCursorsEnabled)
@@ -38,6 +71,10 @@ export function ControlsPanel(): React.ReactElement {
   const setScrollOffset = useStore((s) => s.setScrollOffset)
   const snapToView = useStore((s) => s.snapToView)
 
+  const stats = useStatsIndex()
+  // Tuning at the left edge of the view, for files that retune
+  const viewCapture = captureAt(fileInfo?.captures, Math.max(0, scrollOffset))
+
   const handleAnnotationClick = (ann: SigMFAnnotation) => {
     if (!fileInfo) return
     // Zoom so annotation fills ~80% of the viewport width
@@ -87,6 +124,34 @@ export function ControlsPanel(): React.ReactElement {
         </select>
       </Section>
 
+      <Section title="Display">
+        <select
+          value={tileMode}
+          onChange={(e) => setTileMode(e.target.value as TileMode)}
+          style={{ width: '100%' }}
+        >
+          {TILE_MODES.map((m) => (
+            <option key={m.value} value={m.value}>{m.label}</option>
+          ))}
+        </select>
+      </Section>
+
+      {fileInfo && tileMode === 'dechirp' && <ChirpSection />}
+
+      {fileInfo && fileInfo.channels > 1 && (
+        <Section title="Channel">
+          <select
+            value={channel}
+            onChange={(e) => setChannel(Number(e.target.value))}
+            style={{ width: '100%' }}
+          >
+            {Array.from({ length: fileInfo.channels }, (_, c) => (
+              <option key={c} value={c}>Channel {c}</option>
+            ))}
+          </select>
+        </Section>
+      )}
+
       <Section title="Zoom">
         <input
           type="range"
@@ -141,6 +206,22 @@ export function ControlsPanel(): React.ReactElement {
           />
           <span style={valStyle}>{powerMax}</span>
         </label>
+        <select
+          value={colorMap}
+          onChange={(e) => setColorMap(e.target.value as ColorMapType)}
+          style={{ width: '100%', marginTop: 4 }}
+        >
+          <option value="plasma-dark">Plasma</option>
+          <option value="inspectrum">Inspectrum</option>
+        </select>
+        <button
+          onClick={() => stats.autoRange().catch(() => { })}
+          disabled={!stats.ready}
+          title="Fit the range to the noise floor and strongest signal in view"
+          style={{ width: '100%', fontSize: 11, padding: '4px 8px', marginTop: 4 }}
+        >
+          Auto
+        </button>
       </Section>
 
       <Section title="X Axis">
@@ -181,6 +262,8 @@ export function ControlsPanel(): React.ReactElement {
           zoomLevel={zoomLevel}
           scrollOffset={scrollOffset}
           sampleRate={sampleRate}
+          zoomBand={zoomBand}
+          format={fileInfo?.format}
           viewHeight={viewHeight}
           yZoomLevel={yZoomLevel}
           yScrollOffset={yScrollOffset}
@@ -191,14 +274,33 @@ export function ControlsPanel(): React.ReactElement {
         <Section title="File Info">
           <InfoRow label="Format" value={fileInfo.format} />
           <InfoRow label="Samples" value={fileInfo.totalSamples.toLocaleString()} />
+          {fileInfo.channels > 1 && (
+            <InfoRow label="Channels" value={fileInfo.channels.toLocaleString()} />
+          )}
           <InfoRow label="Size" value={formatBytes(fileInfo.fileSize)} />
-          {fileInfo.centerFrequency && (
-            <InfoRow label="Center" value={`${(fileInfo.centerFrequency / 1e6).toFixed(3)} MHz`} />
+          {viewCapture && viewCapture.frequency !== 0 && (
+            <InfoRow label="Center" value={`${(viewCapture.frequency / 1e6).toFixed(3)} MHz`} />
+          )}
+          {fileInfo.captures.length > 1 && (
+            <InfoRow label="Captures" value={fileInfo.captures.length.toLocaleString()} />
+          )}
+          {fileInfo.annotationCount > 0 && (
+            <InfoRow label="Annotations" value={fileInfo.annotationCount.toLocaleString()} />
           )}
         </Section>
       )}
 
-      {annotations.length > 0 && (
+      {fileInfo && <SignalStatsSection stats={stats} />}
+
+      {fileInfo && <SampleSearchSection />}
+
+      {fileInfo && <BurstDetectionSection />}
+
+      {fileInfo && <OverviewSection filePath={fileInfo.path} />}
+
+      {fileInfo && <PerformanceSection />}
+
+      {annotationTotal > 0 && (
         <Section title="Annotations">
           <label style={{ display: 'flex', alignItems: 'center', gap: 8, cursor: 'pointer', marginBottom: 6 }}>
             <input
@@ -206,21 +308,24 @@ export function ControlsPanel(): React.ReactElement {
               checked={annotationsVisible}
               onChange={(e) => {
                 setAnnotationsVisible(e.target.checked)
-                if (!e.target.checked) setSelectedAnnotationIndex(null)
+                if (!e.target.checked) setSelectedAnnotation(null)
               }}
             />
             <span style={{ fontSize: 12 }}>Show on spectrogram</span>
           </label>
+          <div style={{ fontSize: 10, color: 'var(--text-muted)', marginBottom: 6, fontFamily: 'var(--font-mono)' }}>
+            {annotations.length.toLocaleString()} in view of {annotationTotal.toLocaleString()}
+          </div>
           <div style={{ display: 'flex', flexDirection: 'column', gap: 4 }}>
-            {annotations.map((ann, i) => {
-              const color = ANNOTATION_COLORS[i % ANNOTATION_COLORS.length]
-              const isSelected = selectedAnnotationIndex === i
+            {annotations.map((ann) => {
+              const color = ANNOTATION_COLORS[ann.id % ANNOTATION_COLORS.length]
+              const isSelected = selectedAnnotation?.id === ann.id
               return (
                 <div
-                  key={i}
+                  key={ann.id}
                   onClick={() => {
                     handleAnnotationClick(ann)
-                    setSelectedAnnotationIndex(i)
+                    setSelectedAnnotation(ann)
                   }}
                   style={{
                     padding: '6px 8px',
@@ -242,7 +347,7 @@ export function ControlsPanel(): React.ReactElement {
                   }}
                 >
                   <div style={{ fontWeight: 600, color: 'var(--text)' }}>
-                    {ann.label || `Annotation ${i + 1}`}
+                    {ann.label || `Annotation ${ann.id}`}
                   </div>
                   <div style={{ color: 'var(--text-muted)', fontSize: 10, fontFamily: 'var(--font-mono)' }}>
                     S: {ann.sampleStart.toLocaleString()} ({ann.sampleCount.toLocaleString()})
@@ -257,12 +362,14 @@ export function ControlsPanel(): React.ReactElement {
   )
 }
 
-function CursorInfoSection({ cursors, fftSize, zoomLevel, scrollOffset, sampleRate, viewHeight, yZoomLevel, yScrollOffset }: {
+function CursorInfoSection({ cursors, fftSize, zoomLevel, scrollOffset, sampleRate, zoomBand, format, viewHeight, yZoomLevel, yScrollOffset }: {
   cursors: CursorState
   fftSize: number
   zoomLevel: number
   scrollOffset: number
   sampleRate: number
+  zoomBand: ZoomBand | null
+  format?: SampleFormat
   viewHeight: number
   yZoomLevel: number
   yScrollOffset: number
@@ -274,8 +381,9 @@ function CursorInfoSection({ cursors, fftSize, zoomLevel, scrollOffset, sampleRa
   const timeDelta = sampleDelta / sampleRate
 
   const yNormOffset = viewHeight > 0 ? yScrollOffset / (fftSize / 2) : 0
+  const band = displayBandHz(sampleRate, zoomBand, format)
   const freqFromY = (yPx: number) => viewHeight > 0
-    ? (0.5 - yNormOffset - yPx / viewHeight / yZoomLevel) * sampleRate
+    ? band.centre + (0.5 - yNormOffset - yPx / viewHeight / yZoomLevel) * band.rate
     : 0
   const f1 = freqFromY(cursors.y1)
   const f2 = freqFromY(cursors.y2)
@@ -293,6 +401,455 @@ function CursorInfoSection({ cursors, fftSize, zoomLevel, scrollOffset, sampleRa
   )
 }
 
+function SignalStatsSection({ stats }: { stats: ReturnType<typeof useStatsIndex> }): React.ReactElement {
+  const { status, health, ready, jumpToSignal } = stats
+
+  const buttonStyle: React.CSSProperties = {
+    flex: 1,
+    background: 'var(--surface)',
+    border: '1px solid var(--border)',
+    color: 'var(--text)',
+    fontSize: 11,
+    padding: '4px 8px',
+    cursor: 'pointer',
+    borderRadius: 3
+  }
+
+  return (
+    <Section title="Signal">
+      <div style={{ display: 'flex', gap: 6, marginBottom: 6 }}>
+        <button onClick={() => jumpToSignal(-1).catch(() => { })} disabled={!ready} style={buttonStyle}>
+          {'\u25C0 Prev'}
+        </button>
+        <button onClick={() => jumpToSignal(1).catch(() => { })} disabled={!ready} style={buttonStyle}>
+          {'Next \u25B6'}
+        </button>
+      </div>
+      {status?.state === 'building' && (
+        <div style={{ fontSize: 10, color: 'var(--text-muted)', fontFamily: 'var(--font-mono)' }}>
+          Indexing {(status.progress * 100).toFixed(0)}%
+        </div>
+      )}
+      {status?.state === 'failed' && (
+        <div style={{ fontSize: 10, color: 'var(--text-muted)' }}>Indexing failed: {status.error}</div>
+      )}
+      {health && (
+        <>
+          <InfoRow label="Mean" value={`${health.meanPowerDb.toFixed(1)} dBFS`} />
+          <InfoRow label="Peak" value={`${health.peakPowerDb.toFixed(1)} dBFS`} />
+          <InfoRow label="Noise floor" value={`${health.noiseFloorDb.toFixed(1)} dBFS`} />
+          <InfoRow label="DC offset" value={`${health.dcOffsetDb.toFixed(1)} dBc`} />
+          {health.complex && (
+            <>
+              <InfoRow label="IQ gain" value={`${health.iqGainDb.toFixed(2)} dB`} />
+              <InfoRow label="IQ phase" value={`${health.iqPhaseDeg.toFixed(2)}\u00B0`} />
+            </>
+          )}
+          <InfoRow
+            label="Clipped"
+            value={health.clippedSamples > 0
+              ? `${health.clippedSamples.toLocaleString()} (${(health.clippedFraction * 100).toFixed(3)}%)`
+              : 'none'}
+          />
+        </>
+      )}
+    </Section>
+  )
+}
+
+function BurstDetectionSection(): React.ReactElement {
+  const channel = useStore((s) => s.channel)
+  const { detect, cancel, detecting, progress, found } = useBurstDetection()
+  const [thresholdDb, setThresholdDb] = useState(10)
+
+  const buttonStyle: React.CSSProperties = {
+    flex: 1,
+    background: 'var(--surface)',
+    border: '1px solid var(--border)',
+    color: 'var(--text)',
+    fontSize: 11,
+    padding: '4px 8px',
+    cursor: 'pointer',
+    borderRadius: 3
+  }
+
+  return (
+    <Section title="Burst Detection">
+      <div style={{ display: 'flex', alignItems: 'center', gap: 8, marginBottom: 6 }}>
+        <span style={{ fontSize: 11, color: 'var(--text-muted)' }}>Threshold (dB)</span>
+        <input
+          type="number"
+          value={thresholdDb}
+          min={1}
+          max={60}
+          onChange={(e) => setThresholdDb(Number(e.target.value))}
+          style={{ width: 60 }}
+        />
+      </div>
+      <div style={{ display: 'flex', gap: 6 }}>
+        {detecting ? (
+          <button onClick={cancel} style={buttonStyle}>Cancel</button>
+        ) : (
+          // Two frames minimum so on/off transients alone are not reported
+          <button onClick={() => detect({ thresholdDb, minDuration: 512, channel }).catch(() => { })} style={buttonStyle}>
+            Detect
+          </button>
+        )}
+      </div>
+      {(detecting || found > 0) && (
+        <div style={{ fontSize: 10, color: 'var(--text-muted)', marginTop: 4, fontFamily: 'var(--font-mono)' }}>
+          {detecting ? `${(progress * 100).toFixed(0)}% · ` : ''}{found} found
+        </div>
+      )}
+    </Section>
+  )
+}
+
+// Chirp parameters for the dechirp display, and a whole-file symbol search
+// that annotates each run of symbols it finds
+function ChirpSection(): React.ReactElement {
+  const loraSf = useStore((s) => s.loraSf)
+  const loraBandwidth = useStore((s) => s.loraBandwidth)
+  const sampleRate = useStore((s) => s.sampleRate)
+  const channel = useStore((s) => s.channel)
+  const setLoraSf = useStore((s) => s.setLoraSf)
+  const setLoraBandwidth = useStore((s) => s.setLoraBandwidth)
+  const { search, cancel, searching, progress, found } = useChirpSearch()
+  const [thresholdDb, setThresholdDb] = useState(10)
+
+  const buttonStyle: React.CSSProperties = {
+    flex: 1,
+    background: 'var(--surface)',
+    border: '1px solid var(--border)',
+    color: 'var(--text)',
+    fontSize: 11,
+    padding: '4px 8px',
+    cursor: 'pointer',
+    borderRadius: 3
+  }
+  const rowStyle: React.CSSProperties = { display: 'flex', alignItems: 'center', justifyContent: 'space-between', gap: 8, marginBottom: 6 }
+  const labelStyle: React.CSSProperties = { fontSize: 11, color: 'var(--text-muted)' }
+
+  return (
+    <Section title="Chirps">
+      <div style={rowStyle}>
+        <span style={labelStyle}>SF</span>
+        <select value={loraSf} onChange={(e) => setLoraSf(Number(e.target.value))} style={{ width: 80 }}>
+          {[5, 6, 7, 8, 9, 10, 11, 12].map((sf) => (
+            <option key={sf} value={sf}>{sf}</option>
+          ))}
+        </select>
+      </div>
+      <div style={rowStyle}>
+        <span style={labelStyle}>BW (Hz)</span>
+        <input
+          type="number"
+          value={loraBandwidth}
+          min={1}
+          max={sampleRate}
+          onChange={(e) => {
+            const bw = Number(e.target.value)
+            if (bw > 0) setLoraBandwidth(Math.min(bw, sampleRate))
+          }}
+          style={{ width: 80 }}
+        />
+      </div>
+      <div style={rowStyle}>
+        <span style={labelStyle}>Threshold (dB)</span>
+        <input
+          type="number"
+          value={thresholdDb}
+          min={1}
+          max={60}
+          onChange={(e) => setThresholdDb(Number(e.target.value))}
+          style={{ width: 80 }}
+        />
+      </div>
+      <div style={{ display: 'flex', gap: 6 }}>
+        {searching ? (
+          <button onClick={cancel} style={buttonStyle}>Cancel</button>
+        ) : (
+          <button
+            onClick={() => search({
+              spreadingFactor: loraSf,
+              chirpBandwidth: Math.min(1, loraBandwidth / sampleRate),
+              thresholdDb,
+              channel
+            }).catch(() => { })}
+            style={buttonStyle}
+          >
+            Find symbols
+          </button>
+        )}
+      </div>
+      {(searching || found > 0) && (
+        <div style={{ fontSize: 10, color: 'var(--text-muted)', marginTop: 4, fontFamily: 'var(--font-mono)' }}>
+          {searching ? `${(progress * 100).toFixed(0)}% · ` : ''}{found} frames
+        </div>
+      )}
+    </Section>
+  )
+}
+
+// Time-domain search straight over the samples: jump to the first or next
+// sample over (or under) a power threshold, or annotate every such range
+function SampleSearchSection(): React.ReactElement {
+  const channel = useStore((s) => s.channel)
+  const { find, findAll, cancel, searching, progress, found, last } = useSampleSearch()
+  const [condition, setCondition] = useState<'power' | 'average' | 'clip'>('power')
+  const [thresholdDb, setThresholdDb] = useState(-20)
+  const [windowSamples, setWindowSamples] = useState(1024)
+  const [below, setBelow] = useState(false)
+  const [note, setNote] = useState('')
+
+  const buttonStyle: React.CSSProperties = {
+    flex: 1,
+    background: 'var(--surface)',
+    border: '1px solid var(--border)',
+    color: 'var(--text)',
+    fontSize: 11,
+    padding: '4px 8px',
+    cursor: 'pointer',
+    borderRadius: 3
+  }
+  const rowStyle: React.CSSProperties = { display: 'flex', alignItems: 'center', justifyContent: 'space-between', gap: 8, marginBottom: 6 }
+  const labelStyle: React.CSSProperties = { fontSize: 11, color: 'var(--text-muted)' }
+
+  const config = { condition, thresholdDb, window: windowSamples, below, channel }
+  const report = (promise: Promise<{ ranges: unknown[]; truncated: boolean; cancelled: boolean }>) => {
+    setNote('')
+    promise
+      .then((r) => setNote(r.cancelled ? 'Cancelled' : r.ranges.length === 0 ? 'No match' : r.truncated ? 'Stopped at the range limit' : ''))
+      .catch((err) => setNote(err instanceof Error ? err.message : String(err)))
+  }
+
+  return (
+    <Section title="Sample search">
+      <div style={rowStyle}>
+        <span style={labelStyle}>Condition</span>
+        <select value={condition} onChange={(e) => setCondition(e.target.value as typeof condition)} style={{ width: 100 }}>
+          <option value="power">Power</option>
+          <option value="average">Average power</option>
+          <option value="clip">Clipping</option>
+        </select>
+      </div>
+      {condition !== 'clip' && (
+        <>
+          <div style={rowStyle}>
+            <span style={labelStyle}>Threshold (dBFS)</span>
+            <input
+              type="number"
+              value={thresholdDb}
+              max={10}
+              onChange={(e) => setThresholdDb(Number(e.target.value))}
+              style={{ width: 80 }}
+            />
+          </div>
+          <div style={rowStyle}>
+            <label style={labelStyle}>
+              <input type="checkbox" checked={below} onChange={(e) => setBelow(e.target.checked)} /> Below threshold
+            </label>
+          </div>
+        </>
+      )}
+      {condition === 'average' && (
+        <div style={rowStyle}>
+          <span style={labelStyle}>Window (samples)</span>
+          <input
+            type="number"
+            value={windowSamples}
+            min={1}
+            onChange={(e) => setWindowSamples(Math.max(1, Math.round(Number(e.target.value))))}
+            style={{ width: 80 }}
+          />
+        </div>
+      )}
+      <div style={{ display: 'flex', gap: 6 }}>
+        {searching ? (
+          <button onClick={cancel} style={buttonStyle}>Cancel</button>
+        ) : (
+          <>
+            <button onClick={() => report(find(config, false))} style={buttonStyle}>First</button>
+            <button onClick={() => report(find(config, true))} style={buttonStyle}>{'Next \u25B6'}</button>
+            <button onClick={() => report(findAll(config))} style={buttonStyle}>All</button>
+          </>
+        )}
+      </div>
+      {(searching || found > 0 || note) && (
+        <div style={{ fontSize: 10, color: 'var(--text-muted)', marginTop: 4, fontFamily: 'var(--font-mono)' }}>
+          {searching ? `${(progress * 100).toFixed(0)}%` : note ||
+            (last ? `@ ${last.sampleStart}, ${last.sampleCount} samples, ${last.peakDb.toFixed(1)} dBFS` : `${found} ranges`)}
+        </div>
+      )}
+    </Section>
+  )
+}
+
+// Whole-file image for reports, coloured with the current power range
+function OverviewSection({ filePath }: { filePath: string }): React.ReactElement {
+  const fftSize = useStore((s) => s.fftSize)
+  const powerMin = useStore((s) => s.powerMin)
+  const powerMax = useStore((s) => s.powerMax)
+  const colorMap = useStore((s) => s.colorMap)
+  const channel = useStore((s) => s.channel)
+  const { render, cancel, rendering, progress } = useOverview()
+  const [width, setWidth] = useState(4096)
+  const [height, setHeight] = useState(512)
+  const [note, setNote] = useState('')
+
+  const buttonStyle: React.CSSProperties = {
+    flex: 1,
+    background: 'var(--surface)',
+    border: '1px solid var(--border)',
+    color: 'var(--text)',
+    fontSize: 11,
+    padding: '4px 8px',
+    cursor: 'pointer',
+    borderRadius: 3
+  }
+
+  const save = async () => {
+    setNote('')
+    const name = filePath.split(/[\\/]/).pop()!.replace(/\.(sigmf-(data|meta)|[^.]+)$/, '')
+    const result = await render({ width, height, fftSize, colormap: colorMap, channel, minDb: powerMin, maxDb: powerMax }, `${name}-overview.png`)
+    if (result) setNote(result.cancelled ? 'Cancelled' : `${result.ffts.toLocaleString()} FFTs saved`)
+  }
+
+  return (
+    <Section title="Overview Image">
+      <div style={{ display: 'flex', alignItems: 'center', gap: 8, marginBottom: 6 }}>
+        <input
+          type="number"
+          value={width}
+          min={64}
+          max={65536}
+          onChange={(e) => setWidth(Number(e.target.value))}
+          style={{ width: 70 }}
+        />
+        <span style={{ fontSize: 11, color: 'var(--text-muted)' }}>×</span>
+        <input
+          type="number"
+          value={height}
+          min={16}
+          max={16384}
+          onChange={(e) => setHeight(Number(e.target.value))}
+          style={{ width: 60 }}
+        />
+      </div>
+      <div style={{ display: 'flex', gap: 6 }}>
+        {rendering ? (
+          <button onClick={cancel} style={buttonStyle}>Cancel</button>
+        ) : (
+          <button onClick={() => save().catch((err) => setNote(String(err.message || err)))} style={buttonStyle}>
+            Save PNG…
+          </button>
+        )}
+      </div>
+      {(rendering || note) && (
+        <div style={{ fontSize: 10, color: 'var(--text-muted)', marginTop: 4, fontFamily: 'var(--font-mono)' }}>
+          {rendering ? `${(progress * 100).toFixed(0)}%` : note}
+        </div>
+      )}
+    </Section>
+  )
+}
+
+function PerformanceSection(): React.ReactElement {
+  const [open, setOpen] = useState(false)
+  const { stats, reset, setOptions, dumpTrace } = usePerfStats(open)
+  const [traceNote, setTraceNote] = useState('')
+
+  const buttonStyle: React.CSSProperties = {
+    flex: 1,
+    background: 'var(--surface)',
+    border: '1px solid var(--border)',
+    color: 'var(--text)',
+    fontSize: 11,
+    padding: '4px 8px',
+    cursor: 'pointer',
+    borderRadius: 3
+  }
+
+  const saveTrace = async () => {
+    const result = await dumpTrace()
+    if (result) setTraceNote(`${result.events.toLocaleString()} events saved`)
+  }
+
+  return (
+    <Section title="Performance">
+      <label style={{ display: 'flex', alignItems: 'center', gap: 8, cursor: 'pointer', marginBottom: 4 }}>
+        <input type="checkbox" checked={open} onChange={(e) => setOpen(e.target.checked)} />
+        <span style={{ fontSize: 12 }}>Show timings</span>
+      </label>
+      {open && stats && (
+        <>
+          <label style={{ display: 'flex', alignItems: 'center', gap: 8, cursor: 'pointer' }}>
+            <input type="checkbox" checked={stats.detailed} onChange={(e) => setOptions({ detailed: e.target.checked })} />
+            <span style={{ fontSize: 12 }}>Per-line stages</span>
+          </label>
+          <label style={{ display: 'flex', alignItems: 'center', gap: 8, cursor: 'pointer', marginBottom: 6 }}>
+            <input type="checkbox" checked={stats.tracing} onChange={(e) => setOptions({ tracing: e.target.checked })} />
+            <span style={{ fontSize: 12 }}>Record trace</span>
+          </label>
+          {stats.stages.map((st) => (
+            <InfoRow
+              key={st.stage}
+              label={`${st.stage} ×${st.count.toLocaleString()}`}
+              value={`p50 ${formatMicros(st.p50Us)} · p99 ${formatMicros(st.p99Us)}`}
+            />
+          ))}
+          <InfoRow label="Buffers" value={`${formatBytes(stats.memory.inUse)} + ${formatBytes(stats.memory.pooled)} pooled`} />
+          <InfoRow label="Buffer peak" value={formatBytes(stats.memory.peakTotal)} />
+          {stats.memory.hits + stats.memory.misses > 0 && (
+            <InfoRow
+              label="Buffer reuse"
+              value={`${(100 * stats.memory.hits / (stats.memory.hits + stats.memory.misses)).toFixed(0)}%`}
+            />
+          )}
+          <InfoRow
+            label="Reserved"
+            value={`${formatBytes(stats.memory.budget.reserved)} (peak ${formatBytes(stats.memory.budget.peakReserved)})`}
+          />
+          <InfoRow label="File caches" value={formatBytes(stats.memory.budget.cached)} />
+          {stats.memory.budget.waits + stats.memory.budget.degraded + stats.memory.budget.rejected > 0 && (
+            <InfoRow
+              label="Over budget"
+              value={`${stats.memory.budget.waits} waited · ${stats.memory.budget.degraded} degraded · ${stats.memory.budget.rejected} rejected`}
+            />
+          )}
+          <div style={{ display: 'flex', alignItems: 'center', justifyContent: 'space-between', marginTop: 4 }}>
+            <span style={{ fontSize: 11, color: 'var(--text-muted)' }}>Memory budget</span>
+            <select
+              value={stats.memory.limit}
+              onChange={(e) => setOptions({ memoryLimit: Number(e.target.value) }).catch(() => { })}
+              style={{ width: 100 }}
+            >
+              {MEMORY_LIMITS.map((m) => (
+                <option key={m.value} value={m.value}>{m.label}</option>
+              ))}
+            </select>
+          </div>
+          <div style={{ display: 'flex', gap: 6, marginTop: 6 }}>
+            <button onClick={() => reset().catch(() => { })} style={buttonStyle}>Reset</button>
+            <button onClick={() => saveTrace().catch(() => { })} disabled={!stats.tracing} style={buttonStyle}>
+              Save trace
+            </button>
+          </div>
+          {traceNote && (
+            <div style={{ fontSize: 10, color: 'var(--text-muted)', marginTop: 4, fontFamily: 'var(--font-mono)' }}>{traceNote}</div>
+          )}
+        </>
+      )}
+    </Section>
+  )
+}
+
+function formatMicros(us: number): string {
+  if (us >= 1e6) return `${(us / 1e6).toFixed(2)} s`
+  if (us >= 1e3) return `${(us / 1e3).toFixed(1)} ms`
+  return `${us.toFixed(0)} µs`
+}
+
 function Section({ title, children }: { title: string; children: React.ReactNode }) {
   return (
     <div>
@@ -1,11 +1,16 @@
 import React, { useRef, useEffect, useCallback } from 'react'
 import { useStore } from '../state/store'
-import type { SampleFormat } from '../../shared/sample-formats'
+import type { SampleFormat, OfdmCandidate } from '../../shared/sample-formats'
+import { formatFrequency } from '../../shared/units'
 
 const PREVIEW_HEIGHT = 100
 const PLOT_HEIGHT = 80
 const DEBOUNCE_MS = 500
 
+// Blind OFDM search grid: FFT sizes times the usual CP fractions
+const OFDM_TU = [64, 128, 256, 512, 1024, 2048, 4096, 8192]
+const OFDM_CP_DIVISORS = [4, 8, 16, 32]
+
 const FORMATS: SampleFormat[] = [
   'cf32', 'cf64', 'cs32', 'cs16', 'cs8', 'cu8',
   'rf32', 'rf64', 'rs16', 'rs8', 'ru8'
@@ -43,6 +48,8 @@ export function CorrelationPane(): React.ReactElement {
   const [inputMode, setInputMode] = React.useState<'samples' | 'time'>('samples')
   const [tuText, setTuText] = React.useState(tu.toString())
   const [cpText, setCpText] = React.useState(cpLen.toString())
+  const [ofdmBest, setOfdmBest] = React.useState<OfdmCandidate | null>(null)
+  const [ofdmSearching, setOfdmSearching] = React.useState(false)
 
   // Sync text when tu/cp changes from outside (e.g. store reset or mode toggle)
   useEffect(() => {
@@ -85,6 +92,25 @@ export function CorrelationPane(): React.ReactElement {
     Math.round(Math.abs(cursors.x2 - cursors.x1) * samplesPerPixel)
   )
 
+  // Score every grid numerology over the window and adopt the best
+  const handleOfdmSearch = useCallback(async () => {
+    const hypotheses = OFDM_TU.flatMap((t) => OFDM_CP_DIVISORS.map((d) => ({ tu: t, cpLen: t / d })))
+    setOfdmSearching(true)
+    try {
+      const [best] = await window.snailAPI.searchOfdm({ windowStart, windowLength, hypotheses, maxResults: 1 })
+      setOfdmBest(best ?? null)
+      if (best) {
+        setTu(best.tu)
+        setCpLen(best.cpLen)
+      }
+    } catch (err) {
+      console.error('OFDM search failed:', err)
+      setOfdmBest(null)
+    } finally {
+      setOfdmSearching(false)
+    }
+  }, [windowStart, windowLength, setTu, setCpLen])
+
   const handleLoadFile = useCallback(async () => {
     const path = await window.snailAPI.showOpenDialog()
     if (path) setCorrelationFilePath(path)
@@ -431,6 +457,19 @@ export function CorrelationPane(): React.ReactElement {
                 placeholder={inputMode === 'samples' ? 'Samples' : 'e.g. 16e-6'}
               />
             </label>
+            <button
+              onClick={handleOfdmSearch}
+              disabled={ofdmSearching || !cursors.enabled || Math.abs(cursors.x2 - cursors.x1) < 5}
+              style={{ fontSize: 10, padding: '1px 6px' }}
+              title="Try Tu 64..8192 with CP Tu/4..Tu/32 and keep the best"
+            >
+              {ofdmSearching ? 'Searching...' : 'Search'}
+            </button>
+            {ofdmBest && (
+              <span style={{ color: 'var(--text-muted)', fontFamily: 'var(--font-mono)', fontSize: 10 }}>
+                {`score ${ofdmBest.score.toFixed(2)} · CFO ${formatFrequency(ofdmBest.cfo * sampleRate)}`}
+              </span>
+            )}
 
             <div style={{
               fontSize: 10,
@@ -1,6 +1,9 @@
 import React, { useRef, useEffect, useCallback, useState } from 'react'
 import { useStore } from '../state/store'
 import { formatTimeValue, formatFrequency } from '../../shared/units'
+import { displayBandHz } from '../../shared/zoom-band'
+import { captureIndexAt } from '../../shared/captures'
+import type { AnnotationEntry } from '../../shared/sample-formats'
 
 const GRAB_THRESHOLD = 10
 const TRI_W = 16
@@ -9,6 +12,7 @@ const TRI_COLOR = '#FFD700'
 const TRI_HOVER = '#FFE44D'
 
 const ANNOTATION_COLORS = ['#FF6B6B', '#4DABF7', '#51CF66', '#FFD43B', '#CC5DE8', '#FF922B']
+const RETUNE_COLOR = '#FF8787'
 
 type DragTarget = 'x1' | 'x2' | 'y1' | 'y2' | 'all' | null
 
@@ -23,6 +27,7 @@ export function CursorOverlay(): React.ReactElement {
   const annotations = useStore((s) => s.annotations)
   const annotationsVisible = useStore((s) => s.annotationsVisible)
   const sampleRate = useStore((s) => s.sampleRate)
+  const zoomBand = useStore((s) => s.zoomBand)
   const fftSize = useStore((s) => s.fftSize)
   const zoomLevel = useStore((s) => s.zoomLevel)
   const scrollOffset = useStore((s) => s.scrollOffset)
@@ -35,8 +40,8 @@ export function CursorOverlay(): React.ReactElement {
   const viewWidth = useStore((s) => s.viewWidth)
   const setZoomLevel = useStore((s) => s.setZoomLevel)
   const setScrollOffset = useStore((s) => s.setScrollOffset)
-  const selectedAnnotationIndex = useStore((s) => s.selectedAnnotationIndex)
-  const setSelectedAnnotationIndex = useStore((s) => s.setSelectedAnnotationIndex)
+  const selectedAnnotation = useStore((s) => s.selectedAnnotation)
+  const setSelectedAnnotation = useStore((s) => s.setSelectedAnnotation)
   const setPendingExport = useStore((s) => s.setPendingExport)
   const setShowExportDialog = useStore((s) => s.setShowExportDialog)
 
@@ -69,7 +74,7 @@ export function CursorOverlay(): React.ReactElement {
 
     for (let i = 0; annotationsVisible && i < annotations.length; i++) {
       const ann = annotations[i]
-      const color = ANNOTATION_COLORS[i % ANNOTATION_COLORS.length]
+      const color = ANNOTATION_COLORS[ann.id % ANNOTATION_COLORS.length]
 
       const ax1 = (ann.sampleStart - scrollOffset) / samplesPerPx
       const ax2 = (ann.sampleStart + ann.sampleCount - scrollOffset) / samplesPerPx
@@ -79,8 +84,9 @@ export function CursorOverlay(): React.ReactElement {
         // Map frequency to pixel Y: freq -> normalized bin -> pixel
         // DC is center. Top of view = +sampleRate/2, bottom = -sampleRate/2
         // Normalized position: (0.5 - freq/sampleRate) maps to [0, 1] for full range
-        const normTop = 0.5 - ann.freqUpperEdge / sampleRate
-        const normBot = 0.5 - ann.freqLowerEdge / sampleRate
+        const band = displayBandHz(sampleRate, zoomBand, fileInfo?.format)
+        const normTop = 0.5 - (ann.freqUpperEdge - band.centre) / band.rate
+        const normBot = 0.5 - (ann.freqLowerEdge - band.centre) / band.rate
         // Apply Y zoom/scroll
         ay1 = ((normTop - yScrollBins) * yZoomLevel) * rect.height
         ay2 = ((normBot - yScrollBins) * yZoomLevel) * rect.height
@@ -102,7 +108,7 @@ export function CursorOverlay(): React.ReactElement {
       ctx.fillRect(drawX1, drawY1, drawX2 - drawX1, drawY2 - drawY1)
 
       // Border
-      const isSelected = selectedAnnotationIndex === i
+      const isSelected = selectedAnnotation?.id === ann.id
       ctx.strokeStyle = color + (isSelected ? 'FF' : 'AA')
       ctx.lineWidth = isSelected ? 2 : 1
       ctx.setLineDash([])
@@ -125,6 +131,33 @@ export function CursorOverlay(): React.ReactElement {
       }
     }
 
+    // Retune markers: each capture boundary in view, labelled with the new tuning
+    const captures = fileInfo?.captures ?? []
+    if (captures.length > 1) {
+      const viewEnd = scrollOffset + rect.width * samplesPerPx
+      ctx.font = '10px "JetBrains Mono", monospace'
+      for (let i = captureIndexAt(captures, scrollOffset) + 1; i < captures.length; i++) {
+        const capture = captures[i]
+        if (capture.sampleStart >= viewEnd) break
+        const x = (capture.sampleStart - scrollOffset) / samplesPerPx
+        ctx.strokeStyle = RETUNE_COLOR
+        ctx.lineWidth = 1
+        ctx.setLineDash([2, 3])
+        ctx.beginPath()
+        ctx.moveTo(x, 0)
+        ctx.lineTo(x, rect.height)
+        ctx.stroke()
+        ctx.setLineDash([])
+
+        const label = formatFrequency(capture.frequency)
+        const tw = ctx.measureText(label).width
+        ctx.fillStyle = 'rgba(0, 0, 0, 0.7)'
+        ctx.fillRect(x + 2, rect.height - 18, tw + 6, 14)
+        ctx.fillStyle = RETUNE_COLOR
+        ctx.fillText(label, x + 5, rect.height - 7)
+      }
+    }
+
     if (cursors.enabled) {
       const { x1, x2, y1, y2 } = cursors
 
@@ -199,7 +232,8 @@ export function CursorOverlay(): React.ReactElement {
         // Absolute label for Y — must account for Y zoom/scroll (matches FrequencyAxis mapping)
         const totalBinsY = fftSize / 2
         const yNormOffset = yScrollOffset / totalBinsY
-        const freqVal = (0.5 - yNormOffset - (y / rect.height) / yZoomLevel) * sampleRate
+        const band = displayBandHz(sampleRate, zoomBand, fileInfo?.format)
+        const freqVal = band.centre + (0.5 - yNormOffset - (y / rect.height) / yZoomLevel) * band.rate
         const label = formatFrequency(freqVal)
         ctx.font = '10px "JetBrains Mono", monospace'
         const tw = ctx.measureText(label).width
@@ -210,7 +244,7 @@ export function CursorOverlay(): React.ReactElement {
         ctx.fillText(label, rect.width - TRI_H - tw - 9, y + 4)
       }
     } // end if (cursors.enabled)
-  }, [cursors, annotations, annotationsVisible, fftSize, zoomLevel, sampleRate, scrollOffset, xAxisMode, yZoomLevel, yScrollOffset, hoverTarget, selectedAnnotationIndex])
+  }, [cursors, annotations, annotationsVisible, fileInfo, fftSize, zoomLevel, sampleRate, zoomBand, scrollOffset, xAxisMode, yZoomLevel, yScrollOffset, hoverTarget, selectedAnnotation])
 
   const hitTestTriangle = useCallback((mx: number, my: number): DragTarget => {
     const container = containerRef.current
@@ -235,7 +269,7 @@ export function CursorOverlay(): React.ReactElement {
     return null
   }, [cursors])
 
-  const hitTestAnnotation = useCallback((mx: number, my: number): number | null => {
+  const hitTestAnnotation = useCallback((mx: number, my: number): AnnotationEntry | null => {
     const container = containerRef.current
     if (!container) return null
     const rect = container.getBoundingClientRect()
@@ -253,8 +287,9 @@ export function CursorOverlay(): React.ReactElement {
 
       let ay1: number, ay2: number
       if (ann.freqLowerEdge != null && ann.freqUpperEdge != null) {
-        const normTop = 0.5 - ann.freqUpperEdge / sampleRate
-        const normBot = 0.5 - ann.freqLowerEdge / sampleRate
+        const band = displayBandHz(sampleRate, zoomBand, fileInfo?.format)
+        const normTop = 0.5 - (ann.freqUpperEdge - band.centre) / band.rate
+        const normBot = 0.5 - (ann.freqLowerEdge - band.centre) / band.rate
         ay1 = ((normTop - yScrollBins) * yZoomLevel) * rect.height
         ay2 = ((normBot - yScrollBins) * yZoomLevel) * rect.height
       } else {
@@ -266,11 +301,11 @@ export function CursorOverlay(): React.ReactElement {
       const minY = Math.min(ay1, ay2), maxY = Math.max(ay1, ay2)
 
       if (mx >= minX && mx <= maxX && my >= minY && my <= maxY) {
-        return i
+        return ann
       }
     }
     return null
-  }, [annotations, fftSize, zoomLevel, scrollOffset, yScrollOffset, yZoomLevel, sampleRate])
+  }, [annotations, fileInfo, fftSize, zoomLevel, scrollOffset, yScrollOffset, yZoomLevel, sampleRate, zoomBand])
 
   const findTarget = useCallback((x: number, y: number): DragTarget => {
     // Check triangles first (easier to grab)
@@ -309,15 +344,14 @@ export function CursorOverlay(): React.ReactElement {
     if (target) {
       setDragging(target)
       setDragStart({ x, y })
-      setSelectedAnnotationIndex(null) // deselect when interacting with cursors
+      setSelectedAnnotation(null) // deselect when interacting with cursors
     } else {
       // Check for annotation click
-      const annIdx = hitTestAnnotation(x, y)
-      if (annIdx !== null) {
-        setSelectedAnnotationIndex(annIdx)
+      const ann = hitTestAnnotation(x, y)
+      if (ann) {
+        setSelectedAnnotation(ann)
         // Auto-zoom to center the annotation
-        const ann = annotations[annIdx]
-        if (ann && fileInfo) {
+        if (fileInfo) {
           const targetZoom = Math.round((viewWidth * fftSize * 0.8) / ann.sampleCount)
           const newZoom = Math.max(1, Math.min(fftSize, targetZoom))
           setZoomLevel(newZoom)
@@ -337,10 +371,10 @@ export function CursorOverlay(): React.ReactElement {
         setCursorY(cy, cy)
         setDragging('x2')
         setDragStart({ x: cx, y: cy })
-        setSelectedAnnotationIndex(null)
+        setSelectedAnnotation(null)
       }
     }
-  }, [cursors.enabled, findTarget, hitTestAnnotation, annotations, fileInfo, fftSize, viewWidth, setCursorX, setCursorY, setZoomLevel, setScrollOffset, setSelectedAnnotationIndex])
+  }, [cursors.enabled, findTarget, hitTestAnnotation, fileInfo, fftSize, viewWidth, setCursorX, setCursorY, setZoomLevel, setScrollOffset, setSelectedAnnotation])
 
   // Clamp X pixel position so cursor can't exceed the file's sample range
   const clampX = useCallback((px: number, containerWidth: number): number => {
@@ -395,7 +429,7 @@ export function CursorOverlay(): React.ReactElement {
 
   if (!cursors.enabled && annotations.length === 0) return <></>
 
-  const selectedAnn = selectedAnnotationIndex !== null ? annotations[selectedAnnotationIndex] : null
+  const selectedAnn = selectedAnnotation
 
   return (
     <div
@@ -440,7 +474,7 @@ export function CursorOverlay(): React.ReactElement {
             <button
               onClick={(e) => {
                 e.stopPropagation()
-                setSelectedAnnotationIndex(null)
+                setSelectedAnnotation(null)
               }}
               style={{
                 background: 'none',
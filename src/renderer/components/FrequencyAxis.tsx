@@ -1,6 +1,7 @@
 import React, { useRef, useEffect } from 'react'
 import { useStore } from '../state/store'
 import { formatFrequency } from '../../shared/units'
+import { displayBandHz } from '../../shared/zoom-band'
 
 const AXIS_WIDTH = 72
 
@@ -12,6 +13,8 @@ export function FrequencyAxis(): React.ReactElement {
   const fftSize = useStore((s) => s.fftSize)
   const yZoomLevel = useStore((s) => s.yZoomLevel)
   const yScrollOffset = useStore((s) => s.yScrollOffset)
+  const zoomBand = useStore((s) => s.zoomBand)
+  const format = useStore((s) => s.fileInfo?.format)
 
   useEffect(() => {
     const canvas = canvasRef.current
@@ -32,7 +35,10 @@ export function FrequencyAxis(): React.ReactElement {
     ctx.clearRect(0, 0, AXIS_WIDTH, rect.height)
 
     const numTicks = 8
-    const halfRate = sampleRate / 2
+    // Zoom tiles cover only their band, centred away from DC; real
+    // captures show DC to Nyquist
+    const band = displayBandHz(sampleRate, zoomBand, format)
+    const halfRate = band.rate / 2
     const totalBins = fftSize / 2
 
     // Visible frequency range accounting for Y zoom/scroll
@@ -53,7 +59,7 @@ export function FrequencyAxis(): React.ReactElement {
     for (let i = 0; i <= numTicks; i++) {
       const y = (i / numTicks) * rect.height
       const normalizedPos = yOffset + (i / numTicks) * visibleFraction
-      const freq = halfRate - normalizedPos * sampleRate
+      const freq = band.centre + halfRate - normalizedPos * band.rate
 
       ctx.beginPath()
       ctx.moveTo(0, y)
@@ -62,7 +68,7 @@ export function FrequencyAxis(): React.ReactElement {
 
       ctx.fillText(formatFrequency(freq), 10, y + 4)
     }
-  }, [sampleRate, fftSize, yZoomLevel, yScrollOffset])
+  }, [sampleRate, fftSize, yZoomLevel, yScrollOffset, zoomBand, format])
 
   return (
     <div
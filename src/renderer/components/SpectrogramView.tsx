@@ -1,8 +1,13 @@
 import React, { useRef, useEffect, useCallback, useState } from 'react'
 import { useStore } from '../state/store'
-import { SpectrogramRenderer, TILE_LINES } from '../webgl/SpectrogramRenderer'
+import { SpectrogramRenderer, TILE_LINES, type RenderParams } from '../webgl/SpectrogramRenderer'
+import { tileKey as makeTileKey } from '../webgl/TileCache'
+import { tileBins } from '../../shared/zoom-band'
 
 const MAX_CONCURRENT_TILES = 4
+// Preview tiles use this many times the view's stride: one preview spans
+// that many tiles for about the cost of one
+const PREVIEW_STRIDE_FACTOR = 4
 
 export function SpectrogramView(): React.ReactElement {
   const canvasRef = useRef<HTMLCanvasElement>(null)
@@ -11,12 +16,23 @@ export function SpectrogramView(): React.ReactElement {
   // Track size as state so changes trigger re-render
   const [viewSize, setViewSize] = useState({ width: 0, height: 0 })
   const generationRef = useRef(0)
+  // Tile requests in flight by key, so a new view awaits them instead of
+  // asking again; replaced along with the tiles when a file opens
+  const pendingRef = useRef(new Map<string, Promise<void>>())
+  const renderParamsRef = useRef<RenderParams | null>(null)
 
   const fileInfo = useStore((s) => s.fileInfo)
   const fftSize = useStore((s) => s.fftSize)
+  const tileMode = useStore((s) => s.tileMode)
+  const channel = useStore((s) => s.channel)
+  const zoomBand = useStore((s) => s.zoomBand)
+  const loraSf = useStore((s) => s.loraSf)
+  const loraBandwidth = useStore((s) => s.loraBandwidth)
+  const sampleRate = useStore((s) => s.sampleRate)
   const zoomLevel = useStore((s) => s.zoomLevel)
   const powerMin = useStore((s) => s.powerMin)
   const powerMax = useStore((s) => s.powerMax)
+  const colorMap = useStore((s) => s.colorMap)
   const scrollOffset = useStore((s) => s.scrollOffset)
   const setScrollOffset = useStore((s) => s.setScrollOffset)
   const setZoomLevel = useStore((s) => s.setZoomLevel)
@@ -30,6 +46,15 @@ export function SpectrogramView(): React.ReactElement {
   // zoomLevel > 1 means overlap (stride < fftSize), < 1 means gaps (stride > fftSize)
   const stride = Math.max(1, Math.round(fftSize / zoomLevel))
 
+  // Chirp bandwidth as a fraction of the sample rate
+  const chirpBandwidth = Math.min(1, loraBandwidth / sampleRate)
+  // Distinguishes tiles computed with different modes/bands/channels in the cache
+  const tileVariant = (tileMode === 'zoom' && zoomBand
+    ? `zoom_${zoomBand.fLow}_${zoomBand.fHigh}`
+    : tileMode === 'dechirp'
+      ? `dechirp_${loraSf}_${chirpBandwidth}`
+      : tileMode) + `_ch${channel}`
+
   // Initialize WebGL renderer
   useEffect(() => {
     const canvas = canvasRef.current
@@ -82,13 +107,34 @@ export function SpectrogramView(): React.ReactElement {
     fittedFileRef.current = fileKey
     initialLoadRef.current = true
     rendererRef.current?.clearTiles()
+    pendingRef.current = new Map()
     generationRef.current++
     const fillZoom = fftSize * viewSize.width / fileInfo.totalSamples
     setZoomLevel(Math.min(fftSize, fillZoom))
     setScrollOffset(0)
   }, [fileInfo, viewSize.width])
 
-  // Render spectrogram
+  // Display-only parameters redraw from the cached tiles and never
+  // request new ones; the colormap and power range are applied in the shader
+  useEffect(() => {
+    const renderer = rendererRef.current
+    if (!fileInfo || !renderer || viewSize.width === 0) return
+    renderer.setColorMap(colorMap)
+    renderParamsRef.current = {
+      scrollOffset,
+      fftSize,
+      stride,
+      powerMin,
+      powerMax,
+      totalSamples: fileInfo.totalSamples,
+      tileVariant,
+      yZoomLevel,
+      yScrollOffset: yScrollOffset / (fftSize / 2)
+    }
+    renderer.render(renderParamsRef.current)
+  }, [fileInfo, fftSize, stride, tileVariant, colorMap, powerMin, powerMax, scrollOffset, viewSize, yZoomLevel, yScrollOffset])
+
+  // Load the tiles the view is missing
   useEffect(() => {
     if (!fileInfo || !rendererRef.current) return
     if (viewSize.width === 0) return
@@ -104,23 +150,65 @@ export function SpectrogramView(): React.ReactElement {
     const lastTileIdx = Math.ceil(visibleEnd / tileSampleCoverage)
 
     const generation = ++generationRef.current
-
-    const renderParams = {
-      scrollOffset,
-      fftSize,
-      stride,
-      powerMin,
-      powerMax,
-      totalSamples: fileInfo.totalSamples,
-      yZoomLevel,
-      yScrollOffset: yScrollOffset / (fftSize / 2)
+    // Real captures come back as half-spectrum lines
+    const bins = tileBins(fileInfo.format, fftSize, tileMode)
+    const pending = pendingRef.current
+
+    // A tile is keyed by everything that shapes it, so one that arrives
+    // after the view has moved on is still cached for later
+    const fetchTile = (tileSampleStart: number, tileStride: number): Promise<void> => {
+      const tileKey = makeTileKey(tileSampleStart, fftSize, tileStride, tileVariant)
+      const inFlight = pending.get(tileKey)
+      if (inFlight) return inFlight
+      const promise = window.snailAPI.computeFFTTile({
+        startSample: tileSampleStart,
+        fftSize,
+        stride: tileStride,
+        mode: tileMode,
+        fLow: zoomBand?.fLow,
+        fHigh: zoomBand?.fHigh,
+        channel,
+        spreadingFactor: loraSf,
+        chirpBandwidth
+      }).then((rawData) => {
+        if (pendingRef.current !== pending || rendererRef.current !== renderer) return
+        if (!rawData) return
+
+        let data: Float32Array
+        const dataObj = rawData as any
+        if (dataObj instanceof Float32Array) {
+          data = dataObj
+        } else if (dataObj instanceof ArrayBuffer) {
+          data = new Float32Array(dataObj)
+        } else if (dataObj.buffer instanceof ArrayBuffer) {
+          data = new Float32Array(dataObj.buffer)
+        } else {
+          data = new Float32Array(dataObj)
+        }
+        if (data.length > 0) {
+          renderer.uploadTile(tileKey, data, bins, { sampleStart: tileSampleStart, fftSize, stride: tileStride, variant: tileVariant })
+        }
+      }).catch(() => { }).finally(() => {
+        pending.delete(tileKey)
+      })
+      pending.set(tileKey, promise)
+      return promise
     }
 
-    // Always render immediately with cached tiles
-    renderer.render(renderParams)
+    const fetchInBatches = async (tiles: { start: number; stride: number }[]): Promise<boolean> => {
+      for (let i = 0; i < tiles.length; i += MAX_CONCURRENT_TILES) {
+        if (generationRef.current !== generation) return false
+        const batch = tiles.slice(i, i + MAX_CONCURRENT_TILES)
+        await Promise.all(batch.map((t) => fetchTile(t.start, t.stride)))
+        if (generationRef.current === generation && renderParamsRef.current) {
+          renderer.render(renderParamsRef.current)
+        }
+      }
+      return generationRef.current === generation
+    }
 
     const loadTiles = async () => {
-      const needed: { tileKey: string; tileSampleStart: number }[] = []
+      const needed: { start: number; stride: number }[] = []
 
       for (let tIdx = firstTileIdx; tIdx <= lastTileIdx; tIdx++) {
         const tileSampleStart = tIdx * tileSampleCoverage
@@ -128,9 +216,9 @@ export function SpectrogramView(): React.ReactElement {
         // Skip tiles that start beyond the file
         if (tileSampleStart >= fileInfo.totalSamples) break
 
-        const tileKey = `${tileSampleStart}_${fftSize}_${stride}`
+        const tileKey = makeTileKey(tileSampleStart, fftSize, stride, tileVariant)
         if (renderer.hasTile(tileKey)) continue
-        needed.push({ tileKey, tileSampleStart })
+        needed.push({ start: tileSampleStart, stride })
       }
 
       if (needed.length === 0) {
@@ -138,46 +226,29 @@ export function SpectrogramView(): React.ReactElement {
         return
       }
 
+      // Where nothing cached at any resolution can stand in, fetch coarse
+      // preview tiles first so the view fills at once and then sharpens
+      const previewStride = stride * PREVIEW_STRIDE_FACTOR
+      const previewCoverage = TILE_LINES * previewStride
+      const previews: { start: number; stride: number }[] = []
+      for (const t of needed) {
+        if (renderer.hasCoverage(tileVariant, t.start, t.start + tileSampleCoverage)) continue
+        const start = Math.floor(t.start / previewCoverage) * previewCoverage
+        if (!previews.some((p) => p.start === start)) previews.push({ start, stride: previewStride })
+      }
+
       if (initialLoadRef.current) setLoading(true)
-      for (let i = 0; i < needed.length; i += MAX_CONCURRENT_TILES) {
-        if (generationRef.current !== generation) return
-
-        const batch = needed.slice(i, i + MAX_CONCURRENT_TILES)
-        await Promise.all(batch.map(({ tileKey, tileSampleStart }) =>
-          window.snailAPI.computeFFTTile({
-            startSample: tileSampleStart,
-            fftSize,
-            stride
-          }).then((rawData) => {
-            if (generationRef.current !== generation) return
-            if (!rawData) return
-
-            let data: Float32Array
-            const dataObj = rawData as any
-            if (dataObj instanceof Float32Array) {
-              data = dataObj
-            } else if (dataObj instanceof ArrayBuffer) {
-              data = new Float32Array(dataObj)
-            } else if (dataObj.buffer instanceof ArrayBuffer) {
-              data = new Float32Array(dataObj.buffer)
-            } else {
-              data = new Float32Array(dataObj)
-            }
-            if (data.length > 0) {
-              renderer.uploadTile(tileKey, data, fftSize)
-            }
-          }).catch(() => { })
-        ))
-
-        if (generationRef.current === generation) {
-          renderer.render(renderParams)
-        }
+      if (previews.length > 0 && needed.length > 1) {
+        if (!(await fetchInBatches(previews))) return
+        // The previews already fill the view; no need to hide it any longer
+        if (initialLoadRef.current) { initialLoadRef.current = false; setLoading(false) }
       }
+      if (!(await fetchInBatches(needed))) return
       if (initialLoadRef.current) { initialLoadRef.current = false; setLoading(false) }
     }
 
     loadTiles()
-  }, [fileInfo, fftSize, stride, powerMin, powerMax, scrollOffset, viewSize, yZoomLevel, yScrollOffset])
+  }, [fileInfo, fftSize, stride, tileMode, zoomBand, channel, loraSf, chirpBandwidth, scrollOffset, viewSize])
 
   // Min zoom: enough to fit all samples in the viewport
   const minZoom = fileInfo && viewSize.width > 0
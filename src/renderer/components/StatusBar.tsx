@@ -1,6 +1,7 @@
 import React from 'react'
 import { useStore } from '../state/store'
 import { formatTimeValue, formatFrequency, formatSampleRate } from '../../shared/units'
+import { displayBandHz } from '../../shared/zoom-band'
 import { version } from '../../../package.json'
 
 export function StatusBar(): React.ReactElement {
@@ -14,6 +15,7 @@ export function StatusBar(): React.ReactElement {
   const yZoomLevel = useStore((s) => s.yZoomLevel)
   const yScrollOffset = useStore((s) => s.yScrollOffset)
   const viewHeight = useStore((s) => s.viewHeight)
+  const zoomBand = useStore((s) => s.zoomBand)
   const loading = useStore((s) => s.loading)
   const error = useStore((s) => s.error)
 
@@ -21,7 +23,8 @@ export function StatusBar(): React.ReactElement {
 
   // Convert cursor Y pixel positions to frequencies (same formula as CursorOverlay)
   const yNormOffset = viewHeight > 0 ? yScrollOffset / (fftSize / 2) : 0
-  const pxToFreq = (y: number) => (0.5 - yNormOffset - y / viewHeight / yZoomLevel) * sampleRate
+  const band = displayBandHz(sampleRate, zoomBand, fileInfo?.format)
+  const pxToFreq = (y: number) => band.centre + (0.5 - yNormOffset - y / viewHeight / yZoomLevel) * band.rate
 
   return (
     <div
@@ -12,6 +12,7 @@ export function TracePlot(): React.ReactElement {
   const fftSize = useStore((s) => s.fftSize)
   const zoomLevel = useStore((s) => s.zoomLevel)
   const cursors = useStore((s) => s.cursors)
+  const channel = useStore((s) => s.channel)
 
   useEffect(() => {
     const canvas = canvasRef.current
@@ -47,7 +48,7 @@ export function TracePlot(): React.ReactElement {
       : Math.ceil(rect.width * samplesPerPixel)
 
     // Load samples and draw
-    window.snailAPI.getSamples(start, samplesToRequest, stride)
+    window.snailAPI.getSamples(start, samplesToRequest, stride, channel)
       .then((samples) => {
         if (!samples || samples.length === 0) return
 
@@ -123,7 +124,7 @@ export function TracePlot(): React.ReactElement {
       .catch(() => {
         // Silently fail if native addon not ready
       })
-  }, [fileInfo, scrollOffset, fftSize, zoomLevel, cursors])
+  }, [fileInfo, scrollOffset, fftSize, zoomLevel, cursors, channel])
 
   return (
     <div
@@ -0,0 +1,55 @@
+import { useEffect, useRef } from 'react'
+import { useStore } from '../state/store'
+import type { SigMFAnnotation } from '../../shared/sample-formats'
+import { displayBandHz } from '../../shared/zoom-band'
+
+// Most annotations drawn at once; beyond this the view is too dense to read anyway
+const MAX_VISIBLE_ANNOTATIONS = 5000
+
+// Add annotations to the native index and refresh the visible set
+export async function addAnnotations(annotations: SigMFAnnotation[]): Promise<number[]> {
+  const ids = await window.snailAPI.addAnnotations(annotations)
+  useStore.getState().invalidateAnnotations()
+  return ids
+}
+
+// Keep the store's annotations in step with the viewport by querying the
+// native index whenever the view or the index changes
+export function useVisibleAnnotations(): void {
+  const fileInfo = useStore((s) => s.fileInfo)
+  const version = useStore((s) => s.annotationsVersion)
+  const fftSize = useStore((s) => s.fftSize)
+  const zoomLevel = useStore((s) => s.zoomLevel)
+  const scrollOffset = useStore((s) => s.scrollOffset)
+  const viewWidth = useStore((s) => s.viewWidth)
+  const yZoomLevel = useStore((s) => s.yZoomLevel)
+  const yScrollOffset = useStore((s) => s.yScrollOffset)
+  const sampleRate = useStore((s) => s.sampleRate)
+  const zoomBand = useStore((s) => s.zoomBand)
+  const setVisibleAnnotations = useStore((s) => s.setVisibleAnnotations)
+  const requestSeq = useRef(0)
+
+  useEffect(() => {
+    if (!fileInfo) return
+    const seq = ++requestSeq.current
+
+    // Same mappings as CursorOverlay: integer stride, top of view at yScrollOffset
+    const stride = Math.max(1, Math.round(fftSize / zoomLevel))
+    const band = displayBandHz(sampleRate, zoomBand, fileInfo.format)
+    const freqTop = band.centre + (0.5 - yScrollOffset / (fftSize / 2)) * band.rate
+    const freqBottom = freqTop - band.rate / yZoomLevel
+
+    window.snailAPI.queryAnnotations({
+      sampleStart: Math.max(0, scrollOffset),
+      sampleEnd: scrollOffset + viewWidth * stride,
+      freqLow: freqBottom,
+      freqHigh: freqTop,
+      limit: MAX_VISIBLE_ANNOTATIONS
+    }).then((result) => {
+      // A newer query may have been issued while this one was in flight
+      if (seq === requestSeq.current) setVisibleAnnotations(result.annotations, result.total)
+    }).catch((err) => {
+      console.error('Annotation query failed:', err)
+    })
+  }, [fileInfo, version, fftSize, zoomLevel, scrollOffset, viewWidth, yZoomLevel, yScrollOffset, sampleRate, zoomBand, setVisibleAnnotations])
+}
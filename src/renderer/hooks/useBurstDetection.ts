@@ -0,0 +1,49 @@
+import { useCallback, useEffect, useState } from 'react'
+import { useStore } from '../state/store'
+import type { DetectionConfig, SigMFAnnotation } from '../../shared/sample-formats'
+import { addAnnotations } from './useAnnotations'
+
+export function useBurstDetection() {
+  const [detecting, setDetecting] = useState(false)
+  const [progress, setProgress] = useState(0)
+  const [found, setFound] = useState(0)
+
+  // Bursts arrive in batches while the scan runs; add them as annotations
+  useEffect(() => {
+    return window.snailAPI.onDetectionUpdate((update) => {
+      setProgress(update.progress)
+      if (update.bursts.length === 0) return
+      const sampleRate = useStore.getState().sampleRate
+      const annotations: SigMFAnnotation[] = update.bursts.map((b) => ({
+        sampleStart: b.sampleStart,
+        sampleCount: b.sampleCount,
+        freqLowerEdge: b.freqLow * sampleRate,
+        freqUpperEdge: b.freqHigh * sampleRate,
+        label: 'burst',
+        comment: `peak ${b.peakDb.toFixed(1)} dB above noise`
+      }))
+      setFound((n) => n + annotations.length)
+      addAnnotations(annotations).catch((err) => console.error('Adding bursts failed:', err))
+    })
+  }, [])
+
+  const detect = useCallback(async (config: DetectionConfig) => {
+    try {
+      setDetecting(true)
+      setProgress(0)
+      setFound(0)
+      return await window.snailAPI.detectBursts(config)
+    } catch (err) {
+      console.error('Burst detection failed:', err)
+      throw err
+    } finally {
+      setDetecting(false)
+    }
+  }, [])
+
+  const cancel = useCallback(() => {
+    window.snailAPI.cancelDetection()
+  }, [])
+
+  return { detect, cancel, detecting, progress, found }
+}
@@ -0,0 +1,54 @@
+import { useCallback, useEffect, useState } from 'react'
+import { useStore } from '../state/store'
+import type { ChirpSearchConfig, SigMFAnnotation } from '../../shared/sample-formats'
+import { addAnnotations } from './useAnnotations'
+
+// Symbol values listed in a frame's annotation comment
+const MAX_LISTED_SYMBOLS = 64
+
+export function useChirpSearch() {
+  const [searching, setSearching] = useState(false)
+  const [progress, setProgress] = useState(0)
+  const [found, setFound] = useState(0)
+
+  useEffect(() => window.snailAPI.onChirpProgress(setProgress), [])
+
+  // Frames come back once the scan finishes; add them as annotations
+  // spanning the chirp bandwidth
+  const search = useCallback(async (config: ChirpSearchConfig) => {
+    try {
+      setSearching(true)
+      setProgress(0)
+      setFound(0)
+      const result = await window.snailAPI.findChirpSymbols(config)
+      const bandwidth = (config.chirpBandwidth ?? 1) * useStore.getState().sampleRate
+      const annotations: SigMFAnnotation[] = result.frames.map((f) => {
+        const values = result.symbols
+          .slice(f.firstSymbol, f.firstSymbol + Math.min(f.symbolCount, MAX_LISTED_SYMBOLS))
+          .map((s) => s.value)
+        return {
+          sampleStart: f.sampleStart,
+          sampleCount: f.sampleCount,
+          freqLowerEdge: -bandwidth / 2,
+          freqUpperEdge: bandwidth / 2,
+          label: 'chirps',
+          comment: `${f.symbolCount} symbols: ${values.join(' ')}${f.symbolCount > values.length ? ' ...' : ''}`
+        }
+      })
+      setFound(annotations.length)
+      if (annotations.length > 0) await addAnnotations(annotations)
+      return result
+    } catch (err) {
+      console.error('Chirp search failed:', err)
+      throw err
+    } finally {
+      setSearching(false)
+    }
+  }, [])
+
+  const cancel = useCallback(() => {
+    window.snailAPI.cancelChirpSearch()
+  }, [])
+
+  return { search, cancel, searching, progress, found }
+}
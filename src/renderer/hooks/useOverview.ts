@@ -0,0 +1,28 @@
+import { useCallback, useEffect, useState } from 'react'
+import type { OverviewOptions } from '../../shared/sample-formats'
+
+export function useOverview() {
+  const [rendering, setRendering] = useState(false)
+  const [progress, setProgress] = useState(0)
+
+  useEffect(() => window.snailAPI.onOverviewProgress(setProgress), [])
+
+  const render = useCallback(async (options: OverviewOptions, defaultName?: string) => {
+    try {
+      setRendering(true)
+      setProgress(0)
+      return await window.snailAPI.renderOverview(options, defaultName)
+    } catch (err) {
+      console.error('Overview render failed:', err)
+      throw err
+    } finally {
+      setRendering(false)
+    }
+  }, [])
+
+  const cancel = useCallback(() => {
+    window.snailAPI.cancelOverview()
+  }, [])
+
+  return { render, cancel, rendering, progress }
+}
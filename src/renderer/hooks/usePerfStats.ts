@@ -0,0 +1,38 @@
+import { useCallback, useEffect, useState } from 'react'
+import type { PerfOptions, PerfStats } from '../../shared/sample-formats'
+
+const POLL_INTERVAL_MS = 1000
+
+// Native hot-path timings, polled while enabled (the panel is open)
+export function usePerfStats(enabled: boolean) {
+  const [stats, setStats] = useState<PerfStats | null>(null)
+
+  const refresh = useCallback(async () => {
+    try {
+      setStats(await window.snailAPI.getPerfStats())
+    } catch (err) {
+      console.error('Perf stats failed:', err)
+    }
+  }, [])
+
+  useEffect(() => {
+    if (!enabled) return
+    refresh()
+    const timer = setInterval(refresh, POLL_INTERVAL_MS)
+    return () => clearInterval(timer)
+  }, [enabled, refresh])
+
+  const reset = useCallback(async () => {
+    await window.snailAPI.resetPerfStats()
+    await refresh()
+  }, [refresh])
+
+  const setOptions = useCallback(async (options: PerfOptions) => {
+    await window.snailAPI.setPerfOptions(options)
+    await refresh()
+  }, [refresh])
+
+  const dumpTrace = useCallback(() => window.snailAPI.dumpPerfTrace(), [])
+
+  return { stats, reset, setOptions, dumpTrace }
+}
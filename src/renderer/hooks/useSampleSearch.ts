@@ -0,0 +1,84 @@
+import { useCallback, useEffect, useRef, useState } from 'react'
+import { useStore } from '../state/store'
+import type { SampleSearchConfig, SampleRange, SigMFAnnotation } from '../../shared/sample-formats'
+import { addAnnotations } from './useAnnotations'
+
+// Sample 10% into the view, where jumps put what they found
+function markerSample(): number {
+  const s = useStore.getState()
+  return Math.max(0, Math.round(s.scrollOffset + s.viewWidth * (s.fftSize / s.zoomLevel) * 0.1))
+}
+
+function scrollTo(sample: number): number {
+  const s = useStore.getState()
+  const viewSamples = s.viewWidth * (s.fftSize / s.zoomLevel)
+  const maxOffset = Math.max(0, (s.fileInfo?.totalSamples ?? 0) - s.fftSize)
+  const offset = Math.max(0, Math.min(maxOffset, Math.round(sample - viewSamples * 0.1)))
+  s.setScrollOffset(offset)
+  return offset
+}
+
+export function useSampleSearch() {
+  const [searching, setSearching] = useState(false)
+  const [progress, setProgress] = useState(0)
+  const [found, setFound] = useState(0)
+  const [last, setLast] = useState<SampleRange | null>(null)
+  // Where the last jump left the view, so next resumes from that hit
+  // rather than from a marker that rounding may have put just before it
+  const jumped = useRef<{ offset: number; sample: number } | null>(null)
+
+  useEffect(() => window.snailAPI.onSampleSearchProgress(setProgress), [])
+
+  const run = useCallback(async (config: SampleSearchConfig) => {
+    try {
+      setSearching(true)
+      setProgress(0)
+      return await window.snailAPI.searchSamples(config)
+    } catch (err) {
+      console.error('Sample search failed:', err)
+      throw err
+    } finally {
+      setSearching(false)
+    }
+  }, [])
+
+  // First match from the start of the file, or the next one after the
+  // view's marker position, and jump to it
+  const find = useCallback(async (config: SampleSearchConfig, next: boolean) => {
+    let start = 0
+    if (next) {
+      const j = jumped.current
+      start = j && j.offset === useStore.getState().scrollOffset ? j.sample : markerSample()
+    }
+    const result = await run({ ...config, mode: next ? 'next' : 'first', start })
+    const range = result.ranges[0] ?? null
+    setLast(range)
+    setFound(range ? 1 : 0)
+    jumped.current = range ? { offset: scrollTo(range.sampleStart), sample: range.sampleStart } : null
+    return result
+  }, [run])
+
+  // Every match, annotated across the full band
+  const findAll = useCallback(async (config: SampleSearchConfig) => {
+    const result = await run({ ...config, mode: 'all' })
+    const sampleRate = useStore.getState().sampleRate
+    const annotations: SigMFAnnotation[] = result.ranges.map((r) => ({
+      sampleStart: r.sampleStart,
+      sampleCount: r.sampleCount,
+      freqLowerEdge: -sampleRate / 2,
+      freqUpperEdge: sampleRate / 2,
+      label: 'search',
+      comment: `${config.condition ?? 'power'} ${config.below ? '<' : '>='} ${config.thresholdDb ?? -20} dBFS, peak ${r.peakDb.toFixed(1)} dBFS`
+    }))
+    setLast(null)
+    setFound(annotations.length)
+    if (annotations.length > 0) await addAnnotations(annotations)
+    return result
+  }, [run])
+
+  const cancel = useCallback(() => {
+    window.snailAPI.cancelSampleSearch()
+  }, [])
+
+  return { find, findAll, cancel, searching, progress, found, last }
+}
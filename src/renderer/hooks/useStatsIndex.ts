@@ -0,0 +1,68 @@
+import { useCallback, useEffect, useState } from 'react'
+import { useStore } from '../state/store'
+import type { HealthReport, StatsStatus } from '../../shared/sample-formats'
+
+const POLL_INTERVAL_MS = 500
+
+export function useStatsIndex() {
+  const fileInfo = useStore((s) => s.fileInfo)
+  const [status, setStatus] = useState<StatsStatus | null>(null)
+  const [health, setHealth] = useState<HealthReport | null>(null)
+
+  // The index builds in the background after each open; poll until it settles
+  useEffect(() => {
+    setStatus(null)
+    setHealth(null)
+    if (!fileInfo) return
+
+    let cancelled = false
+    let timer: ReturnType<typeof setTimeout> | undefined
+    const poll = async () => {
+      try {
+        const next = await window.snailAPI.getStatsStatus()
+        if (cancelled) return
+        setStatus(next)
+        if (next.state === 'ready') {
+          const report = await window.snailAPI.getHealthReport()
+          if (!cancelled) setHealth(report)
+        } else if (next.state === 'building') {
+          timer = setTimeout(poll, POLL_INTERVAL_MS)
+        }
+      } catch (err) {
+        console.error('Statistics index status failed:', err)
+      }
+    }
+    poll()
+
+    return () => {
+      cancelled = true
+      if (timer) clearTimeout(timer)
+    }
+  }, [fileInfo])
+
+  // Fit the colormap to the power in view
+  const autoRange = useCallback(async () => {
+    const s = useStore.getState()
+    const stride = s.fftSize / s.zoomLevel
+    const end = s.scrollOffset + s.viewWidth * stride
+    const range = await window.snailAPI.getAutoRange(s.scrollOffset, end, s.fftSize)
+    if (!range) return
+    s.setPowerMin(Math.max(-150, Math.round(range.minDb)))
+    s.setPowerMax(Math.min(0, Math.round(range.maxDb)))
+  }, [])
+
+  // Scroll so the next signal in the given direction starts a tenth of the way into the view
+  const jumpToSignal = useCallback(async (direction: 1 | -1, thresholdDb = 10) => {
+    const s = useStore.getState()
+    if (!s.fileInfo) return
+    const stride = s.fftSize / s.zoomLevel
+    const viewSamples = s.viewWidth * stride
+    const from = s.scrollOffset + viewSamples * 0.1
+    const sample = await window.snailAPI.findSignal(Math.max(0, Math.round(from)), direction, thresholdDb)
+    if (sample < 0) return
+    const maxOffset = Math.max(0, s.fileInfo.totalSamples - s.fftSize)
+    s.setScrollOffset(Math.max(0, Math.min(maxOffset, Math.round(sample - viewSamples * 0.1))))
+  }, [])
+
+  return { status, health, ready: status?.state === 'ready', autoRange, jumpToSignal }
+}
@@ -1,5 +1,7 @@
 import { create } from 'zustand'
-import type { FileInfo, SigMFAnnotation, SampleFormat } from '../../shared/sample-formats'
+import type { FileInfo, AnnotationEntry, SampleFormat, TileMode } from '../../shared/sample-formats'
+import { displayBandHz, type ZoomBand } from '../../shared/zoom-band'
+import type { ColorMapType } from '../webgl/ColorMap'
 
 export type XAxisMode = 'samples' | 'time'
 
@@ -19,9 +21,15 @@ export interface AppState {
 
   // Spectrogram
   fftSize: number
+  tileMode: TileMode
+  channel: number // of a multi-channel file
+  zoomBand: ZoomBand | null
+  loraSf: number // dechirp mode spreading factor
+  loraBandwidth: number // dechirp mode chirp bandwidth, Hz
   zoomLevel: number
   powerMin: number
   powerMax: number
+  colorMap: ColorMapType
   scrollOffset: number
   xAxisMode: XAxisMode
   sampleRate: number
@@ -35,10 +43,12 @@ export interface AppState {
   // Cursors
   cursors: CursorState
 
-  // Annotations
-  annotations: SigMFAnnotation[]
+  // Annotations live in the native index; the store holds those in view
+  annotations: AnnotationEntry[]
+  annotationTotal: number
+  annotationsVersion: number // bumped whenever the index changes
   annotationsVisible: boolean
-  selectedAnnotationIndex: number | null
+  selectedAnnotation: AnnotationEntry | null
 
   // Dialogs
   showExportDialog: boolean
@@ -60,9 +70,14 @@ export interface AppState {
   setLoading: (loading: boolean) => void
   setError: (error: string | null) => void
   setFFTSize: (size: number) => void
+  setTileMode: (mode: TileMode) => void
+  setChannel: (channel: number) => void
+  setLoraSf: (sf: number) => void
+  setLoraBandwidth: (bandwidth: number) => void
   setZoomLevel: (zoom: number) => void
   setPowerMin: (min: number) => void
   setPowerMax: (max: number) => void
+  setColorMap: (colorMap: ColorMapType) => void
   setScrollOffset: (offset: number) => void
   setXAxisMode: (mode: XAxisMode) => void
   setSampleRate: (rate: number) => void
@@ -73,10 +88,10 @@ export interface AppState {
   setCursorsEnabled: (enabled: boolean) => void
   setCursorX: (x1: number, x2: number) => void
   setCursorY: (y1: number, y2: number) => void
-  setAnnotations: (annotations: SigMFAnnotation[]) => void
+  setVisibleAnnotations: (annotations: AnnotationEntry[], total: number) => void
+  invalidateAnnotations: () => void
   setAnnotationsVisible: (visible: boolean) => void
-  setSelectedAnnotationIndex: (index: number | null) => void
-  addAnnotation: (annotation: SigMFAnnotation) => void
+  setSelectedAnnotation: (annotation: AnnotationEntry | null) => void
   setShowExportDialog: (show: boolean) => void
   setShowAnnotationDialog: (show: boolean) => void
   setPendingExport: (pending: { start: number; end: number; label?: string; comment?: string } | null) => void
@@ -97,9 +112,15 @@ const initialState = {
   loading: false,
   error: null,
   fftSize: 512,
+  tileMode: 'stft' as TileMode,
+  channel: 0,
+  zoomBand: null as ZoomBand | null,
+  loraSf: 7,
+  loraBandwidth: 125000,
   zoomLevel: 1,
   powerMin: -100,
   powerMax: 0,
+  colorMap: 'plasma-dark' as ColorMapType,
   scrollOffset: 0,
   xAxisMode: 'samples' as XAxisMode,
   sampleRate: 1000000,
@@ -108,9 +129,11 @@ const initialState = {
   yZoomLevel: 1,
   yScrollOffset: 0,
   cursors: { enabled: false, x1: 0, x2: 0, y1: 0, y2: 0 },
-  annotations: [] as SigMFAnnotation[],
+  annotations: [] as AnnotationEntry[],
+  annotationTotal: 0,
+  annotationsVersion: 0,
   annotationsVisible: true,
-  selectedAnnotationIndex: null as number | null,
+  selectedAnnotation: null as AnnotationEntry | null,
   showExportDialog: false,
   showAnnotationDialog: false,
   pendingExport: null as { start: number; end: number; label?: string; comment?: string } | null,
@@ -127,34 +150,20 @@ const initialState = {
 export const useStore = create<AppState>((set, get) => ({
   ...initialState,
 
-  setFileInfo: (info) => {
-    let annotations: SigMFAnnotation[] = []
-    if (info?.sigmfMetaJson) {
-      try {
-        const meta = JSON.parse(info.sigmfMetaJson)
-        if (Array.isArray(meta.annotations)) {
-          annotations = meta.annotations.map((a: any) => ({
-            sampleStart: a['core:sample_start'] ?? 0,
-            sampleCount: a['core:sample_count'] ?? 0,
-            freqLowerEdge: a['core:freq_lower_edge'],
-            freqUpperEdge: a['core:freq_upper_edge'],
-            label: a['core:label'],
-            comment: a['core:comment']
-          }))
-        }
-      } catch { /* ignore parse errors */ }
-    }
-    set({
-      fileInfo: info,
-      sampleRate: info?.sampleRate ?? 1000000,
-      annotations,
-      error: null,
-      zoomLevel: 1,
-      scrollOffset: 0,
-      yZoomLevel: 1,
-      yScrollOffset: 0
-    })
-  },
+  setFileInfo: (info) => set((s) => ({
+    fileInfo: info,
+    sampleRate: info?.sampleRate ?? 1000000,
+    annotations: [],
+    annotationTotal: 0,
+    annotationsVersion: s.annotationsVersion + 1,
+    selectedAnnotation: null,
+    error: null,
+    channel: 0,
+    zoomLevel: 1,
+    scrollOffset: 0,
+    yZoomLevel: 1,
+    yScrollOffset: 0
+  })),
   setLoading: (loading) => set({ loading }),
   setError: (error) => set({ error }),
   setFFTSize: (fftSize) => {
@@ -165,9 +174,29 @@ export const useStore = create<AppState>((set, get) => ({
     const nextZoom = fftSize / currentStride
     set({ fftSize, zoomLevel: nextZoom })
   },
+  setTileMode: (tileMode) => {
+    const s = get()
+    if (tileMode !== 'zoom') {
+      set({ tileMode, zoomBand: null, ...(s.zoomBand ? { yZoomLevel: 1, yScrollOffset: 0 } : {}) })
+      return
+    }
+    if (s.zoomBand) return
+    // Zoom into the band currently visible on the Y axis; the zoom tiles
+    // then fill the full height, so the Y zoom resets
+    const totalBins = s.fftSize / 2
+    const yOffset = s.yScrollOffset / totalBins
+    const band = displayBandHz(1, null, s.fileInfo?.format) // cycles/sample
+    const fHigh = band.centre + (0.5 - yOffset) * band.rate
+    const fLow = fHigh - band.rate / s.yZoomLevel
+    set({ tileMode, zoomBand: { fLow, fHigh }, yZoomLevel: 1, yScrollOffset: 0 })
+  },
+  setChannel: (channel) => set({ channel }),
+  setLoraSf: (loraSf) => set({ loraSf }),
+  setLoraBandwidth: (loraBandwidth) => set({ loraBandwidth }),
   setZoomLevel: (zoomLevel) => set({ zoomLevel }),
   setPowerMin: (powerMin) => set({ powerMin }),
   setPowerMax: (powerMax) => set({ powerMax }),
+  setColorMap: (colorMap) => set({ colorMap }),
   setScrollOffset: (scrollOffset) => set({ scrollOffset }),
   setXAxisMode: (xAxisMode) => set({ xAxisMode }),
   setSampleRate: (sampleRate) => set({ sampleRate }),
@@ -192,12 +221,10 @@ export const useStore = create<AppState>((set, get) => ({
   setCursorY: (y1: number, y2: number) => set((s) => ({
     cursors: { ...s.cursors, y1, y2 }
   })),
-  setAnnotations: (annotations) => set({ annotations }),
+  setVisibleAnnotations: (annotations, annotationTotal) => set({ annotations, annotationTotal }),
+  invalidateAnnotations: () => set((s) => ({ annotationsVersion: s.annotationsVersion + 1 })),
   setAnnotationsVisible: (visible) => set({ annotationsVisible: visible }),
-  setSelectedAnnotationIndex: (index) => set({ selectedAnnotationIndex: index }),
-  addAnnotation: (annotation) => set((s) => ({
-    annotations: [...s.annotations, annotation]
-  })),
+  setSelectedAnnotation: (selectedAnnotation) => set({ selectedAnnotation }),
   setShowExportDialog: (showExportDialog) => set({ showExportDialog }),
   setShowAnnotationDialog: (showAnnotationDialog) => set({ showAnnotationDialog }),
   setPendingExport: (pendingExport) => set({ pendingExport }),
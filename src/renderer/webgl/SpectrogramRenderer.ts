@@ -1,5 +1,5 @@
-import { TileCache } from './TileCache'
-import { generateColorMap } from './ColorMap'
+import { TileCache, tileKey, type TileSpan } from './TileCache'
+import { generateColorMap, type ColorMapType } from './ColorMap'
 
 export const TILE_LINES = 256
 
@@ -14,7 +14,7 @@ void main() {
 `
 
 // The tile texture is laid out as:
-//   width  = fftSize (frequency bins)
+//   width  = bins per line (fftSize, or fftSize / 2 for real input)
 //   height = numLines (time steps)
 // On screen we want:
 //   X axis = time  -> sample from texture Y
@@ -57,6 +57,7 @@ export interface RenderParams {
   powerMin: number
   powerMax: number
   totalSamples: number
+  tileVariant: string
   yZoomLevel?: number
   yScrollOffset?: number
 }
@@ -66,6 +67,7 @@ export class SpectrogramRenderer {
   private program: WebGLProgram | null = null
   private tileCache: TileCache
   private colormapTexture: WebGLTexture | null = null
+  private colorMap: ColorMapType = 'plasma-dark'
   private posBuffer: WebGLBuffer | null = null
   private texBuffer: WebGLBuffer | null = null
   private width = 0
@@ -124,7 +126,7 @@ export class SpectrogramRenderer {
     this.colormapTexture = gl.createTexture()!
     gl.activeTexture(gl.TEXTURE1)
     gl.bindTexture(gl.TEXTURE_2D, this.colormapTexture)
-    const cmData = generateColorMap('plasma-dark')
+    const cmData = generateColorMap(this.colorMap)
     gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 256, 1, 0, gl.RGBA, gl.UNSIGNED_BYTE, cmData)
     gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.LINEAR)
     gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MAG_FILTER, gl.LINEAR)
@@ -151,25 +153,41 @@ export class SpectrogramRenderer {
     this.gl.viewport(0, 0, width, height)
   }
 
+  // Tiles hold dB values and are coloured in the shader, so a new colormap
+  // is one 256-texel upload and no tile is recomputed
+  setColorMap(type: ColorMapType): void {
+    if (type === this.colorMap || !this.colormapTexture) return
+    this.colorMap = type
+    const gl = this.gl
+    gl.activeTexture(gl.TEXTURE1)
+    gl.bindTexture(gl.TEXTURE_2D, this.colormapTexture)
+    gl.texSubImage2D(gl.TEXTURE_2D, 0, 0, 0, 256, 1, gl.RGBA, gl.UNSIGNED_BYTE, generateColorMap(type))
+  }
+
   hasTile(key: string): boolean {
     return this.tileCache.has(key)
   }
 
-  uploadTile(key: string, data: Float32Array, fftSize: number): void {
+  // Whether any cached tile of variant, at any resolution, lies under samples [start, end)
+  hasCoverage(variant: string, start: number, end: number): boolean {
+    return this.tileCache.overlapping(variant, start, end).length > 0
+  }
+
+  uploadTile(key: string, data: Float32Array, bins: number, span: TileSpan): void {
     const gl = this.gl
     // Ensure we have a real Float32Array (IPC may deliver a different typed array)
     const floatData = data instanceof Float32Array ? data : new Float32Array(data)
-    const numRows = Math.floor(floatData.length / fftSize)
+    const numRows = Math.floor(floatData.length / bins)
     if (numRows < 1) return
 
     const texture = gl.createTexture()!
     gl.activeTexture(gl.TEXTURE0)
     gl.bindTexture(gl.TEXTURE_2D, texture)
 
-    // Texture layout: width=fftSize (freq bins), height=numRows (time lines)
+    // Texture layout: width=bins (freq), height=numRows (time lines)
     gl.texImage2D(
       gl.TEXTURE_2D, 0, gl.R32F,
-      fftSize, numRows, 0,
+      bins, numRows, 0,
       gl.RED, gl.FLOAT, floatData
     )
     // R32F textures need OES_texture_float_linear for LINEAR; fall back to NEAREST
@@ -179,7 +197,7 @@ export class SpectrogramRenderer {
     gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_S, gl.CLAMP_TO_EDGE)
     gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_T, gl.CLAMP_TO_EDGE)
 
-    this.tileCache.put(key, texture, numRows)
+    this.tileCache.put(key, texture, numRows, span)
   }
 
   render(params: RenderParams): void {
@@ -215,52 +233,82 @@ export class SpectrogramRenderer {
     const firstTileIdx = Math.floor(visibleStart / tileSampleCoverage)
     const lastTileIdx = Math.ceil(visibleEnd / tileSampleCoverage)
 
+    const tiles: { texture: WebGLTexture; sampleStart: number; sampleEnd: number }[] = []
+    let missing = false
     for (let tIdx = firstTileIdx; tIdx <= lastTileIdx; tIdx++) {
       const tileSampleStart = tIdx * tileSampleCoverage
-      const tileKey = `${tileSampleStart}_${params.fftSize}_${params.stride}`
-      const entry = this.tileCache.get(tileKey)
-      if (!entry) continue
-
-      gl.activeTexture(gl.TEXTURE0)
-      gl.bindTexture(gl.TEXTURE_2D, entry.texture)
-      gl.uniform1i(this.uTile, 0)
-
+      if (tileSampleStart >= params.totalSamples) break
+      const key = tileKey(tileSampleStart, params.fftSize, params.stride, params.tileVariant)
+      const entry = this.tileCache.get(key)
+      if (!entry) {
+        missing = true
+        continue
+      }
       // Use actual numRows to compute the real sample extent of this tile
-      const actualTileEnd = tileSampleStart + entry.numRows * stride
-
-      // Map tile sample range to pixel positions
-      const tileStartPx = (tileSampleStart - visibleStart) / samplesPerPixel
-      const tileEndPx = (actualTileEnd - visibleStart) / samplesPerPixel
-
-      // Convert pixel coords to NDC (-1 to 1)
-      const x0 = (tileStartPx / viewWidthPx) * 2.0 - 1.0
-      const x1 = (tileEndPx / viewWidthPx) * 2.0 - 1.0
-
-      // Positions: quad spanning [x0,x1] horizontally, full height vertically
-      const positions = new Float32Array([
-        x0, -1,  x1, -1,  x0, 1,
-        x0,  1,  x1, -1,  x1, 1
-      ])
-
-      // texCoord: x=time within tile (0..1), y=frequency (0=top, 1=bottom)
-      // The shader swaps these to sample the texture correctly
-      const texCoords = new Float32Array([
-        0, 1,  1, 1,  0, 0,
-        0, 0,  1, 1,  1, 0
-      ])
-
-      gl.bindBuffer(gl.ARRAY_BUFFER, this.posBuffer)
-      gl.bufferData(gl.ARRAY_BUFFER, positions, gl.DYNAMIC_DRAW)
-      gl.enableVertexAttribArray(this.aPos)
-      gl.vertexAttribPointer(this.aPos, 2, gl.FLOAT, false, 0, 0)
-
-      gl.bindBuffer(gl.ARRAY_BUFFER, this.texBuffer)
-      gl.bufferData(gl.ARRAY_BUFFER, texCoords, gl.DYNAMIC_DRAW)
-      gl.enableVertexAttribArray(this.aTex)
-      gl.vertexAttribPointer(this.aTex, 2, gl.FLOAT, false, 0, 0)
-
-      gl.drawArrays(gl.TRIANGLES, 0, 6)
+      tiles.push({ texture: entry.texture, sampleStart: tileSampleStart, sampleEnd: tileSampleStart + entry.numRows * stride })
     }
+
+    // Until every tile is in, draw the same view from tiles cached at other
+    // fftSizes and strides underneath, coarsest first, so a parameter change
+    // sharpens the old picture instead of blanking it
+    if (missing) {
+      const fallbacks = this.tileCache.overlapping(params.tileVariant, visibleStart, visibleEnd)
+        .filter((t) => t.fftSize !== params.fftSize || t.stride !== params.stride)
+        .sort((a, b) => b.stride - a.stride || a.fftSize - b.fftSize)
+      for (const t of fallbacks) {
+        this.drawTile(t.texture, t.sampleStart, t.sampleStart + t.numRows * t.stride, visibleStart, samplesPerPixel, viewWidthPx)
+      }
+    }
+    for (const t of tiles) {
+      this.drawTile(t.texture, t.sampleStart, t.sampleEnd, visibleStart, samplesPerPixel, viewWidthPx)
+    }
+  }
+
+  private drawTile(
+    texture: WebGLTexture,
+    tileSampleStart: number,
+    tileSampleEnd: number,
+    visibleStart: number,
+    samplesPerPixel: number,
+    viewWidthPx: number
+  ): void {
+    const gl = this.gl
+    gl.activeTexture(gl.TEXTURE0)
+    gl.bindTexture(gl.TEXTURE_2D, texture)
+    gl.uniform1i(this.uTile, 0)
+
+    // Map tile sample range to pixel positions
+    const tileStartPx = (tileSampleStart - visibleStart) / samplesPerPixel
+    const tileEndPx = (tileSampleEnd - visibleStart) / samplesPerPixel
+
+    // Convert pixel coords to NDC (-1 to 1)
+    const x0 = (tileStartPx / viewWidthPx) * 2.0 - 1.0
+    const x1 = (tileEndPx / viewWidthPx) * 2.0 - 1.0
+
+    // Positions: quad spanning [x0,x1] horizontally, full height vertically
+    const positions = new Float32Array([
+      x0, -1,  x1, -1,  x0, 1,
+      x0,  1,  x1, -1,  x1, 1
+    ])
+
+    // texCoord: x=time within tile (0..1), y=frequency (0=top, 1=bottom)
+    // The shader swaps these to sample the texture correctly
+    const texCoords = new Float32Array([
+      0, 1,  1, 1,  0, 0,
+      0, 0,  1, 1,  1, 0
+    ])
+
+    gl.bindBuffer(gl.ARRAY_BUFFER, this.posBuffer)
+    gl.bufferData(gl.ARRAY_BUFFER, positions, gl.DYNAMIC_DRAW)
+    gl.enableVertexAttribArray(this.aPos)
+    gl.vertexAttribPointer(this.aPos, 2, gl.FLOAT, false, 0, 0)
+
+    gl.bindBuffer(gl.ARRAY_BUFFER, this.texBuffer)
+    gl.bufferData(gl.ARRAY_BUFFER, texCoords, gl.DYNAMIC_DRAW)
+    gl.enableVertexAttribArray(this.aTex)
+    gl.vertexAttribPointer(this.aTex, 2, gl.FLOAT, false, 0, 0)
+
+    gl.drawArrays(gl.TRIANGLES, 0, 6)
   }
 
   clearTiles(): void {
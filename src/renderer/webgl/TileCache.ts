@@ -1,11 +1,27 @@
 /**
  * LRU cache for WebGL tile textures.
- * Keyed by "{sampleOffset}_{fftSize}_{zoomLevel}".
+ * Keyed by "{sampleOffset}_{fftSize}_{stride}_{variant}", where variant
+ * names the tile mode and any parameters that change its contents.
  */
 
-interface CacheEntry {
+export function tileKey(sampleOffset: number, fftSize: number, stride: number, variant: string): string {
+  return `${sampleOffset}_${fftSize}_${stride}_${variant}`
+}
+
+// What a cached tile holds, for drawing it under another resolution
+export interface TileSpan {
+  sampleStart: number
+  fftSize: number
+  stride: number
+  variant: string
+}
+
+export interface CachedTile extends TileSpan {
   texture: WebGLTexture
   numRows: number
+}
+
+interface CacheEntry extends CachedTile {
   lastUsed: number
 }
 
@@ -34,9 +50,21 @@ export class TileCache {
     return { texture: entry.texture, numRows: entry.numRows }
   }
 
-  put(key: string, texture: WebGLTexture, numRows: number): void {
+  put(key: string, texture: WebGLTexture, numRows: number, span: TileSpan): void {
     this.evictIfNeeded()
-    this.cache.set(key, { texture, numRows, lastUsed: Date.now() })
+    this.cache.set(key, { ...span, texture, numRows, lastUsed: Date.now() })
+  }
+
+  // Tiles of variant at any fftSize and stride that overlap samples
+  // [start, end). Does not count as a use.
+  overlapping(variant: string, start: number, end: number): CachedTile[] {
+    const tiles: CachedTile[] = []
+    for (const entry of this.cache.values()) {
+      if (entry.variant !== variant) continue
+      if (entry.sampleStart >= end || entry.sampleStart + entry.numRows * entry.stride <= start) continue
+      tiles.push(entry)
+    }
+    return tiles
   }
 
   private evictIfNeeded(): void {
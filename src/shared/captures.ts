@@ -0,0 +1,22 @@
+import type { CaptureSegment } from './sample-formats'
+
+/**
+ * Index of the capture segment holding sample. Segments are sorted by
+ * sampleStart and the first starts at 0 (see InputSource::captures).
+ */
+export function captureIndexAt(captures: CaptureSegment[], sample: number): number {
+  let lo = 0
+  let hi = captures.length
+  while (hi - lo > 1) {
+    const mid = (lo + hi) >> 1
+    if (captures[mid].sampleStart <= sample) lo = mid
+    else hi = mid
+  }
+  return lo
+}
+
+// Segment holding sample, or undefined for files without capture info
+export function captureAt(captures: CaptureSegment[] | undefined, sample: number): CaptureSegment | undefined {
+  if (!captures || captures.length === 0) return undefined
+  return captures[captureIndexAt(captures, sample)]
+}
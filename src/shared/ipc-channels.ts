@@ -1,10 +1,43 @@
 export const IPC = {
   OPEN_FILE: 'snail:open-file',
+  REFRESH_FILE: 'snail:refresh-file',
   GET_SAMPLES: 'snail:get-samples',
   COMPUTE_FFT_TILE: 'snail:compute-fft-tile',
   EXPORT_SIGMF: 'snail:export-sigmf',
   CORRELATE: 'snail:correlate',
+  SEARCH_OFDM: 'snail:search-ofdm',
+  COMPUTE_PSD: 'snail:compute-psd',
+  COMPUTE_CROSS_SPECTRUM: 'snail:compute-cross-spectrum',
+  DETECT_BURSTS: 'snail:detect-bursts',
+  CANCEL_DETECTION: 'snail:cancel-detection',
+  DETECTION_UPDATE: 'snail:detection-update',
+  RENDER_OVERVIEW: 'snail:render-overview',
+  CANCEL_OVERVIEW: 'snail:cancel-overview',
+  OVERVIEW_PROGRESS: 'snail:overview-progress',
+  FIND_CHIRP_SYMBOLS: 'snail:find-chirp-symbols',
+  CANCEL_CHIRP_SEARCH: 'snail:cancel-chirp-search',
+  CHIRP_PROGRESS: 'snail:chirp-progress',
+  SEARCH_SAMPLES: 'snail:search-samples',
+  CANCEL_SAMPLE_SEARCH: 'snail:cancel-sample-search',
+  SAMPLE_SEARCH_PROGRESS: 'snail:sample-search-progress',
+  QUERY_ANNOTATIONS: 'snail:query-annotations',
+  ANNOTATION_PAGE: 'snail:annotation-page',
+  ADD_ANNOTATIONS: 'snail:add-annotations',
+  UPDATE_ANNOTATION: 'snail:update-annotation',
+  REMOVE_ANNOTATION: 'snail:remove-annotation',
+  STATS_STATUS: 'snail:stats-status',
+  AUTO_RANGE: 'snail:auto-range',
+  FIND_SIGNAL: 'snail:find-signal',
+  HEALTH_REPORT: 'snail:health-report',
+  PERF_STATS: 'snail:perf-stats',
+  RESET_PERF_STATS: 'snail:reset-perf-stats',
+  SET_PERF_OPTIONS: 'snail:set-perf-options',
+  DUMP_PERF_TRACE: 'snail:dump-perf-trace',
   READ_FILE_SAMPLES: 'snail:read-file-samples',
+  START_STREAM: 'snail:start-stream',
+  STOP_STREAM: 'snail:stop-stream',
+  STREAM_STATS: 'snail:stream-stats',
+  STREAM_EVENT: 'snail:stream-event',
   SHOW_OPEN_DIALOG: 'snail:show-open-dialog',
   SHOW_SAVE_DIALOG: 'snail:show-save-dialog',
   SAVE_ANNOTATION: 'snail:save-annotation'
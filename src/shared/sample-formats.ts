@@ -20,20 +20,350 @@ export interface SigMFAnnotation {
   comment?: string
 }
 
+// An annotation held in the native index; ids are stable until the next open
+export interface AnnotationEntry extends SigMFAnnotation {
+  id: number
+}
+
+export interface AnnotationQuery {
+  sampleStart: number
+  sampleEnd: number // exclusive
+  freqLow?: number
+  freqHigh?: number
+  limit?: number
+}
+
+export interface AnnotationQueryResult {
+  annotations: AnnotationEntry[] // ordered by sampleStart
+  total: number // annotations in the index
+  truncated: boolean // more matched than limit
+}
+
+// Walks every annotation in start order; pass the last entry of a page as after
+export interface AnnotationPageRequest {
+  after?: { sampleStart: number; id: number }
+  count: number
+}
+
+export type IOBackend = 'auto' | 'mmap' | 'async'
+
+export interface OpenFileOptions {
+  // 'auto' uses async reads on NFS/SMB mounts and mmap elsewhere
+  ioBackend?: IOBackend
+  queueDepth?: number
+  blockSize?: number
+  cacheSize?: number
+  // Further data files appended after the opened one (rolled recordings)
+  segments?: string[]
+  // Channels interleaved sample by sample; omitted = SigMF core:num_channels, else 1
+  channels?: number
+}
+
+// One SigMF capture: the tuning from sampleStart up to the next segment
+export interface CaptureSegment {
+  sampleStart: number
+  frequency: number // Hz, carried forward from the previous capture if omitted
+  globalIndex?: number
+  datetime?: string
+}
+
 export interface FileInfo {
   path: string
   format: SampleFormat
   sampleRate: number
   totalSamples: number
   fileSize: number
+  ioBackend: string
+  segmentCount: number
+  channels: number // interleaved channels; sample counts are per channel
   centerFrequency?: number
-  sigmfMetaJson?: string
+  annotationCount: number // SigMF annotations loaded into the native index
+  captures: CaptureSegment[] // always at least one, starting at sample 0
+}
+
+export interface RefreshResult {
+  totalSamples: number
+  fileSize: number
+  grown: boolean
+}
+
+export type WindowType = 'hann' | 'hamming' | 'blackman' | 'blackman-harris' | 'flattop' | 'rectangular'
+export type PSDMode = 'average' | 'max' | 'min'
+
+export interface PSDRequest {
+  start: number
+  end: number
+  fftSize: number
+  overlap?: number // fraction of fftSize, default 0.5
+  window?: WindowType
+  mode?: PSDMode
+  channel?: number
+}
+
+export interface PSDResult {
+  spectrum: Float32Array // fftSize dB values, DC-centered; fftSize / 2 from DC up for real formats
+  segments: number
+  end: number // the range stops at the first retune after start
+  centerFrequency: number // tuning of the capture the spectrum came from
+}
+
+// Cross-spectral density between channels of a multi-channel file
+export interface CrossSpectrumRequest {
+  start: number
+  end: number
+  fftSize: number
+  overlap?: number // fraction of fftSize, default 0.5
+  window?: WindowType
+  pairs?: [number, number][] // omitted = every pair a < b
+}
+
+export interface CrossSpectrumPair {
+  a: number
+  b: number
+  // Per bin, laid out like PSDResult.spectrum
+  magnitude: Float32Array // |CSD| in dB
+  phase: Float32Array // phase of a relative to b, radians
+  coherence: Float32Array // magnitude-squared coherence, 0..1
+}
+
+export interface CrossSpectrumResult {
+  pairs: CrossSpectrumPair[]
+  segments: number
+  end: number
+  centerFrequency: number
+}
+
+export interface DetectionConfig {
+  start?: number
+  end?: number // 0 or omitted = end of file
+  fftSize?: number // frame length, default 256
+  bands?: number // default 32
+  thresholdDb?: number // above the adaptive noise floor, default 10
+  hysteresisDb?: number // default 4
+  minDuration?: number // samples
+  holdFrames?: number // quiet frames tolerated inside a burst, default 1
+  channel?: number
+}
+
+export interface DetectedBurst {
+  sampleStart: number
+  sampleCount: number
+  freqLow: number // normalized frequency, cycles/sample
+  freqHigh: number
+  peakDb: number // above the noise floor
+}
+
+export interface DetectionUpdate {
+  progress: number // 0..1
+  bursts: DetectedBurst[]
+}
+
+export interface DetectionResult {
+  found: number
+  cancelled: boolean
+}
+
+// Whole-file spectrogram image, peak-held per column
+export interface OverviewOptions {
+  width: number
+  height: number
+  fftSize: number
+  colormap?: 'plasma-dark' | 'inspectrum'
+  start?: number
+  end?: number // 0 or omitted = end of file
+  channel?: number
+  minDb?: number // omitted = from the image
+  maxDb?: number
+}
+
+export interface OverviewResult {
+  path: string
+  minDb: number
+  maxDb: number
+  ffts: number
+  cancelled: boolean
 }
 
+// Per-file statistics index, built in the background after openFile
+export interface StatsStatus {
+  state: 'idle' | 'building' | 'ready' | 'failed'
+  progress: number // 0..1
+  fromCache: boolean
+  error?: string
+}
+
+export interface PowerRange {
+  minDb: number
+  maxDb: number
+}
+
+// Power is in dB relative to a full-scale complex sinusoid
+export interface HealthReport {
+  complex: boolean
+  meanPowerDb: number
+  peakPowerDb: number
+  noiseFloorDb: number
+  dcOffsetI: number
+  dcOffsetQ: number
+  dcOffsetDb: number // DC power relative to total power
+  iqGainDb: number
+  iqPhaseDeg: number
+  clippedSamples: number // always 0 for float formats
+  clippedFraction: number
+  powerPercentilesDb: { p10: number; p50: number; p90: number; p99: number }
+}
+
+// Native hot-path timing for one stage, since the last reset
+export interface PerfStageStats {
+  stage: 'queueWait' | 'tile' | 'read' | 'window' | 'fft' | 'log' | 'copyToJS' | 'correlate' | 'export' | 'search'
+  count: number
+  totalMs: number
+  meanUs: number
+  p50Us: number // percentiles to within ~9%
+  p90Us: number
+  p99Us: number
+  maxUs: number
+  bytes: number // bytes touched
+  minorFaults: number // Linux only; 0 elsewhere
+  majorFaults: number
+}
+
+// Native scratch buffer pool, in bytes
+export interface MemoryBudgetStats {
+  reserved: number // bytes held by running requests and caches
+  cached: number // of reserved, held by caches of open files
+  peakReserved: number
+  queued: number // requests waiting for room now
+  waits: number // requests that had to wait
+  degraded: number // requests that took a leaner path instead, e.g. streamed correlation
+  rejected: number // requests larger than the budget less the caches
+}
+
+export interface MemoryStats {
+  limit: number // 0 = unlimited
+  inUse: number
+  pooled: number // held for reuse
+  peakInUse: number
+  peakTotal: number // in use + pooled
+  hits: number // buffers reused
+  misses: number // buffers allocated
+  trims: number // pooled buffers freed to stay under the limit
+  budget: MemoryBudgetStats
+}
+
+export interface PerfStats {
+  detailed: boolean
+  tracing: boolean
+  stages: PerfStageStats[]
+  memory: MemoryStats
+}
+
+export interface PerfOptions {
+  detailed?: boolean // per-line read/window/FFT/log timing
+  tracing?: boolean // keep events for a Chrome trace dump
+  memoryLimit?: number // native memory budget in bytes, 0 = unlimited
+}
+
+export interface StreamConfig {
+  path: string // FIFO or UNIX socket path, '-' for stdin
+  format?: SampleFormat
+  fftSize?: number
+  stride?: number
+  ringSize?: number // bytes
+  linesPerBatch?: number
+}
+
+export type StreamEvent =
+  | { type: 'lines'; lines: Float32Array; numLines: number; fftSize: number; firstSample: number }
+  | { type: 'end'; error?: string }
+
+export interface StreamStats {
+  running: boolean
+  bytesIn: number
+  samplesIn: number
+  linesOut: number
+  overruns: number
+  droppedBytes: number
+  linesDropped: number
+  error?: string
+}
+
+// 'stft': plain windowed FFT; 'reassigned': energy moved to its time-frequency
+// centre of gravity (sharper chirps and bursts, ~3x the cost); 'zoom': only
+// the band [fLow, fHigh], mixed down and decimated before the FFT;
+// 'dechirp': each window multiplied by a conjugate LoRa-style up-chirp first,
+// so chirps of that slope show as horizontal lines
+export type TileMode = 'stft' | 'reassigned' | 'zoom' | 'dechirp'
+
 export interface FFTTileRequest {
   startSample: number
   fftSize: number
   stride: number
+  mode?: TileMode
+  fLow?: number // zoom band, normalized frequency (cycles/sample)
+  fHigh?: number
+  channel?: number
+  spreadingFactor?: number // dechirp: 2^SF symbol values (5..12)
+  chirpBandwidth?: number // dechirp: normalized (cycles/sample, 0..1]
+  symbolSamples?: number // dechirp: overrides 2^SF / chirpBandwidth
+}
+
+export interface ChirpSearchConfig {
+  spreadingFactor?: number
+  chirpBandwidth?: number // normalized (cycles/sample, 0..1]
+  symbolSamples?: number
+  start?: number
+  end?: number // 0 = end of file
+  step?: number // samples between windows, default one symbol
+  thresholdDb?: number // symbol peak above the mean of the symbol bins
+  minSymbols?: number // shortest run reported as a frame
+  channel?: number
+}
+
+export interface ChirpSymbol {
+  sampleStart: number
+  value: number // 0 .. 2^SF - 1
+  powerDb: number
+}
+
+export interface ChirpFrame {
+  sampleStart: number
+  sampleCount: number
+  firstSymbol: number // index into ChirpSearchResult.symbols
+  symbolCount: number
+}
+
+export interface ChirpSearchResult {
+  symbols: ChirpSymbol[]
+  frames: ChirpFrame[]
+  windows: number
+  cancelled: boolean
+}
+
+export interface SampleSearchConfig {
+  condition?: 'power' | 'average' | 'clip'
+  mode?: 'first' | 'next' | 'all' // next passes over a range already under way at start
+  thresholdDb?: number // dBFS
+  below?: boolean // match power under the threshold
+  window?: number // average power window, samples
+  start?: number
+  end?: number // 0 = end of file
+  maxGap?: number // matches at most this many samples apart join one range
+  maxRanges?: number
+  channel?: number
+}
+
+export interface SampleRange {
+  sampleStart: number
+  sampleCount: number
+  peakDb: number // strongest (for below, weakest) matching power, dBFS
+}
+
+export interface SampleSearchResult {
+  ranges: SampleRange[]
+  scanned: number // samples tested before the search could stop
+  truncated: boolean
+  cancelled: boolean
 }
 
 export interface ExportConfig {
@@ -46,7 +376,7 @@ export interface ExportConfig {
   bandpassLow?: number
   bandpassHigh?: number
   sampleRate: number
-  centerFrequency?: number
+  centerFrequency?: number // used only when the file has no capture tuning
 }
 
 export interface CorrelateRequest {
@@ -61,6 +391,25 @@ export interface CorrelateRequest {
   cpLen?: number
 }
 
+// Blind OFDM numerology search over a window: every (Tu, CP) hypothesis
+// is scored in one native pass
+export interface OfdmSearchRequest {
+  windowStart: number
+  windowLength: number
+  hypotheses: { tu: number; cpLen: number }[]
+  maxResults?: number // default: all that fit in the window
+}
+
+export interface OfdmCandidate {
+  tu: number
+  cpLen: number
+  timing: number // absolute sample of a symbol (CP) start
+  symbols: number // symbol periods averaged
+  score: number // CP correlation averaged at the symbol rate, 0..1
+  peak: number // highest single CP correlation, 0..1
+  cfo: number // fractional carrier offset, cycles/sample (modulo 1 / Tu)
+}
+
 export const FORMAT_EXTENSIONS: Record<string, SampleFormat> = {
   '.cf32': 'cf32',
   '.fc32': 'cf32',
@@ -75,6 +424,7 @@ export const FORMAT_EXTENSIONS: Record<string, SampleFormat> = {
   '.sc8': 'cs8',
   '.cu8': 'cu8',
   '.sigmf-data': 'cf32',
+  '.sigmf-collection': 'cf32',
   '.rf32': 'rf32',
   '.rf64': 'rf64',
   '.rs16': 'rs16',
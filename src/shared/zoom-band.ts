@@ -0,0 +1,47 @@
+import type { SampleFormat, TileMode } from './sample-formats'
+
+export interface ZoomBand {
+  fLow: number // normalized frequency, cycles/sample (-0.5 .. 0.5)
+  fHigh: number
+}
+
+const MAX_DECIMATION = 1 << 16
+
+/**
+ * Band actually covered by a zoom tile. The native worker decimates by
+ * floor(1 / bandwidth), so the tile spans centre +- 0.5 / decimation,
+ * at least as wide as requested. Must match ZoomEngine::decimationFor.
+ */
+export function zoomBandLayout(band: ZoomBand): { centre: number; span: number; decimation: number } {
+  const bandwidth = band.fHigh - band.fLow
+  const decimation = Math.min(Math.max(1, Math.floor(1 / bandwidth + 1e-9)), MAX_DECIMATION)
+  return { centre: (band.fLow + band.fHigh) / 2, span: 1 / decimation, decimation }
+}
+
+/** Real formats have no negative frequencies; their tiles run from DC up. */
+export function isRealFormat(format: SampleFormat | undefined): boolean {
+  return !!format && format.startsWith('r')
+}
+
+/**
+ * Values per tile line: fftSize / 2 for real formats outside zoom mode,
+ * fftSize otherwise. Must match TileEngine::lineBins.
+ */
+export function tileBins(format: SampleFormat | undefined, fftSize: number, mode: TileMode): number {
+  return isRealFormat(format) && mode !== 'zoom' ? fftSize / 2 : fftSize
+}
+
+/**
+ * Frequency mapping of the spectrogram's Y axis: a normalized position p
+ * (0 = top, 1 = bottom of the full tile) shows centre + (0.5 - p) * rate Hz.
+ * Real formats show 0 .. sampleRate / 2; zoom tiles are always complex.
+ */
+export function displayBandHz(sampleRate: number, band: ZoomBand | null, format?: SampleFormat): { centre: number; rate: number } {
+  if (!band) {
+    return isRealFormat(format)
+      ? { centre: sampleRate / 4, rate: sampleRate / 2 }
+      : { centre: 0, rate: sampleRate }
+  }
+  const layout = zoomBandLayout(band)
+  return { centre: layout.centre * sampleRate, rate: layout.span * sampleRate }
+}